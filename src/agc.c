@@ -17,96 +17,283 @@
  */
 
 
+
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #include "agc.h"
+#include "fixed.h"
 #include "log.h"
-#include "dsp.h"
 
-agc_ctx *agc_init() {
+static FP_FLOAT agc_coefficient(double, uint32_t);
+
+agc_ctx *agc_init(uint32_t sample_rate, size_t size, uint32_t attack, uint32_t decay) {
     agc_ctx *ctx;
+    double segment_time;
 
     log_info("Initializing AGC");
 
+    if (sample_rate == 0 || size == 0) {
+        log_error("Invalid sample rate or block size");
+        return NULL;
+    }
+
     log_debug("Create AGC context");
-    ctx = (agc_ctx *) malloc(sizeof(agc_ctx));
+    ctx = (agc_ctx *) calloc(1, sizeof(agc_ctx));
     if (ctx == NULL) {
         log_error("Unable to allocate AGC context");
         return NULL;
     }
 
+    ctx->size = size;
+    ctx->segments = size % AGC_SEGMENTS == 0 ? AGC_SEGMENTS : 1;
+    ctx->segment_size = size / ctx->segments;
+
+    log_debug("Computing time constants");
+    segment_time = (double) ctx->segment_size / sample_rate;
+    ctx->attack = agc_coefficient(segment_time, attack);
+    ctx->decay = agc_coefficient(segment_time, decay);
+
     log_debug("Setting default values");
+    ctx->envelope = (FP_FLOAT) AGC_TARGET;
     ctx->gain = 1;
-    ctx->dc_offset = 0;
+    ctx->delay_peak = 0;
 
-    ctx->gain_factor = 0.05f;
-    ctx->dc_offset_factor = 0.01f;
+    log_debug("Allocating look-ahead buffers");
+    ctx->delay = (FP_FLOAT *) calloc(ctx->segment_size, sizeof(FP_FLOAT));
+    ctx->spare = (FP_FLOAT *) calloc(ctx->segment_size, sizeof(FP_FLOAT));
+    ctx->delay_fixed = (int16_t *) calloc(ctx->segment_size, sizeof(int16_t));
+    ctx->spare_fixed = (int16_t *) calloc(ctx->segment_size, sizeof(int16_t));
+    if (ctx->delay == NULL || ctx->spare == NULL || ctx->delay_fixed == NULL || ctx->spare_fixed == NULL) {
+        log_error("Unable to allocate look-ahead buffers");
+        agc_free(ctx);
+        return NULL;
+    }
 
     return ctx;
 }
 
 void agc_free(agc_ctx *ctx) {
+    log_info("Freeing AGC");
+
+    if (ctx == NULL)
+        return;
+
+    if (ctx->delay != NULL)
+        free(ctx->delay);
+
+    if (ctx->spare != NULL)
+        free(ctx->spare);
+
+    if (ctx->delay_fixed != NULL)
+        free(ctx->delay_fixed);
+
+    if (ctx->spare_fixed != NULL)
+        free(ctx->spare_fixed);
+
     free(ctx);
 }
 
 int agc_perform_gain(agc_ctx *ctx, FP_FLOAT *data, size_t len) {
-    size_t i;
+    FP_FLOAT *swap;
+    FP_FLOAT gain;
+    size_t k;
 
-    FP_FLOAT max;
-    FP_FLOAT clip_gain;
+    if (len != ctx->size) {
+        log_error("Invalid block size: %zu", len);
+        return EXIT_FAILURE;
+    }
 
-    log_debug("Performing gain computations");
+    ctx->peaks[0] = ctx->delay_peak;
+    for (k = 0; k < ctx->segments; k++)
+        ctx->peaks[k + 1] = agc_peak(data + k * ctx->segment_size, ctx->segment_size);
 
-    max = 0;
+    memcpy(ctx->spare, data + len - ctx->segment_size, ctx->segment_size * sizeof(FP_FLOAT));
+    memmove(data + ctx->segment_size, data, (len - ctx->segment_size) * sizeof(FP_FLOAT));
+    memcpy(data, ctx->delay, ctx->segment_size * sizeof(FP_FLOAT));
 
-    for (i = 0; i < len; i++)
-        if (data[i] >= 0 && data[i] > max)
-            max = data[i];
-        else if (data[i] < 0 && data[i] < -max)
-            max = -data[i];
+    swap = ctx->delay;
+    ctx->delay = ctx->spare;
+    ctx->spare = swap;
+    ctx->delay_peak = ctx->peaks[ctx->segments];
 
-    if (max > 0)
-        clip_gain = 1 / max;
-    else
-        clip_gain = 0;
+    for (k = 0; k < ctx->segments; k++) {
+        gain = agc_update(ctx, ctx->peaks[k], ctx->peaks[k + 1]);
+        agc_ramp(data + k * ctx->segment_size, ctx->segment_size, ctx->gain, gain);
+        ctx->gain = gain;
+    }
 
-    if (ctx->gain < clip_gain)
-        ctx->gain += ctx->gain_factor;
-    else if (ctx->gain * max > 1)
-        ctx->gain -= ctx->gain_factor;
+    return EXIT_SUCCESS;
+}
+
+int agc_perform_gain_fixed(agc_ctx *ctx, int16_t *data, size_t len) {
+    int16_t *swap;
+    FP_FLOAT gain;
+    size_t k;
+
+    if (len != ctx->size) {
+        log_error("Invalid block size: %zu", len);
+        return EXIT_FAILURE;
+    }
 
-    for (i = 0; i < len; i++)
-        *(data + i) = *(data + i) * ctx->gain;
+    ctx->peaks[0] = ctx->delay_peak;
+    for (k = 0; k < ctx->segments; k++)
+        ctx->peaks[k + 1] = (FP_FLOAT) agc_peak_fixed(data + k * ctx->segment_size, ctx->segment_size)
+                            / FIXED_Q15_ONE;
+
+    memcpy(ctx->spare_fixed, data + len - ctx->segment_size, ctx->segment_size * sizeof(int16_t));
+    memmove(data + ctx->segment_size, data, (len - ctx->segment_size) * sizeof(int16_t));
+    memcpy(data, ctx->delay_fixed, ctx->segment_size * sizeof(int16_t));
+
+    swap = ctx->delay_fixed;
+    ctx->delay_fixed = ctx->spare_fixed;
+    ctx->spare_fixed = swap;
+    ctx->delay_peak = ctx->peaks[ctx->segments];
+
+    for (k = 0; k < ctx->segments; k++) {
+        gain = agc_update(ctx, ctx->peaks[k], ctx->peaks[k + 1]);
+        agc_ramp_fixed(data + k * ctx->segment_size, ctx->segment_size,
+                       (int32_t) lround((double) ctx->gain * (1 << AGC_FIXED_SHIFT)),
+                       (int32_t) lround((double) gain * (1 << AGC_FIXED_SHIFT)));
+        ctx->gain = gain;
+    }
 
     return EXIT_SUCCESS;
 }
 
-//int agc_perform_gain(int8_t *data, size_t data_size) {
-//    size_t i;
-//    int8_t abs_value;
-//    int8_t max;
-//    FP_FLOAT rms;
-//    FP_FLOAT gain;
-//
-//    log_info("Applying limiter");
-//
-//    rms = dsp_rms(data, data_size);
-//    gain = pow(2, rms + 4);
-//
-//    max = 0;
-//
-//    for (i = 0; i < data_size; i++) {
-//        abs_value = abs(data[i]);
-//        if (abs_value > max)
-//            max = abs_value;
-//    }
-//
-//    if (max * gain > 127)
-//        gain = 127.0 / max;
-//
-//    for (i = 0; i < data_size; i++)
-//        data[i] *= gain;
-//
-//    return EXIT_SUCCESS;
-//}
+FP_FLOAT agc_update(agc_ctx *ctx, FP_FLOAT peak, FP_FLOAT lookahead) {
+    FP_FLOAT level;
+    FP_FLOAT gain;
+
+    level = peak > lookahead ? peak : lookahead;
+
+    if (level > ctx->envelope)
+        ctx->envelope += ctx->attack * (level - ctx->envelope);
+    else
+        ctx->envelope += ctx->decay * (level - ctx->envelope);
+
+    if (ctx->envelope > AGC_PEAK_MIN)
+        gain = (FP_FLOAT) AGC_TARGET / ctx->envelope;
+    else
+        gain = AGC_GAIN_MAX;
+
+    if (gain > AGC_GAIN_MAX)
+        gain = AGC_GAIN_MAX;
+
+    if (gain * level > 1)
+        gain = 1 / level;
+
+    return gain;
+}
+
+FP_FLOAT agc_peak(const FP_FLOAT *data, size_t size) {
+    FP_FLOAT peak;
+    FP_FLOAT value;
+    size_t i;
+#ifdef AGC_SIMD_ENABLED
+    agc_simd_bits acc = {0};
+    agc_simd_bits bits;
+    agc_simd_bits mask;
+    agc_simd_word word;
+    size_t l;
+#endif
+
+    peak = 0;
+    i = 0;
+
+#ifdef AGC_SIMD_ENABLED
+    for (; i + AGC_SIMD_LANES <= size; i += AGC_SIMD_LANES) {
+        memcpy(&bits, data + i, sizeof(agc_simd_bits));
+
+        bits &= AGC_SIMD_ABS_MASK;
+        mask = bits > acc;
+        acc = (bits & mask) | (acc & ~mask);
+    }
+
+    word = 0;
+    for (l = 0; l < AGC_SIMD_LANES; l++)
+        if (acc[l] > word)
+            word = acc[l];
+
+    memcpy(&peak, &word, sizeof(FP_FLOAT));
+#endif
+
+    for (; i < size; i++) {
+        value = data[i] < 0 ? -data[i] : data[i];
+        if (value > peak)
+            peak = value;
+    }
+
+    return peak;
+}
+
+int16_t agc_peak_fixed(const int16_t *data, size_t size) {
+    int32_t peak;
+    int32_t value;
+    size_t i;
+
+    peak = 0;
+
+    for (i = 0; i < size; i++) {
+        value = data[i] < 0 ? -(int32_t) data[i] : data[i];
+        peak = value > peak ? value : peak;
+    }
+
+    return fixed_saturate(peak);
+}
+
+void agc_ramp(FP_FLOAT *data, size_t size, FP_FLOAT from, FP_FLOAT to) {
+    FP_FLOAT step;
+    size_t i;
+#ifdef AGC_SIMD_ENABLED
+    agc_simd gains;
+    agc_simd steps;
+    agc_simd v;
+    size_t l;
+#endif
+
+    step = (to - from) / (FP_FLOAT) size;
+    i = 0;
+
+#ifdef AGC_SIMD_ENABLED
+    for (l = 0; l < AGC_SIMD_LANES; l++) {
+        gains[l] = from + step * (FP_FLOAT) l;
+        steps[l] = step * (FP_FLOAT) AGC_SIMD_LANES;
+    }
+
+    for (; i + AGC_SIMD_LANES <= size; i += AGC_SIMD_LANES) {
+        memcpy(&v, data + i, sizeof(agc_simd));
+        v *= gains;
+        memcpy(data + i, &v, sizeof(agc_simd));
+
+        gains += steps;
+    }
+#endif
+
+    for (; i < size; i++)
+        data[i] *= from + step * (FP_FLOAT) i;
+}
+
+void agc_ramp_fixed(int16_t *data, size_t size, int32_t from, int32_t to) {
+    int32_t step;
+    int32_t gain;
+    int64_t value;
+    size_t i;
+
+    step = (to - from) / (int32_t) size;
+    gain = from;
+
+    for (i = 0; i < size; i++) {
+        value = ((int64_t) data[i] * gain + (1 << (AGC_FIXED_SHIFT - 1))) >> AGC_FIXED_SHIFT;
+        data[i] = fixed_saturate((int32_t) value);
+        gain += step;
+    }
+}
+
+static FP_FLOAT agc_coefficient(double segment_time, uint32_t time_constant) {
+    if (time_constant == 0)
+        return 1;
+
+    return (FP_FLOAT) (1 - exp(-segment_time * 1000 / time_constant));
+}
@@ -17,6 +17,7 @@
  */
 
 
+
 #ifndef __RTLSDR_RADIO__AGC__H
 #define __RTLSDR_RADIO__AGC__H
 
@@ -25,22 +26,88 @@
 
 #include "buildflags.h"
 
+/*
+ * Block AGC on the demodulated channel, run before resampling.
+ *
+ * Each block is split in segments of segment_size samples and the output is
+ * delayed by one segment, so the gain for a segment is computed knowing the
+ * peak of the next one (look-ahead). The peak envelope follows the segment
+ * peaks with separate attack and decay time constants, the gain brings the
+ * envelope to AGC_TARGET and is then limited so that no sample can exceed
+ * full scale. Within a segment the gain moves linearly from the previous
+ * value to the new one, which avoids zipper noise.
+ *
+ * Peak search and ramp are computed AGC_SIMD_BYTES at a time when the
+ * compiler supports vector extensions; the absolute value and the maximum
+ * are done on the IEEE bit patterns, which sort like the values they hold
+ * once the sign bit is cleared.
+ *
+ * The _fixed variants work on Q15 samples with the gain in Q16.
+ */
+
+#define AGC_SEGMENTS 8
+#define AGC_TARGET 0.5
+#define AGC_GAIN_MAX 100
+#define AGC_PEAK_MIN 1e-6
+
+#define AGC_FIXED_SHIFT 16
+
+#if defined(__GNUC__) && (defined(RTLSDR_RADIO_FP_FLOAT) || defined(RTLSDR_RADIO_FP_DOUBLE))
+#define AGC_SIMD_ENABLED
+#define AGC_SIMD_BYTES 16
+#define AGC_SIMD_LANES (AGC_SIMD_BYTES / sizeof(FP_FLOAT))
+
+typedef FP_FLOAT agc_simd __attribute__ ((vector_size (AGC_SIMD_BYTES)));
+
+#ifdef RTLSDR_RADIO_FP_FLOAT
+typedef int32_t agc_simd_word;
+#define AGC_SIMD_ABS_MASK INT32_MAX
+#else
+typedef int64_t agc_simd_word;
+#define AGC_SIMD_ABS_MASK INT64_MAX
+#endif
+
+typedef agc_simd_word agc_simd_bits __attribute__ ((vector_size (AGC_SIMD_BYTES)));
+#endif
+
 struct agc_ctx_t {
+    size_t size;
+    size_t segments;
+    size_t segment_size;
+
+    FP_FLOAT attack;
+    FP_FLOAT decay;
+
+    FP_FLOAT envelope;
     FP_FLOAT gain;
-    FP_FLOAT dc_offset;
 
-    FP_FLOAT gain_factor;
-    FP_FLOAT dc_offset_factor;
+    FP_FLOAT *delay;
+    FP_FLOAT *spare;
+    int16_t *delay_fixed;
+    int16_t *spare_fixed;
+    FP_FLOAT delay_peak;
+
+    FP_FLOAT peaks[AGC_SEGMENTS + 1];
 };
 
 typedef struct agc_ctx_t agc_ctx;
 
-agc_ctx *agc_init();
+agc_ctx *agc_init(uint32_t, size_t, uint32_t, uint32_t);
+
+void agc_free(agc_ctx *);
+
+int agc_perform_gain(agc_ctx *, FP_FLOAT *, size_t);
+
+int agc_perform_gain_fixed(agc_ctx *, int16_t *, size_t);
+
+FP_FLOAT agc_update(agc_ctx *, FP_FLOAT, FP_FLOAT);
+
+FP_FLOAT agc_peak(const FP_FLOAT *, size_t);
 
-void agc_free();
+int16_t agc_peak_fixed(const int16_t *, size_t);
 
-int agc_perform_gain(agc_ctx *ctx, FP_FLOAT *data, size_t len);
+void agc_ramp(FP_FLOAT *, size_t, FP_FLOAT, FP_FLOAT);
 
-//int agc_perform_gain(int8_t *, size_t);
+void agc_ramp_fixed(int16_t *, size_t, int32_t, int32_t);
 
 #endif
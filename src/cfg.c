@@ -66,11 +66,41 @@ void cfg_init() {
     conf->rtlsdr_device_tuner_gain = CONFIG_RTLSDR_DEVICE_TUNER_GAIN_DEFAULT;
     conf->rtlsdr_device_agc_mode = CONFIG_RTLSDR_DEVICE_AGC_MODEDEFAULT;
     conf->rtlsdr_samples = CONFIG_RTLSDR_SAMPLES_DEFAULT;
+    conf->rtlsdr_settle = CONFIG_RTLSDR_SETTLE_DEFAULT;
+
+    conf->iq_correction = CONFIG_IQ_CORRECTION_DEFAULT;
+
+    conf->channel_sample_rate = CONFIG_CHANNEL_SAMPLE_RATE_DEFAULT;
+    conf->channel_freqs = NULL;
+    conf->channel_freqs_count = 0;
+
+    conf->channelizer_channels = CONFIG_CHANNELIZER_CHANNELS_DEFAULT;
 
     conf->modulation = CONFIG_MODULATION_DEFAULT;
 
+    conf->squelch = CONFIG_SQUELCH_DEFAULT;
+    conf->squelch_level = CONFIG_SQUELCH_LEVEL_DEFAULT;
+    conf->squelch_hysteresis = CONFIG_SQUELCH_HYSTERESIS_DEFAULT;
+    conf->squelch_hang = CONFIG_SQUELCH_HANG_DEFAULT;
+
+    conf->ctcss_tones = NULL;
+    conf->ctcss_tones_count = 0;
+
+    conf->agc = CONFIG_AGC_DEFAULT;
+    conf->agc_attack = CONFIG_AGC_ATTACK_DEFAULT;
+    conf->agc_decay = CONFIG_AGC_DECAY_DEFAULT;
+
     conf->filter = CONFIG_FILTER_DEFAULT;
-    conf->filter_fir = CONFIG_FILTER_FIR_DEFAULT;
+    conf->filter_design = CONFIG_FILTER_DESIGN_DEFAULT;
+    conf->filter_cutoff = CONFIG_FILTER_CUTOFF_DEFAULT;
+    conf->filter_transition = CONFIG_FILTER_TRANSITION_DEFAULT;
+    conf->filter_attenuation = CONFIG_FILTER_ATTENUATION_DEFAULT;
+
+    conf->fft_planner = CONFIG_FFT_PLANNER_DEFAULT;
+
+    ln = strlen(CONFIG_FFT_WISDOM_FILE_DEFAULT) + 1;
+    conf->fft_wisdom_file = (char *) calloc(sizeof(char), ln);
+    strcpy(conf->fft_wisdom_file, CONFIG_FFT_WISDOM_FILE_DEFAULT);
 
     conf->audio_frames_per_period = CONFIG_AUDIO_FRAME_PER_PERIOD_DEFAULT;
     conf->audio_sample_rate = CONFIG_AUDIO_SAMPLE_RATE_DEFAULT;
@@ -96,14 +126,100 @@ void cfg_init() {
     strcpy(conf->network_server, CONFIG_NETWORK_SERVER_DEFAULT);
 
     conf->network_port = CONFIG_NETWORK_PORT_DEFAULT;
+    conf->network_protocol = CONFIG_NETWORK_PROTOCOL_DEFAULT;
+    conf->network_transport = CONFIG_NETWORK_TRANSPORT_DEFAULT;
+    conf->network_queue = CONFIG_NETWORK_QUEUE_DEFAULT;
+    conf->network_fec = CONFIG_NETWORK_FEC_DEFAULT;
+    conf->network_aggregate_frames = CONFIG_NETWORK_AGGREGATE_FRAMES_DEFAULT;
+    conf->network_aggregate_time = CONFIG_NETWORK_AGGREGATE_TIME_DEFAULT;
+    conf->network_destinations = NULL;
+    conf->network_destinations_ports = NULL;
+    conf->network_destinations_count = 0;
+    conf->network_multicast_ttl = CONFIG_NETWORK_MULTICAST_TTL_DEFAULT;
+
+    ln = strlen(CONFIG_NETWORK_MULTICAST_INTERFACE_DEFAULT) + 1;
+    conf->network_multicast_interface = (char *) calloc(sizeof(char), ln);
+    strcpy(conf->network_multicast_interface, CONFIG_NETWORK_MULTICAST_INTERFACE_DEFAULT);
+
+    conf->spectrum = CONFIG_SPECTRUM_DEFAULT;
+    conf->spectrum_size = CONFIG_SPECTRUM_SIZE_DEFAULT;
+    conf->spectrum_rate = CONFIG_SPECTRUM_RATE_DEFAULT;
+    conf->spectrum_averages = CONFIG_SPECTRUM_AVERAGES_DEFAULT;
+
+    ln = strlen(CONFIG_SPECTRUM_SERVER_DEFAULT) + 1;
+    conf->spectrum_server = (char *) calloc(sizeof(char), ln);
+    strcpy(conf->spectrum_server, CONFIG_SPECTRUM_SERVER_DEFAULT);
+
+    conf->spectrum_port = CONFIG_SPECTRUM_PORT_DEFAULT;
+
+    conf->iq = CONFIG_IQ_DEFAULT;
+    conf->iq_offset = CONFIG_IQ_OFFSET_DEFAULT;
+    conf->iq_sample_rate = CONFIG_IQ_SAMPLE_RATE_DEFAULT;
+    conf->iq_format = CONFIG_IQ_FORMAT_DEFAULT;
+    conf->iq_gain = CONFIG_IQ_GAIN_DEFAULT;
+
+    ln = strlen(CONFIG_IQ_SERVER_DEFAULT) + 1;
+    conf->iq_server = (char *) calloc(sizeof(char), ln);
+    strcpy(conf->iq_server, CONFIG_IQ_SERVER_DEFAULT);
+
+    conf->iq_port = CONFIG_IQ_PORT_DEFAULT;
+
+    conf->control_port = CONFIG_CONTROL_PORT_DEFAULT;
+
+    conf->scan_freqs = NULL;
+    conf->scan_freqs_count = 0;
+    conf->scan_dwell = CONFIG_SCAN_DWELL_DEFAULT;
+    conf->scan_resume = CONFIG_SCAN_RESUME_DEFAULT;
+
+    conf->survey_start = CONFIG_SURVEY_START_DEFAULT;
+    conf->survey_stop = CONFIG_SURVEY_STOP_DEFAULT;
+    conf->survey_size = CONFIG_SURVEY_SIZE_DEFAULT;
+    conf->survey_averages = CONFIG_SURVEY_AVERAGES_DEFAULT;
+    conf->survey_crop = CONFIG_SURVEY_CROP_DEFAULT;
+    conf->survey_loops = CONFIG_SURVEY_LOOPS_DEFAULT;
+    conf->survey_format = CONFIG_SURVEY_FORMAT_DEFAULT;
+
+    ln = strlen(CONFIG_SURVEY_OUTPUT_DEFAULT) + 1;
+    conf->survey_output = (char *) calloc(sizeof(char), ln);
+    strcpy(conf->survey_output, CONFIG_SURVEY_OUTPUT_DEFAULT);
+
+    ln = strlen(CONFIG_PLAY_ADDRESS_DEFAULT) + 1;
+    conf->play_address = (char *) calloc(sizeof(char), ln);
+    strcpy(conf->play_address, CONFIG_PLAY_ADDRESS_DEFAULT);
+
+    conf->play_port = CONFIG_PLAY_PORT_DEFAULT;
+    conf->play_channel = CONFIG_PLAY_CHANNEL_DEFAULT;
+    conf->play_latency = CONFIG_PLAY_LATENCY_DEFAULT;
+    conf->play_concealment = CONFIG_PLAY_CONCEALMENT_DEFAULT;
+
+    ln = strlen(CONFIG_VOTE_ADDRESS_DEFAULT) + 1;
+    conf->vote_address = (char *) calloc(sizeof(char), ln);
+    strcpy(conf->vote_address, CONFIG_VOTE_ADDRESS_DEFAULT);
+
+    conf->vote_port = CONFIG_VOTE_PORT_DEFAULT;
+    conf->vote_channel = CONFIG_VOTE_CHANNEL_DEFAULT;
+    conf->vote_receivers = CONFIG_VOTE_RECEIVERS_DEFAULT;
+    conf->vote_window = CONFIG_VOTE_WINDOW_DEFAULT;
 }
 
 void cfg_free() {
     free(conf->file_log_name);
     free(conf->rawiq_file_path);
+    free(conf->channel_freqs);
+    free(conf->ctcss_tones);
+    free(conf->fft_wisdom_file);
     free(conf->audio_file_path);
     free(conf->audio_monitor_device);
     free(conf->network_server);
+    cfg_free_destination_list(&conf->network_destinations, &conf->network_destinations_ports,
+                              &conf->network_destinations_count);
+    free(conf->network_multicast_interface);
+    free(conf->spectrum_server);
+    free(conf->iq_server);
+    free(conf->scan_freqs);
+    free(conf->survey_output);
+    free(conf->play_address);
+    free(conf->vote_address);
 
     free(conf);
 }
@@ -179,6 +295,7 @@ void cfg_init_uuid() {
 
 void cfg_print() {
     char uuid[UUID_STR_LEN];
+    size_t i;
 
     uuid_unparse_lower(conf->uuid, uuid);
 
@@ -204,11 +321,44 @@ void cfg_print() {
     ui_message("rtlsdr_device_tuner_gain:      %u (10e-1 dB)\n", conf->rtlsdr_device_tuner_gain);
     ui_message("rtlsdr_device_agc_mode:        %s\n", cfg_tochar_bool(conf->rtlsdr_device_agc_mode));
     ui_message("rtlsdr_samples:                %zu\n", conf->rtlsdr_samples);
+    ui_message("rtlsdr_settle:                 %u (ms)\n", conf->rtlsdr_settle);
+    ui_message("\n");
+    ui_message("iq_correction:                 %s\n", cfg_tochar_bool(conf->iq_correction));
+    ui_message("\n");
+    ui_message("channel_sample_rate:           %u (Hz)\n", conf->channel_sample_rate);
+    if (conf->channel_freqs_count == 0) {
+        ui_message("channel_freqs:                 center frequency\n");
+    }
+    for (i = 0; i < conf->channel_freqs_count; i++)
+        ui_message("channel_freqs:                 %u (Hz)\n", conf->channel_freqs[i]);
+    ui_message("\n");
+    ui_message("channelizer_channels:          %zu\n", conf->channelizer_channels);
     ui_message("\n");
     ui_message("modulation:                    %s\n", cfg_tochar_modulation(conf->modulation));
     ui_message("\n");
+    ui_message("squelch:                       %s\n", cfg_tochar_squelch_mode(conf->squelch));
+    ui_message("squelch_level:                 %d (dB)\n", conf->squelch_level);
+    ui_message("squelch_hysteresis:            %u (dB)\n", conf->squelch_hysteresis);
+    ui_message("squelch_hang:                  %u (ms)\n", conf->squelch_hang);
+    ui_message("\n");
+    if (conf->ctcss_tones_count == 0) {
+        ui_message("ctcss_tones:                   none\n");
+    }
+    for (i = 0; i < conf->ctcss_tones_count; i++)
+        ui_message("ctcss_tones:                   %u.%u (Hz)\n", conf->ctcss_tones[i] / 10, conf->ctcss_tones[i] % 10);
+    ui_message("\n");
+    ui_message("agc:                           %s\n", cfg_tochar_bool(conf->agc));
+    ui_message("agc_attack:                    %u (ms)\n", conf->agc_attack);
+    ui_message("agc_decay:                     %u (ms)\n", conf->agc_decay);
+    ui_message("\n");
     ui_message("filter:                        %s\n", cfg_tochar_filter_mode(conf->filter));
-    ui_message("filter_fir:                    %d\n", conf->filter_fir);
+    ui_message("filter_design:                 %s\n", cfg_tochar_filter_design(conf->filter_design));
+    ui_message("filter_cutoff:                 %u (Hz)\n", conf->filter_cutoff);
+    ui_message("filter_transition:             %u (Hz)\n", conf->filter_transition);
+    ui_message("filter_attenuation:            %u (dB)\n", conf->filter_attenuation);
+    ui_message("\n");
+    ui_message("fft_planner:                   %s\n", cfg_tochar_fft_rigor(conf->fft_planner));
+    ui_message("fft_wisdom_file:               %s\n", conf->fft_wisdom_file);
     ui_message("\n");
     ui_message("audio_frames_per_period:       %u\n", conf->audio_frames_per_period);
     ui_message("audio_sample_rate:             %u (Hz)\n", conf->audio_sample_rate);
@@ -225,6 +375,60 @@ void cfg_print() {
     ui_message("\n");
     ui_message("network_server:                %s\n", conf->network_server);
     ui_message("network_port:                  %u\n", conf->network_port);
+    ui_message("network_protocol:              %u\n", conf->network_protocol);
+    ui_message("network_transport:             %s\n", cfg_tochar_network_transport(conf->network_transport));
+    ui_message("network_queue:                 %zu (frames)\n", conf->network_queue);
+    ui_message("network_fec:                   %zu (frames per repair)\n", conf->network_fec);
+    ui_message("network_aggregate_frames:      %zu\n", conf->network_aggregate_frames);
+    ui_message("network_aggregate_time:        %u (ms)\n", conf->network_aggregate_time);
+    for (i = 0; i < conf->network_destinations_count; i++)
+        ui_message("network_destinations:          %s:%u\n", conf->network_destinations[i],
+                   conf->network_destinations_ports[i] > 0 ? conf->network_destinations_ports[i] : conf->network_port);
+    ui_message("network_multicast_ttl:         %u\n", conf->network_multicast_ttl);
+    ui_message("network_multicast_interface:   %s\n", conf->network_multicast_interface);
+    ui_message("\n");
+    ui_message("spectrum:                      %s\n", cfg_tochar_bool(conf->spectrum));
+    ui_message("spectrum_size:                 %zu\n", conf->spectrum_size);
+    ui_message("spectrum_rate:                 %u (frames/s)\n", conf->spectrum_rate);
+    ui_message("spectrum_averages:             %zu\n", conf->spectrum_averages);
+    ui_message("spectrum_server:               %s\n", conf->spectrum_server);
+    ui_message("spectrum_port:                 %u\n", conf->spectrum_port);
+    ui_message("\n");
+    ui_message("iq:                            %s\n", cfg_tochar_bool(conf->iq));
+    ui_message("iq_offset:                     %d (Hz)\n", conf->iq_offset);
+    ui_message("iq_sample_rate:                %u (Hz)\n", conf->iq_sample_rate);
+    ui_message("iq_format:                     %s\n", cfg_tochar_iq_format(conf->iq_format));
+    ui_message("iq_gain:                       %d (dB)\n", conf->iq_gain);
+    ui_message("iq_server:                     %s\n", conf->iq_server);
+    ui_message("iq_port:                       %u\n", conf->iq_port);
+    ui_message("\n");
+    ui_message("control_port:                  %u%s\n", conf->control_port, conf->control_port == 0 ? " (disabled)" : "");
+    ui_message("\n");
+    for (i = 0; i < conf->scan_freqs_count; i++)
+        ui_message("scan_freqs:                    %u (Hz)\n", conf->scan_freqs[i]);
+    ui_message("scan_dwell:                    %u (ms)\n", conf->scan_dwell);
+    ui_message("scan_resume:                   %u (ms)\n", conf->scan_resume);
+    ui_message("\n");
+    ui_message("survey_start:                  %u (Hz)\n", conf->survey_start);
+    ui_message("survey_stop:                   %u (Hz)\n", conf->survey_stop);
+    ui_message("survey_size:                   %zu\n", conf->survey_size);
+    ui_message("survey_averages:               %zu\n", conf->survey_averages);
+    ui_message("survey_crop:                   %u (%%)\n", conf->survey_crop);
+    ui_message("survey_loops:                  %u\n", conf->survey_loops);
+    ui_message("survey_format:                 %s\n", cfg_tochar_survey_format(conf->survey_format));
+    ui_message("survey_output:                 %s\n", conf->survey_output);
+    ui_message("\n");
+    ui_message("play_address:                  %s\n", conf->play_address);
+    ui_message("play_port:                     %u\n", conf->play_port);
+    ui_message("play_channel:                  %u\n", conf->play_channel);
+    ui_message("play_latency:                  %u (ms)\n", conf->play_latency);
+    ui_message("play_concealment:              %s\n", cfg_tochar_bool(conf->play_concealment));
+    ui_message("\n");
+    ui_message("vote_address:                  %s\n", conf->vote_address);
+    ui_message("vote_port:                     %u\n", conf->vote_port);
+    ui_message("vote_channel:                  %u\n", conf->vote_channel);
+    ui_message("vote_receivers:                %zu\n", conf->vote_receivers);
+    ui_message("vote_window:                   %u (ms)\n", conf->vote_window);
     ui_message("\n");
 }
 
@@ -508,6 +712,36 @@ int cfg_parse_file(char *config_filename) {
             continue;
         }
 
+        if (strcmp(param, "rtlsdr_settle") == 0) {
+            conf->rtlsdr_settle = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "iq_correction") == 0) {
+            conf->iq_correction = cfg_parse_flag(value);
+            continue;
+        }
+
+        if (strcmp(param, "channel_sample_rate") == 0) {
+            conf->channel_sample_rate = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "channel_freqs") == 0) {
+            if (cfg_parse_freq_list(&conf->channel_freqs, &conf->channel_freqs_count, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "channelizer_channels") == 0) {
+            conf->channelizer_channels = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
         if (strcmp(param, "modulation") == 0) {
             if (cfg_parse_modulation(&conf->modulation, value) != EXIT_SUCCESS) {
                 log_error("Config file error in line %zu", line_num);
@@ -518,6 +752,56 @@ int cfg_parse_file(char *config_filename) {
             continue;
         }
 
+        if (strcmp(param, "squelch") == 0) {
+            if (cfg_parse_squelch_mode(&conf->squelch, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "squelch_level") == 0) {
+            conf->squelch_level = (int) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "squelch_hysteresis") == 0) {
+            conf->squelch_hysteresis = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "squelch_hang") == 0) {
+            conf->squelch_hang = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "ctcss_tones") == 0) {
+            if (cfg_parse_tone_list(&conf->ctcss_tones, &conf->ctcss_tones_count, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "agc") == 0) {
+            conf->agc = cfg_parse_flag(value);
+            continue;
+        }
+
+        if (strcmp(param, "agc_attack") == 0) {
+            conf->agc_attack = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "agc_decay") == 0) {
+            conf->agc_decay = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
         if (strcmp(param, "filter") == 0) {
             if (cfg_parse_filter_mode(&conf->filter, value) != EXIT_SUCCESS) {
                 log_error("Config file error in line %zu", line_num);
@@ -528,8 +812,45 @@ int cfg_parse_file(char *config_filename) {
             continue;
         }
 
-        if (strcmp(param, "filter_fir") == 0) {
-            conf->filter_fir = (int) strtol(value, &endptr, 10);
+        if (strcmp(param, "filter_design") == 0) {
+            if (cfg_parse_filter_design(&conf->filter_design, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "filter_cutoff") == 0) {
+            conf->filter_cutoff = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "filter_transition") == 0) {
+            conf->filter_transition = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "filter_attenuation") == 0) {
+            conf->filter_attenuation = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "fft_planner") == 0) {
+            if (cfg_parse_fft_rigor(&conf->fft_planner, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "fft_wisdom_file") == 0) {
+            ln = strlen(value) + 1;
+            conf->fft_wisdom_file = (char *) realloc((void *) conf->fft_wisdom_file, sizeof(char) * ln);
+            strcpy(conf->fft_wisdom_file, value);
             continue;
         }
 
@@ -594,6 +915,265 @@ int cfg_parse_file(char *config_filename) {
             continue;
         }
 
+        if (strcmp(param, "network_protocol") == 0) {
+            conf->network_protocol = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "network_transport") == 0) {
+            if (cfg_parse_network_transport(&conf->network_transport, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "network_queue") == 0) {
+            conf->network_queue = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "network_fec") == 0) {
+            conf->network_fec = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "network_aggregate_frames") == 0) {
+            conf->network_aggregate_frames = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "network_aggregate_time") == 0) {
+            conf->network_aggregate_time = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "network_destinations") == 0) {
+            if (cfg_parse_destination_list(&conf->network_destinations, &conf->network_destinations_ports,
+                                           &conf->network_destinations_count, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "network_multicast_ttl") == 0) {
+            conf->network_multicast_ttl = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "network_multicast_interface") == 0) {
+            ln = strlen(value) + 1;
+            conf->network_multicast_interface = (char *) realloc((void *) conf->network_multicast_interface,
+                                                                 sizeof(char) * ln);
+            strcpy(conf->network_multicast_interface, value);
+            continue;
+        }
+
+        if (strcmp(param, "spectrum") == 0) {
+            conf->spectrum = cfg_parse_flag(value);
+            continue;
+        }
+
+        if (strcmp(param, "spectrum_size") == 0) {
+            conf->spectrum_size = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "spectrum_rate") == 0) {
+            conf->spectrum_rate = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "spectrum_averages") == 0) {
+            conf->spectrum_averages = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "spectrum_server") == 0) {
+            ln = strlen(value) + 1;
+            conf->spectrum_server = (char *) realloc((void *) conf->spectrum_server, sizeof(char) * ln);
+            strcpy(conf->spectrum_server, value);
+            continue;
+        }
+
+        if (strcmp(param, "spectrum_port") == 0) {
+            conf->spectrum_port = (uint16_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "iq") == 0) {
+            conf->iq = cfg_parse_flag(value);
+            continue;
+        }
+
+        if (strcmp(param, "iq_offset") == 0) {
+            conf->iq_offset = (int32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "iq_sample_rate") == 0) {
+            conf->iq_sample_rate = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "iq_format") == 0) {
+            if (cfg_parse_iq_format(&conf->iq_format, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "iq_gain") == 0) {
+            conf->iq_gain = (int) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "iq_server") == 0) {
+            ln = strlen(value) + 1;
+            conf->iq_server = (char *) realloc((void *) conf->iq_server, sizeof(char) * ln);
+            strcpy(conf->iq_server, value);
+            continue;
+        }
+
+        if (strcmp(param, "iq_port") == 0) {
+            conf->iq_port = (uint16_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "control_port") == 0) {
+            conf->control_port = (uint16_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "scan_freqs") == 0) {
+            if (cfg_parse_freq_list(&conf->scan_freqs, &conf->scan_freqs_count, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "scan_dwell") == 0) {
+            conf->scan_dwell = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "scan_resume") == 0) {
+            conf->scan_resume = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "survey_start") == 0) {
+            conf->survey_start = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "survey_stop") == 0) {
+            conf->survey_stop = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "survey_size") == 0) {
+            conf->survey_size = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "survey_averages") == 0) {
+            conf->survey_averages = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "survey_crop") == 0) {
+            conf->survey_crop = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "survey_loops") == 0) {
+            conf->survey_loops = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "survey_format") == 0) {
+            if (cfg_parse_survey_format(&conf->survey_format, value) != EXIT_SUCCESS) {
+                log_error("Config file error in line %zu", line_num);
+                ret = EXIT_FAILURE;
+                break;
+            }
+
+            continue;
+        }
+
+        if (strcmp(param, "survey_output") == 0) {
+            ln = strlen(value) + 1;
+            conf->survey_output = (char *) realloc((void *) conf->survey_output, sizeof(char) * ln);
+            strcpy(conf->survey_output, value);
+            continue;
+        }
+
+        if (strcmp(param, "play_address") == 0) {
+            ln = strlen(value) + 1;
+            conf->play_address = (char *) realloc((void *) conf->play_address, sizeof(char) * ln);
+            strcpy(conf->play_address, value);
+            continue;
+        }
+
+        if (strcmp(param, "play_port") == 0) {
+            conf->play_port = (uint16_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "play_channel") == 0) {
+            conf->play_channel = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "play_latency") == 0) {
+            conf->play_latency = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "play_concealment") == 0) {
+            conf->play_concealment = cfg_parse_flag(value);
+            continue;
+        }
+
+        if (strcmp(param, "vote_address") == 0) {
+            ln = strlen(value) + 1;
+            conf->vote_address = (char *) realloc((void *) conf->vote_address, sizeof(char) * ln);
+            strcpy(conf->vote_address, value);
+            continue;
+        }
+
+        if (strcmp(param, "vote_port") == 0) {
+            conf->vote_port = (uint16_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "vote_channel") == 0) {
+            conf->vote_channel = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "vote_receivers") == 0) {
+            conf->vote_receivers = (size_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
+        if (strcmp(param, "vote_window") == 0) {
+            conf->vote_window = (uint32_t) strtol(value, &endptr, 10);
+            continue;
+        }
+
         log_debug("Line: %zu - Param: \"%s\" - Value: \"%s\"", line_num, param, value);
     }
 
@@ -642,6 +1222,14 @@ int cfg_parse_work_mode(work_mode *source, char *value) {
         *source = MODE_RX;
     else if (strcmp(value, "info") == 0)
         *source = MODE_INFO;
+    else if (strcmp(value, "scan") == 0)
+        *source = MODE_SCAN;
+    else if (strcmp(value, "survey") == 0)
+        *source = MODE_SURVEY;
+    else if (strcmp(value, "play") == 0)
+        *source = MODE_PLAY;
+    else if (strcmp(value, "vote") == 0)
+        *source = MODE_VOTE;
     else {
         log_error("Wrong source: %s", value);
         ret = EXIT_FAILURE;
@@ -686,6 +1274,82 @@ int cfg_parse_filter_mode(filter_mode *filter, char *value) {
     return ret;
 }
 
+int cfg_parse_squelch_mode(squelch_mode *squelch, char *value) {
+    int ret;
+
+    ret = EXIT_SUCCESS;
+
+    if (strcmp(value, "none") == 0)
+        *squelch = SQUELCH_MODE_NONE;
+    else if (strcmp(value, "rms") == 0)
+        *squelch = SQUELCH_MODE_RMS;
+    else if (strcmp(value, "snr") == 0)
+        *squelch = SQUELCH_MODE_SNR;
+    else {
+        log_error("Wrong squelch: %s", value);
+        ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
+
+int cfg_parse_filter_design(fir_design_type *design, char *value) {
+    int ret;
+
+    ret = EXIT_SUCCESS;
+
+    if (strcmp(value, "windowed_sinc") == 0)
+        *design = FIR_DESIGN_TYPE_WINDOWED_SINC;
+    else if (strcmp(value, "kaiser") == 0)
+        *design = FIR_DESIGN_TYPE_KAISER;
+    else if (strcmp(value, "equiripple") == 0)
+        *design = FIR_DESIGN_TYPE_EQUIRIPPLE;
+    else {
+        log_error("Wrong design: %s", value);
+        ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
+
+int cfg_parse_fft_rigor(fft_rigor *rigor, char *value) {
+    int ret;
+
+    ret = EXIT_SUCCESS;
+
+    if (strcmp(value, "estimate") == 0)
+        *rigor = FFT_RIGOR_ESTIMATE;
+    else if (strcmp(value, "measure") == 0)
+        *rigor = FFT_RIGOR_MEASURE;
+    else if (strcmp(value, "patient") == 0)
+        *rigor = FFT_RIGOR_PATIENT;
+    else if (strcmp(value, "exhaustive") == 0)
+        *rigor = FFT_RIGOR_EXHAUSTIVE;
+    else {
+        log_error("Wrong planner: %s", value);
+        ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
+
+int cfg_parse_survey_format(survey_format *format, char *value) {
+    int ret;
+
+    ret = EXIT_SUCCESS;
+
+    if (strcmp(value, "csv") == 0)
+        *format = SURVEY_FORMAT_CSV;
+    else if (strcmp(value, "binary") == 0)
+        *format = SURVEY_FORMAT_BINARY;
+    else {
+        log_error("Wrong survey format: %s", value);
+        ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
+
 int cfg_parse_codec2_mode(int *codec2_mode, char *value) {
     int ret;
 
@@ -721,6 +1385,189 @@ int cfg_parse_codec2_mode(int *codec2_mode, char *value) {
     return ret;
 }
 
+int cfg_parse_network_transport(network_transport *transport, char *value) {
+    int ret;
+
+    ret = EXIT_SUCCESS;
+
+    if (strcmp(value, "udp") == 0)
+        *transport = NETWORK_TRANSPORT_UDP;
+    else if (strcmp(value, "tcp") == 0)
+        *transport = NETWORK_TRANSPORT_TCP;
+    else {
+        log_error("Wrong network transport: %s", value);
+        ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
+
+int cfg_parse_iq_format(iq_format *format, char *value) {
+    int ret;
+
+    ret = EXIT_SUCCESS;
+
+    if (strcmp(value, "int4") == 0)
+        *format = IQ_FORMAT_INT4;
+    else if (strcmp(value, "int8") == 0)
+        *format = IQ_FORMAT_INT8;
+    else if (strcmp(value, "int16") == 0)
+        *format = IQ_FORMAT_INT16;
+    else if (strcmp(value, "float") == 0)
+        *format = IQ_FORMAT_FLOAT;
+    else {
+        log_error("Wrong IQ format: %s", value);
+        ret = EXIT_FAILURE;
+    }
+
+    return ret;
+}
+
+int cfg_parse_freq_list(uint32_t **freqs, size_t *count, char *value) {
+    char *token;
+    char *save_ptr;
+    char *endptr;
+    unsigned long freq;
+    uint32_t *list;
+
+    free(*freqs);
+    *freqs = NULL;
+    *count = 0;
+
+    for (token = strtok_r(value, ", ", &save_ptr); token != NULL; token = strtok_r(NULL, ", ", &save_ptr)) {
+        freq = strtoul(token, &endptr, 10);
+        if (*endptr != '\0' || freq == 0 || freq > UINT32_MAX) {
+            log_error("Wrong frequency: %s", token);
+            return EXIT_FAILURE;
+        }
+
+        list = (uint32_t *) realloc(*freqs, sizeof(uint32_t) * (*count + 1));
+        if (list == NULL) {
+            log_error("Unable to allocate frequency list");
+            return EXIT_FAILURE;
+        }
+
+        *freqs = list;
+        (*freqs)[*count] = (uint32_t) freq;
+        (*count)++;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int cfg_parse_tone_list(uint32_t **tones, size_t *count, char *value) {
+    char *token;
+    char *save_ptr;
+    char *endptr;
+    double tone;
+    uint32_t *list;
+
+    free(*tones);
+    *tones = NULL;
+    *count = 0;
+
+    for (token = strtok_r(value, ", ", &save_ptr); token != NULL; token = strtok_r(NULL, ", ", &save_ptr)) {
+        tone = strtod(token, &endptr);
+        if (*endptr != '\0' || tone < 0 || tone > 1000) {
+            log_error("Wrong tone: %s", token);
+            return EXIT_FAILURE;
+        }
+
+        list = (uint32_t *) realloc(*tones, sizeof(uint32_t) * (*count + 1));
+        if (list == NULL) {
+            log_error("Unable to allocate tone list");
+            return EXIT_FAILURE;
+        }
+
+        *tones = list;
+        (*tones)[*count] = (uint32_t) (tone * 10 + 0.5);
+        (*count)++;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int cfg_parse_destination_list(char ***destinations, uint16_t **ports, size_t *count, char *value) {
+    char *token;
+    char *save_ptr;
+    char *endptr;
+    char *host;
+    char *separator;
+    unsigned long port;
+    char **list;
+    uint16_t *ports_list;
+
+    cfg_free_destination_list(destinations, ports, count);
+
+    for (token = strtok_r(value, ", ", &save_ptr); token != NULL; token = strtok_r(NULL, ", ", &save_ptr)) {
+        host = token;
+        port = 0;
+
+        if (token[0] == '[') {
+            host = token + 1;
+            separator = strchr(host, ']');
+            if (separator == NULL || (separator[1] != '\0' && separator[1] != ':')) {
+                log_error("Wrong destination: %s", token);
+                return EXIT_FAILURE;
+            }
+
+            *separator = '\0';
+            separator = separator[1] == ':' ? separator + 1 : NULL;
+        } else if (token[0] == '/') {
+            separator = NULL;
+        } else {
+            separator = strrchr(token, ':');
+        }
+
+        if (separator != NULL) {
+            *separator = '\0';
+            port = strtoul(separator + 1, &endptr, 10);
+            if (*endptr != '\0' || port == 0 || port > UINT16_MAX) {
+                log_error("Wrong destination port: %s", separator + 1);
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (strlen(host) == 0) {
+            log_error("Wrong destination: %s", token);
+            return EXIT_FAILURE;
+        }
+
+        list = (char **) realloc(*destinations, sizeof(char *) * (*count + 1));
+        if (list != NULL)
+            *destinations = list;
+
+        ports_list = (uint16_t *) realloc(*ports, sizeof(uint16_t) * (*count + 1));
+        if (ports_list != NULL)
+            *ports = ports_list;
+
+        if (list == NULL || ports_list == NULL) {
+            log_error("Unable to allocate destination list");
+            return EXIT_FAILURE;
+        }
+
+        (*destinations)[*count] = strdup(host);
+        (*ports)[*count] = (uint16_t) port;
+        (*count)++;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void cfg_free_destination_list(char ***destinations, uint16_t **ports, size_t *count) {
+    size_t i;
+
+    for (i = 0; i < *count; i++)
+        free((*destinations)[i]);
+
+    free(*destinations);
+    free(*ports);
+
+    *destinations = NULL;
+    *ports = NULL;
+    *count = 0;
+}
+
 const char *cfg_tochar_bool(bool_flag value) {
     switch (value) {
         case FLAG_FALSE:
@@ -772,6 +1619,14 @@ const char *cfg_tochar_work_mode(work_mode value) {
             return "RX";
         case MODE_INFO:
             return "INFO";
+        case MODE_SCAN:
+            return "SCAN";
+        case MODE_SURVEY:
+            return "SURVEY";
+        case MODE_PLAY:
+            return "PLAY";
+        case MODE_VOTE:
+            return "VOTE";
         default:
             return "";
     }
@@ -793,7 +1648,7 @@ const char *cfg_tochar_filter_mode(filter_mode value) {
         case FILTER_MODE_NONE:
             return "None (bypass)";
         case FILTER_MODE_FIR_SW:
-            return "FIR Software (Finite Impulse Response with no optimizations)";
+            return "FIR Software (Finite Impulse Response designed at startup)";
         case FILTER_MODE_FFT_SW:
             return "Fast Fourier Transform (based on libfftw3)";
         default:
@@ -801,6 +1656,58 @@ const char *cfg_tochar_filter_mode(filter_mode value) {
     }
 }
 
+const char *cfg_tochar_squelch_mode(squelch_mode value) {
+    switch (value) {
+        case SQUELCH_MODE_NONE:
+            return "None (always open)";
+        case SQUELCH_MODE_RMS:
+            return "RMS level (dBFS)";
+        case SQUELCH_MODE_SNR:
+            return "SNR over tracked noise floor (dB)";
+        default:
+            return "";
+    }
+}
+
+const char *cfg_tochar_filter_design(fir_design_type value) {
+    switch (value) {
+        case FIR_DESIGN_TYPE_WINDOWED_SINC:
+            return "Windowed sinc (Hann, Hamming or Blackman)";
+        case FIR_DESIGN_TYPE_KAISER:
+            return "Kaiser window";
+        case FIR_DESIGN_TYPE_EQUIRIPPLE:
+            return "Equiripple (Parks-McClellan)";
+        default:
+            return "";
+    }
+}
+
+const char *cfg_tochar_fft_rigor(fft_rigor value) {
+    switch (value) {
+        case FFT_RIGOR_ESTIMATE:
+            return "Estimate (no measurement)";
+        case FFT_RIGOR_MEASURE:
+            return "Measure";
+        case FFT_RIGOR_PATIENT:
+            return "Patient";
+        case FFT_RIGOR_EXHAUSTIVE:
+            return "Exhaustive";
+        default:
+            return "";
+    }
+}
+
+const char *cfg_tochar_survey_format(survey_format value) {
+    switch (value) {
+        case SURVEY_FORMAT_CSV:
+            return "CSV";
+        case SURVEY_FORMAT_BINARY:
+            return "Binary";
+        default:
+            return "";
+    }
+}
+
 const char *cfg_tochar_codec2_mode(int codec2_mode) {
     switch (codec2_mode) {
         case CODEC2_MODE_3200:
@@ -829,3 +1736,29 @@ const char *cfg_tochar_codec2_mode(int codec2_mode) {
             return "";
     }
 }
+
+const char *cfg_tochar_network_transport(network_transport value) {
+    switch (value) {
+        case NETWORK_TRANSPORT_UDP:
+            return "UDP";
+        case NETWORK_TRANSPORT_TCP:
+            return "TCP";
+        default:
+            return "";
+    }
+}
+
+const char *cfg_tochar_iq_format(iq_format value) {
+    switch (value) {
+        case IQ_FORMAT_INT4:
+            return "int4";
+        case IQ_FORMAT_INT8:
+            return "int8";
+        case IQ_FORMAT_INT16:
+            return "int16";
+        case IQ_FORMAT_FLOAT:
+            return "float";
+        default:
+            return "";
+    }
+}
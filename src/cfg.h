@@ -26,6 +26,8 @@
 #include <stdint.h>
 #include <uuid/uuid.h>
 
+#include "fir_design.h"
+
 enum bool_flag_t {
     FLAG_FALSE = 0,
     FLAG_TRUE = 1
@@ -44,7 +46,11 @@ enum work_mode_t {
     MODE_VERSION = 'v',
     MODE_HELP = 'h',
     MODE_RX = 'r',
-    MODE_INFO = 'i'
+    MODE_INFO = 'i',
+    MODE_SCAN = 's',
+    MODE_SURVEY = 'w',
+    MODE_PLAY = 'p',
+    MODE_VOTE = 'o'
 };
 
 typedef enum work_mode_t work_mode;
@@ -64,6 +70,46 @@ enum filter_mode_t {
 
 typedef enum filter_mode_t filter_mode;
 
+enum squelch_mode_t {
+    SQUELCH_MODE_NONE = 0,
+    SQUELCH_MODE_RMS = 1,
+    SQUELCH_MODE_SNR = 2
+};
+
+typedef enum squelch_mode_t squelch_mode;
+
+enum fft_rigor_t {
+    FFT_RIGOR_ESTIMATE = 'e',
+    FFT_RIGOR_MEASURE = 'm',
+    FFT_RIGOR_PATIENT = 'p',
+    FFT_RIGOR_EXHAUSTIVE = 'x'
+};
+
+typedef enum fft_rigor_t fft_rigor;
+
+enum survey_format_t {
+    SURVEY_FORMAT_CSV = 'c',
+    SURVEY_FORMAT_BINARY = 'b'
+};
+
+typedef enum survey_format_t survey_format;
+
+enum network_transport_t {
+    NETWORK_TRANSPORT_UDP = 'u',
+    NETWORK_TRANSPORT_TCP = 't'
+};
+
+typedef enum network_transport_t network_transport;
+
+enum iq_format_t {
+    IQ_FORMAT_INT4 = 'n',
+    IQ_FORMAT_INT8 = 'b',
+    IQ_FORMAT_INT16 = 's',
+    IQ_FORMAT_FLOAT = 'f'
+};
+
+typedef enum iq_format_t iq_format;
+
 struct cfg_t {
     uuid_t uuid;
 
@@ -86,11 +132,38 @@ struct cfg_t {
     int rtlsdr_device_tuner_gain;
     bool_flag rtlsdr_device_agc_mode;
     size_t rtlsdr_samples;
+    uint32_t rtlsdr_settle;
+
+    bool_flag iq_correction;
+
+    uint32_t channel_sample_rate;
+    uint32_t *channel_freqs;
+    size_t channel_freqs_count;
+
+    size_t channelizer_channels;
 
     modulation_type modulation;
 
+    squelch_mode squelch;
+    int squelch_level;
+    uint32_t squelch_hysteresis;
+    uint32_t squelch_hang;
+
+    uint32_t *ctcss_tones;
+    size_t ctcss_tones_count;
+
+    bool_flag agc;
+    uint32_t agc_attack;
+    uint32_t agc_decay;
+
     filter_mode filter;
-    int filter_fir;
+    fir_design_type filter_design;
+    uint32_t filter_cutoff;
+    uint32_t filter_transition;
+    uint32_t filter_attenuation;
+
+    fft_rigor fft_planner;
+    char *fft_wisdom_file;
 
     uint64_t audio_frames_per_period;
     uint32_t audio_sample_rate;
@@ -107,6 +180,60 @@ struct cfg_t {
 
     char *network_server;
     uint16_t network_port;
+    uint32_t network_protocol;
+    network_transport network_transport;
+    size_t network_queue;
+    size_t network_fec;
+    size_t network_aggregate_frames;
+    uint32_t network_aggregate_time;
+    char **network_destinations;
+    uint16_t *network_destinations_ports;
+    size_t network_destinations_count;
+    uint32_t network_multicast_ttl;
+    char *network_multicast_interface;
+
+    bool_flag spectrum;
+    size_t spectrum_size;
+    uint32_t spectrum_rate;
+    size_t spectrum_averages;
+    char *spectrum_server;
+    uint16_t spectrum_port;
+
+    bool_flag iq;
+    int32_t iq_offset;
+    uint32_t iq_sample_rate;
+    iq_format iq_format;
+    int iq_gain;
+    char *iq_server;
+    uint16_t iq_port;
+
+    uint16_t control_port;
+
+    uint32_t *scan_freqs;
+    size_t scan_freqs_count;
+    uint32_t scan_dwell;
+    uint32_t scan_resume;
+
+    uint32_t survey_start;
+    uint32_t survey_stop;
+    size_t survey_size;
+    size_t survey_averages;
+    uint32_t survey_crop;
+    uint32_t survey_loops;
+    survey_format survey_format;
+    char *survey_output;
+
+    char *play_address;
+    uint16_t play_port;
+    uint32_t play_channel;
+    uint32_t play_latency;
+    bool_flag play_concealment;
+
+    char *vote_address;
+    uint16_t vote_port;
+    uint32_t vote_channel;
+    size_t vote_receivers;
+    uint32_t vote_window;
 };
 
 typedef struct cfg_t cfg;
@@ -133,8 +260,28 @@ int cfg_parse_modulation(modulation_type *, char *);
 
 int cfg_parse_filter_mode(filter_mode *, char *);
 
+int cfg_parse_squelch_mode(squelch_mode *, char *);
+
+int cfg_parse_filter_design(fir_design_type *, char *);
+
+int cfg_parse_fft_rigor(fft_rigor *, char *);
+
+int cfg_parse_survey_format(survey_format *, char *);
+
 int cfg_parse_codec2_mode(int *, char *);
 
+int cfg_parse_network_transport(network_transport *, char *);
+
+int cfg_parse_iq_format(iq_format *, char *);
+
+int cfg_parse_freq_list(uint32_t **, size_t *, char *);
+
+int cfg_parse_tone_list(uint32_t **, size_t *, char *);
+
+int cfg_parse_destination_list(char ***, uint16_t **, size_t *, char *);
+
+void cfg_free_destination_list(char ***, uint16_t **, size_t *);
+
 const char *cfg_tochar_bool(bool_flag);
 
 const char *cfg_tochar_log_level(int);
@@ -147,6 +294,18 @@ const char *cfg_tochar_modulation(modulation_type);
 
 const char *cfg_tochar_filter_mode(filter_mode);
 
+const char *cfg_tochar_squelch_mode(squelch_mode);
+
+const char *cfg_tochar_filter_design(fir_design_type);
+
+const char *cfg_tochar_fft_rigor(fft_rigor);
+
+const char *cfg_tochar_survey_format(survey_format);
+
 const char *cfg_tochar_codec2_mode(int);
 
+const char *cfg_tochar_network_transport(network_transport);
+
+const char *cfg_tochar_iq_format(iq_format);
+
 #endif
@@ -0,0 +1,222 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+
+#include "channelizer.h"
+#include "log.h"
+
+channelizer_ctx *channelizer_init(uint32_t sample_rate, size_t channels, size_t input_size,
+                                  const FP_FLOAT *taps, size_t taps_size, fft_rigor rigor) {
+    channelizer_ctx *ctx;
+    size_t n;
+    size_t p;
+
+    log_info("Initializing channelizer context");
+
+    if (channels < CHANNELIZER_OVERSAMPLE || channels % CHANNELIZER_OVERSAMPLE != 0
+        || sample_rate % channels != 0 || taps_size == 0) {
+        log_error("Invalid channelizer parameters: rate %u - channels %zu - taps %zu",
+                  sample_rate, channels, taps_size);
+        return NULL;
+    }
+
+    if (input_size % (channels / CHANNELIZER_OVERSAMPLE) != 0) {
+        log_error("Input size %zu is not a multiple of channelizer decimation %zu",
+                  input_size, channels / CHANNELIZER_OVERSAMPLE);
+        return NULL;
+    }
+
+    log_debug("Allocating context");
+    ctx = (channelizer_ctx *) malloc(sizeof(channelizer_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate context");
+        return NULL;
+    }
+
+    ctx->sample_rate = sample_rate;
+    ctx->channels = channels;
+    ctx->decimation = channels / CHANNELIZER_OVERSAMPLE;
+    ctx->taps_per_branch = (taps_size + channels - 1) / channels;
+    ctx->input_size = input_size;
+    ctx->output_size = input_size / ctx->decimation;
+    ctx->buffer_size = ctx->taps_per_branch * channels - 1 + input_size;
+    ctx->frame = 0;
+    ctx->buffer = NULL;
+    ctx->fft = NULL;
+    ctx->output = NULL;
+
+    log_debug("Channels: %zu - Taps per branch: %zu - Decimation: %zu",
+              ctx->channels, ctx->taps_per_branch, ctx->decimation);
+
+    log_debug("Allocating polyphase branches");
+    ctx->branches = (FP_FLOAT *) calloc(ctx->taps_per_branch * channels, sizeof(FP_FLOAT));
+    if (ctx->branches == NULL) {
+        log_error("Unable to allocate polyphase branches");
+        channelizer_free(ctx);
+        return NULL;
+    }
+
+    for (n = 0; n < channels; n++)
+        for (p = 0; p < ctx->taps_per_branch; p++)
+            if (n + p * channels < taps_size)
+                ctx->branches[n * ctx->taps_per_branch + p] = taps[n + p * channels];
+
+    log_debug("Allocating delay line");
+    ctx->buffer = (FP_FLOAT complex *) calloc(ctx->buffer_size, sizeof(FP_FLOAT complex));
+    if (ctx->buffer == NULL) {
+        log_error("Unable to allocate delay line");
+        channelizer_free(ctx);
+        return NULL;
+    }
+
+    log_debug("Allocating output buffer");
+    ctx->output = (FP_FLOAT complex *) calloc(ctx->output_size * channels, sizeof(FP_FLOAT complex));
+    if (ctx->output == NULL) {
+        log_error("Unable to allocate output buffer");
+        channelizer_free(ctx);
+        return NULL;
+    }
+
+    log_debug("Initializing FFT context");
+    ctx->fft = fft_init(channels, FFTW_BACKWARD, FFT_DATA_TYPE_COMPLEX, rigor);
+    if (ctx->fft == NULL) {
+        log_error("Unable to allocate FFT context");
+        channelizer_free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+void channelizer_free(channelizer_ctx *ctx) {
+    log_info("Freeing channelizer context");
+
+    if (ctx == NULL)
+        return;
+
+    if (ctx->branches != NULL)
+        free(ctx->branches);
+
+    if (ctx->buffer != NULL)
+        free(ctx->buffer);
+
+    if (ctx->output != NULL)
+        free(ctx->output);
+
+    if (ctx->fft != NULL)
+        fft_free(ctx->fft);
+
+    free(ctx);
+}
+
+uint32_t channelizer_spacing(channelizer_ctx *ctx) {
+    return ctx->sample_rate / (uint32_t) ctx->channels;
+}
+
+uint32_t channelizer_output_rate(channelizer_ctx *ctx) {
+    return ctx->sample_rate / (uint32_t) ctx->decimation;
+}
+
+ssize_t channelizer_bin(channelizer_ctx *ctx, int64_t offset) {
+    int64_t spacing;
+    int64_t bin;
+
+    spacing = channelizer_spacing(ctx);
+
+    if (offset % spacing != 0) {
+        log_error("Offset %lld Hz is not on the %lld Hz channel grid", (long long) offset, (long long) spacing);
+        return -1;
+    }
+
+    bin = offset / spacing;
+    if (bin >= (int64_t) ctx->channels / 2 || bin < -(int64_t) ctx->channels / 2) {
+        log_error("Offset %lld Hz is outside the channelizer band", (long long) offset);
+        return -1;
+    }
+
+    if (bin < 0)
+        bin += (int64_t) ctx->channels;
+
+    return (ssize_t) bin;
+}
+
+int channelizer_do(channelizer_ctx *ctx, const FP_FLOAT complex *input, size_t size) {
+    FP_FLOAT complex *fft_input;
+    FP_FLOAT complex *fft_output;
+    const FP_FLOAT complex *x;
+    const FP_FLOAT *h;
+    FP_FLOAT complex v;
+    size_t history;
+    size_t t;
+    size_t m;
+    size_t n;
+    size_t p;
+    size_t k;
+
+    log_trace("Channelizing");
+
+    if (size != ctx->input_size) {
+        log_error("Invalid input size %zu", size);
+        return EXIT_FAILURE;
+    }
+
+    fft_input = (FP_FLOAT complex *) ctx->fft->complex_input;
+    fft_output = (FP_FLOAT complex *) ctx->fft->complex_output;
+
+    history = ctx->taps_per_branch * ctx->channels - 1;
+
+    memcpy(ctx->buffer + history, input, size * sizeof(FP_FLOAT complex));
+
+    for (m = 0; m < ctx->output_size; m++) {
+        t = history + (m + 1) * ctx->decimation - 1;
+
+        for (n = 0; n < ctx->channels; n++) {
+            h = ctx->branches + n * ctx->taps_per_branch;
+            x = ctx->buffer + t - n;
+
+            v = 0;
+            for (p = 0; p < ctx->taps_per_branch; p++)
+                v += h[p] * x[-(ptrdiff_t) (p * ctx->channels)];
+
+            fft_input[n] = v;
+        }
+
+        fft_compute(ctx->fft);
+
+        // Bin k is rotated by exp(-j 2 pi k frame / 2), a sign flip on odd bins of odd frames
+        for (k = 0; k < ctx->channels; k++)
+            if ((ctx->frame & 1) && (k & 1))
+                ctx->output[k * ctx->output_size + m] = -fft_output[k];
+            else
+                ctx->output[k * ctx->output_size + m] = fft_output[k];
+
+        ctx->frame++;
+    }
+
+    memmove(ctx->buffer, ctx->buffer + size, history * sizeof(FP_FLOAT complex));
+
+    return EXIT_SUCCESS;
+}
+
+const FP_FLOAT complex *channelizer_get(channelizer_ctx *ctx, size_t bin) {
+    return ctx->output + bin * ctx->output_size;
+}
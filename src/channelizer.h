@@ -0,0 +1,86 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__CHANNELIZER__H
+#define __RTLSDR_RADIO__CHANNELIZER__H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <complex.h>
+#include <sys/types.h>
+
+#include "buildflags.h"
+#include "cfg.h"
+#include "fft.h"
+
+/*
+ * Uniform polyphase filter-bank channelizer.
+ *
+ * The band is split in `channels` bins spaced sample_rate / channels apart;
+ * bin k is centered at k * spacing from the tuned frequency (bins above
+ * channels / 2 are the negative offsets). Outputs are 2x oversampled, so
+ * every channel comes out at 2 * spacing and a channel edge never falls
+ * into a gap between two bins.
+ *
+ * For each output frame the prototype low-pass, split in `channels`
+ * branches of taps_per_branch taps, is applied to the delay line and a
+ * single inverse FFT of size `channels` produces one sample for every bin.
+ */
+
+#define CHANNELIZER_OVERSAMPLE 2
+
+struct channelizer_ctx_t {
+    uint32_t sample_rate;
+
+    size_t channels;
+    size_t decimation;
+    size_t taps_per_branch;
+
+    size_t input_size;
+    size_t output_size;
+
+    FP_FLOAT *branches;
+
+    size_t buffer_size;
+    FP_FLOAT complex *buffer;
+
+    uint64_t frame;
+
+    fft_ctx *fft;
+
+    FP_FLOAT complex *output;
+};
+
+typedef struct channelizer_ctx_t channelizer_ctx;
+
+channelizer_ctx *channelizer_init(uint32_t, size_t, size_t, const FP_FLOAT *, size_t, fft_rigor);
+
+void channelizer_free(channelizer_ctx *);
+
+uint32_t channelizer_spacing(channelizer_ctx *);
+
+uint32_t channelizer_output_rate(channelizer_ctx *);
+
+ssize_t channelizer_bin(channelizer_ctx *, int64_t);
+
+int channelizer_do(channelizer_ctx *, const FP_FLOAT complex *, size_t);
+
+const FP_FLOAT complex *channelizer_get(channelizer_ctx *, size_t);
+
+#endif
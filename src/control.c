@@ -0,0 +1,309 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "control.h"
+#include "utils.h"
+#include "log.h"
+
+static int control_parse_number(const char *, long *);
+
+control_ctx *control_init(const cfg *conf, uint16_t port) {
+    control_ctx *ctx;
+    int result;
+
+    log_info("Initializing control context");
+
+    log_debug("Allocating control context");
+    ctx = (control_ctx *) malloc(sizeof(control_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate control context");
+        return NULL;
+    }
+
+    log_debug("Initializing control mutex");
+    result = pthread_mutex_init(&ctx->mutex, NULL);
+    if (result != 0) {
+        log_error("Error initializing control mutex: %d", result);
+        free(ctx);
+        return NULL;
+    }
+
+    log_debug("Setting initial params");
+    ctx->generation = 0;
+    ctx->params.center_freq = conf->rtlsdr_device_center_freq;
+    ctx->params.tuner_gain = conf->rtlsdr_device_tuner_gain;
+    ctx->params.modulation = conf->modulation;
+    ctx->params.squelch = conf->squelch;
+    ctx->params.squelch_level = conf->squelch_level;
+    ctx->params.squelch_hysteresis = conf->squelch_hysteresis;
+    ctx->params.squelch_hang = conf->squelch_hang;
+    ctx->params.filter = conf->filter;
+    ctx->params.filter_cutoff = conf->filter_cutoff;
+    ctx->params.filter_transition = conf->filter_transition;
+
+    ctx->port = port;
+    ctx->sck = -1;
+
+    return ctx;
+}
+
+void control_free(control_ctx *ctx) {
+    log_info("Freeing control context");
+
+    if (ctx == NULL)
+        return;
+
+    control_socket_close(ctx);
+    pthread_mutex_destroy(&ctx->mutex);
+
+    free(ctx);
+}
+
+uint64_t control_get(control_ctx *ctx, control_params *params) {
+    uint64_t generation;
+
+    pthread_mutex_lock(&ctx->mutex);
+    *params = ctx->params;
+    generation = ctx->generation;
+    pthread_mutex_unlock(&ctx->mutex);
+
+    return generation;
+}
+
+uint64_t control_publish(control_ctx *ctx, const control_params *params) {
+    uint64_t generation;
+
+    pthread_mutex_lock(&ctx->mutex);
+    ctx->params = *params;
+    generation = ++ctx->generation;
+    pthread_mutex_unlock(&ctx->mutex);
+
+    log_debug("Published control params generation %llu", (unsigned long long) generation);
+
+    return generation;
+}
+
+int control_parse(control_params *params, char *message) {
+    char *line;
+    char *line_save_ptr;
+    char *param;
+    char *save_ptr;
+    char *value;
+    long number;
+    int ret;
+
+    ret = EXIT_SUCCESS;
+    value = NULL;
+
+    for (line = strtok_r(message, "\r\n", &line_save_ptr); line != NULL && ret == EXIT_SUCCESS;
+         line = strtok_r(NULL, "\r\n", &line_save_ptr)) {
+        param = strtok_r(line, " ", &save_ptr);
+        if (param == NULL || param[0] == '#')
+            continue;
+
+        value = (char *) realloc(value, sizeof(char) * (strlen(save_ptr) + 1));
+        if (value == NULL || utils_trim(value, save_ptr, strlen(save_ptr) + 1) != EXIT_SUCCESS) {
+            log_error("Unable to read value of %s", param);
+            ret = EXIT_FAILURE;
+            break;
+        }
+
+        if (strcmp(param, "rtlsdr_device_center_freq") == 0) {
+            ret = control_parse_number(value, &number);
+            if (number <= 0 || number > UINT32_MAX)
+                ret = EXIT_FAILURE;
+            params->center_freq = (uint32_t) number;
+        } else if (strcmp(param, "rtlsdr_device_tuner_gain") == 0) {
+            ret = control_parse_number(value, &number);
+            params->tuner_gain = (int) number;
+        } else if (strcmp(param, "modulation") == 0) {
+            ret = cfg_parse_modulation(&params->modulation, value);
+        } else if (strcmp(param, "squelch") == 0) {
+            ret = cfg_parse_squelch_mode(&params->squelch, value);
+        } else if (strcmp(param, "squelch_level") == 0) {
+            ret = control_parse_number(value, &number);
+            params->squelch_level = (int) number;
+        } else if (strcmp(param, "squelch_hysteresis") == 0) {
+            ret = control_parse_number(value, &number);
+            if (number < 0)
+                ret = EXIT_FAILURE;
+            params->squelch_hysteresis = (uint32_t) number;
+        } else if (strcmp(param, "squelch_hang") == 0) {
+            ret = control_parse_number(value, &number);
+            if (number < 0)
+                ret = EXIT_FAILURE;
+            params->squelch_hang = (uint32_t) number;
+        } else if (strcmp(param, "filter") == 0) {
+            ret = cfg_parse_filter_mode(&params->filter, value);
+        } else if (strcmp(param, "filter_cutoff") == 0) {
+            ret = control_parse_number(value, &number);
+            if (number <= 0)
+                ret = EXIT_FAILURE;
+            params->filter_cutoff = (uint32_t) number;
+        } else if (strcmp(param, "filter_transition") == 0) {
+            ret = control_parse_number(value, &number);
+            if (number <= 0)
+                ret = EXIT_FAILURE;
+            params->filter_transition = (uint32_t) number;
+        } else {
+            log_error("Param %s cannot be changed at runtime", param);
+            ret = EXIT_FAILURE;
+        }
+
+        if (ret != EXIT_SUCCESS) {
+            log_error("Wrong value for %s: %s", param, value);
+        }
+    }
+
+    free(value);
+
+    return ret;
+}
+
+/*
+ * Rejects params which would put a channel outside the captured band or,
+ * with the channelizer, off its grid, or a filter above channel Nyquist.
+ */
+int control_check(const control_params *params, const cfg *conf, size_t channels, uint32_t channel_sample_rate) {
+    int64_t offset;
+    int64_t spacing;
+    int64_t bin;
+    uint32_t freq;
+    size_t c;
+
+    for (c = 0; c < channels; c++) {
+        freq = conf->channel_freqs_count > 0 ? conf->channel_freqs[c] : params->center_freq;
+        offset = (int64_t) freq - params->center_freq;
+
+        if (llabs(offset) * 2 + channel_sample_rate > conf->rtlsdr_device_sample_rate) {
+            log_warn("Channel %zu at %u Hz would be outside the captured band", c + 1, freq);
+            return EXIT_FAILURE;
+        }
+
+        if (conf->channelizer_channels > 0) {
+            spacing = conf->rtlsdr_device_sample_rate / (int64_t) conf->channelizer_channels;
+            bin = offset / spacing;
+
+            if (offset % spacing != 0
+                || bin < -(int64_t) conf->channelizer_channels / 2
+                || bin >= (int64_t) conf->channelizer_channels / 2) {
+                log_warn("Channel %zu at %u Hz would not be on the channelizer grid", c + 1, freq);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    if (params->filter != FILTER_MODE_NONE && params->filter_cutoff * 2 >= channel_sample_rate) {
+        log_warn("Filter cutoff %u Hz is above channel Nyquist frequency", params->filter_cutoff);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int control_socket_open(control_ctx *ctx) {
+    struct sockaddr_in sockaddr;
+    struct timeval timeout;
+
+    log_info("Opening control socket");
+
+    log_debug("Creating socket");
+    ctx->sck = socket(AF_INET, SOCK_DGRAM, 0);
+    if (ctx->sck == -1) {
+        log_error("Socket creation failed");
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Setting receive timeout");
+    timeout.tv_sec = 0;
+    timeout.tv_usec = CONTROL_TIMEOUT_MS * 1000;
+    if (setsockopt(ctx->sck, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) {
+        log_error("Unable to set receive timeout");
+        control_socket_close(ctx);
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Binding to %s:%u", CONTROL_ADDRESS, ctx->port);
+    memset(&sockaddr, '\0', sizeof(sockaddr));
+    sockaddr.sin_family = AF_INET;
+    sockaddr.sin_port = htons(ctx->port);
+    sockaddr.sin_addr.s_addr = inet_addr(CONTROL_ADDRESS);
+
+    if (bind(ctx->sck, (struct sockaddr *) &sockaddr, sizeof(sockaddr)) != 0) {
+        log_error("Unable to bind control socket");
+        control_socket_close(ctx);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void control_socket_close(control_ctx *ctx) {
+    if (ctx->sck != -1) {
+        log_debug("Closing control socket");
+        close(ctx->sck);
+    }
+
+    ctx->sck = -1;
+}
+
+ssize_t control_socket_receive(control_ctx *ctx, char *message, size_t message_size,
+                               struct sockaddr_storage *sender, socklen_t *sender_len) {
+    ssize_t received;
+
+    *sender_len = sizeof(struct sockaddr_storage);
+    received = recvfrom(ctx->sck, message, message_size - 1, 0, (struct sockaddr *) sender, sender_len);
+    if (received < 0)
+        return received;
+
+    message[received] = '\0';
+
+    return received;
+}
+
+int control_socket_reply(control_ctx *ctx, const char *reply, const struct sockaddr_storage *sender,
+                         socklen_t sender_len) {
+    ssize_t sent_bytes;
+
+    sent_bytes = sendto(ctx->sck, reply, strlen(reply), 0, (const struct sockaddr *) sender, sender_len);
+    if (sent_bytes != (ssize_t) strlen(reply)) {
+        log_error("Unable to send control reply");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int control_parse_number(const char *value, long *number) {
+    char *endptr;
+
+    *number = strtol(value, &endptr, 10);
+    if (endptr == value || *endptr != '\0')
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
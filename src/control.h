@@ -0,0 +1,94 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__CONTROL__H
+#define __RTLSDR_RADIO__CONTROL__H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include "cfg.h"
+
+/*
+ * Live parameters of a running receiver. Writers publish a whole new set
+ * of parameters under the mutex and bump the generation; each pipeline
+ * thread polls the generation once per block and, when it changed, takes
+ * a copy and rebuilds only the state it owns, so a change always lands on
+ * a block boundary.
+ *
+ * Requests come on a local UDP socket as "key value" lines, using the
+ * same keys and values as the config file; the reply is "OK" or "ERR".
+ */
+
+#define CONTROL_ADDRESS "127.0.0.1"
+#define CONTROL_MESSAGE_SIZE 1024
+#define CONTROL_TIMEOUT_MS 200
+
+struct control_params_t {
+    uint32_t center_freq;
+    int tuner_gain;
+
+    modulation_type modulation;
+
+    squelch_mode squelch;
+    int squelch_level;
+    uint32_t squelch_hysteresis;
+    uint32_t squelch_hang;
+
+    filter_mode filter;
+    uint32_t filter_cutoff;
+    uint32_t filter_transition;
+};
+
+struct control_ctx_t {
+    pthread_mutex_t mutex;
+
+    uint64_t generation;
+    struct control_params_t params;
+
+    uint16_t port;
+    int sck;
+};
+
+typedef struct control_params_t control_params;
+typedef struct control_ctx_t control_ctx;
+
+control_ctx *control_init(const cfg *, uint16_t);
+
+void control_free(control_ctx *);
+
+uint64_t control_get(control_ctx *, control_params *);
+
+uint64_t control_publish(control_ctx *, const control_params *);
+
+int control_parse(control_params *, char *);
+
+int control_check(const control_params *, const cfg *, size_t, uint32_t);
+
+int control_socket_open(control_ctx *);
+
+void control_socket_close(control_ctx *);
+
+ssize_t control_socket_receive(control_ctx *, char *, size_t, struct sockaddr_storage *, socklen_t *);
+
+int control_socket_reply(control_ctx *, const char *, const struct sockaddr_storage *, socklen_t);
+
+#endif
@@ -0,0 +1,606 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+#include <math.h>
+
+#include "decimate.h"
+#include "log.h"
+
+static double decimate_cic_response(const decimate_cic *, double);
+
+decimate_ctx *decimate_init(uint32_t src_rate, uint32_t dst_rate, size_t input_size) {
+    decimate_ctx *ctx;
+    uint32_t cic_ratio;
+    uint32_t fir_ratio;
+    size_t stage_size;
+    size_t i;
+    size_t s;
+
+    log_info("Initializing decimate context");
+
+    if (dst_rate == 0 || src_rate % dst_rate != 0) {
+        log_error("Source rate %u is not a multiple of destination rate %u", src_rate, dst_rate);
+        return NULL;
+    }
+
+    log_debug("Allocating decimate context");
+    ctx = (decimate_ctx *) malloc(sizeof(decimate_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate decimate context");
+        return NULL;
+    }
+
+    ctx->src_rate = src_rate;
+    ctx->dst_rate = dst_rate;
+    ctx->ratio = src_rate / dst_rate;
+    ctx->input_size = input_size;
+
+    ctx->halfband_stages = 0;
+    ctx->work[0] = NULL;
+    ctx->work[1] = NULL;
+    ctx->work_fixed[0] = NULL;
+    ctx->work_fixed[1] = NULL;
+    for (s = 0; s < DECIMATE_HALFBAND_STAGES_MAX; s++) {
+        ctx->halfband[s].buffer = NULL;
+        ctx->halfband[s].buffer_fixed = NULL;
+    }
+    ctx->fir.ratio = 1;
+    ctx->fir.kernel = NULL;
+    ctx->fir.kernel_fixed = NULL;
+    ctx->fir.buffer = NULL;
+    ctx->fir.buffer_fixed = NULL;
+
+    if (input_size % ctx->ratio != 0) {
+        log_error("Input size %zu is not a multiple of decimation ratio %u", input_size, ctx->ratio);
+        decimate_free(ctx);
+        return NULL;
+    }
+
+    log_debug("Splitting ratio %u between CIC and half-band stages", ctx->ratio);
+    cic_ratio = ctx->ratio;
+    while (cic_ratio % 2 == 0 && ctx->halfband_stages < DECIMATE_HALFBAND_STAGES_MAX) {
+        cic_ratio /= 2;
+        ctx->halfband_stages++;
+    }
+
+    fir_ratio = 1;
+    if (ctx->halfband_stages == 0 && cic_ratio > 1) {
+        fir_ratio = 3;
+        while (cic_ratio % fir_ratio != 0)
+            fir_ratio += 2;
+        cic_ratio /= fir_ratio;
+    }
+
+    log_debug("CIC ratio: %u - Half-band stages: %zu - FIR ratio: %u", cic_ratio, ctx->halfband_stages, fir_ratio);
+
+    ctx->cic.ratio = cic_ratio;
+    ctx->cic.count = 0;
+    ctx->cic.gain = (FP_FLOAT) (1.0 / (pow(cic_ratio, DECIMATE_CIC_ORDER) * DECIMATE_CIC_SCALE));
+    ctx->cic.norm = 1;
+    for (i = 0; i < DECIMATE_CIC_ORDER; i++)
+        ctx->cic.norm *= cic_ratio;
+    for (i = 0; i < DECIMATE_CIC_ORDER; i++) {
+        ctx->cic.integrators_i[i] = 0;
+        ctx->cic.integrators_q[i] = 0;
+        ctx->cic.combs_i[i] = 0;
+        ctx->cic.combs_q[i] = 0;
+    }
+
+    stage_size = input_size / cic_ratio;
+
+    if (cic_ratio > 1) {
+        log_info("CIC alias rejection at the output band edge: %.1f dB",
+                 20 * log10(decimate_cic_response(&ctx->cic, 0.5 * cic_ratio / ctx->ratio)
+                            / decimate_cic_response(&ctx->cic, 1 - 0.5 * cic_ratio / ctx->ratio)));
+    }
+
+    if (fir_ratio > 1) {
+        log_debug("Allocating FIR stage");
+        if (decimate_fir_init(&ctx->fir, fir_ratio, &ctx->cic, stage_size) != EXIT_SUCCESS) {
+            log_error("Unable to allocate FIR stage");
+            decimate_free(ctx);
+            return NULL;
+        }
+    }
+
+    for (s = 0; s < ctx->halfband_stages; s++) {
+        log_debug("Allocating half-band stage %zu", s);
+        if (decimate_halfband_init(&ctx->halfband[s], stage_size) != EXIT_SUCCESS) {
+            log_error("Unable to allocate half-band stage buffer");
+            decimate_free(ctx);
+            return NULL;
+        }
+
+        stage_size /= 2;
+    }
+
+    log_debug("Allocating work buffers");
+    for (i = 0; i < 2; i++) {
+        ctx->work[i] = (FP_FLOAT complex *) calloc(input_size / cic_ratio, sizeof(FP_FLOAT complex));
+        ctx->work_fixed[i] = (fixed_complex *) calloc(input_size / cic_ratio, sizeof(fixed_complex));
+        if (ctx->work[i] == NULL || ctx->work_fixed[i] == NULL) {
+            log_error("Unable to allocate work buffer");
+            decimate_free(ctx);
+            return NULL;
+        }
+    }
+
+    return ctx;
+}
+
+void decimate_free(decimate_ctx *ctx) {
+    size_t i;
+
+    log_info("Freeing decimate context");
+
+    if (ctx == NULL)
+        return;
+
+    for (i = 0; i < DECIMATE_HALFBAND_STAGES_MAX; i++) {
+        if (ctx->halfband[i].buffer != NULL)
+            free(ctx->halfband[i].buffer);
+
+        if (ctx->halfband[i].buffer_fixed != NULL)
+            free(ctx->halfband[i].buffer_fixed);
+    }
+
+    decimate_fir_free(&ctx->fir);
+
+    for (i = 0; i < 2; i++) {
+        if (ctx->work[i] != NULL)
+            free(ctx->work[i]);
+
+        if (ctx->work_fixed[i] != NULL)
+            free(ctx->work_fixed[i]);
+    }
+
+    free(ctx);
+}
+
+size_t decimate_compute_output_size(decimate_ctx *ctx, size_t input_size) {
+    return input_size / ctx->ratio;
+}
+
+int decimate_do(decimate_ctx *ctx, const FP_FLOAT complex *input, size_t input_size, FP_FLOAT complex *output) {
+    const FP_FLOAT complex *src;
+    FP_FLOAT complex *dst;
+    size_t size;
+    size_t steps;
+    size_t step;
+    size_t s;
+
+    log_trace("Decimating");
+
+    if (input_size > ctx->input_size || input_size % ctx->ratio != 0) {
+        log_error("Invalid input size %zu", input_size);
+        return EXIT_FAILURE;
+    }
+
+    if (ctx->ratio == 1) {
+        memcpy(output, input, input_size * sizeof(FP_FLOAT complex));
+        return EXIT_SUCCESS;
+    }
+
+    steps = ctx->halfband_stages + (ctx->cic.ratio > 1 ? 1 : 0) + (ctx->fir.ratio > 1 ? 1 : 0);
+    step = 0;
+
+    src = input;
+    size = input_size;
+
+    if (ctx->cic.ratio > 1) {
+        step++;
+        dst = step == steps ? output : ctx->work[step % 2];
+
+        decimate_cic_do(&ctx->cic, src, size, dst);
+
+        src = dst;
+        size /= ctx->cic.ratio;
+    }
+
+    for (s = 0; s < ctx->halfband_stages; s++) {
+        step++;
+        dst = step == steps ? output : ctx->work[step % 2];
+
+        decimate_halfband_do(&ctx->halfband[s], src, size, dst);
+
+        src = dst;
+        size /= 2;
+    }
+
+    if (ctx->fir.ratio > 1)
+        decimate_fir_do(&ctx->fir, src, size, output);
+
+    return EXIT_SUCCESS;
+}
+
+int decimate_do_fixed(decimate_ctx *ctx, const fixed_complex *input, size_t input_size, fixed_complex *output) {
+    const fixed_complex *src;
+    fixed_complex *dst;
+    size_t size;
+    size_t steps;
+    size_t step;
+    size_t s;
+
+    log_trace("Decimating fixed point");
+
+    if (input_size > ctx->input_size || input_size % ctx->ratio != 0) {
+        log_error("Invalid input size %zu", input_size);
+        return EXIT_FAILURE;
+    }
+
+    if (ctx->ratio == 1) {
+        memcpy(output, input, input_size * sizeof(fixed_complex));
+        return EXIT_SUCCESS;
+    }
+
+    steps = ctx->halfband_stages + (ctx->cic.ratio > 1 ? 1 : 0) + (ctx->fir.ratio > 1 ? 1 : 0);
+    step = 0;
+
+    src = input;
+    size = input_size;
+
+    if (ctx->cic.ratio > 1) {
+        step++;
+        dst = step == steps ? output : ctx->work_fixed[step % 2];
+
+        decimate_cic_do_fixed(&ctx->cic, src, size, dst);
+
+        src = dst;
+        size /= ctx->cic.ratio;
+    }
+
+    for (s = 0; s < ctx->halfband_stages; s++) {
+        step++;
+        dst = step == steps ? output : ctx->work_fixed[step % 2];
+
+        decimate_halfband_do_fixed(&ctx->halfband[s], src, size, dst);
+
+        src = dst;
+        size /= 2;
+    }
+
+    if (ctx->fir.ratio > 1)
+        decimate_fir_do_fixed(&ctx->fir, src, size, output);
+
+    return EXIT_SUCCESS;
+}
+
+void decimate_cic_do(decimate_cic *cic, const FP_FLOAT complex *input, size_t input_size, FP_FLOAT complex *output) {
+    size_t i;
+    size_t s;
+    size_t o;
+    uint64_t vi;
+    uint64_t vq;
+    uint64_t tmp;
+
+    o = 0;
+
+    for (i = 0; i < input_size; i++) {
+        cic->integrators_i[0] += (uint64_t) llround(creal(input[i]) * DECIMATE_CIC_SCALE);
+        cic->integrators_q[0] += (uint64_t) llround(cimag(input[i]) * DECIMATE_CIC_SCALE);
+
+        for (s = 1; s < DECIMATE_CIC_ORDER; s++) {
+            cic->integrators_i[s] += cic->integrators_i[s - 1];
+            cic->integrators_q[s] += cic->integrators_q[s - 1];
+        }
+
+        cic->count++;
+        if (cic->count < cic->ratio)
+            continue;
+
+        cic->count = 0;
+
+        vi = cic->integrators_i[DECIMATE_CIC_ORDER - 1];
+        vq = cic->integrators_q[DECIMATE_CIC_ORDER - 1];
+
+        for (s = 0; s < DECIMATE_CIC_ORDER; s++) {
+            tmp = vi;
+            vi -= cic->combs_i[s];
+            cic->combs_i[s] = tmp;
+
+            tmp = vq;
+            vq -= cic->combs_q[s];
+            cic->combs_q[s] = tmp;
+        }
+
+        output[o] = (FP_FLOAT) (int64_t) vi * cic->gain + (FP_FLOAT) (int64_t) vq * cic->gain * I;
+        o++;
+    }
+}
+
+void decimate_cic_do_fixed(decimate_cic *cic, const fixed_complex *input, size_t input_size, fixed_complex *output) {
+    size_t i;
+    size_t s;
+    size_t o;
+    uint64_t vi;
+    uint64_t vq;
+    uint64_t tmp;
+
+    o = 0;
+
+    for (i = 0; i < input_size; i++) {
+        cic->integrators_i[0] += (uint64_t) (int64_t) input[i].i;
+        cic->integrators_q[0] += (uint64_t) (int64_t) input[i].q;
+
+        for (s = 1; s < DECIMATE_CIC_ORDER; s++) {
+            cic->integrators_i[s] += cic->integrators_i[s - 1];
+            cic->integrators_q[s] += cic->integrators_q[s - 1];
+        }
+
+        cic->count++;
+        if (cic->count < cic->ratio)
+            continue;
+
+        cic->count = 0;
+
+        vi = cic->integrators_i[DECIMATE_CIC_ORDER - 1];
+        vq = cic->integrators_q[DECIMATE_CIC_ORDER - 1];
+
+        for (s = 0; s < DECIMATE_CIC_ORDER; s++) {
+            tmp = vi;
+            vi -= cic->combs_i[s];
+            cic->combs_i[s] = tmp;
+
+            tmp = vq;
+            vq -= cic->combs_q[s];
+            cic->combs_q[s] = tmp;
+        }
+
+        output[o].i = fixed_saturate((int32_t) ((int64_t) vi / cic->norm));
+        output[o].q = fixed_saturate((int32_t) ((int64_t) vq / cic->norm));
+        o++;
+    }
+}
+
+int decimate_halfband_init(decimate_halfband *hb, size_t input_size) {
+    FP_FLOAT sum;
+    double n;
+    double w;
+    size_t k;
+    size_t m;
+
+    m = (DECIMATE_HALFBAND_TAPS - 1) / 2;
+
+    hb->center = (FP_FLOAT) 0.5;
+    sum = hb->center;
+
+    for (k = 0; k < (DECIMATE_HALFBAND_TAPS + 1) / 4; k++) {
+        n = (double) (2 * k + 1);
+        w = 0.42 + 0.5 * cos(M_PI * n / (double) (m + 1)) + 0.08 * cos(2 * M_PI * n / (double) (m + 1));
+        hb->kernel[k] = (FP_FLOAT) (sin(M_PI * n / 2) / (M_PI * n) * w);
+        sum += 2 * hb->kernel[k];
+    }
+
+    hb->center /= sum;
+    for (k = 0; k < (DECIMATE_HALFBAND_TAPS + 1) / 4; k++)
+        hb->kernel[k] /= sum;
+
+    hb->center_fixed = fixed_from_float(hb->center);
+    for (k = 0; k < (DECIMATE_HALFBAND_TAPS + 1) / 4; k++)
+        hb->kernel_fixed[k] = fixed_from_float(hb->kernel[k]);
+
+    hb->buffer_size = DECIMATE_HALFBAND_TAPS - 1 + input_size;
+    hb->buffer = (FP_FLOAT complex *) calloc(hb->buffer_size, sizeof(FP_FLOAT complex));
+    if (hb->buffer == NULL)
+        return EXIT_FAILURE;
+
+    hb->buffer_fixed = (fixed_complex *) calloc(hb->buffer_size, sizeof(fixed_complex));
+    if (hb->buffer_fixed == NULL)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+void decimate_halfband_do(decimate_halfband *hb,
+                          const FP_FLOAT complex *input, size_t input_size,
+                          FP_FLOAT complex *output) {
+    FP_FLOAT complex *center;
+    FP_FLOAT complex sum;
+    size_t history;
+    size_t i;
+    size_t k;
+
+    history = DECIMATE_HALFBAND_TAPS - 1;
+
+    memcpy(hb->buffer + history, input, input_size * sizeof(FP_FLOAT complex));
+
+    for (i = 0; i < input_size / 2; i++) {
+        center = hb->buffer + 2 * i + history / 2;
+        sum = hb->center * center[0];
+
+        for (k = 0; k < (DECIMATE_HALFBAND_TAPS + 1) / 4; k++)
+            sum += hb->kernel[k] * (center[-(ssize_t) (2 * k + 1)] + center[2 * k + 1]);
+
+        output[i] = sum;
+    }
+
+    memmove(hb->buffer, hb->buffer + input_size, history * sizeof(FP_FLOAT complex));
+}
+
+void decimate_halfband_do_fixed(decimate_halfband *hb,
+                                const fixed_complex *input, size_t input_size,
+                                fixed_complex *output) {
+    fixed_complex *center;
+    int32_t sum_i;
+    int32_t sum_q;
+    size_t history;
+    size_t i;
+    size_t k;
+
+    history = DECIMATE_HALFBAND_TAPS - 1;
+
+    memcpy(hb->buffer_fixed + history, input, input_size * sizeof(fixed_complex));
+
+    for (i = 0; i < input_size / 2; i++) {
+        center = hb->buffer_fixed + 2 * i + history / 2;
+        sum_i = (int32_t) hb->center_fixed * center[0].i;
+        sum_q = (int32_t) hb->center_fixed * center[0].q;
+
+        for (k = 0; k < (DECIMATE_HALFBAND_TAPS + 1) / 4; k++) {
+            sum_i += (int32_t) hb->kernel_fixed[k]
+                     * ((int32_t) center[-(ssize_t) (2 * k + 1)].i + center[2 * k + 1].i);
+            sum_q += (int32_t) hb->kernel_fixed[k]
+                     * ((int32_t) center[-(ssize_t) (2 * k + 1)].q + center[2 * k + 1].q);
+        }
+
+        output[i].i = fixed_saturate((sum_i + FIXED_Q15_HALF) >> FIXED_Q15_SHIFT);
+        output[i].q = fixed_saturate((sum_q + FIXED_Q15_HALF) >> FIXED_Q15_SHIFT);
+    }
+
+    memmove(hb->buffer_fixed, hb->buffer_fixed + input_size, history * sizeof(fixed_complex));
+}
+
+int decimate_fir_init(decimate_fir *fir, uint32_t ratio, const decimate_cic *cic, size_t input_size) {
+    FP_FLOAT *lowpass;
+    double passband;
+    double comp;
+    double sum;
+    double n;
+    double w;
+    size_t m;
+    size_t k;
+
+    fir->ratio = ratio;
+    fir->taps_size = DECIMATE_FIR_TAPS_PER_PHASE * ratio + 3;
+
+    fir->kernel = (FP_FLOAT *) calloc(fir->taps_size, sizeof(FP_FLOAT));
+    fir->kernel_fixed = (int16_t *) calloc(fir->taps_size, sizeof(int16_t));
+    lowpass = (FP_FLOAT *) calloc(fir->taps_size - 2, sizeof(FP_FLOAT));
+    if (fir->kernel == NULL || fir->kernel_fixed == NULL || lowpass == NULL) {
+        free(lowpass);
+        return EXIT_FAILURE;
+    }
+
+    // Windowed sinc cut at the output Nyquist frequency
+    m = (fir->taps_size - 3) / 2;
+    sum = 0;
+    for (k = 0; k < fir->taps_size - 2; k++) {
+        n = (double) k - (double) m;
+        w = 0.42 - 0.5 * cos(M_PI * (double) k / (double) m) + 0.08 * cos(2 * M_PI * (double) k / (double) m);
+        lowpass[k] = (FP_FLOAT) ((k == m ? 1.0 / ratio : sin(M_PI * n / ratio) / (M_PI * n)) * w);
+        sum += lowpass[k];
+    }
+
+    // Three taps (-comp, 1 + 2 comp, -comp) undo the CIC droop at the passband edge
+    passband = DECIMATE_FIR_PASSBAND * 0.5 / ratio;
+    comp = (1 / decimate_cic_response(cic, passband) - 1) / (2 - 2 * cos(2 * M_PI * passband));
+
+    for (k = 0; k < fir->taps_size - 2; k++) {
+        lowpass[k] = (FP_FLOAT) (lowpass[k] / sum);
+        fir->kernel[k] -= (FP_FLOAT) comp * lowpass[k];
+        fir->kernel[k + 1] += (FP_FLOAT) (1 + 2 * comp) * lowpass[k];
+        fir->kernel[k + 2] -= (FP_FLOAT) comp * lowpass[k];
+    }
+
+    free(lowpass);
+
+    for (k = 0; k < fir->taps_size; k++)
+        fir->kernel_fixed[k] = fixed_from_float(fir->kernel[k]);
+
+    fir->buffer_size = fir->taps_size - 1 + input_size;
+    fir->buffer = (FP_FLOAT complex *) calloc(fir->buffer_size, sizeof(FP_FLOAT complex));
+    if (fir->buffer == NULL)
+        return EXIT_FAILURE;
+
+    fir->buffer_fixed = (fixed_complex *) calloc(fir->buffer_size, sizeof(fixed_complex));
+    if (fir->buffer_fixed == NULL)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+void decimate_fir_free(decimate_fir *fir) {
+    free(fir->kernel);
+    free(fir->kernel_fixed);
+    free(fir->buffer);
+    free(fir->buffer_fixed);
+
+    fir->kernel = NULL;
+    fir->kernel_fixed = NULL;
+    fir->buffer = NULL;
+    fir->buffer_fixed = NULL;
+}
+
+void decimate_fir_do(decimate_fir *fir, const FP_FLOAT complex *input, size_t input_size, FP_FLOAT complex *output) {
+    const FP_FLOAT complex *window;
+    FP_FLOAT complex sum;
+    size_t history;
+    size_t i;
+    size_t k;
+
+    history = fir->taps_size - 1;
+
+    memcpy(fir->buffer + history, input, input_size * sizeof(FP_FLOAT complex));
+
+    for (i = 0; i < input_size / fir->ratio; i++) {
+        window = fir->buffer + i * fir->ratio + fir->ratio - 1;
+        sum = 0;
+
+        for (k = 0; k < fir->taps_size; k++)
+            sum += fir->kernel[k] * window[k];
+
+        output[i] = sum;
+    }
+
+    memmove(fir->buffer, fir->buffer + input_size, history * sizeof(FP_FLOAT complex));
+}
+
+void decimate_fir_do_fixed(decimate_fir *fir, const fixed_complex *input, size_t input_size, fixed_complex *output) {
+    const fixed_complex *window;
+    int64_t sum_i;
+    int64_t sum_q;
+    size_t history;
+    size_t i;
+    size_t k;
+
+    history = fir->taps_size - 1;
+
+    memcpy(fir->buffer_fixed + history, input, input_size * sizeof(fixed_complex));
+
+    for (i = 0; i < input_size / fir->ratio; i++) {
+        window = fir->buffer_fixed + i * fir->ratio + fir->ratio - 1;
+        sum_i = 0;
+        sum_q = 0;
+
+        for (k = 0; k < fir->taps_size; k++) {
+            sum_i += (int32_t) fir->kernel_fixed[k] * window[k].i;
+            sum_q += (int32_t) fir->kernel_fixed[k] * window[k].q;
+        }
+
+        output[i].i = fixed_saturate((int32_t) ((sum_i + FIXED_Q15_HALF) >> FIXED_Q15_SHIFT));
+        output[i].q = fixed_saturate((int32_t) ((sum_q + FIXED_Q15_HALF) >> FIXED_Q15_SHIFT));
+    }
+
+    memmove(fir->buffer_fixed, fir->buffer_fixed + input_size, history * sizeof(fixed_complex));
+}
+
+// Magnitude response of the CIC at a frequency relative to its output rate
+static double decimate_cic_response(const decimate_cic *cic, double frequency) {
+    double f;
+
+    if (cic->ratio <= 1 || frequency == 0)
+        return 1;
+
+    f = M_PI * frequency;
+
+    return pow(fabs(sin(f) / (cic->ratio * sin(f / cic->ratio))), DECIMATE_CIC_ORDER);
+}
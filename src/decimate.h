@@ -0,0 +1,148 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__DECIMATE__H
+#define __RTLSDR_RADIO__DECIMATE__H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <complex.h>
+
+#include "buildflags.h"
+#include "fixed.h"
+
+/*
+ * The decimation chain is made of an optional CIC stage, which takes care of
+ * the odd part of the ratio (and of the big powers of two), followed by up to
+ * DECIMATE_HALFBAND_STAGES_MAX half-band stages, each one decimating by 2.
+ *
+ * When no half-band stage follows, the smallest prime factor of the odd part
+ * is moved from the CIC to a final FIR stage, so the CIC output stays at least
+ * 3 times the output rate. The FIR (DECIMATE_FIR_TAPS_PER_PHASE taps for each
+ * output phase, Blackman window) rejects what the CIC folds near the band edge
+ * and compensates the CIC droop up to DECIMATE_FIR_PASSBAND of the output
+ * Nyquist frequency.
+ *
+ * The CIC runs in fixed point (input scaled by DECIMATE_CIC_SCALE) with
+ * wrapping 64 bit registers, so integrators never drift.
+ *
+ * The _fixed variants run the same chain on Q15 samples, with the half-band
+ * taps quantized to Q15 and accumulated in 32 bit.
+ */
+
+#define DECIMATE_CIC_ORDER 4
+#define DECIMATE_CIC_SCALE 32768
+
+#define DECIMATE_HALFBAND_TAPS 31
+#define DECIMATE_HALFBAND_STAGES_MAX 4
+
+#define DECIMATE_FIR_TAPS_PER_PHASE 16
+#define DECIMATE_FIR_PASSBAND 0.8
+
+struct decimate_cic_t {
+    uint32_t ratio;
+    uint32_t count;
+
+    FP_FLOAT gain;
+    int64_t norm;
+
+    uint64_t integrators_i[DECIMATE_CIC_ORDER];
+    uint64_t integrators_q[DECIMATE_CIC_ORDER];
+
+    uint64_t combs_i[DECIMATE_CIC_ORDER];
+    uint64_t combs_q[DECIMATE_CIC_ORDER];
+};
+
+struct decimate_halfband_t {
+    FP_FLOAT center;
+    FP_FLOAT kernel[(DECIMATE_HALFBAND_TAPS + 1) / 4];
+
+    int16_t center_fixed;
+    int16_t kernel_fixed[(DECIMATE_HALFBAND_TAPS + 1) / 4];
+
+    size_t buffer_size;
+    FP_FLOAT complex *buffer;
+    fixed_complex *buffer_fixed;
+};
+
+struct decimate_fir_t {
+    uint32_t ratio;
+
+    size_t taps_size;
+    FP_FLOAT *kernel;
+    int16_t *kernel_fixed;
+
+    size_t buffer_size;
+    FP_FLOAT complex *buffer;
+    fixed_complex *buffer_fixed;
+};
+
+struct decimate_ctx_t {
+    uint32_t src_rate;
+    uint32_t dst_rate;
+
+    uint32_t ratio;
+
+    size_t input_size;
+
+    struct decimate_cic_t cic;
+
+    size_t halfband_stages;
+    struct decimate_halfband_t halfband[DECIMATE_HALFBAND_STAGES_MAX];
+
+    struct decimate_fir_t fir;
+
+    FP_FLOAT complex *work[2];
+    fixed_complex *work_fixed[2];
+};
+
+typedef struct decimate_cic_t decimate_cic;
+typedef struct decimate_halfband_t decimate_halfband;
+typedef struct decimate_fir_t decimate_fir;
+typedef struct decimate_ctx_t decimate_ctx;
+
+decimate_ctx *decimate_init(uint32_t, uint32_t, size_t);
+
+void decimate_free(decimate_ctx *);
+
+size_t decimate_compute_output_size(decimate_ctx *, size_t);
+
+int decimate_do(decimate_ctx *, const FP_FLOAT complex *, size_t, FP_FLOAT complex *);
+
+int decimate_do_fixed(decimate_ctx *, const fixed_complex *, size_t, fixed_complex *);
+
+void decimate_cic_do(decimate_cic *, const FP_FLOAT complex *, size_t, FP_FLOAT complex *);
+
+void decimate_cic_do_fixed(decimate_cic *, const fixed_complex *, size_t, fixed_complex *);
+
+int decimate_halfband_init(decimate_halfband *, size_t);
+
+void decimate_halfband_do(decimate_halfband *, const FP_FLOAT complex *, size_t, FP_FLOAT complex *);
+
+void decimate_halfband_do_fixed(decimate_halfband *, const fixed_complex *, size_t, fixed_complex *);
+
+int decimate_fir_init(decimate_fir *, uint32_t, const decimate_cic *, size_t);
+
+void decimate_fir_free(decimate_fir *);
+
+void decimate_fir_do(decimate_fir *, const FP_FLOAT complex *, size_t, FP_FLOAT complex *);
+
+void decimate_fir_do_fixed(decimate_fir *, const fixed_complex *, size_t, fixed_complex *);
+
+#endif
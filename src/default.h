@@ -43,11 +43,33 @@
 #define CONFIG_RTLSDR_DEVICE_TUNER_GAIN_DEFAULT 496
 #define CONFIG_RTLSDR_DEVICE_AGC_MODEDEFAULT FLAG_FALSE
 #define CONFIG_RTLSDR_SAMPLES_DEFAULT 2048
+#define CONFIG_RTLSDR_SETTLE_DEFAULT 10
+
+#define CONFIG_IQ_CORRECTION_DEFAULT FLAG_FALSE
+
+#define CONFIG_CHANNEL_SAMPLE_RATE_DEFAULT 32000
+
+#define CONFIG_CHANNELIZER_CHANNELS_DEFAULT 0
 
 #define CONFIG_MODULATION_DEFAULT MOD_TYPE_AM
 
+#define CONFIG_SQUELCH_DEFAULT SQUELCH_MODE_NONE
+#define CONFIG_SQUELCH_LEVEL_DEFAULT 10
+#define CONFIG_SQUELCH_HYSTERESIS_DEFAULT 3
+#define CONFIG_SQUELCH_HANG_DEFAULT 500
+
+#define CONFIG_AGC_DEFAULT FLAG_FALSE
+#define CONFIG_AGC_ATTACK_DEFAULT 5
+#define CONFIG_AGC_DECAY_DEFAULT 300
+
 #define CONFIG_FILTER_DEFAULT FILTER_MODE_FFT_SW
-#define CONFIG_FILTER_FIR_DEFAULT 1
+#define CONFIG_FILTER_DESIGN_DEFAULT FIR_DESIGN_TYPE_KAISER
+#define CONFIG_FILTER_CUTOFF_DEFAULT 3500
+#define CONFIG_FILTER_TRANSITION_DEFAULT 1500
+#define CONFIG_FILTER_ATTENUATION_DEFAULT 60
+
+#define CONFIG_FFT_PLANNER_DEFAULT FFT_RIGOR_EXHAUSTIVE
+#define CONFIG_FFT_WISDOM_FILE_DEFAULT ""
 
 #define CONFIG_AUDIO_FRAME_PER_PERIOD_DEFAULT 4096
 #define CONFIG_AUDIO_SAMPLE_RATE_DEFAULT 8000
@@ -64,5 +86,54 @@
 
 #define CONFIG_NETWORK_SERVER_DEFAULT "127.0.0.1"
 #define CONFIG_NETWORK_PORT_DEFAULT 64123
+#define CONFIG_NETWORK_PROTOCOL_DEFAULT 1
+#define CONFIG_NETWORK_TRANSPORT_DEFAULT NETWORK_TRANSPORT_UDP
+#define CONFIG_NETWORK_QUEUE_DEFAULT 256
+#define CONFIG_NETWORK_FEC_DEFAULT 0
+#define CONFIG_NETWORK_AGGREGATE_FRAMES_DEFAULT 1
+#define CONFIG_NETWORK_AGGREGATE_TIME_DEFAULT 0
+#define CONFIG_NETWORK_MULTICAST_TTL_DEFAULT 1
+#define CONFIG_NETWORK_MULTICAST_INTERFACE_DEFAULT ""
+
+#define CONFIG_SPECTRUM_DEFAULT FLAG_FALSE
+#define CONFIG_SPECTRUM_SIZE_DEFAULT 1024
+#define CONFIG_SPECTRUM_RATE_DEFAULT 10
+#define CONFIG_SPECTRUM_AVERAGES_DEFAULT 4
+#define CONFIG_SPECTRUM_SERVER_DEFAULT "127.0.0.1"
+#define CONFIG_SPECTRUM_PORT_DEFAULT 64124
+
+#define CONFIG_IQ_DEFAULT FLAG_FALSE
+#define CONFIG_IQ_OFFSET_DEFAULT 0
+#define CONFIG_IQ_SAMPLE_RATE_DEFAULT 48000
+#define CONFIG_IQ_FORMAT_DEFAULT IQ_FORMAT_INT16
+#define CONFIG_IQ_GAIN_DEFAULT 0
+#define CONFIG_IQ_SERVER_DEFAULT "127.0.0.1"
+#define CONFIG_IQ_PORT_DEFAULT 64125
+
+#define CONFIG_CONTROL_PORT_DEFAULT 0
+
+#define CONFIG_SCAN_DWELL_DEFAULT 50
+#define CONFIG_SCAN_RESUME_DEFAULT 2000
+
+#define CONFIG_SURVEY_START_DEFAULT 24000000
+#define CONFIG_SURVEY_STOP_DEFAULT 1700000000
+#define CONFIG_SURVEY_SIZE_DEFAULT 1024
+#define CONFIG_SURVEY_AVERAGES_DEFAULT 16
+#define CONFIG_SURVEY_CROP_DEFAULT 25
+#define CONFIG_SURVEY_LOOPS_DEFAULT 1
+#define CONFIG_SURVEY_FORMAT_DEFAULT SURVEY_FORMAT_CSV
+#define CONFIG_SURVEY_OUTPUT_DEFAULT "survey.csv"
+
+#define CONFIG_PLAY_ADDRESS_DEFAULT "0.0.0.0"
+#define CONFIG_PLAY_PORT_DEFAULT 64123
+#define CONFIG_PLAY_CHANNEL_DEFAULT 1
+#define CONFIG_PLAY_LATENCY_DEFAULT 60
+#define CONFIG_PLAY_CONCEALMENT_DEFAULT FLAG_TRUE
+
+#define CONFIG_VOTE_ADDRESS_DEFAULT "0.0.0.0"
+#define CONFIG_VOTE_PORT_DEFAULT 64123
+#define CONFIG_VOTE_CHANNEL_DEFAULT 1
+#define CONFIG_VOTE_RECEIVERS_DEFAULT 16
+#define CONFIG_VOTE_WINDOW_DEFAULT 60
 
 #endif
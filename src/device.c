@@ -183,6 +183,18 @@ int device_set_frequency(rtlsdr_dev_t *device, uint32_t frequency) {
     return EXIT_SUCCESS;
 }
 
+int device_set_gain(rtlsdr_dev_t *device, int tuner_gain) {
+    int result;
+
+    result = rtlsdr_set_tuner_gain(device, tuner_gain);
+    if (result < 0) {
+        log_error("Failed to set tuner gain: %d", result);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 int device_buffer_to_samples(const uint8_t *buffer, FP_FLOAT complex *samples, size_t buffer_size) {
     FP_FLOAT i;
     FP_FLOAT q;
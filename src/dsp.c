@@ -25,13 +25,28 @@ FP_FLOAT dsp_complex_rms(FP_FLOAT complex *data, size_t data_size) {
     size_t i;
     FP_FLOAT sum;
 
+    if (data_size == 0)
+        return 0;
+
     sum = 0;
     for (i = 0; i < data_size; i++)
-        sum += cabs(data[i]);
+        sum += creal(data[i]) * creal(data[i]) + cimag(data[i]) * cimag(data[i]);
 
-    sum /= (data_size * M_SQRT2);
+    return sqrt(sum / data_size);
+}
 
-    return sqrt(sum);
+FP_FLOAT dsp_fixed_complex_rms(fixed_complex *data, size_t data_size) {
+    size_t i;
+    int64_t sum;
+
+    if (data_size == 0)
+        return 0;
+
+    sum = 0;
+    for (i = 0; i < data_size; i++)
+        sum += (int32_t) data[i].i * data[i].i + (int32_t) data[i].q * data[i].q;
+
+    return sqrt((FP_FLOAT) sum / data_size) / (FP_FLOAT) (1 << FIXED_Q15_SHIFT);
 }
 
 FP_FLOAT dsp_rms(int8_t *data, size_t data_size) {
@@ -25,9 +25,12 @@
 #include <complex.h>
 
 #include "buildflags.h"
+#include "fixed.h"
 
 FP_FLOAT dsp_complex_rms(FP_FLOAT complex *, size_t);
 
+FP_FLOAT dsp_fixed_complex_rms(fixed_complex *, size_t);
+
 FP_FLOAT dsp_rms(int8_t *, size_t data_size);
 
 void dsp_remove_dc_offset(int8_t *, size_t);
@@ -0,0 +1,233 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+
+#include "fec.h"
+#include "log.h"
+
+static fec_result fec_finish(fec_ctx *);
+
+static void fec_xor(uint8_t *, const uint8_t *, size_t);
+
+fec_ctx *fec_init(size_t group_size, size_t frame_size) {
+    fec_ctx *ctx;
+    size_t i;
+
+    log_info("Initializing FEC context");
+
+    if (group_size < FEC_GROUP_SIZE_MIN || group_size > FEC_GROUP_SIZE_MAX) {
+        log_error("FEC group size must be between %d and %d", FEC_GROUP_SIZE_MIN, FEC_GROUP_SIZE_MAX);
+        return NULL;
+    }
+
+    if (frame_size == 0) {
+        log_error("FEC frame size must be greater than 0");
+        return NULL;
+    }
+
+    log_debug("Allocating FEC context");
+    ctx = (fec_ctx *) calloc(1, sizeof(fec_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate FEC context");
+        return NULL;
+    }
+
+    log_debug("Allocating FEC buffers");
+    ctx->buffer = (uint8_t *) calloc((3 + FEC_HISTORY) * frame_size, sizeof(uint8_t));
+    if (ctx->buffer == NULL) {
+        log_error("Unable to allocate FEC buffers");
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->group_size = group_size;
+    ctx->frame_size = frame_size;
+
+    ctx->current.data = ctx->buffer;
+    ctx->repair.data = ctx->buffer + frame_size;
+    ctx->recovered.data = ctx->buffer + 2 * frame_size;
+    for (i = 0; i < FEC_HISTORY; i++)
+        ctx->history[i].data = ctx->buffer + (3 + i) * frame_size;
+
+    return ctx;
+}
+
+void fec_free(fec_ctx *ctx) {
+    log_info("Freeing FEC context");
+
+    if (ctx == NULL)
+        return;
+
+    free(ctx->buffer);
+    free(ctx);
+}
+
+fec_result fec_encode(fec_ctx *ctx, uint64_t number, uint64_t timestamp, const uint8_t *data, size_t size) {
+    fec_group *group;
+    fec_result result;
+    uint64_t base;
+    uint32_t bit;
+
+    result = FEC_NONE;
+    group = &ctx->current;
+
+    base = number - number % ctx->group_size;
+    bit = (uint32_t) 1 << (number - base);
+
+    if (group->frames > 0 && group->base != base)
+        result = fec_finish(ctx);
+
+    if (size > ctx->frame_size) {
+        log_error("Frame of %zu bytes too big for FEC", size);
+        return result;
+    }
+
+    if (group->frames == 0) {
+        group->base = base;
+        group->mask = 0;
+        group->timestamp = 0;
+        group->size = 0;
+        group->data_size = 0;
+        memset(group->data, 0, ctx->frame_size);
+    }
+
+    if (group->mask & bit)
+        return result;
+
+    group->mask |= bit;
+    group->frames++;
+    group->timestamp ^= timestamp;
+    group->size ^= (uint32_t) size;
+    fec_xor(group->data, data, size);
+    if (size > group->data_size)
+        group->data_size = (uint32_t) size;
+
+    if (result == FEC_NONE && number - base == ctx->group_size - 1)
+        result = fec_finish(ctx);
+
+    return result;
+}
+
+fec_result fec_flush(fec_ctx *ctx) {
+    if (ctx->current.frames == 0)
+        return FEC_NONE;
+
+    return fec_finish(ctx);
+}
+
+void fec_decode_frame(fec_ctx *ctx, uint64_t number, uint64_t timestamp, const uint8_t *data, size_t size) {
+    fec_frame *frame;
+
+    frame = &ctx->history[number % FEC_HISTORY];
+
+    if (size > ctx->frame_size) {
+        frame->valid = 0;
+        return;
+    }
+
+    frame->valid = 1;
+    frame->number = number;
+    frame->timestamp = timestamp;
+    frame->size = (uint32_t) size;
+    memcpy(frame->data, data, size);
+}
+
+fec_result fec_decode_repair(fec_ctx *ctx, uint64_t base, uint32_t mask, uint64_t timestamp, uint32_t size,
+                             const uint8_t *data, size_t data_size) {
+    fec_frame *recovered;
+    fec_frame *frame;
+    uint64_t number;
+    size_t missing;
+    size_t i;
+
+    if (data_size > ctx->frame_size) {
+        log_error("Repair of %zu bytes too big for FEC", data_size);
+        return FEC_NONE;
+    }
+
+    recovered = &ctx->recovered;
+    recovered->timestamp = timestamp;
+    recovered->size = size;
+    memcpy(recovered->data, data, data_size);
+
+    missing = 0;
+    number = 0;
+
+    for (i = 0; i < FEC_GROUP_SIZE_MAX; i++) {
+        if (!(mask & ((uint32_t) 1 << i)))
+            continue;
+
+        frame = &ctx->history[(base + i) % FEC_HISTORY];
+        if (frame->valid && frame->number == base + i && frame->size <= data_size) {
+            recovered->timestamp ^= frame->timestamp;
+            recovered->size ^= frame->size;
+            fec_xor(recovered->data, frame->data, frame->size);
+        } else {
+            missing++;
+            number = base + i;
+        }
+    }
+
+    if (missing == 0)
+        return FEC_NONE;
+
+    if (missing > 1 || recovered->size > data_size) {
+        log_debug("Unable to recover %zu frames from repair %llu", missing, (unsigned long long) base);
+        ctx->failures++;
+        return FEC_NONE;
+    }
+
+    log_debug("Recovered frame %llu", (unsigned long long) number);
+
+    recovered->valid = 1;
+    recovered->number = number;
+    ctx->recoveries++;
+
+    fec_decode_frame(ctx, recovered->number, recovered->timestamp, recovered->data, recovered->size);
+
+    return FEC_RECOVERED;
+}
+
+static fec_result fec_finish(fec_ctx *ctx) {
+    fec_group group;
+
+    if (ctx->current.frames < 2) {
+        ctx->current.frames = 0;
+        return FEC_NONE;
+    }
+
+    group = ctx->repair;
+    ctx->repair = ctx->current;
+    ctx->current = group;
+    ctx->current.frames = 0;
+
+    ctx->repairs++;
+
+    return FEC_REPAIR;
+}
+
+static void fec_xor(uint8_t *dst, const uint8_t *src, size_t size) {
+    size_t i;
+
+    for (i = 0; i < size; i++)
+        dst[i] ^= src[i];
+}
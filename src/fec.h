@@ -0,0 +1,104 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__FEC__H
+#define __RTLSDR_RADIO__FEC__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * XOR parity over groups of frames of one channel.
+ *
+ * Frame numbers are split in groups of group_size consecutive numbers. The
+ * encoder XORs timestamp, size and data (zero padded to the longest frame)
+ * of every frame sent in a group and, once the group is over, hands out a
+ * repair made of the group base number, the mask of the frames it covers
+ * and the parity. Groups with a single frame get no repair.
+ *
+ * The decoder keeps the last FEC_HISTORY frames it received: a repair
+ * missing exactly one of its frames rebuilds it from the others.
+ */
+
+#define FEC_GROUP_SIZE_MIN 2
+#define FEC_GROUP_SIZE_MAX 32
+#define FEC_HISTORY (2 * FEC_GROUP_SIZE_MAX)
+
+enum fec_result_t {
+    FEC_NONE = 0,
+    FEC_REPAIR,
+    FEC_RECOVERED
+};
+
+struct fec_frame_t {
+    int valid;
+
+    uint64_t number;
+    uint64_t timestamp;
+    uint32_t size;
+
+    uint8_t *data;
+};
+
+struct fec_group_t {
+    uint64_t base;
+    uint32_t mask;
+    uint32_t frames;
+
+    uint64_t timestamp;
+    uint32_t size;
+
+    uint32_t data_size;
+    uint8_t *data;
+};
+
+struct fec_ctx_t {
+    size_t group_size;
+    size_t frame_size;
+    uint8_t *buffer;
+
+    struct fec_group_t current;
+    struct fec_group_t repair;
+
+    struct fec_frame_t history[FEC_HISTORY];
+    struct fec_frame_t recovered;
+
+    uint64_t repairs;
+    uint64_t recoveries;
+    uint64_t failures;
+};
+
+typedef enum fec_result_t fec_result;
+typedef struct fec_frame_t fec_frame;
+typedef struct fec_group_t fec_group;
+typedef struct fec_ctx_t fec_ctx;
+
+fec_ctx *fec_init(size_t, size_t);
+
+void fec_free(fec_ctx *);
+
+fec_result fec_encode(fec_ctx *, uint64_t, uint64_t, const uint8_t *, size_t);
+
+fec_result fec_flush(fec_ctx *);
+
+void fec_decode_frame(fec_ctx *, uint64_t, uint64_t, const uint8_t *, size_t);
+
+fec_result fec_decode_repair(fec_ctx *, uint64_t, uint32_t, uint64_t, uint32_t, const uint8_t *, size_t);
+
+#endif
@@ -21,11 +21,106 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <time.h>
 
 #include "fft.h"
 #include "log.h"
 
-fft_ctx *fft_init(size_t size, int sign, fft_data_type data_type) {
+static pthread_mutex_t fft_planner_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *fft_wisdom_path = NULL;
+
+static pthread_mutex_t fft_replan_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fft_replan_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t fft_replan_thread;
+static int fft_replan_started = 0;
+static int fft_replan_stopping = 0;
+static fft_ctx *fft_replan_head = NULL;
+static fft_ctx *fft_replan_tail = NULL;
+
+static FFT_plan fft_plan_create(fft_ctx *, unsigned int, double, void *, void *);
+
+static void fft_destroy(fft_ctx *);
+
+static int fft_replan_queue(fft_ctx *);
+
+static void fft_replan_push(fft_ctx *);
+
+static fft_ctx *fft_replan_pop();
+
+static FFT_plan fft_replan_compute(fft_ctx *);
+
+static void *fft_replan_worker(void *);
+
+int fft_wisdom_init(const char *path) {
+    int ret;
+
+    log_info("Initializing FFT wisdom");
+
+    fft_wisdom_free();
+
+    if (path == NULL || strlen(path) == 0) {
+        log_debug("No wisdom file configured");
+        return EXIT_SUCCESS;
+    }
+
+    log_debug("Importing wisdom from %s", path);
+    pthread_mutex_lock(&fft_planner_mutex);
+    fft_wisdom_path = strdup(path);
+    ret = fft_wisdom_path == NULL ? -1 : FFT_import_wisdom_from_filename(fft_wisdom_path);
+    pthread_mutex_unlock(&fft_planner_mutex);
+
+    if (ret < 0) {
+        log_error("Unable to allocate wisdom file path");
+        return EXIT_FAILURE;
+    } else if (ret == 0) {
+        log_info("No wisdom imported from %s", path);
+    } else {
+        log_info("Wisdom imported from %s", path);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void fft_wisdom_save() {
+    int ret;
+
+    // The path is guarded by the planner lock, re-plans save wisdom from the worker
+    pthread_mutex_lock(&fft_planner_mutex);
+    if (fft_wisdom_path == NULL) {
+        pthread_mutex_unlock(&fft_planner_mutex);
+        return;
+    }
+
+    log_debug("Exporting wisdom to %s", fft_wisdom_path);
+    ret = FFT_export_wisdom_to_filename(fft_wisdom_path);
+    if (ret == 0) {
+        log_error("Unable to export wisdom to %s", fft_wisdom_path);
+    }
+    pthread_mutex_unlock(&fft_planner_mutex);
+}
+
+void fft_wisdom_free() {
+    pthread_mutex_lock(&fft_planner_mutex);
+    free(fft_wisdom_path);
+    fft_wisdom_path = NULL;
+    pthread_mutex_unlock(&fft_planner_mutex);
+}
+
+unsigned int fft_rigor_flags(fft_rigor rigor) {
+    switch (rigor) {
+        case FFT_RIGOR_ESTIMATE:
+            return FFTW_ESTIMATE;
+        case FFT_RIGOR_MEASURE:
+            return FFTW_MEASURE;
+        case FFT_RIGOR_PATIENT:
+            return FFTW_PATIENT;
+        case FFT_RIGOR_EXHAUSTIVE:
+        default:
+            return FFTW_EXHAUSTIVE;
+    }
+}
+
+fft_ctx *fft_init(size_t size, int sign, fft_data_type data_type, fft_rigor rigor) {
     fft_ctx *ctx;
 
     log_info("Initializing");
@@ -39,9 +134,17 @@ fft_ctx *fft_init(size_t size, int sign, fft_data_type data_type) {
 
     log_debug("Setting samples_size");
     ctx->size = size;
+    ctx->sign = sign;
 
     log_debug("Setting data type");
     ctx->data_type = data_type;
+    ctx->rigor = rigor;
+
+    ctx->replan = NULL;
+    ctx->replan_ready = 0;
+    ctx->replan_state = FFT_REPLAN_NONE;
+    ctx->replan_orphan = 0;
+    ctx->replan_next = NULL;
 
     switch (ctx->data_type) {
 
@@ -50,9 +153,9 @@ fft_ctx *fft_init(size_t size, int sign, fft_data_type data_type) {
             ctx->complex_input = FFT_alloc_complex(ctx->size);
             ctx->complex_output = FFT_alloc_complex(ctx->size);
 
-            log_debug("Computing complex FFT plan");
-            ctx->plan = FFT_plan_dft_1d((int) ctx->size, ctx->complex_input, ctx->complex_output, sign,
-                                         FFTW_EXHAUSTIVE);
+            log_debug("Looking for complex FFT plan in wisdom");
+            ctx->plan = fft_plan_create(ctx, fft_rigor_flags(rigor) | FFTW_WISDOM_ONLY,
+                                        FFTW_NO_TIMELIMIT, ctx->complex_input, ctx->complex_output);
             break;
 
         case FFT_DATA_TYPE_REAL:
@@ -60,12 +163,39 @@ fft_ctx *fft_init(size_t size, int sign, fft_data_type data_type) {
             ctx->real_input = FFT_alloc_real(ctx->size);
             ctx->real_output = FFT_alloc_real(ctx->size);
 
-            log_debug("Computing complex FFT plan");
-            ctx->plan = FFT_plan_r2r_1d((int) ctx->size, ctx->real_input, ctx->real_output, sign, FFTW_EXHAUSTIVE);
+            log_debug("Looking for real FFT plan in wisdom");
+            ctx->plan = fft_plan_create(ctx, fft_rigor_flags(rigor) | FFTW_WISDOM_ONLY,
+                                        FFTW_NO_TIMELIMIT, ctx->real_input, ctx->real_output);
             break;
 
         default:
             log_error("Not implemented");
+            free(ctx);
+            return NULL;
+    }
+
+    if (ctx->plan != NULL)
+        return ctx;
+
+    log_info("No wisdom for this FFT, using an estimated plan");
+    if (ctx->data_type == FFT_DATA_TYPE_COMPLEX)
+        ctx->plan = fft_plan_create(ctx, FFTW_ESTIMATE, FFTW_NO_TIMELIMIT, ctx->complex_input, ctx->complex_output);
+    else
+        ctx->plan = fft_plan_create(ctx, FFTW_ESTIMATE, FFTW_NO_TIMELIMIT, ctx->real_input, ctx->real_output);
+
+    if (ctx->plan == NULL) {
+        log_error("Unable to create FFT plan");
+        fft_free(ctx);
+        return NULL;
+    }
+
+    if (rigor != FFT_RIGOR_ESTIMATE) {
+        log_debug("Queuing background re-plan");
+        pthread_mutex_lock(&fft_replan_mutex);
+        if (fft_replan_queue(ctx) != EXIT_SUCCESS) {
+            log_error("Unable to start background re-plan, keeping the estimated plan");
+        }
+        pthread_mutex_unlock(&fft_replan_mutex);
     }
 
     return ctx;
@@ -74,8 +204,60 @@ fft_ctx *fft_init(size_t size, int sign, fft_data_type data_type) {
 void fft_free(fft_ctx *ctx) {
     log_info("Freeing");
 
+    // Destroying plans needs the planner, so once the worker runs it does it
+    pthread_mutex_lock(&fft_replan_mutex);
+    if (ctx->replan_state == FFT_REPLAN_NONE && fft_replan_started && !fft_replan_stopping)
+        fft_replan_push(ctx);
+
+    if (ctx->replan_state != FFT_REPLAN_NONE) {
+        log_debug("Handing context over to the re-plan worker");
+        ctx->replan_orphan = 1;
+        pthread_mutex_unlock(&fft_replan_mutex);
+        return;
+    }
+    pthread_mutex_unlock(&fft_replan_mutex);
+
+    fft_destroy(ctx);
+}
+
+void fft_wait_replan(fft_ctx *ctx) {
+    pthread_mutex_lock(&fft_replan_mutex);
+    if (ctx->replan_state != FFT_REPLAN_NONE) {
+        log_debug("Waiting for background re-plan");
+    }
+    while (ctx->replan_state != FFT_REPLAN_NONE)
+        pthread_cond_wait(&fft_replan_cond, &fft_replan_mutex);
+    pthread_mutex_unlock(&fft_replan_mutex);
+}
+
+void fft_replan_stop() {
+    pthread_mutex_lock(&fft_replan_mutex);
+    if (!fft_replan_started || fft_replan_stopping) {
+        pthread_mutex_unlock(&fft_replan_mutex);
+        return;
+    }
+
+    log_debug("Stopping re-plan worker");
+    fft_replan_stopping = 1;
+    pthread_cond_broadcast(&fft_replan_cond);
+    pthread_mutex_unlock(&fft_replan_mutex);
+
+    pthread_join(fft_replan_thread, NULL);
+
+    pthread_mutex_lock(&fft_replan_mutex);
+    fft_replan_started = 0;
+    fft_replan_stopping = 0;
+    pthread_mutex_unlock(&fft_replan_mutex);
+}
+
+static void fft_destroy(fft_ctx *ctx) {
     log_debug("Destroing plan");
-    FFT_destroy_plan(ctx->plan);
+    pthread_mutex_lock(&fft_planner_mutex);
+    if (ctx->plan != NULL)
+        FFT_destroy_plan(ctx->plan);
+    if (ctx->replan != NULL)
+        FFT_destroy_plan(ctx->replan);
+    pthread_mutex_unlock(&fft_planner_mutex);
 
     log_debug("Deallocating buffers");
     switch (ctx->data_type) {
@@ -99,8 +281,191 @@ void fft_free(fft_ctx *ctx) {
 }
 
 void fft_compute(fft_ctx *ctx) {
+    FFT_plan old;
+
+    if (ctx->replan_ready && pthread_mutex_trylock(&fft_replan_mutex) == 0) {
+        log_info("Switching to re-planned FFT");
+        old = ctx->plan;
+        ctx->plan = ctx->replan;
+        ctx->replan = old;
+        ctx->replan_ready = 0;
+        pthread_mutex_unlock(&fft_replan_mutex);
+    }
+
     log_debug("Computing FFT");
-    FFT_execute(ctx->plan);
+    if (ctx->data_type == FFT_DATA_TYPE_COMPLEX)
+        FFT_execute_dft(ctx->plan, ctx->complex_input, ctx->complex_output);
+    else
+        FFT_execute_r2r(ctx->plan, ctx->real_input, ctx->real_output);
+}
+
+static FFT_plan fft_plan_create(fft_ctx *ctx, unsigned int flags, double timelimit, void *input, void *output) {
+    FFT_plan plan;
+    struct timespec start;
+    struct timespec stop;
+    struct timespec diff;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_mutex_lock(&fft_planner_mutex);
+
+    FFT_set_timelimit(timelimit);
+
+    if (ctx->data_type == FFT_DATA_TYPE_COMPLEX)
+        plan = FFT_plan_dft_1d((int) ctx->size, (FFT_complex *) input, (FFT_complex *) output, ctx->sign, flags);
+    else
+        plan = FFT_plan_r2r_1d((int) ctx->size, (FFT_FLOAT *) input, (FFT_FLOAT *) output, ctx->sign, flags);
+
+    FFT_set_timelimit(FFTW_NO_TIMELIMIT);
+
+    pthread_mutex_unlock(&fft_planner_mutex);
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    utils_timespec_sub(&start, &stop, &diff);
+
+    if (plan != NULL) {
+        log_info("FFT plan of size %zu computed in %ld.%03ld s",
+                 ctx->size, (long) diff.tv_sec, diff.tv_nsec / 1000000L);
+    }
+
+    return plan;
+}
+
+// Caller holds fft_replan_mutex, the worker is started on first use
+static int fft_replan_queue(fft_ctx *ctx) {
+    if (fft_replan_stopping)
+        return EXIT_FAILURE;
+
+    if (!fft_replan_started) {
+        log_debug("Starting re-plan worker");
+        if (pthread_create(&fft_replan_thread, NULL, fft_replan_worker, NULL) != 0)
+            return EXIT_FAILURE;
+        fft_replan_started = 1;
+    }
+
+    fft_replan_push(ctx);
+
+    return EXIT_SUCCESS;
+}
+
+static void fft_replan_push(fft_ctx *ctx) {
+    ctx->replan_state = FFT_REPLAN_QUEUED;
+    ctx->replan_next = NULL;
+
+    if (fft_replan_tail == NULL)
+        fft_replan_head = ctx;
+    else
+        fft_replan_tail->replan_next = ctx;
+    fft_replan_tail = ctx;
+
+    pthread_cond_broadcast(&fft_replan_cond);
+}
+
+static fft_ctx *fft_replan_pop() {
+    fft_ctx *ctx;
+
+    ctx = fft_replan_head;
+    fft_replan_head = ctx->replan_next;
+    if (fft_replan_head == NULL)
+        fft_replan_tail = NULL;
+    ctx->replan_next = NULL;
+
+    return ctx;
+}
+
+static FFT_plan fft_replan_compute(fft_ctx *ctx) {
+    FFT_plan plan;
+    void *input;
+    void *output;
+
+    log_debug("Allocating scratch buffers for re-plan");
+    if (ctx->data_type == FFT_DATA_TYPE_COMPLEX) {
+        input = FFT_alloc_complex(ctx->size);
+        output = FFT_alloc_complex(ctx->size);
+    } else {
+        input = FFT_alloc_real(ctx->size);
+        output = FFT_alloc_real(ctx->size);
+    }
+
+    if (input == NULL || output == NULL) {
+        log_error("Unable to allocate scratch buffers for re-plan");
+        FFT_free(input);
+        FFT_free(output);
+        return NULL;
+    }
+
+    log_debug("Computing rigorous plan");
+    plan = fft_plan_create(ctx, fft_rigor_flags(ctx->rigor), FFT_REPLAN_TIMELIMIT, input, output);
+
+    FFT_free(input);
+    FFT_free(output);
+
+    if (plan == NULL) {
+        log_error("Unable to compute rigorous plan");
+    }
+
+    return plan;
+}
+
+// Plans one queued context at a time, the planner is free between two plans
+static void *fft_replan_worker(void *data) {
+    fft_ctx *ctx;
+    FFT_plan plan;
+
+    (void) data;
+
+    pthread_mutex_lock(&fft_replan_mutex);
+    while (!fft_replan_stopping) {
+        if (fft_replan_head == NULL) {
+            pthread_cond_wait(&fft_replan_cond, &fft_replan_mutex);
+            continue;
+        }
+
+        ctx = fft_replan_pop();
+        ctx->replan_state = FFT_REPLAN_RUNNING;
+
+        if (ctx->replan_orphan) {
+            pthread_mutex_unlock(&fft_replan_mutex);
+            fft_destroy(ctx);
+            pthread_mutex_lock(&fft_replan_mutex);
+            continue;
+        }
+
+        pthread_mutex_unlock(&fft_replan_mutex);
+        plan = fft_replan_compute(ctx);
+        if (plan != NULL)
+            fft_wisdom_save();
+        pthread_mutex_lock(&fft_replan_mutex);
+
+        ctx->replan_state = FFT_REPLAN_NONE;
+        if (ctx->replan_orphan) {
+            log_debug("Context freed during re-plan, discarding it");
+            pthread_mutex_unlock(&fft_replan_mutex);
+            if (plan != NULL) {
+                pthread_mutex_lock(&fft_planner_mutex);
+                FFT_destroy_plan(plan);
+                pthread_mutex_unlock(&fft_planner_mutex);
+            }
+            fft_destroy(ctx);
+            pthread_mutex_lock(&fft_replan_mutex);
+        } else if (plan != NULL) {
+            ctx->replan = plan;
+            ctx->replan_ready = 1;
+        }
+        pthread_cond_broadcast(&fft_replan_cond);
+    }
+
+    log_debug("Dropping queued re-plans");
+    while (fft_replan_head != NULL) {
+        ctx = fft_replan_pop();
+        ctx->replan_state = FFT_REPLAN_NONE;
+        if (ctx->replan_orphan)
+            fft_destroy(ctx);
+    }
+    pthread_cond_broadcast(&fft_replan_cond);
+    pthread_mutex_unlock(&fft_replan_mutex);
+
+    return NULL;
 }
 
 int fft_complex_compute(fft_ctx *ctx, FFT_FLOAT complex *input, FFT_FLOAT complex *output) {
@@ -22,9 +22,11 @@
 
 #include <stddef.h>
 #include <complex.h>
+#include <pthread.h>
 #include <fftw3.h>
 
 #include "buildflags.h"
+#include "cfg.h"
 #include "utils.h"
 
 #define FFT_FLOAT FP_FLOAT
@@ -44,6 +46,14 @@
 #define FFT_destroy_plan CONCAT(FFT_prefix, _destroy_plan)
 #define FFT_free CONCAT(FFT_prefix, _free)
 #define FFT_execute CONCAT(FFT_prefix, _execute)
+#define FFT_execute_dft CONCAT(FFT_prefix, _execute_dft)
+#define FFT_execute_r2r CONCAT(FFT_prefix, _execute_r2r)
+#define FFT_import_wisdom_from_filename CONCAT(FFT_prefix, _import_wisdom_from_filename)
+#define FFT_export_wisdom_to_filename CONCAT(FFT_prefix, _export_wisdom_to_filename)
+#define FFT_set_timelimit CONCAT(FFT_prefix, _set_timelimit)
+
+// Upper bound in seconds for one background re-plan, the planner lock is held meanwhile
+#define FFT_REPLAN_TIMELIMIT 1.0
 
 enum fft_data_type_t {
     FFT_DATA_TYPE_COMPLEX = 'C',
@@ -52,9 +62,29 @@ enum fft_data_type_t {
 
 typedef enum fft_data_type_t fft_data_type;
 
+enum fft_replan_state_t {
+    FFT_REPLAN_NONE = 0,
+    FFT_REPLAN_QUEUED,
+    FFT_REPLAN_RUNNING
+};
+
+typedef enum fft_replan_state_t fft_replan_state;
+
+/*
+ * Plans are first looked up in the wisdom (imported from the configured
+ * file) with the requested rigor. When there is no wisdom for them, an
+ * FFTW_ESTIMATE plan is used right away and a background thread computes
+ * the rigorous one, which replaces it at the next fft_compute.
+ *
+ * FFTW planner is not thread safe, so every planner call goes through
+ * a single global mutex.
+ */
+
 struct fft_ctx_t {
     size_t size;
+    int sign;
     fft_data_type data_type;
+    fft_rigor rigor;
 
     FFT_FLOAT *real_input;
     FFT_FLOAT *real_output;
@@ -63,14 +93,32 @@ struct fft_ctx_t {
     FFT_complex *complex_output;
 
     FFT_plan plan;
+
+    FFT_plan replan;
+    volatile int replan_ready;
+    fft_replan_state replan_state;
+    int replan_orphan;
+    struct fft_ctx_t *replan_next;
 };
 
 typedef struct fft_ctx_t fft_ctx;
 
-fft_ctx *fft_init(size_t, int, fft_data_type);
+int fft_wisdom_init(const char *);
+
+void fft_wisdom_save();
+
+void fft_wisdom_free();
+
+unsigned int fft_rigor_flags(fft_rigor);
+
+fft_ctx *fft_init(size_t, int, fft_data_type, fft_rigor);
 
 void fft_free(fft_ctx *);
 
+void fft_wait_replan(fft_ctx *);
+
+void fft_replan_stop();
+
 void fft_compute(fft_ctx *ctx);
 
 int fft_complex_compute(fft_ctx *, FFT_FLOAT complex *, FFT_FLOAT complex *);
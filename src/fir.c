@@ -22,13 +22,21 @@
 #include <string.h>
 
 #include "fir.h"
-#include "fir_lpf.h"
 #include "log.h"
 
-fir_ctx *fir_init(const FP_FLOAT *kernel, size_t kernel_size) {
+fir_ctx *fir_init(const FP_FLOAT *kernel, size_t kernel_size, size_t input_size, size_t decimation) {
     fir_ctx *ctx;
     size_t i;
 
+    log_info("Initializing FIR context");
+
+    if (kernel_size == 0 || decimation == 0 || input_size % decimation != 0) {
+        log_error("Invalid FIR parameters: kernel %zu - input %zu - decimation %zu",
+                  kernel_size, input_size, decimation);
+        return NULL;
+    }
+
+    log_debug("Allocating context");
     ctx = (fir_ctx *) malloc(sizeof(fir_ctx));
     if (ctx == NULL) {
         log_error("Unable to allocate context");
@@ -36,81 +44,161 @@ fir_ctx *fir_init(const FP_FLOAT *kernel, size_t kernel_size) {
     }
 
     ctx->kernel_size = kernel_size;
-
+    ctx->decimation = decimation;
+    ctx->input_size = input_size;
+    ctx->buffer_size = kernel_size - 1 + input_size;
+    ctx->buffer = NULL;
+    ctx->kernel_fixed = NULL;
+    ctx->buffer_fixed = NULL;
+    ctx->output_fixed = NULL;
+
+    log_debug("Allocating kernel buffer");
     ctx->kernel = (FP_FLOAT *) calloc(ctx->kernel_size, sizeof(FP_FLOAT));
     if (ctx->kernel == NULL) {
-        log_error("Unable to allocate kernel buffer_int16");
+        log_error("Unable to allocate kernel buffer");
         fir_free(ctx);
         return NULL;
     }
 
-    ctx->prev = (int8_t *) calloc((ctx->kernel_size - 1), sizeof(int8_t));
-    if (ctx->prev == NULL) {
-        log_error("Unable to allocate previous values buffer_int16");
+    log_debug("Allocating delay line");
+    ctx->buffer = (FP_FLOAT *) calloc(ctx->buffer_size, sizeof(FP_FLOAT));
+    if (ctx->buffer == NULL) {
+        log_error("Unable to allocate delay line");
         fir_free(ctx);
         return NULL;
     }
 
-    for (i = 0; i < ctx->kernel_size; i++)
-        ctx->prev[i] = 0;
+    log_debug("Allocating fixed point buffers");
+    ctx->kernel_fixed = (int16_t *) calloc(ctx->kernel_size, sizeof(int16_t));
+    ctx->buffer_fixed = (int16_t *) calloc(ctx->buffer_size, sizeof(int16_t));
+    ctx->output_fixed = (int32_t *) calloc(ctx->input_size / ctx->decimation, sizeof(int32_t));
+    if (ctx->kernel_fixed == NULL || ctx->buffer_fixed == NULL || ctx->output_fixed == NULL) {
+        log_error("Unable to allocate fixed point buffers");
+        fir_free(ctx);
+        return NULL;
+    }
 
-    memcpy(ctx->kernel, kernel, ctx->kernel_size * sizeof(FP_FLOAT));
+    log_debug("Storing reversed kernel");
+    for (i = 0; i < ctx->kernel_size; i++) {
+        ctx->kernel[i] = kernel[ctx->kernel_size - 1 - i];
+        ctx->kernel_fixed[i] = fixed_from_float(ctx->kernel[i]);
+    }
 
     return ctx;
 }
 
 void fir_free(fir_ctx *ctx) {
-    if (ctx->prev != NULL)
-        free(ctx->prev);
+    log_info("Freeing FIR context");
+
+    if (ctx == NULL)
+        return;
+
+    if (ctx->buffer != NULL)
+        free(ctx->buffer);
 
     if (ctx->kernel != NULL)
         free(ctx->kernel);
 
+    if (ctx->buffer_fixed != NULL)
+        free(ctx->buffer_fixed);
+
+    if (ctx->kernel_fixed != NULL)
+        free(ctx->kernel_fixed);
+
+    if (ctx->output_fixed != NULL)
+        free(ctx->output_fixed);
+
     free(ctx);
 }
 
-int fir_convolve(fir_ctx *ctx, int8_t *output, const int8_t *input, size_t size) {
+size_t fir_compute_output_size(fir_ctx *ctx, size_t input_size) {
+    return input_size / ctx->decimation;
+}
+
+int fir_convolve(fir_ctx *ctx, const FP_FLOAT *input, size_t size, FP_FLOAT *output) {
+    size_t history;
     size_t i;
-    size_t j;
-    ssize_t input_pos;
-    int8_t *item;
-    FP_FLOAT sum;
+    size_t o;
 
-    for (i = 0; i < size; i++) {
-        sum = 0;
+    log_trace("Convolving");
 
-        for (j = 0; j < ctx->kernel_size; j++) {
-            input_pos = i - j;
+    if (size > ctx->input_size || size % ctx->decimation != 0) {
+        log_error("Invalid input size %zu", size);
+        return EXIT_FAILURE;
+    }
 
-            if (input_pos >= 0)
-                item = (int8_t *) &input[input_pos];
-            else
-                item = &ctx->prev[ctx->kernel_size + input_pos];
+    history = ctx->kernel_size - 1;
 
-            sum += (*item) * (ctx->kernel[j]);
-        }
+    memcpy(ctx->buffer + history, input, size * sizeof(FP_FLOAT));
 
-        output[i] = (int8_t) sum;
+    for (i = ctx->decimation - 1, o = 0; i < size; i += ctx->decimation, o++)
+        output[o] = fir_dot(ctx->kernel, ctx->buffer + i, ctx->kernel_size);
+
+    memmove(ctx->buffer, ctx->buffer + size, history * sizeof(FP_FLOAT));
+
+    return EXIT_SUCCESS;
+}
+
+int fir_convolve_fixed(fir_ctx *ctx, const int16_t *input, size_t size, int16_t *output) {
+    size_t history;
+    size_t i;
+    size_t o;
+
+    log_trace("Convolving fixed point");
+
+    if (size > ctx->input_size || size % ctx->decimation != 0) {
+        log_error("Invalid input size %zu", size);
+        return EXIT_FAILURE;
     }
 
-    memcpy(ctx->prev, &input[size - ctx->kernel_size], (ctx->kernel_size - 1) * sizeof(int8_t));
+    history = ctx->kernel_size - 1;
+
+    memcpy(ctx->buffer_fixed + history, input, size * sizeof(int16_t));
+
+    for (i = ctx->decimation - 1, o = 0; i < size; i += ctx->decimation, o++)
+        ctx->output_fixed[o] = fixed_dot(ctx->kernel_fixed, ctx->buffer_fixed + i, ctx->kernel_size);
+
+    fixed_narrow(ctx->output_fixed, output, o);
+
+    memmove(ctx->buffer_fixed, ctx->buffer_fixed + size, history * sizeof(int16_t));
 
     return EXIT_SUCCESS;
 }
 
-fir_ctx *fir_init_lpf(int number) {
-    switch (number) {
-        case 1:
-            return fir_init(fir_kernel_lpf1_filter_taps, FIR_KERNEL_LPF1_TAP_NUM);
-        case 2:
-            return fir_init(fir_kernel_lpf2_filter_taps, FIR_KERNEL_LPF2_TAP_NUM);
-        case 3:
-            return fir_init(fir_kernel_lpf3_filter_taps, FIR_KERNEL_LPF3_TAP_NUM);
-        case 4:
-            return fir_init(fir_kernel_lpf4_filter_taps, FIR_KERNEL_LPF4_TAP_NUM);
-        case 5:
-            return fir_init(fir_kernel_lpf5_filter_taps, FIR_KERNEL_LPF5_TAP_NUM);
-        default:
-            return NULL;
+FP_FLOAT fir_dot(const FP_FLOAT *a, const FP_FLOAT *b, size_t size) {
+    FP_FLOAT sum;
+    size_t i;
+#ifdef FIR_SIMD_ENABLED
+    fir_simd acc0 = {0};
+    fir_simd acc1 = {0};
+    fir_simd va0;
+    fir_simd va1;
+    fir_simd vb0;
+    fir_simd vb1;
+    size_t l;
+#endif
+
+    sum = 0;
+    i = 0;
+
+#ifdef FIR_SIMD_ENABLED
+    for (; i + 2 * FIR_SIMD_LANES <= size; i += 2 * FIR_SIMD_LANES) {
+        memcpy(&va0, a + i, sizeof(fir_simd));
+        memcpy(&vb0, b + i, sizeof(fir_simd));
+        memcpy(&va1, a + i + FIR_SIMD_LANES, sizeof(fir_simd));
+        memcpy(&vb1, b + i + FIR_SIMD_LANES, sizeof(fir_simd));
+
+        acc0 += va0 * vb0;
+        acc1 += va1 * vb1;
     }
+
+    acc0 += acc1;
+    for (l = 0; l < FIR_SIMD_LANES; l++)
+        sum += acc0[l];
+#endif
+
+    for (; i < size; i++)
+        sum += a[i] * b[i];
+
+    return sum;
 }
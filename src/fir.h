@@ -21,23 +21,60 @@
 #define __RTLSDR_RADIO__FIR__H
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include "buildflags.h"
+#include "fixed.h"
+
+/*
+ * The delay line keeps the last kernel_size - 1 input samples followed by the
+ * current block, so each output is a plain dot product between the reversed
+ * kernel and a contiguous window of the delay line.
+ *
+ * When the compiler supports vector extensions, the dot product is computed
+ * FIR_SIMD_BYTES at a time (4 floats or 2 doubles per lane group).
+ *
+ * fir_convolve_fixed does the same on Q15 samples with a Q15 copy of the
+ * kernel; the int32 accumulator cannot overflow as long as the sum of the
+ * absolute values of the taps stays below 2, which holds for low-pass
+ * kernels.
+ */
+
+#if defined(__GNUC__) && !defined(RTLSDR_RADIO_FP_LONG_DOUBLE)
+#define FIR_SIMD_ENABLED
+#define FIR_SIMD_BYTES 16
+#define FIR_SIMD_LANES (FIR_SIMD_BYTES / sizeof(FP_FLOAT))
+
+typedef FP_FLOAT fir_simd __attribute__ ((vector_size (FIR_SIMD_BYTES)));
+#endif
 
 struct fir_ctx_t {
     size_t kernel_size;
     FP_FLOAT *kernel;
-    int8_t *prev;
+    int16_t *kernel_fixed;
+
+    size_t decimation;
+
+    size_t input_size;
+
+    size_t buffer_size;
+    FP_FLOAT *buffer;
+    int16_t *buffer_fixed;
+    int32_t *output_fixed;
 };
 
 typedef struct fir_ctx_t fir_ctx;
 
-fir_ctx *fir_init(const FP_FLOAT *, size_t);
+fir_ctx *fir_init(const FP_FLOAT *, size_t, size_t, size_t);
 
 void fir_free(fir_ctx *);
 
-int fir_convolve(fir_ctx *ctx, int8_t *output, const int8_t *input, size_t size);
+size_t fir_compute_output_size(fir_ctx *, size_t);
+
+int fir_convolve(fir_ctx *, const FP_FLOAT *, size_t, FP_FLOAT *);
+
+int fir_convolve_fixed(fir_ctx *, const int16_t *, size_t, int16_t *);
 
-fir_ctx *fir_init_lpf(int);
+FP_FLOAT fir_dot(const FP_FLOAT *, const FP_FLOAT *, size_t);
 
 #endif
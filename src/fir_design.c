@@ -0,0 +1,564 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "fir_design.h"
+#include "log.h"
+
+struct fir_design_window_t {
+    const char *name;
+    double attenuation;
+    double width;
+    double a0;
+    double a1;
+    double a2;
+};
+
+typedef struct fir_design_window_t fir_design_window;
+
+static const fir_design_window fir_design_windows[] = {
+        {"Hann",     44, 3.1, 0.5,  0.5,  0},
+        {"Hamming",  53, 3.3, 0.54, 0.46, 0},
+        {"Blackman", 74, 5.5, 0.42, 0.5,  0.08}
+};
+
+static fir_design *fir_design_cache = NULL;
+static pthread_mutex_t fir_design_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t fir_design_odd(double);
+
+static double fir_design_sinc(double, double);
+
+static void fir_design_normalize(FP_FLOAT *, size_t);
+
+static double fir_design_remez_eval(double, const double *, const size_t *, const double *, const double *, size_t);
+
+const fir_design *fir_design_get(const fir_design_params *params) {
+    fir_design *design;
+
+    log_info("Getting FIR design");
+
+    pthread_mutex_lock(&fir_design_cache_mutex);
+
+    log_debug("Looking for cached design");
+    for (design = fir_design_cache; design != NULL; design = design->next)
+        if (memcmp(&design->params, params, sizeof(fir_design_params)) == 0)
+            break;
+
+    if (design == NULL) {
+        log_debug("Design not cached, computing");
+        design = fir_design_compute(params);
+        if (design != NULL) {
+            design->next = fir_design_cache;
+            fir_design_cache = design;
+        }
+    }
+
+    pthread_mutex_unlock(&fir_design_cache_mutex);
+
+    return design;
+}
+
+void fir_design_cache_free() {
+    fir_design *design;
+
+    log_info("Freeing FIR design cache");
+
+    pthread_mutex_lock(&fir_design_cache_mutex);
+
+    while (fir_design_cache != NULL) {
+        design = fir_design_cache;
+        fir_design_cache = design->next;
+        fir_design_free(design);
+    }
+
+    pthread_mutex_unlock(&fir_design_cache_mutex);
+}
+
+fir_design *fir_design_compute(const fir_design_params *params) {
+    fir_design *design;
+    double cutoff;
+    double transition;
+    double attenuation;
+
+    log_info("Computing FIR design");
+
+    if (params->sample_rate == 0 || params->transition == 0 || params->transition >= 2 * params->cutoff
+        || 2 * params->cutoff + params->transition >= params->sample_rate) {
+        log_error("Invalid FIR design: rate %u - cutoff %u - transition %u",
+                  params->sample_rate, params->cutoff, params->transition);
+        return NULL;
+    }
+
+    log_debug("Allocating design");
+    design = (fir_design *) malloc(sizeof(fir_design));
+    if (design == NULL) {
+        log_error("Unable to allocate design");
+        return NULL;
+    }
+
+    memset(&design->params, 0, sizeof(fir_design_params));
+    design->params.type = params->type;
+    design->params.sample_rate = params->sample_rate;
+    design->params.cutoff = params->cutoff;
+    design->params.transition = params->transition;
+    design->params.attenuation = params->attenuation;
+    design->taps_size = 0;
+    design->taps = NULL;
+    design->next = NULL;
+
+    cutoff = (double) params->cutoff / params->sample_rate;
+    transition = (double) params->transition / params->sample_rate;
+    attenuation = (double) params->attenuation;
+
+    switch (params->type) {
+
+        case FIR_DESIGN_TYPE_WINDOWED_SINC:
+            design->taps = fir_design_windowed_sinc(cutoff, transition, attenuation, &design->taps_size);
+            break;
+
+        case FIR_DESIGN_TYPE_KAISER:
+            design->taps = fir_design_kaiser(cutoff, transition, attenuation, &design->taps_size);
+            break;
+
+        case FIR_DESIGN_TYPE_EQUIRIPPLE:
+            design->taps = fir_design_equiripple(cutoff, transition, attenuation, &design->taps_size);
+            break;
+
+        default:
+            log_error("Not implemented");
+    }
+
+    if (design->taps == NULL) {
+        log_error("Unable to design filter");
+        fir_design_free(design);
+        return NULL;
+    }
+
+    log_debug("Designed %zu taps", design->taps_size);
+
+    return design;
+}
+
+void fir_design_free(fir_design *design) {
+    if (design == NULL)
+        return;
+
+    if (design->taps != NULL)
+        free(design->taps);
+
+    free(design);
+}
+
+FP_FLOAT *fir_design_windowed_sinc(double cutoff, double transition, double attenuation, size_t *taps_size) {
+    const fir_design_window *window;
+    FP_FLOAT *taps;
+    double w;
+    size_t size;
+    size_t i;
+    size_t n;
+
+    n = sizeof(fir_design_windows) / sizeof(fir_design_window);
+    for (i = 0; i < n - 1; i++)
+        if (fir_design_windows[i].attenuation >= attenuation)
+            break;
+
+    window = &fir_design_windows[i];
+    if (window->attenuation < attenuation) {
+        log_warn("Attenuation %.0f dB not reachable with windowed sinc, using %s window", attenuation, window->name);
+    }
+
+    size = fir_design_odd(window->width / transition);
+    if (size > FIR_DESIGN_TAPS_MAX) {
+        log_error("Too many taps: %zu", size);
+        return NULL;
+    }
+
+    log_debug("Windowed sinc with %s window and %zu taps", window->name, size);
+
+    taps = (FP_FLOAT *) calloc(size, sizeof(FP_FLOAT));
+    if (taps == NULL) {
+        log_error("Unable to allocate taps");
+        return NULL;
+    }
+
+    for (i = 0; i < size; i++) {
+        w = window->a0
+            - window->a1 * cos(2 * M_PI * (double) i / (double) (size - 1))
+            + window->a2 * cos(4 * M_PI * (double) i / (double) (size - 1));
+        taps[i] = (FP_FLOAT) (fir_design_sinc(cutoff, (double) i - (double) (size - 1) / 2) * w);
+    }
+
+    fir_design_normalize(taps, size);
+
+    *taps_size = size;
+
+    return taps;
+}
+
+FP_FLOAT *fir_design_kaiser(double cutoff, double transition, double attenuation, size_t *taps_size) {
+    FP_FLOAT *taps;
+    double beta;
+    double r;
+    size_t size;
+    size_t i;
+
+    if (attenuation > 50)
+        beta = 0.1102 * (attenuation - 8.7);
+    else if (attenuation >= 21)
+        beta = 0.5842 * pow(attenuation - 21, 0.4) + 0.07886 * (attenuation - 21);
+    else
+        beta = 0;
+
+    size = fir_design_odd((attenuation - 8) / (2.285 * 2 * M_PI * transition) + 1);
+    if (size > FIR_DESIGN_TAPS_MAX) {
+        log_error("Too many taps: %zu", size);
+        return NULL;
+    }
+
+    log_debug("Kaiser window with beta %.3f and %zu taps", beta, size);
+
+    taps = (FP_FLOAT *) calloc(size, sizeof(FP_FLOAT));
+    if (taps == NULL) {
+        log_error("Unable to allocate taps");
+        return NULL;
+    }
+
+    for (i = 0; i < size; i++) {
+        r = size > 1 ? 2 * (double) i / (double) (size - 1) - 1 : 0;
+        taps[i] = (FP_FLOAT) (fir_design_sinc(cutoff, (double) i - (double) (size - 1) / 2)
+                              * fir_design_bessel_i0(beta * sqrt(1 - r * r)) / fir_design_bessel_i0(beta));
+    }
+
+    fir_design_normalize(taps, size);
+
+    *taps_size = size;
+
+    return taps;
+}
+
+FP_FLOAT *fir_design_equiripple(double cutoff, double transition, double attenuation, size_t *taps_size) {
+    FP_FLOAT *taps;
+    FP_FLOAT *best;
+    double stopband_ripple;
+    double passband_ripple;
+    double weight;
+    double delta;
+    size_t size;
+
+    passband_ripple = FIR_DESIGN_REMEZ_PASSBAND_RIPPLE;
+    stopband_ripple = pow(10, -attenuation / 20);
+    weight = passband_ripple / stopband_ripple;
+
+    size = fir_design_odd((-20 * log10(sqrt(passband_ripple * stopband_ripple)) - 13) / (14.6 * transition) + 1);
+    if (size < 5)
+        size = 5;
+
+    log_debug("Equiripple estimate: %zu taps", size);
+
+    taps = (FP_FLOAT *) calloc(FIR_DESIGN_TAPS_MAX, sizeof(FP_FLOAT));
+    best = (FP_FLOAT *) calloc(FIR_DESIGN_TAPS_MAX, sizeof(FP_FLOAT));
+    if (taps == NULL || best == NULL) {
+        log_error("Unable to allocate taps");
+        free(taps);
+        free(best);
+        return NULL;
+    }
+
+    *taps_size = 0;
+
+    log_debug("Growing until the spec is met");
+    while (size <= FIR_DESIGN_TAPS_MAX) {
+        if (fir_design_remez(taps, size, cutoff - transition / 2, cutoff + transition / 2, weight, &delta)
+            == EXIT_SUCCESS && delta <= passband_ripple)
+            break;
+
+        size += 2;
+    }
+
+    if (size > FIR_DESIGN_TAPS_MAX) {
+        log_error("Unable to meet the spec within %d taps", FIR_DESIGN_TAPS_MAX);
+        free(taps);
+        free(best);
+        return NULL;
+    }
+
+    log_debug("Shrinking while the spec is still met");
+    do {
+        memcpy(best, taps, size * sizeof(FP_FLOAT));
+        *taps_size = size;
+        size -= 2;
+    } while (size >= 5
+             && fir_design_remez(taps, size, cutoff - transition / 2, cutoff + transition / 2, weight, &delta)
+                == EXIT_SUCCESS && delta <= passband_ripple);
+
+    free(taps);
+
+    log_debug("Equiripple with %zu taps", *taps_size);
+
+    return best;
+}
+
+int fir_design_remez(FP_FLOAT *taps, size_t size, double pass, double stop, double weight, double *delta) {
+    size_t half;
+    size_t r;
+    size_t grid_size;
+    size_t pass_size;
+    size_t cand_size;
+    size_t *indexes;
+    size_t *ext;
+    size_t *cand;
+    double *values;
+    double *grid;
+    double *x;
+    double *d;
+    double *w;
+    double *e;
+    double *ad;
+    double *bd;
+    double *c;
+    double num;
+    double den;
+    double dev;
+    double max_err;
+    double t;
+    int ret;
+    int it;
+    size_t i;
+    size_t j;
+    size_t k;
+
+    half = (size - 1) / 2;
+    r = half + 1;
+
+    pass_size = (size_t) ceil(FIR_DESIGN_REMEZ_GRID_DENSITY * r * pass / (pass + 0.5 - stop));
+    if (pass_size < 2)
+        pass_size = 2;
+    grid_size = pass_size + (size_t) ceil(FIR_DESIGN_REMEZ_GRID_DENSITY * r * (0.5 - stop) / (pass + 0.5 - stop));
+    if (grid_size < pass_size + r + 1)
+        grid_size = pass_size + r + 1;
+
+    values = (double *) calloc(5 * grid_size + 3 * r + 1, sizeof(double));
+    indexes = (size_t *) calloc(grid_size + r + 1, sizeof(size_t));
+    if (values == NULL || indexes == NULL) {
+        log_error("Unable to allocate Remez buffers");
+        free(values);
+        free(indexes);
+        return EXIT_FAILURE;
+    }
+
+    grid = values;
+    x = grid + grid_size;
+    d = x + grid_size;
+    w = d + grid_size;
+    e = w + grid_size;
+    ad = e + grid_size;
+    bd = ad + r + 1;
+    c = bd + r;
+
+    cand = indexes;
+    ext = cand + grid_size;
+
+    for (j = 0; j < pass_size; j++) {
+        grid[j] = pass * (double) j / (double) (pass_size - 1);
+        d[j] = 1;
+        w[j] = 1;
+    }
+
+    for (j = pass_size; j < grid_size; j++) {
+        grid[j] = stop + (0.5 - stop) * (double) (j - pass_size) / (double) (grid_size - pass_size - 1);
+        d[j] = 0;
+        w[j] = weight;
+    }
+
+    for (j = 0; j < grid_size; j++)
+        x[j] = cos(2 * M_PI * grid[j]);
+
+    for (k = 0; k <= r; k++)
+        ext[k] = k * (grid_size - 1) / r;
+
+    ret = EXIT_SUCCESS;
+    max_err = 0;
+
+    for (it = 0; it < FIR_DESIGN_REMEZ_ITERATIONS; it++) {
+        for (k = 0; k <= r; k++) {
+            ad[k] = 1;
+            for (i = 0; i <= r; i++)
+                if (i != k)
+                    ad[k] *= 2 * (x[ext[k]] - x[ext[i]]);
+            ad[k] = 1 / ad[k];
+        }
+
+        num = 0;
+        den = 0;
+        for (k = 0; k <= r; k++) {
+            num += ad[k] * d[ext[k]];
+            den += ad[k] * (k % 2 == 0 ? 1 : -1) / w[ext[k]];
+        }
+        dev = num / den;
+
+        for (k = 0; k < r; k++) {
+            c[k] = d[ext[k]] - (k % 2 == 0 ? 1 : -1) * dev / w[ext[k]];
+            bd[k] = 1;
+            for (i = 0; i < r; i++)
+                if (i != k)
+                    bd[k] *= 2 * (x[ext[k]] - x[ext[i]]);
+            bd[k] = 1 / bd[k];
+        }
+
+        max_err = 0;
+        for (j = 0; j < grid_size; j++) {
+            e[j] = w[j] * (d[j] - fir_design_remez_eval(x[j], x, ext, bd, c, r));
+            if (fabs(e[j]) > max_err)
+                max_err = fabs(e[j]);
+        }
+
+        if (max_err - fabs(dev) <= 1e-6 * fabs(dev) || it == FIR_DESIGN_REMEZ_ITERATIONS - 1)
+            break;
+
+        cand_size = 0;
+        for (j = 0; j < grid_size; j++) {
+            t = e[j] > 0 ? 1 : -1;
+            if (j > 0 && j != pass_size && t * e[j - 1] > t * e[j])
+                continue;
+            if (j < grid_size - 1 && j + 1 != pass_size && t * e[j + 1] > t * e[j])
+                continue;
+
+            if (cand_size > 0 && (e[cand[cand_size - 1]] > 0) == (e[j] > 0)) {
+                if (fabs(e[j]) > fabs(e[cand[cand_size - 1]]))
+                    cand[cand_size - 1] = j;
+                continue;
+            }
+
+            cand[cand_size] = j;
+            cand_size++;
+        }
+
+        if (cand_size < r + 1) {
+            ret = EXIT_FAILURE;
+            break;
+        }
+
+        i = 0;
+        while (cand_size - i > r + 1) {
+            if (fabs(e[cand[i]]) < fabs(e[cand[cand_size - 1]]))
+                i++;
+            else
+                cand_size--;
+        }
+
+        for (k = 0; k <= r; k++)
+            ext[k] = cand[i + k];
+    }
+
+    if (ret == EXIT_SUCCESS) {
+        for (j = 0; j <= half; j++)
+            e[j] = fir_design_remez_eval(cos(2 * M_PI * (double) j / (double) size), x, ext, bd, c, r);
+
+        for (i = 0; i <= half; i++) {
+            t = e[0];
+            for (j = 1; j <= half; j++)
+                t += 2 * e[j] * cos(2 * M_PI * (double) j * (double) i / (double) size);
+            taps[half + i] = (FP_FLOAT) (t / (double) size);
+            taps[half - i] = taps[half + i];
+        }
+
+        *delta = max_err;
+    }
+
+    free(values);
+    free(indexes);
+
+    return ret;
+}
+
+double fir_design_bessel_i0(double x) {
+    double sum;
+    double term;
+    int k;
+
+    sum = 1;
+    term = 1;
+
+    for (k = 1; k < 64; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+
+    return sum;
+}
+
+static size_t fir_design_odd(double value) {
+    size_t size;
+
+    size = (size_t) ceil(value);
+    if (size < 1)
+        size = 1;
+
+    return size % 2 == 0 ? size + 1 : size;
+}
+
+static double fir_design_sinc(double cutoff, double n) {
+    if (n == 0)
+        return 2 * cutoff;
+
+    return sin(2 * M_PI * cutoff * n) / (M_PI * n);
+}
+
+static void fir_design_normalize(FP_FLOAT *taps, size_t size) {
+    FP_FLOAT sum;
+    size_t i;
+
+    sum = 0;
+    for (i = 0; i < size; i++)
+        sum += taps[i];
+
+    for (i = 0; i < size; i++)
+        taps[i] /= sum;
+}
+
+static double fir_design_remez_eval(double xx, const double *x, const size_t *ext,
+                                    const double *bd, const double *c, size_t r) {
+    double num;
+    double den;
+    double t;
+    size_t k;
+
+    num = 0;
+    den = 0;
+
+    for (k = 0; k < r; k++) {
+        t = xx - x[ext[k]];
+        if (fabs(t) < 1e-12)
+            return c[k];
+
+        t = bd[k] / t;
+        num += t * c[k];
+        den += t;
+    }
+
+    return num / den;
+}
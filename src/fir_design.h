@@ -0,0 +1,91 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__FIR_DESIGN__H
+#define __RTLSDR_RADIO__FIR_DESIGN__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "buildflags.h"
+
+/*
+ * Low-pass FIR designer. Every design is described by its sample rate,
+ * cutoff (center of the transition band), transition width and stopband
+ * attenuation; the number of taps is the minimum one meeting the spec.
+ *
+ * Designs are cached by their parameters, so the same filter requested by
+ * different stages is computed only once.
+ */
+
+#define FIR_DESIGN_TAPS_MAX 4095
+
+#define FIR_DESIGN_REMEZ_GRID_DENSITY 16
+#define FIR_DESIGN_REMEZ_ITERATIONS 64
+#define FIR_DESIGN_REMEZ_PASSBAND_RIPPLE 0.01
+
+enum fir_design_type_t {
+    FIR_DESIGN_TYPE_WINDOWED_SINC = 'w',
+    FIR_DESIGN_TYPE_KAISER = 'k',
+    FIR_DESIGN_TYPE_EQUIRIPPLE = 'e'
+};
+
+typedef enum fir_design_type_t fir_design_type;
+
+struct fir_design_params_t {
+    fir_design_type type;
+
+    uint32_t sample_rate;
+    uint32_t cutoff;
+    uint32_t transition;
+    uint32_t attenuation;
+};
+
+typedef struct fir_design_params_t fir_design_params;
+
+struct fir_design_t {
+    fir_design_params params;
+
+    size_t taps_size;
+    FP_FLOAT *taps;
+
+    struct fir_design_t *next;
+};
+
+typedef struct fir_design_t fir_design;
+
+const fir_design *fir_design_get(const fir_design_params *);
+
+void fir_design_cache_free();
+
+fir_design *fir_design_compute(const fir_design_params *);
+
+void fir_design_free(fir_design *);
+
+FP_FLOAT *fir_design_windowed_sinc(double, double, double, size_t *);
+
+FP_FLOAT *fir_design_kaiser(double, double, double, size_t *);
+
+FP_FLOAT *fir_design_equiripple(double, double, double, size_t *);
+
+int fir_design_remez(FP_FLOAT *, size_t, double, double, double, double *);
+
+double fir_design_bessel_i0(double);
+
+#endif
@@ -1,959 +0,0 @@
-/*
- * rtlsdr-radio
- * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
- *
- * This program is free software: you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation, either version 3 of the License.
- *
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License
- * along with this program.  If not, see <https://www.gnu.org/licenses/>.
- *
- */
-
-
-#ifndef __RTLSDR_RADIO__FIR_LPF__H
-#define __RTLSDR_RADIO__FIR_LPF__H
-
-#include "buildflags.h"
-
-/*
-
-FIR filter designed with
-http://t-filter.appspot.com
-
-sampling frequency: 256000 Hz
-
-* 0 Hz - 3500 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 4.106803220329853 dB
-
-* 5000 Hz - 128000 Hz
-  gain = 0
-  desired attenuation = -20 dB
-  actual attenuation = -20.139690323946475 dB
-
-*/
-
-#define FIR_KERNEL_LPF1_TAP_NUM 97
-
-static FP_FLOAT fir_kernel_lpf1_filter_taps[FIR_KERNEL_LPF1_TAP_NUM] = {
-        -0.051298747163170705,
-        -0.004099165537033711,
-        -0.004180429443577068,
-        -0.004206473811560699,
-        -0.004171931255908463,
-        -0.004071323134638165,
-        -0.0038931303207846617,
-        -0.003640054918186207,
-        -0.003350555159048662,
-        -0.0029506312789688675,
-        -0.0024888855043200715,
-        -0.0019469401423248892,
-        -0.001327203294293466,
-        -0.000632142520272416,
-        0.00014458749566717988,
-        0.0010010069753050718,
-        0.001922337961670564,
-        0.00292255612645123,
-        0.003986893820942631,
-        0.005115701977531208,
-        0.006304533368009584,
-        0.007543544029479012,
-        0.00883363200400465,
-        0.010166819530978888,
-        0.011532614664046719,
-        0.012932061285409299,
-        0.01435266537881081,
-        0.01578871641734517,
-        0.017235624301330965,
-        0.01867790401577318,
-        0.020117927446764272,
-        0.021539576678351782,
-        0.022933078163482834,
-        0.02429593485990434,
-        0.025615663330664958,
-        0.02688222239987326,
-        0.028095336353071723,
-        0.029225847506838896,
-        0.03029875030053963,
-        0.03128647487066252,
-        0.032181543130736866,
-        0.032987197342523436,
-        0.033698601100619854,
-        0.03430417368646,
-        0.03487797009933638,
-        0.03518307715542657,
-        0.0355039326145189,
-        0.035712314871077594,
-        0.03578255907544505,
-        0.035712314871077594,
-        0.0355039326145189,
-        0.03518307715542657,
-        0.03487797009933638,
-        0.03430417368646,
-        0.033698601100619854,
-        0.032987197342523436,
-        0.032181543130736866,
-        0.03128647487066252,
-        0.03029875030053963,
-        0.029225847506838896,
-        0.028095336353071723,
-        0.02688222239987326,
-        0.025615663330664958,
-        0.02429593485990434,
-        0.022933078163482834,
-        0.021539576678351782,
-        0.020117927446764272,
-        0.01867790401577318,
-        0.017235624301330965,
-        0.01578871641734517,
-        0.01435266537881081,
-        0.012932061285409299,
-        0.011532614664046719,
-        0.010166819530978888,
-        0.00883363200400465,
-        0.007543544029479012,
-        0.006304533368009584,
-        0.005115701977531208,
-        0.003986893820942631,
-        0.00292255612645123,
-        0.001922337961670564,
-        0.0010010069753050718,
-        0.00014458749566717988,
-        -0.000632142520272416,
-        -0.001327203294293466,
-        -0.0019469401423248892,
-        -0.0024888855043200715,
-        -0.0029506312789688675,
-        -0.003350555159048662,
-        -0.003640054918186207,
-        -0.0038931303207846617,
-        -0.004071323134638165,
-        -0.004171931255908463,
-        -0.004206473811560699,
-        -0.004180429443577068,
-        -0.004099165537033711,
-        -0.051298747163170705
-};
-
-
-/*
-
-FIR filter designed with
- http://t-filter.appspot.com
-
-sampling frequency: 256000 Hz
-
-* 0 Hz - 3000 Hz
-  gain = 1
-  desired ripple = 10 dB
-  actual ripple = 10.07342030574804 dB
-
-* 4000 Hz - 128000 Hz
-  gain = 0
-  desired attenuation = -80 dB
-  actual attenuation = -80.07910820343137 dB
-
-*/
-
-#define FIR_KERNEL_LPF2_TAP_NUM 431
-
-static FP_FLOAT fir_kernel_lpf2_filter_taps[FIR_KERNEL_LPF2_TAP_NUM] = {
-        -0.00006206339989040454,
-        -0.000027719794077257308,
-        -0.00003376497555965666,
-        -0.000040570967456494595,
-        -0.000048183697807799624,
-        -0.00005665091596618633,
-        -0.0000660134380588213,
-        -0.00007631889418527722,
-        -0.00008759897640206701,
-        -0.00009989772506066183,
-        -0.00011324087296686662,
-        -0.00012765705851650855,
-        -0.00014317275331006657,
-        -0.00015979962346099436,
-        -0.00017755194291552197,
-        -0.00019643431591661022,
-        -0.0002164418338133301,
-        -0.0002375625425190539,
-        -0.0002597793171263142,
-        -0.0002830633093877374,
-        -0.0003073727222229766,
-        -0.0003326613835601459,
-        -0.00035886928184762916,
-        -0.0003859230927374626,
-        -0.00041373964687695233,
-        -0.0004422243707134662,
-        -0.00047126968797673,
-        -0.0005007539712453431,
-        -0.0005305445174724294,
-        -0.0005604955118788564,
-        -0.0005904492581511841,
-        -0.0006202339555835284,
-        -0.0006496625182456606,
-        -0.0006785369554303315,
-        -0.0007066468011838411,
-        -0.0007337677089503433,
-        -0.0007596618085043226,
-        -0.0007840808011855785,
-        -0.000806765645109431,
-        -0.0008274467055839751,
-        -0.0008458465111466572,
-        -0.0008616783722948005,
-        -0.0008746485380942947,
-        -0.0008844579273069166,
-        -0.000890802476812074,
-        -0.0008933731114150303,
-        -0.0008918571525123297,
-        -0.0008859405669042607,
-        -0.0008753085408928514,
-        -0.0008596502623202041,
-        -0.0008386594577531522,
-        -0.0008120346727726441,
-        -0.0007794832300803786,
-        -0.0007407237451187581,
-        -0.000695486509394975,
-        -0.0006435124789559279,
-        -0.0005845572698362794,
-        -0.0005183921293996749,
-        -0.00044480726847229255,
-        -0.00036361619007235085,
-        -0.0002746558384235003,
-        -0.00017779141599258178,
-        -0.00007291745747770354,
-        0.000040042790511995335,
-        0.00016113927231773155,
-        0.0002903902836857423,
-        0.0004277797782454728,
-        0.0005732602295096151,
-        0.000726740626200138,
-        0.0008880852446547268,
-        0.0010571175363889296,
-        0.0012336234142536577,
-        0.0014173535435934963,
-        0.001608022600790913,
-        0.0018053073242181247,
-        0.002008822203561615,
-        0.002218129167231367,
-        0.0024327503766989047,
-        0.002652180780963496,
-        0.0028759060563174348,
-        0.0031033434619087727,
-        0.0033338230067350935,
-        0.0035666315372629826,
-        0.0038011376930096965,
-        0.004036674432244893,
-        0.004272224074794212,
-        0.004507242322312256,
-        0.004740732542446031,
-        0.00497190062684576,
-        0.005199849189427117,
-        0.005423676483969745,
-        0.005642471355757043,
-        0.005855294001186753,
-        0.006061220710163648,
-        0.006259295809303252,
-        0.0064485848100731555,
-        0.0066281503208488884,
-        0.006797053787644911,
-        0.0069543845011445435,
-        0.007099240813545138,
-        0.007230740785089176,
-        0.007348031907285498,
-        0.00745029748995376,
-        0.007536750926922235,
-        0.00760664532924302,
-        0.007659287701952713,
-        0.007694030002295014,
-        0.007710276769793386,
-        0.007707492675743672,
-        0.007685207031874112,
-        0.007643016534137792,
-        0.007580586871220126,
-        0.007497658783299586,
-        0.0073940513124652,
-        0.007269667983488756,
-        0.007124494374978435,
-        0.006958599568131674,
-        0.006772143457352052,
-        0.006565377030679099,
-        0.006338643014211194,
-        0.006092376537639479,
-        0.0058271073388043715,
-        0.005543458517025799,
-        0.005242147484085504,
-        0.004923986516972895,
-        0.004589877929922167,
-        0.0042408138438976535,
-        0.0038778751454169496,
-        0.0035022300500638466,
-        0.003115131436657766,
-        0.0027179132886108654,
-        0.002311985518841573,
-        0.0018988284857825372,
-        0.0014799917939572092,
-        0.001057087467741617,
-        0.0006317838031791465,
-        0.000205801422045513,
-        -0.0002190924077202417,
-        -0.0006410907288682408,
-        -0.0010583548918470086,
-        -0.0014690204948233782,
-        -0.001871207237685343,
-        -0.002263024527036142,
-        -0.0026425779629200485,
-        -0.00300797876379342,
-        -0.0033573490775895766,
-        -0.0036888321761020452,
-        -0.004000603352392086,
-        -0.004290879447091839,
-        -0.0045579206828686575,
-        -0.004800038325366563,
-        -0.005015607117572998,
-        -0.005203069598804959,
-        -0.005360950355515643,
-        -0.005487862988928806,
-        -0.0055825114426830275,
-        -0.005643692974106227,
-        -0.005670310850005453,
-        -0.005661390330788742,
-        -0.00561607551125261,
-        -0.005533635531224416,
-        -0.0054134561009845945,
-        -0.005255055686007765,
-        -0.005058113686082446,
-        -0.004822444554483181,
-        -0.004547989710894641,
-        -0.004234833979238277,
-        -0.0038832532395640957,
-        -0.0034936444836145895,
-        -0.0030665125636581314,
-        -0.0026026211744391704,
-        -0.002102761261313228,
-        -0.0015679634580924341,
-        -0.000999355560761932,
-        -0.00039822641663914105,
-        0.00023399328453464709,
-        0.0008957548840071729,
-        0.001585343899527155,
-        0.0023009688223680886,
-        0.003040666808722624,
-        0.0038023929634727347,
-        0.004583995649678666,
-        0.005383200892133849,
-        0.006197661829254983,
-        0.007024949058869698,
-        0.007862551851441003,
-        0.008707889830141959,
-        0.00955833981937523,
-        0.010411232087891761,
-        0.011263850846167042,
-        0.012113460940738572,
-        0.012957314538633007,
-        0.013792661690403626,
-        0.014616756991299495,
-        0.0154268705481583,
-        0.01622030371109197,
-        0.016994400289550002,
-        0.01774655494337078,
-        0.018474217532113046,
-        0.01917491031449632,
-        0.01984623924750957,
-        0.02048590090683959,
-        0.021091693608099645,
-        0.0216615243039222,
-        0.02219341660258619,
-        0.022685519417764456,
-        0.023136118264690305,
-        0.023543639979292045,
-        0.023906657240262898,
-        0.02422389677304999,
-        0.024494243459740123,
-        0.024716746644993095,
-        0.02489062377383575,
-        0.025015262475736693,
-        0.025090222295181715,
-        0.025115238131239774,
-        0.025090222295181715,
-        0.025015262475736693,
-        0.02489062377383575,
-        0.024716746644993095,
-        0.024494243459740123,
-        0.02422389677304999,
-        0.023906657240262898,
-        0.023543639979292045,
-        0.023136118264690305,
-        0.022685519417764456,
-        0.02219341660258619,
-        0.0216615243039222,
-        0.021091693608099645,
-        0.02048590090683959,
-        0.01984623924750957,
-        0.01917491031449632,
-        0.018474217532113046,
-        0.01774655494337078,
-        0.016994400289550002,
-        0.01622030371109197,
-        0.0154268705481583,
-        0.014616756991299495,
-        0.013792661690403626,
-        0.012957314538633007,
-        0.012113460940738572,
-        0.011263850846167042,
-        0.010411232087891761,
-        0.00955833981937523,
-        0.008707889830141959,
-        0.007862551851441003,
-        0.007024949058869698,
-        0.006197661829254983,
-        0.005383200892133849,
-        0.004583995649678666,
-        0.0038023929634727347,
-        0.003040666808722624,
-        0.0023009688223680886,
-        0.001585343899527155,
-        0.0008957548840071729,
-        0.00023399328453464709,
-        -0.00039822641663914105,
-        -0.000999355560761932,
-        -0.0015679634580924341,
-        -0.002102761261313228,
-        -0.0026026211744391704,
-        -0.0030665125636581314,
-        -0.0034936444836145895,
-        -0.0038832532395640957,
-        -0.004234833979238277,
-        -0.004547989710894641,
-        -0.004822444554483181,
-        -0.005058113686082446,
-        -0.005255055686007765,
-        -0.0054134561009845945,
-        -0.005533635531224416,
-        -0.00561607551125261,
-        -0.005661390330788742,
-        -0.005670310850005453,
-        -0.005643692974106227,
-        -0.0055825114426830275,
-        -0.005487862988928806,
-        -0.005360950355515643,
-        -0.005203069598804959,
-        -0.005015607117572998,
-        -0.004800038325366563,
-        -0.0045579206828686575,
-        -0.004290879447091839,
-        -0.004000603352392086,
-        -0.0036888321761020452,
-        -0.0033573490775895766,
-        -0.00300797876379342,
-        -0.0026425779629200485,
-        -0.002263024527036142,
-        -0.001871207237685343,
-        -0.0014690204948233782,
-        -0.0010583548918470086,
-        -0.0006410907288682408,
-        -0.0002190924077202417,
-        0.000205801422045513,
-        0.0006317838031791465,
-        0.001057087467741617,
-        0.0014799917939572092,
-        0.0018988284857825372,
-        0.002311985518841573,
-        0.0027179132886108654,
-        0.003115131436657766,
-        0.0035022300500638466,
-        0.0038778751454169496,
-        0.0042408138438976535,
-        0.004589877929922167,
-        0.004923986516972895,
-        0.005242147484085504,
-        0.005543458517025799,
-        0.0058271073388043715,
-        0.006092376537639479,
-        0.006338643014211194,
-        0.006565377030679099,
-        0.006772143457352052,
-        0.006958599568131674,
-        0.007124494374978435,
-        0.007269667983488756,
-        0.0073940513124652,
-        0.007497658783299586,
-        0.007580586871220126,
-        0.007643016534137792,
-        0.007685207031874112,
-        0.007707492675743672,
-        0.007710276769793386,
-        0.007694030002295014,
-        0.007659287701952713,
-        0.00760664532924302,
-        0.007536750926922235,
-        0.00745029748995376,
-        0.007348031907285498,
-        0.007230740785089176,
-        0.007099240813545138,
-        0.0069543845011445435,
-        0.006797053787644911,
-        0.0066281503208488884,
-        0.0064485848100731555,
-        0.006259295809303252,
-        0.006061220710163648,
-        0.005855294001186753,
-        0.005642471355757043,
-        0.005423676483969745,
-        0.005199849189427117,
-        0.00497190062684576,
-        0.004740732542446031,
-        0.004507242322312256,
-        0.004272224074794212,
-        0.004036674432244893,
-        0.0038011376930096965,
-        0.0035666315372629826,
-        0.0033338230067350935,
-        0.0031033434619087727,
-        0.0028759060563174348,
-        0.002652180780963496,
-        0.0024327503766989047,
-        0.002218129167231367,
-        0.002008822203561615,
-        0.0018053073242181247,
-        0.001608022600790913,
-        0.0014173535435934963,
-        0.0012336234142536577,
-        0.0010571175363889296,
-        0.0008880852446547268,
-        0.000726740626200138,
-        0.0005732602295096151,
-        0.0004277797782454728,
-        0.0002903902836857423,
-        0.00016113927231773155,
-        0.000040042790511995335,
-        -0.00007291745747770354,
-        -0.00017779141599258178,
-        -0.0002746558384235003,
-        -0.00036361619007235085,
-        -0.00044480726847229255,
-        -0.0005183921293996749,
-        -0.0005845572698362794,
-        -0.0006435124789559279,
-        -0.000695486509394975,
-        -0.0007407237451187581,
-        -0.0007794832300803786,
-        -0.0008120346727726441,
-        -0.0008386594577531522,
-        -0.0008596502623202041,
-        -0.0008753085408928514,
-        -0.0008859405669042607,
-        -0.0008918571525123297,
-        -0.0008933731114150303,
-        -0.000890802476812074,
-        -0.0008844579273069166,
-        -0.0008746485380942947,
-        -0.0008616783722948005,
-        -0.0008458465111466572,
-        -0.0008274467055839751,
-        -0.000806765645109431,
-        -0.0007840808011855785,
-        -0.0007596618085043226,
-        -0.0007337677089503433,
-        -0.0007066468011838411,
-        -0.0006785369554303315,
-        -0.0006496625182456606,
-        -0.0006202339555835284,
-        -0.0005904492581511841,
-        -0.0005604955118788564,
-        -0.0005305445174724294,
-        -0.0005007539712453431,
-        -0.00047126968797673,
-        -0.0004422243707134662,
-        -0.00041373964687695233,
-        -0.0003859230927374626,
-        -0.00035886928184762916,
-        -0.0003326613835601459,
-        -0.0003073727222229766,
-        -0.0002830633093877374,
-        -0.0002597793171263142,
-        -0.0002375625425190539,
-        -0.0002164418338133301,
-        -0.00019643431591661022,
-        -0.00017755194291552197,
-        -0.00015979962346099436,
-        -0.00014317275331006657,
-        -0.00012765705851650855,
-        -0.00011324087296686662,
-        -0.00009989772506066183,
-        -0.00008759897640206701,
-        -0.00007631889418527722,
-        -0.0000660134380588213,
-        -0.00005665091596618633,
-        -0.000048183697807799624,
-        -0.000040570967456494595,
-        -0.00003376497555965666,
-        -0.000027719794077257308,
-        -0.00006206339989040454
-};
-
-
-/*
-
-FIR filter designed with
- http://t-filter.appspot.com
-
-sampling frequency: 256000 Hz
-
-* 0 Hz - 3000 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 4.174069116146564 dB
-
-* 4000 Hz - 128000 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -40.00378122815701 dB
-
-*/
-
-#define FIR_KERNEL_LPF3_TAP_NUM 279
-
-static FP_FLOAT fir_kernel_lpf3_filter_taps[FIR_KERNEL_LPF3_TAP_NUM] = {
-        -0.00481168660374754,
-        0.0003879115472240537,
-        0.0003952238282195715,
-        0.00041792396392899175,
-        0.0004531130266602515,
-        0.0005012692029208926,
-        0.0005614355867436955,
-        0.0006331248644123052,
-        0.0007153440673451512,
-        0.0008076192861873183,
-        0.0009093746422321068,
-        0.0010202669298270816,
-        0.001139687972731184,
-        0.0012670480525383409,
-        0.0014016016843393317,
-        0.0015427291077753816,
-        0.0016897693644550803,
-        0.0018421175221109086,
-        0.0019990427258546684,
-        0.00215979094427692,
-        0.0023235179072518667,
-        0.0024894016721650884,
-        0.002656564480038883,
-        0.0028241133376673516,
-        0.0029910684897386315,
-        0.0031564292051143084,
-        0.003319159597820234,
-        0.003478245100319215,
-        0.0036326512625629863,
-        0.003781335606744961,
-        0.003923218296994191,
-        0.00405721892055518,
-        0.004182259893569875,
-        0.004297288013193989,
-        0.00440125786295976,
-        0.004493135378649171,
-        0.004571906978624541,
-        0.004636605358807619,
-        0.004686329881550721,
-        0.004720240139806672,
-        0.00473755327957633,
-        0.0047375296498150385,
-        0.004719504307823812,
-        0.004682890152006832,
-        0.004627210083495376,
-        0.004552061658138318,
-        0.004457140067146331,
-        0.004342212874760945,
-        0.004207190742530503,
-        0.0040521024303269825,
-        0.0038771420206450387,
-        0.003682577805321255,
-        0.0034688016723247676,
-        0.003236263813886941,
-        0.0029855999752102834,
-        0.0027175457329170916,
-        0.0024330291255523218,
-        0.0021329843061680146,
-        0.0018185008376423112,
-        0.0014906901883440802,
-        0.0011509942472141502,
-        0.0008009332307502663,
-        0.00044234071832197606,
-        0.00007678583188776564,
-        -0.00029397180924654144,
-        -0.0006685789811455449,
-        -0.0010448086598142446,
-        -0.00142081201826191,
-        -0.001792607901236982,
-        -0.0021627400147054775,
-        -0.002516157576743759,
-        -0.0028785535497209067,
-        -0.003217436401303588,
-        -0.0035418936131884882,
-        -0.003850345547333067,
-        -0.0041417016020495545,
-        -0.00441322004361501,
-        -0.004662524326169938,
-        -0.00488692637216601,
-        -0.005084342989202836,
-        -0.005252683925595853,
-        -0.005390153083807338,
-        -0.0054948238721902205,
-        -0.005564961406187203,
-        -0.005598874853922616,
-        -0.005595166708959681,
-        -0.005552541386567708,
-        -0.005469896141210455,
-        -0.005346172581020237,
-        -0.005180495530990977,
-        -0.004972129623643023,
-        -0.004720590752007301,
-        -0.004425563854907241,
-        -0.004086946266457018,
-        -0.003704789411429502,
-        -0.0032793705800530973,
-        -0.0028111712186886994,
-        -0.002300913851175944,
-        -0.001749507115846064,
-        -0.001158055124824341,
-        -0.0005278352856559061,
-        0.00013966453041018486,
-        0.0008427520235503395,
-        0.001579527606524235,
-        0.0023479148880209823,
-        0.003145668317217591,
-        0.003970373971412427,
-        0.004819446254665665,
-        0.005690134992644437,
-        0.0065795612485003785,
-        0.0074847343784164655,
-        0.008402576372539241,
-        0.009329897517274031,
-        0.010263416822731646,
-        0.01119975522254189,
-        0.012135500354171167,
-        0.013067196736080719,
-        0.013991390311191402,
-        0.014904576878846769,
-        0.01580326883329499,
-        0.01668397695403491,
-        0.01754332660426631,
-        0.01837799727679059,
-        0.019184790505155574,
-        0.019960501704144363,
-        0.020702049659074555,
-        0.021406400802304656,
-        0.022070783965075398,
-        0.022692508065714212,
-        0.023269120022075932,
-        0.023798100377515206,
-        0.02427723293035747,
-        0.02470437483587,
-        0.02507810132008922,
-        0.02539704426811058,
-        0.025660523989261816,
-        0.025866908117668366,
-        0.026015329799823652,
-        0.0261014103199288,
-        0.02613337800465598,
-        0.0261014103199288,
-        0.026015329799823652,
-        0.025866908117668366,
-        0.025660523989261816,
-        0.02539704426811058,
-        0.02507810132008922,
-        0.02470437483587,
-        0.02427723293035747,
-        0.023798100377515206,
-        0.023269120022075932,
-        0.022692508065714212,
-        0.022070783965075398,
-        0.021406400802304656,
-        0.020702049659074555,
-        0.019960501704144363,
-        0.019184790505155574,
-        0.01837799727679059,
-        0.01754332660426631,
-        0.01668397695403491,
-        0.01580326883329499,
-        0.014904576878846769,
-        0.013991390311191402,
-        0.013067196736080719,
-        0.012135500354171167,
-        0.01119975522254189,
-        0.010263416822731646,
-        0.009329897517274031,
-        0.008402576372539241,
-        0.0074847343784164655,
-        0.0065795612485003785,
-        0.005690134992644437,
-        0.004819446254665665,
-        0.003970373971412427,
-        0.003145668317217591,
-        0.0023479148880209823,
-        0.001579527606524235,
-        0.0008427520235503395,
-        0.00013966453041018486,
-        -0.0005278352856559061,
-        -0.001158055124824341,
-        -0.001749507115846064,
-        -0.002300913851175944,
-        -0.0028111712186886994,
-        -0.0032793705800530973,
-        -0.003704789411429502,
-        -0.004086946266457018,
-        -0.004425563854907241,
-        -0.004720590752007301,
-        -0.004972129623643023,
-        -0.005180495530990977,
-        -0.005346172581020237,
-        -0.005469896141210455,
-        -0.005552541386567708,
-        -0.005595166708959681,
-        -0.005598874853922616,
-        -0.005564961406187203,
-        -0.0054948238721902205,
-        -0.005390153083807338,
-        -0.005252683925595853,
-        -0.005084342989202836,
-        -0.00488692637216601,
-        -0.004662524326169938,
-        -0.00441322004361501,
-        -0.0041417016020495545,
-        -0.003850345547333067,
-        -0.0035418936131884882,
-        -0.003217436401303588,
-        -0.0028785535497209067,
-        -0.002516157576743759,
-        -0.0021627400147054775,
-        -0.001792607901236982,
-        -0.00142081201826191,
-        -0.0010448086598142446,
-        -0.0006685789811455449,
-        -0.00029397180924654144,
-        0.00007678583188776564,
-        0.00044234071832197606,
-        0.0008009332307502663,
-        0.0011509942472141502,
-        0.0014906901883440802,
-        0.0018185008376423112,
-        0.0021329843061680146,
-        0.0024330291255523218,
-        0.0027175457329170916,
-        0.0029855999752102834,
-        0.003236263813886941,
-        0.0034688016723247676,
-        0.003682577805321255,
-        0.0038771420206450387,
-        0.0040521024303269825,
-        0.004207190742530503,
-        0.004342212874760945,
-        0.004457140067146331,
-        0.004552061658138318,
-        0.004627210083495376,
-        0.004682890152006832,
-        0.004719504307823812,
-        0.0047375296498150385,
-        0.00473755327957633,
-        0.004720240139806672,
-        0.004686329881550721,
-        0.004636605358807619,
-        0.004571906978624541,
-        0.004493135378649171,
-        0.00440125786295976,
-        0.004297288013193989,
-        0.004182259893569875,
-        0.00405721892055518,
-        0.003923218296994191,
-        0.003781335606744961,
-        0.0036326512625629863,
-        0.003478245100319215,
-        0.003319159597820234,
-        0.0031564292051143084,
-        0.0029910684897386315,
-        0.0028241133376673516,
-        0.002656564480038883,
-        0.0024894016721650884,
-        0.0023235179072518667,
-        0.00215979094427692,
-        0.0019990427258546684,
-        0.0018421175221109086,
-        0.0016897693644550803,
-        0.0015427291077753816,
-        0.0014016016843393317,
-        0.0012670480525383409,
-        0.001139687972731184,
-        0.0010202669298270816,
-        0.0009093746422321068,
-        0.0008076192861873183,
-        0.0007153440673451512,
-        0.0006331248644123052,
-        0.0005614355867436955,
-        0.0005012692029208926,
-        0.0004531130266602515,
-        0.00041792396392899175,
-        0.0003952238282195715,
-        0.0003879115472240537,
-        -0.00481168660374754
-};
-
-
-/*
- * Custom filter
- */
-
-#define FIR_KERNEL_LPF4_TAP_NUM 32
-
-static FP_FLOAT fir_kernel_lpf4_filter_taps[FIR_KERNEL_LPF4_TAP_NUM] = {
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125,
-        0.0078125
-};
-
-
-/*
- * Bypass filter
- */
-
-#define FIR_KERNEL_LPF5_TAP_NUM 10
-
-static FP_FLOAT fir_kernel_lpf5_filter_taps[FIR_KERNEL_LPF5_TAP_NUM] = {
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0
-};
-
-#endif
@@ -0,0 +1,185 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+#include "fixed.h"
+
+#if !defined(__ARM_NEON) && defined(__GNUC__)
+typedef int32_t fixed_simd __attribute__ ((vector_size (16)));
+#endif
+
+int16_t fixed_saturate(int32_t value) {
+    if (value > INT16_MAX)
+        return INT16_MAX;
+
+    if (value < INT16_MIN)
+        return INT16_MIN;
+
+    return (int16_t) value;
+}
+
+int16_t fixed_from_float(FP_FLOAT value) {
+    FP_FLOAT scaled;
+
+    scaled = value * (FP_FLOAT) (1 << FIXED_Q15_SHIFT);
+
+    if (scaled >= INT16_MAX)
+        return INT16_MAX;
+
+    if (scaled <= INT16_MIN)
+        return INT16_MIN;
+
+    return (int16_t) (scaled < 0 ? scaled - (FP_FLOAT) 0.5 : scaled + (FP_FLOAT) 0.5);
+}
+
+void fixed_buffer_to_samples(const uint8_t *buffer, fixed_complex *samples, size_t buffer_size) {
+    size_t j;
+
+    for (j = 0; j < buffer_size; j += 2) {
+        samples[j / 2].i = (int16_t) (((int16_t) buffer[j] - 128) * 256);
+        samples[j / 2].q = (int16_t) (((int16_t) buffer[j + 1] - 128) * 256);
+    }
+}
+
+int32_t fixed_dot(const int16_t *a, const int16_t *b, size_t size) {
+    int32_t sum;
+    size_t i;
+#ifdef __ARM_NEON
+    int32x4_t acc;
+#elif defined(__GNUC__)
+    fixed_simd acc = {0};
+    fixed_simd va;
+    fixed_simd vb;
+#endif
+
+    sum = 0;
+    i = 0;
+
+#ifdef __ARM_NEON
+    acc = vdupq_n_s32(0);
+
+    for (; i + 4 <= size; i += 4)
+        acc = vmlal_s16(acc, vld1_s16(a + i), vld1_s16(b + i));
+
+    sum = vgetq_lane_s32(acc, 0) + vgetq_lane_s32(acc, 1) + vgetq_lane_s32(acc, 2) + vgetq_lane_s32(acc, 3);
+#elif defined(__GNUC__)
+    for (; i + 4 <= size; i += 4) {
+        va = (fixed_simd) {a[i], a[i + 1], a[i + 2], a[i + 3]};
+        vb = (fixed_simd) {b[i], b[i + 1], b[i + 2], b[i + 3]};
+        acc += va * vb;
+    }
+
+    sum = acc[0] + acc[1] + acc[2] + acc[3];
+#endif
+
+    for (; i < size; i++)
+        sum += (int32_t) a[i] * b[i];
+
+    return sum;
+}
+
+void fixed_narrow(const int32_t *input, int16_t *output, size_t size) {
+    size_t i;
+
+    i = 0;
+
+#ifdef __ARM_NEON
+    for (; i + 4 <= size; i += 4)
+        vst1_s16(output + i, vqrshrn_n_s32(vld1q_s32(input + i), FIXED_Q15_SHIFT));
+#endif
+
+    for (; i < size; i++)
+        output[i] = fixed_saturate((int32_t) (((int64_t) input[i] + FIXED_Q15_HALF) >> FIXED_Q15_SHIFT));
+}
+
+static int32_t fixed_atan_unit(int32_t z) {
+    int32_t t;
+    int32_t u;
+
+    t = 2552 + ((691 * z) >> FIXED_Q15_SHIFT);
+    u = (int32_t) ((((int64_t) z * (32768 - z)) >> FIXED_Q15_SHIFT) * t >> FIXED_Q15_SHIFT);
+
+    return (z >> 2) + u;
+}
+
+int16_t fixed_atan2(int32_t y, int32_t x) {
+    int64_t ax;
+    int64_t ay;
+    int32_t angle;
+
+    ax = x < 0 ? -(int64_t) x : x;
+    ay = y < 0 ? -(int64_t) y : y;
+
+    if (ax == 0 && ay == 0)
+        return 0;
+
+    if (ax >= ay)
+        angle = fixed_atan_unit((int32_t) ((ay << FIXED_Q15_SHIFT) / ax));
+    else
+        angle = 16384 - fixed_atan_unit((int32_t) ((ax << FIXED_Q15_SHIFT) / ay));
+
+    if (x < 0)
+        angle = 32768 - angle;
+
+    if (y < 0)
+        angle = -angle;
+
+    return fixed_saturate(angle);
+}
+
+void fixed_fm_demod(const fixed_complex *input, size_t size, fixed_complex *prev, int16_t *output) {
+    int32_t real;
+    int32_t imag;
+    size_t j;
+
+    for (j = 0; j < size; j++) {
+        real = (((int32_t) input[j].i * prev->i) >> 1) + (((int32_t) input[j].q * prev->q) >> 1);
+        imag = (((int32_t) input[j].q * prev->i) >> 1) - (((int32_t) input[j].i * prev->q) >> 1);
+
+        output[j] = fixed_atan2(imag, real);
+
+        *prev = input[j];
+    }
+}
+
+void fixed_am_demod(const fixed_complex *input, size_t size, int16_t *output) {
+    int32_t ai;
+    int32_t aq;
+    int32_t max;
+    int32_t min;
+    int32_t mag;
+    size_t j;
+
+    for (j = 0; j < size; j++) {
+        ai = abs(input[j].i);
+        aq = abs(input[j].q);
+
+        max = ai > aq ? ai : aq;
+        min = ai > aq ? aq : ai;
+
+        mag = ((max * 31470) >> FIXED_Q15_SHIFT) + ((min * 13036) >> FIXED_Q15_SHIFT);
+
+        output[j] = fixed_saturate((mag * FIXED_INV_SQRT2) >> FIXED_Q15_SHIFT);
+    }
+}
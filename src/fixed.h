@@ -0,0 +1,66 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__FIXED__H
+#define __RTLSDR_RADIO__FIXED__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "buildflags.h"
+
+/*
+ * Q15 helpers for the fixed point pipeline (RTLSDR_RADIO_FIXED_POINT).
+ *
+ * Samples are int16 with 32767 meaning 1.0, products are accumulated in
+ * int32 and brought back to Q15 with a rounding, saturating shift. Angles
+ * returned by fixed_atan2 are normalized by pi, like the floating point
+ * FM demodulator output.
+ */
+
+#define FIXED_Q15_SHIFT 15
+#define FIXED_Q15_ONE 32767
+#define FIXED_Q15_HALF (1 << (FIXED_Q15_SHIFT - 1))
+
+#define FIXED_INV_SQRT2 23170
+
+struct fixed_complex_t {
+    int16_t i;
+    int16_t q;
+};
+
+typedef struct fixed_complex_t fixed_complex;
+
+int16_t fixed_saturate(int32_t);
+
+int16_t fixed_from_float(FP_FLOAT);
+
+void fixed_buffer_to_samples(const uint8_t *, fixed_complex *, size_t);
+
+int32_t fixed_dot(const int16_t *, const int16_t *, size_t);
+
+void fixed_narrow(const int32_t *, int16_t *, size_t);
+
+int16_t fixed_atan2(int32_t, int32_t);
+
+void fixed_fm_demod(const fixed_complex *, size_t, fixed_complex *, int16_t *);
+
+void fixed_am_demod(const fixed_complex *, size_t, int16_t *);
+
+#endif
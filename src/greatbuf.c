@@ -60,6 +60,8 @@ greatbuf_circbuf *greatbuf_circbuf_init(const char *name, size_t size) {
     circbuf->busy_head = 0;
     circbuf->busy_tail = 0;
 
+    circbuf->produced = 0;
+
     circbuf->keep_running = 1;
 
     log_debug("Initializing mutex");
@@ -99,7 +101,8 @@ void greatbuf_circbuf_free(greatbuf_circbuf *circbuf) {
     free(circbuf);
 }
 
-greatbuf_item *greatbuf_item_init(size_t samples_size, size_t pcm_size, size_t data_size) {
+greatbuf_item *greatbuf_item_init(size_t samples_size, size_t channel_size, size_t pcm_size, size_t data_size,
+                                  size_t channels) {
     greatbuf_item *item;
     size_t i;
 
@@ -116,7 +119,9 @@ greatbuf_item *greatbuf_item_init(size_t samples_size, size_t pcm_size, size_t d
 
     log_trace("Setting samples_size");
 
+    item->channels = channels;
     item->samples_size = samples_size;
+    item->channel_size = channel_size;
     item->pcm_size = pcm_size;
     item->data_size = data_size;
 
@@ -129,15 +134,23 @@ greatbuf_item *greatbuf_item_init(size_t samples_size, size_t pcm_size, size_t d
     }
 
     log_trace("Allocating samples buffer");
-    item->samples = (FP_FLOAT complex *) calloc(item->samples_size, sizeof(FP_FLOAT complex));
+    item->samples = (greatbuf_complex *) calloc(item->samples_size, sizeof(greatbuf_complex));
     if (item->samples == NULL) {
         log_error("Unable to allocate samples buffer");
         greatbuf_item_free(item);
         return NULL;
     }
 
+    log_trace("Allocating channel buffer");
+    item->channel = (greatbuf_complex *) calloc(item->channel_size * item->channels, sizeof(greatbuf_complex));
+    if (item->channel == NULL) {
+        log_error("Unable to allocate channel buffer");
+        greatbuf_item_free(item);
+        return NULL;
+    }
+
     log_trace("Allocating demod buffer");
-    item->demod = (FP_FLOAT *) calloc(item->samples_size, sizeof(FP_FLOAT));
+    item->demod = (greatbuf_real *) calloc(item->channel_size * item->channels, sizeof(greatbuf_real));
     if (item->demod == NULL) {
         log_error("Unable to allocate demod buffer");
         greatbuf_item_free(item);
@@ -145,7 +158,7 @@ greatbuf_item *greatbuf_item_init(size_t samples_size, size_t pcm_size, size_t d
     }
 
     log_trace("Allocating filtered buffer");
-    item->filtered = (FP_FLOAT *) calloc(item->samples_size, sizeof(FP_FLOAT));
+    item->filtered = (greatbuf_real *) calloc(item->channel_size * item->channels, sizeof(greatbuf_real));
     if (item->filtered == NULL) {
         log_error("Unable to allocate filtered buffer");
         greatbuf_item_free(item);
@@ -153,7 +166,7 @@ greatbuf_item *greatbuf_item_init(size_t samples_size, size_t pcm_size, size_t d
     }
 
     log_trace("Allocating pcm buffer");
-    item->pcm = (int16_t *) calloc(item->pcm_size, sizeof(int16_t));
+    item->pcm = (int16_t *) calloc(item->pcm_size * item->channels, sizeof(int16_t));
     if (item->pcm == NULL) {
         log_error("Unable to allocate pcm buffer");
         greatbuf_item_free(item);
@@ -161,16 +174,27 @@ greatbuf_item *greatbuf_item_init(size_t samples_size, size_t pcm_size, size_t d
     }
 
     log_trace("Allocating data buffer");
-    item->data = (uint8_t *) calloc(item->data_size, sizeof(uint8_t));
+    item->data = (uint8_t *) calloc(item->data_size * item->channels, sizeof(uint8_t));
     if (item->data == NULL) {
         log_error("Unable to allocate pcm buffer");
         greatbuf_item_free(item);
         return NULL;
     }
 
+    log_trace("Allocating channel flags");
+    item->contains_data = (int *) calloc(item->channels, sizeof(int));
+    item->squelch_open = (int *) calloc(item->channels, sizeof(int));
+    item->rms = (FP_FLOAT *) calloc(item->channels, sizeof(FP_FLOAT));
+    if (item->contains_data == NULL || item->squelch_open == NULL || item->rms == NULL) {
+        log_error("Unable to allocate channel flags");
+        greatbuf_item_free(item);
+        return NULL;
+    }
+
     log_trace("Setting initial values");
 
     item->number = 0;
+    item->center_freq = 0;
 
     item->ts.tv_sec = 0;
     item->ts.tv_nsec = 0;
@@ -181,18 +205,25 @@ greatbuf_item *greatbuf_item_init(size_t samples_size, size_t pcm_size, size_t d
     for (i = 0; i < item->samples_size; i++) {
         item->iq[i * 2] = 0;
         item->iq[i * 2 + 1] = 0;
-        item->samples[i] = 0 + 0 * I;
+    }
+
+    memset(item->samples, 0, item->samples_size * sizeof(greatbuf_complex));
+    memset(item->channel, 0, item->channel_size * item->channels * sizeof(greatbuf_complex));
+
+    for (i = 0; i < item->channel_size * item->channels; i++) {
         item->demod[i] = 0;
         item->filtered[i] = 0;
     }
 
-    for (i = 0; i < item->pcm_size; i++) {
+    for (i = 0; i < item->pcm_size * item->channels; i++) {
         item->pcm[i] = 0;
     }
 
-    item->contains_data = 0;
-
-    item->rms = 0;
+    for (i = 0; i < item->channels; i++) {
+        item->contains_data[i] = 0;
+        item->squelch_open[i] = 1;
+        item->rms[i] = 0;
+    }
 
     return item;
 }
@@ -207,6 +238,8 @@ void greatbuf_item_free(greatbuf_item *item) {
         free(item->iq);
     if (item->samples != NULL)
         free(item->samples);
+    if (item->channel != NULL)
+        free(item->channel);
     if (item->demod != NULL)
         free(item->demod);
     if (item->filtered != NULL)
@@ -215,11 +248,18 @@ void greatbuf_item_free(greatbuf_item *item) {
         free(item->pcm);
     if (item->data != NULL)
         free(item->data);
+    if (item->contains_data != NULL)
+        free(item->contains_data);
+    if (item->squelch_open != NULL)
+        free(item->squelch_open);
+    if (item->rms != NULL)
+        free(item->rms);
 
     free(item);
 }
 
-greatbuf_ctx *greatbuf_init(size_t size, size_t samples_size, size_t pcm_size, size_t data_size) {
+greatbuf_ctx *greatbuf_init(size_t size, size_t samples_size, size_t channel_size, size_t pcm_size, size_t data_size,
+                            size_t channels) {
     greatbuf_ctx *ctx;
     size_t i;
 
@@ -247,7 +287,7 @@ greatbuf_ctx *greatbuf_init(size_t size, size_t samples_size, size_t pcm_size, s
 
     log_debug("Initializing items");
     for (i = 0; i < ctx->size; i++) {
-        ctx->items[i] = greatbuf_item_init(samples_size, pcm_size, data_size);
+        ctx->items[i] = greatbuf_item_init(samples_size, channel_size, pcm_size, data_size, channels);
         if (ctx->items[i] == NULL) {
             log_error("Unable to allocate item");
             greatbuf_free(ctx);
@@ -465,6 +505,15 @@ void greatbuf_tail_release(greatbuf_ctx *ctx, int circbuf_num) {
     greatbuf_circbuf_tail_release(circbuf);
 }
 
+ssize_t greatbuf_head_last(greatbuf_ctx *ctx, int circbuf_num, uint64_t *produced) {
+    greatbuf_circbuf *circbuf;
+
+    log_trace("Selecting circbuf");
+    circbuf = greatbuf_circbuf_get(ctx, circbuf_num);
+
+    return greatbuf_circbuf_head_last(circbuf, produced);
+}
+
 ssize_t greatbuf_circbuf_head_acquire(greatbuf_circbuf *circbuf) {
     ssize_t pos;
 
@@ -501,6 +550,8 @@ void greatbuf_circbuf_head_release(greatbuf_circbuf *circbuf) {
         if (circbuf->head >= circbuf->size)
             circbuf->head = 0;
 
+        circbuf->produced++;
+
         circbuf->free--;
         if (circbuf->free == 0) {
             log_warn("Buffer %s full", circbuf->name);
@@ -562,3 +613,22 @@ void greatbuf_circbuf_tail_release(greatbuf_circbuf *circbuf) {
     pthread_mutex_unlock(&circbuf->mutex);
     log_trace("Releasing lock");
 }
+
+ssize_t greatbuf_circbuf_head_last(greatbuf_circbuf *circbuf, uint64_t *produced) {
+    ssize_t pos;
+
+    log_trace("Acquiring lock");
+    pthread_mutex_lock(&circbuf->mutex);
+
+    *produced = circbuf->produced;
+
+    if (circbuf->produced > 0)
+        pos = (ssize_t) ((circbuf->head + circbuf->size - 1) % circbuf->size);
+    else
+        pos = -1;
+
+    pthread_mutex_unlock(&circbuf->mutex);
+    log_trace("Releasing lock");
+
+    return pos;
+}
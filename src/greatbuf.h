@@ -27,6 +27,7 @@
 #include <pthread.h>
 
 #include "buildflags.h"
+#include "fixed.h"
 
 #define GREATBUF_CIRCBUF_IQ 0
 #define GREATBUF_CIRCBUF_SAMPLES 1
@@ -37,6 +38,14 @@
 #define GREATBUF_CIRCBUF_MONITOR 6
 #define GREATBUF_CIRCBUF_NETWORK 7
 
+#ifdef RTLSDR_RADIO_FIXED_POINT
+typedef fixed_complex greatbuf_complex;
+typedef int16_t greatbuf_real;
+#else
+typedef FP_FLOAT complex greatbuf_complex;
+typedef FP_FLOAT greatbuf_real;
+#endif
+
 struct greatbuf_circbuf_t {
     char *name;
 
@@ -49,34 +58,49 @@ struct greatbuf_circbuf_t {
     int busy_head;
     int busy_tail;
 
+    uint64_t produced;
+
     pthread_mutex_t mutex;
     pthread_cond_t cond;
 
     volatile int keep_running;
 };
 
+/*
+ * Channel, demod, filtered, pcm and data buffers hold one slice per channel,
+ * laid out one after the other: channel c starts at c * channel_size (or
+ * pcm_size, data_size). contains_data, squelch_open and rms have one entry
+ * per channel.
+ */
+
 struct greatbuf_item_t {
+    size_t channels;
+
     size_t samples_size;
+    size_t channel_size;
     size_t pcm_size;
     size_t data_size;
 
     uint64_t number;
+    uint32_t center_freq;
 
     struct timespec ts;
     struct timespec delay;
 
     uint8_t *iq;
-    FP_FLOAT complex *samples;
+    greatbuf_complex *samples;
+    greatbuf_complex *channel;
 
-    FP_FLOAT *demod;
-    FP_FLOAT *filtered;
+    greatbuf_real *demod;
+    greatbuf_real *filtered;
 
     int16_t *pcm;
     uint8_t *data;
 
-    int contains_data;
+    int *contains_data;
+    int *squelch_open;
 
-    FP_FLOAT rms;
+    FP_FLOAT *rms;
 };
 
 struct greatbuf_ctx_t {
@@ -101,11 +125,11 @@ greatbuf_circbuf *greatbuf_circbuf_init(const char *, size_t);
 
 void greatbuf_circbuf_free(greatbuf_circbuf *);
 
-greatbuf_item *greatbuf_item_init(size_t, size_t, size_t);
+greatbuf_item *greatbuf_item_init(size_t, size_t, size_t, size_t, size_t);
 
 void greatbuf_item_free(greatbuf_item *);
 
-greatbuf_ctx *greatbuf_init(size_t, size_t, size_t, size_t);
+greatbuf_ctx *greatbuf_init(size_t, size_t, size_t, size_t, size_t, size_t);
 
 void greatbuf_free(greatbuf_ctx *);
 
@@ -137,4 +161,15 @@ ssize_t greatbuf_circbuf_tail_acquire(greatbuf_circbuf *);
 
 void greatbuf_circbuf_tail_release(greatbuf_circbuf * );
 
+/*
+ * Position of the newest item released on the head, without acquiring it,
+ * and the number of items released so far. Meant for lossy observers which
+ * must never hold the pipeline back: the item stays valid until the ring
+ * wraps around.
+ */
+
+ssize_t greatbuf_head_last(greatbuf_ctx *, int, uint64_t *);
+
+ssize_t greatbuf_circbuf_head_last(greatbuf_circbuf *, uint64_t *);
+
 #endif
@@ -0,0 +1,255 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "iqcorr.h"
+#include "log.h"
+
+iqcorr_ctx *iqcorr_init() {
+    iqcorr_ctx *ctx;
+
+    log_info("Initializing IQ correction context");
+
+    log_debug("Allocating IQ correction context");
+    ctx = (iqcorr_ctx *) calloc(1, sizeof(iqcorr_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate IQ correction context");
+        return NULL;
+    }
+
+    ctx->primed = 0;
+
+    ctx->i_offset = 0;
+    ctx->q_gain = 1;
+    ctx->q_cross = 0;
+    ctx->q_offset = 0;
+
+    ctx->i_offset_fixed = 0;
+    ctx->q_gain_fixed = 1 << IQCORR_FIXED_SHIFT;
+    ctx->q_cross_fixed = 0;
+    ctx->q_offset_fixed = 0;
+
+    return ctx;
+}
+
+void iqcorr_free(iqcorr_ctx *ctx) {
+    log_info("Freeing IQ correction context");
+
+    if (ctx == NULL)
+        return;
+
+    free(ctx);
+}
+
+void iqcorr_update(iqcorr_ctx *ctx, FP_FLOAT mean_i, FP_FLOAT mean_q, FP_FLOAT var_i, FP_FLOAT var_q, FP_FLOAT cov) {
+    FP_FLOAT phase;
+    FP_FLOAT residual;
+    FP_FLOAT gain;
+
+    if (ctx->primed == 0) {
+        ctx->mean_i = mean_i;
+        ctx->mean_q = mean_q;
+        ctx->var_i = var_i;
+        ctx->var_q = var_q;
+        ctx->cov = cov;
+        ctx->primed = 1;
+    } else {
+        ctx->mean_i += (FP_FLOAT) IQCORR_ALPHA * (mean_i - ctx->mean_i);
+        ctx->mean_q += (FP_FLOAT) IQCORR_ALPHA * (mean_q - ctx->mean_q);
+        ctx->var_i += (FP_FLOAT) IQCORR_ALPHA * (var_i - ctx->var_i);
+        ctx->var_q += (FP_FLOAT) IQCORR_ALPHA * (var_q - ctx->var_q);
+        ctx->cov += (FP_FLOAT) IQCORR_ALPHA * (cov - ctx->cov);
+    }
+
+    phase = 0;
+    gain = 1;
+
+    if (ctx->var_i > IQCORR_POWER_MIN) {
+        phase = ctx->cov / ctx->var_i;
+        if (phase > IQCORR_PHASE_MAX)
+            phase = IQCORR_PHASE_MAX;
+        else if (phase < -IQCORR_PHASE_MAX)
+            phase = -IQCORR_PHASE_MAX;
+
+        residual = ctx->var_q - phase * ctx->cov;
+        if (residual > IQCORR_POWER_MIN)
+            gain = (FP_FLOAT) sqrt((double) (ctx->var_i / residual));
+        if (gain > IQCORR_GAIN_MAX)
+            gain = IQCORR_GAIN_MAX;
+    }
+
+    ctx->i_offset = -ctx->mean_i;
+    ctx->q_gain = gain;
+    ctx->q_cross = -gain * phase;
+    ctx->q_offset = gain * (phase * ctx->mean_i - ctx->mean_q);
+
+    ctx->i_offset_fixed = (int32_t) lround((double) ctx->i_offset * FIXED_Q15_ONE);
+    ctx->q_gain_fixed = (int32_t) lround((double) ctx->q_gain * (1 << IQCORR_FIXED_SHIFT));
+    ctx->q_cross_fixed = (int32_t) lround((double) ctx->q_cross * (1 << IQCORR_FIXED_SHIFT));
+    ctx->q_offset_fixed = (int32_t) lround((double) ctx->q_offset * FIXED_Q15_ONE);
+}
+
+void iqcorr_do(iqcorr_ctx *ctx, FP_FLOAT complex *samples, size_t size) {
+    FP_FLOAT sum_i;
+    FP_FLOAT sum_q;
+    FP_FLOAT sum_ii;
+    FP_FLOAT sum_qq;
+    FP_FLOAT sum_iq;
+    FP_FLOAT mean_i;
+    FP_FLOAT mean_q;
+    FP_FLOAT i_value;
+    FP_FLOAT q_value;
+    size_t i;
+#ifdef IQCORR_SIMD_ENABLED
+    const iqcorr_simd_mask swap = IQCORR_SIMD_SWAP;
+    iqcorr_simd acc_sum = {0};
+    iqcorr_simd acc_square = {0};
+    iqcorr_simd acc_cross = {0};
+    iqcorr_simd scale;
+    iqcorr_simd cross;
+    iqcorr_simd offset;
+    iqcorr_simd v;
+    size_t l;
+#endif
+
+    if (size == 0)
+        return;
+
+    sum_i = 0;
+    sum_q = 0;
+    sum_ii = 0;
+    sum_qq = 0;
+    sum_iq = 0;
+    i = 0;
+
+#ifdef IQCORR_SIMD_ENABLED
+    for (; i + IQCORR_SIMD_SAMPLES <= size; i += IQCORR_SIMD_SAMPLES) {
+        memcpy(&v, samples + i, sizeof(iqcorr_simd));
+
+        acc_sum += v;
+        acc_square += v * v;
+        acc_cross += v * __builtin_shuffle(v, swap);
+    }
+
+    for (l = 0; l < IQCORR_SIMD_LANES; l += 2) {
+        sum_i += acc_sum[l];
+        sum_q += acc_sum[l + 1];
+        sum_ii += acc_square[l];
+        sum_qq += acc_square[l + 1];
+        sum_iq += acc_cross[l];
+    }
+#endif
+
+    for (; i < size; i++) {
+        i_value = creal(samples[i]);
+        q_value = cimag(samples[i]);
+
+        sum_i += i_value;
+        sum_q += q_value;
+        sum_ii += i_value * i_value;
+        sum_qq += q_value * q_value;
+        sum_iq += i_value * q_value;
+    }
+
+    mean_i = sum_i / (FP_FLOAT) size;
+    mean_q = sum_q / (FP_FLOAT) size;
+
+    iqcorr_update(ctx, mean_i, mean_q,
+                  sum_ii / (FP_FLOAT) size - mean_i * mean_i,
+                  sum_qq / (FP_FLOAT) size - mean_q * mean_q,
+                  sum_iq / (FP_FLOAT) size - mean_i * mean_q);
+
+    i = 0;
+
+#ifdef IQCORR_SIMD_ENABLED
+    for (l = 0; l < IQCORR_SIMD_LANES; l += 2) {
+        scale[l] = 1;
+        scale[l + 1] = ctx->q_gain;
+        cross[l] = 0;
+        cross[l + 1] = ctx->q_cross;
+        offset[l] = ctx->i_offset;
+        offset[l + 1] = ctx->q_offset;
+    }
+
+    for (; i + IQCORR_SIMD_SAMPLES <= size; i += IQCORR_SIMD_SAMPLES) {
+        memcpy(&v, samples + i, sizeof(iqcorr_simd));
+        v = v * scale + __builtin_shuffle(v, swap) * cross + offset;
+        memcpy(samples + i, &v, sizeof(iqcorr_simd));
+    }
+#endif
+
+    for (; i < size; i++) {
+        i_value = creal(samples[i]);
+        q_value = cimag(samples[i]);
+
+        samples[i] = (i_value + ctx->i_offset)
+                     + (ctx->q_gain * q_value + ctx->q_cross * i_value + ctx->q_offset) * I;
+    }
+}
+
+void iqcorr_do_fixed(iqcorr_ctx *ctx, fixed_complex *samples, size_t size) {
+    int64_t sum_i;
+    int64_t sum_q;
+    int64_t sum_ii;
+    int64_t sum_qq;
+    int64_t sum_iq;
+    FP_FLOAT norm;
+    FP_FLOAT mean_i;
+    FP_FLOAT mean_q;
+    int32_t q_acc;
+    size_t i;
+
+    if (size == 0)
+        return;
+
+    sum_i = 0;
+    sum_q = 0;
+    sum_ii = 0;
+    sum_qq = 0;
+    sum_iq = 0;
+
+    for (i = 0; i < size; i++) {
+        sum_i += samples[i].i;
+        sum_q += samples[i].q;
+        sum_ii += (int32_t) samples[i].i * samples[i].i;
+        sum_qq += (int32_t) samples[i].q * samples[i].q;
+        sum_iq += (int32_t) samples[i].i * samples[i].q;
+    }
+
+    norm = (FP_FLOAT) size * FIXED_Q15_ONE;
+    mean_i = (FP_FLOAT) sum_i / norm;
+    mean_q = (FP_FLOAT) sum_q / norm;
+
+    iqcorr_update(ctx, mean_i, mean_q,
+                  (FP_FLOAT) sum_ii / norm / FIXED_Q15_ONE - mean_i * mean_i,
+                  (FP_FLOAT) sum_qq / norm / FIXED_Q15_ONE - mean_q * mean_q,
+                  (FP_FLOAT) sum_iq / norm / FIXED_Q15_ONE - mean_i * mean_q);
+
+    for (i = 0; i < size; i++) {
+        q_acc = ctx->q_gain_fixed * samples[i].q + ctx->q_cross_fixed * samples[i].i;
+        q_acc = (q_acc + (1 << (IQCORR_FIXED_SHIFT - 1))) >> IQCORR_FIXED_SHIFT;
+
+        samples[i].q = fixed_saturate(q_acc + ctx->q_offset_fixed);
+        samples[i].i = fixed_saturate(samples[i].i + ctx->i_offset_fixed);
+    }
+}
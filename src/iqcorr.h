@@ -0,0 +1,109 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef __RTLSDR_RADIO__IQCORR__H
+#define __RTLSDR_RADIO__IQCORR__H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <complex.h>
+
+#include "buildflags.h"
+#include "fixed.h"
+
+/*
+ * Adaptive DC offset and I/Q imbalance correction.
+ *
+ * Every block the mean, variance and covariance of the raw I and Q
+ * components are measured and blended into running estimates with weight
+ * IQCORR_ALPHA. The estimates give the correction
+ *
+ *   i' = i - dc_i
+ *   q' = gain * ((q - dc_q) - phase * (i - dc_i))
+ *
+ * where phase = cov / var_i removes the part of I leaking into Q and gain
+ * equalizes the power of the two arms. Everything is folded into a single
+ * affine map, applied IQCORR_SIMD_BYTES at a time when the compiler
+ * supports vector shuffles.
+ *
+ * Phase and gain are clamped, so a block carrying a signal on one arm only
+ * cannot blow the correction up.
+ *
+ * The _fixed variant applies the same map on Q15 samples, with the
+ * coefficients in Q14 so that gains slightly above 1 can be represented.
+ */
+
+#define IQCORR_ALPHA 0.05
+#define IQCORR_POWER_MIN 1e-12
+#define IQCORR_PHASE_MAX 0.5
+#define IQCORR_GAIN_MAX 1.5
+
+#define IQCORR_FIXED_SHIFT 14
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(RTLSDR_RADIO_FP_FLOAT) || defined(RTLSDR_RADIO_FP_DOUBLE))
+#define IQCORR_SIMD_ENABLED
+#define IQCORR_SIMD_BYTES 16
+#define IQCORR_SIMD_LANES (IQCORR_SIMD_BYTES / sizeof(FP_FLOAT))
+#define IQCORR_SIMD_SAMPLES (IQCORR_SIMD_BYTES / sizeof(FP_FLOAT complex))
+
+typedef FP_FLOAT iqcorr_simd __attribute__ ((vector_size (IQCORR_SIMD_BYTES)));
+
+#ifdef RTLSDR_RADIO_FP_FLOAT
+typedef int32_t iqcorr_simd_mask __attribute__ ((vector_size (IQCORR_SIMD_BYTES)));
+#define IQCORR_SIMD_SWAP {1, 0, 3, 2}
+#else
+typedef int64_t iqcorr_simd_mask __attribute__ ((vector_size (IQCORR_SIMD_BYTES)));
+#define IQCORR_SIMD_SWAP {1, 0}
+#endif
+#endif
+
+struct iqcorr_ctx_t {
+    int primed;
+
+    FP_FLOAT mean_i;
+    FP_FLOAT mean_q;
+    FP_FLOAT var_i;
+    FP_FLOAT var_q;
+    FP_FLOAT cov;
+
+    FP_FLOAT i_offset;
+    FP_FLOAT q_gain;
+    FP_FLOAT q_cross;
+    FP_FLOAT q_offset;
+
+    int32_t i_offset_fixed;
+    int32_t q_gain_fixed;
+    int32_t q_cross_fixed;
+    int32_t q_offset_fixed;
+};
+
+typedef struct iqcorr_ctx_t iqcorr_ctx;
+
+iqcorr_ctx *iqcorr_init();
+
+void iqcorr_free(iqcorr_ctx *);
+
+void iqcorr_update(iqcorr_ctx *, FP_FLOAT, FP_FLOAT, FP_FLOAT, FP_FLOAT, FP_FLOAT);
+
+void iqcorr_do(iqcorr_ctx *, FP_FLOAT complex *, size_t);
+
+void iqcorr_do_fixed(iqcorr_ctx *, fixed_complex *, size_t);
+
+#endif
@@ -0,0 +1,267 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "iqsink.h"
+#include "log.h"
+#include "utils.h"
+
+static void iqsink_pack(iqsink_ctx *);
+
+static int32_t iqsink_quantize(FP_FLOAT, int32_t);
+
+iqsink_ctx *iqsink_init(uint32_t src_rate, uint32_t dst_rate, int32_t offset, size_t input_size, iq_format format,
+                        int gain) {
+    iqsink_ctx *ctx;
+    size_t sample_size;
+
+    log_info("Initializing IQ sink context");
+
+    sample_size = iqsink_get_sample_size(format);
+    if (sample_size == 0) {
+        log_error("Unknown IQ format");
+        return NULL;
+    }
+
+    log_debug("Allocating IQ sink context");
+    ctx = (iqsink_ctx *) calloc(1, sizeof(iqsink_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate IQ sink context");
+        return NULL;
+    }
+
+    ctx->src_rate = src_rate;
+    ctx->dst_rate = dst_rate;
+    ctx->offset = offset;
+    ctx->format = format;
+    ctx->gain = (FP_FLOAT) pow(10, (double) gain / 20);
+    ctx->input_size = input_size;
+    ctx->sample = 0;
+
+    log_debug("Initializing mixer and decimator");
+    ctx->nco = nco_init(src_rate, offset);
+    ctx->decimate = decimate_init(src_rate, dst_rate, input_size);
+    if (ctx->nco == NULL || ctx->decimate == NULL) {
+        log_error("Unable to initialize mixer and decimator");
+        iqsink_free(ctx);
+        return NULL;
+    }
+
+    ctx->output_size = decimate_compute_output_size(ctx->decimate, input_size);
+
+    ctx->packet_samples = (IQSINK_PACKET_SIZE_MAX - IQSINK_HEADER_SIZE) / sample_size;
+    ctx->packets_size = (ctx->output_size + ctx->packet_samples - 1) / ctx->packet_samples;
+    ctx->packets_count = 0;
+
+    log_debug("Output samples per block: %zu - Packets per block: %zu", ctx->output_size, ctx->packets_size);
+
+    log_debug("Allocating buffers");
+    ctx->mixed = (FP_FLOAT complex *) calloc(input_size, sizeof(FP_FLOAT complex));
+    ctx->output = (FP_FLOAT complex *) calloc(ctx->output_size, sizeof(FP_FLOAT complex));
+    ctx->mixed_fixed = (fixed_complex *) calloc(input_size, sizeof(fixed_complex));
+    ctx->output_fixed = (fixed_complex *) calloc(ctx->output_size, sizeof(fixed_complex));
+    ctx->packets = (iqsink_packet *) calloc(ctx->packets_size, sizeof(iqsink_packet));
+    ctx->data = (uint8_t *) calloc(ctx->output_size * sample_size, sizeof(uint8_t));
+    if (ctx->mixed == NULL || ctx->output == NULL || ctx->mixed_fixed == NULL || ctx->output_fixed == NULL
+        || ctx->packets == NULL || ctx->data == NULL) {
+        log_error("Unable to allocate buffers");
+        iqsink_free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+void iqsink_free(iqsink_ctx *ctx) {
+    log_info("Freeing IQ sink context");
+
+    if (ctx == NULL)
+        return;
+
+    nco_free(ctx->nco);
+    decimate_free(ctx->decimate);
+
+    free(ctx->mixed);
+    free(ctx->output);
+    free(ctx->mixed_fixed);
+    free(ctx->output_fixed);
+    free(ctx->packets);
+    free(ctx->data);
+
+    free(ctx);
+}
+
+size_t iqsink_get_sample_size(iq_format format) {
+    switch (format) {
+        case IQ_FORMAT_INT4:
+            return 1;
+        case IQ_FORMAT_INT8:
+            return 2;
+        case IQ_FORMAT_INT16:
+            return 2 * sizeof(int16_t);
+        case IQ_FORMAT_FLOAT:
+            return 2 * sizeof(float);
+        default:
+            return 0;
+    }
+}
+
+int iqsink_process(iqsink_ctx *ctx, const FP_FLOAT complex *input) {
+    const FP_FLOAT complex *source;
+
+    source = input;
+
+    if (ctx->nco->increment != 0) {
+        nco_mix(ctx->nco, input, ctx->input_size, ctx->mixed);
+        source = ctx->mixed;
+    }
+
+    if (decimate_do(ctx->decimate, source, ctx->input_size, ctx->output) != EXIT_SUCCESS) {
+        log_error("Unable to decimate IQ samples");
+        return EXIT_FAILURE;
+    }
+
+    iqsink_pack(ctx);
+
+    return EXIT_SUCCESS;
+}
+
+int iqsink_process_fixed(iqsink_ctx *ctx, const fixed_complex *input) {
+    const fixed_complex *source;
+    size_t i;
+
+    source = input;
+
+    if (ctx->nco->increment != 0) {
+        nco_mix_fixed(ctx->nco, input, ctx->input_size, ctx->mixed_fixed);
+        source = ctx->mixed_fixed;
+    }
+
+    if (decimate_do_fixed(ctx->decimate, source, ctx->input_size, ctx->output_fixed) != EXIT_SUCCESS) {
+        log_error("Unable to decimate IQ samples");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < ctx->output_size; i++)
+        ctx->output[i] = (FP_FLOAT) ctx->output_fixed[i].i / FIXED_Q15_ONE
+                         + (FP_FLOAT) ctx->output_fixed[i].q / FIXED_Q15_ONE * I;
+
+    iqsink_pack(ctx);
+
+    return EXIT_SUCCESS;
+}
+
+void iqsink_skip(iqsink_ctx *ctx, uint64_t blocks) {
+    ctx->sample += blocks * ctx->output_size;
+    ctx->packets_count = 0;
+}
+
+int iqsink_serialize_header(iqsink_ctx *ctx, iqsink_packet *packet, struct timespec *ts, uint32_t frequency,
+                            uint8_t *buffer, size_t buffer_size, size_t *bytes_written) {
+    if (buffer_size < IQSINK_HEADER_SIZE) {
+        log_error("Not enough space for IQ header serialization");
+        return EXIT_FAILURE;
+    }
+
+    memcpy(buffer, IQSINK_HEADER, strlen(IQSINK_HEADER));
+    utils_uint64_to_be(buffer + IQSINK_OFFSET_SAMPLE, packet->sample);
+    utils_uint64_to_be(buffer + IQSINK_OFFSET_TIMESTAMP,
+                       (uint64_t) ts->tv_sec * 1000 + (uint64_t) ts->tv_nsec / 1000000);
+    utils_uint32_to_be(buffer + IQSINK_OFFSET_FREQUENCY, (uint32_t) ((int64_t) frequency + ctx->offset));
+    utils_uint32_to_be(buffer + IQSINK_OFFSET_SAMPLE_RATE, ctx->dst_rate);
+    buffer[IQSINK_OFFSET_FORMAT] = (uint8_t) ctx->format;
+    utils_uint32_to_be(buffer + IQSINK_OFFSET_SAMPLES, (uint32_t) packet->samples);
+
+    *bytes_written = IQSINK_HEADER_SIZE;
+
+    return EXIT_SUCCESS;
+}
+
+static void iqsink_pack(iqsink_ctx *ctx) {
+    iqsink_packet *packet;
+    size_t sample_size;
+    size_t i;
+    size_t p;
+    int32_t re;
+    int32_t im;
+    int16_t value;
+    float number;
+
+    sample_size = iqsink_get_sample_size(ctx->format);
+
+    for (i = 0; i < ctx->output_size; i++) {
+        switch (ctx->format) {
+            case IQ_FORMAT_INT4:
+                re = iqsink_quantize(creal(ctx->output[i]) * ctx->gain, 7);
+                im = iqsink_quantize(cimag(ctx->output[i]) * ctx->gain, 7);
+                ctx->data[i] = (uint8_t) (((uint32_t) re & 0x0F) << 4 | ((uint32_t) im & 0x0F));
+                break;
+
+            case IQ_FORMAT_INT8:
+                re = iqsink_quantize(creal(ctx->output[i]) * ctx->gain, INT8_MAX);
+                im = iqsink_quantize(cimag(ctx->output[i]) * ctx->gain, INT8_MAX);
+                ctx->data[2 * i] = (uint8_t) (int8_t) re;
+                ctx->data[2 * i + 1] = (uint8_t) (int8_t) im;
+                break;
+
+            case IQ_FORMAT_INT16:
+                value = (int16_t) iqsink_quantize(creal(ctx->output[i]) * ctx->gain, INT16_MAX);
+                utils_int16_to_be(ctx->data + 4 * i, value);
+                value = (int16_t) iqsink_quantize(cimag(ctx->output[i]) * ctx->gain, INT16_MAX);
+                utils_int16_to_be(ctx->data + 4 * i + 2, value);
+                break;
+
+            case IQ_FORMAT_FLOAT:
+                number = (float) (creal(ctx->output[i]) * ctx->gain);
+                memcpy(ctx->data + 8 * i, &number, sizeof(float));
+                number = (float) (cimag(ctx->output[i]) * ctx->gain);
+                memcpy(ctx->data + 8 * i + 4, &number, sizeof(float));
+                break;
+        }
+    }
+
+    for (p = 0; p < ctx->packets_size; p++) {
+        packet = &ctx->packets[p];
+        packet->sample = ctx->sample + p * ctx->packet_samples;
+        packet->samples = ctx->output_size - p * ctx->packet_samples < ctx->packet_samples
+                          ? ctx->output_size - p * ctx->packet_samples : ctx->packet_samples;
+        packet->data = ctx->data + p * ctx->packet_samples * sample_size;
+        packet->data_size = packet->samples * sample_size;
+    }
+
+    ctx->packets_count = ctx->packets_size;
+    ctx->sample += ctx->output_size;
+}
+
+static int32_t iqsink_quantize(FP_FLOAT value, int32_t scale) {
+    long rounded;
+
+    rounded = lround((double) (value * (FP_FLOAT) scale));
+
+    if (rounded > scale)
+        return scale;
+
+    if (rounded < -scale - 1)
+        return -scale - 1;
+
+    return (int32_t) rounded;
+}
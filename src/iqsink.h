@@ -0,0 +1,123 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__IQSINK__H
+#define __RTLSDR_RADIO__IQSINK__H
+
+/*
+
+# 0         1         2         3
+# 012345678901234567890123456789012
+# GFISSSSSSSSttttttttFFFFRRRRfnnnndddd...
+
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <complex.h>
+#include <time.h>
+
+#include "buildflags.h"
+#include "cfg.h"
+#include "fixed.h"
+#include "nco.h"
+#include "decimate.h"
+
+/*
+ * Narrowband IQ stream of one slice of the band.
+ *
+ * Every block of input samples is mixed down by offset Hz, decimated to
+ * dst_rate and quantized to the configured format, scaled by the gain:
+ * int8 and int16 hold I and Q as signed full scale integers (int16 least
+ * significant byte first), float as two native floats and int4 packs I in
+ * the high nibble and Q in the low one of a single byte.
+ *
+ * The block is then split in packets of at most IQSINK_PACKET_SIZE_MAX
+ * bytes. Each header carries the index of its first sample since the
+ * stream start (S), the block timestamp in ms, the frequency of the
+ * baseband center, the sample rate, the format (f) and the sample count
+ * (n). Skipped blocks advance the sample index, so gaps are visible.
+ */
+
+#define IQSINK_HEADER "GFI"
+
+#define IQSINK_OFFSET_SAMPLE 3
+#define IQSINK_OFFSET_TIMESTAMP 11
+#define IQSINK_OFFSET_FREQUENCY 19
+#define IQSINK_OFFSET_SAMPLE_RATE 23
+#define IQSINK_OFFSET_FORMAT 27
+#define IQSINK_OFFSET_SAMPLES 28
+#define IQSINK_HEADER_SIZE 32
+
+#define IQSINK_PACKET_SIZE_MAX 1400
+
+struct iqsink_packet_t {
+    uint64_t sample;
+    size_t samples;
+
+    uint8_t *data;
+    size_t data_size;
+};
+
+struct iqsink_ctx_t {
+    uint32_t src_rate;
+    uint32_t dst_rate;
+    int32_t offset;
+
+    iq_format format;
+    FP_FLOAT gain;
+
+    size_t input_size;
+    size_t output_size;
+
+    nco_ctx *nco;
+    decimate_ctx *decimate;
+
+    FP_FLOAT complex *mixed;
+    FP_FLOAT complex *output;
+    fixed_complex *mixed_fixed;
+    fixed_complex *output_fixed;
+
+    uint64_t sample;
+
+    size_t packet_samples;
+    size_t packets_size;
+    size_t packets_count;
+    struct iqsink_packet_t *packets;
+    uint8_t *data;
+};
+
+typedef struct iqsink_packet_t iqsink_packet;
+typedef struct iqsink_ctx_t iqsink_ctx;
+
+iqsink_ctx *iqsink_init(uint32_t, uint32_t, int32_t, size_t, iq_format, int);
+
+void iqsink_free(iqsink_ctx *);
+
+size_t iqsink_get_sample_size(iq_format);
+
+int iqsink_process(iqsink_ctx *, const FP_FLOAT complex *);
+
+int iqsink_process_fixed(iqsink_ctx *, const fixed_complex *);
+
+void iqsink_skip(iqsink_ctx *, uint64_t);
+
+int iqsink_serialize_header(iqsink_ctx *, iqsink_packet *, struct timespec *, uint32_t, uint8_t *, size_t, size_t *);
+
+#endif
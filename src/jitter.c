@@ -0,0 +1,223 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+#include <math.h>
+
+#include "jitter.h"
+#include "log.h"
+
+static void jitter_update_target(jitter_ctx *);
+
+static void jitter_reset(jitter_ctx *);
+
+jitter_ctx *jitter_init(size_t slots_size, uint32_t latency_ms) {
+    jitter_ctx *ctx;
+
+    log_info("Initializing jitter buffer");
+
+    if (slots_size < 2) {
+        log_error("Jitter buffer needs at least 2 slots");
+        return NULL;
+    }
+
+    log_debug("Allocating jitter buffer context");
+    ctx = (jitter_ctx *) calloc(1, sizeof(jitter_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate jitter buffer context");
+        return NULL;
+    }
+
+    log_debug("Allocating jitter buffer slots");
+    ctx->slots = (jitter_slot *) calloc(slots_size, sizeof(jitter_slot));
+    if (ctx->slots == NULL) {
+        log_error("Unable to allocate jitter buffer slots");
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->slots_size = slots_size;
+    ctx->latency_ms = latency_ms;
+    ctx->frame_ms = 0;
+
+    jitter_update_target(ctx);
+
+    return ctx;
+}
+
+void jitter_free(jitter_ctx *ctx) {
+    log_info("Freeing jitter buffer");
+
+    if (ctx == NULL)
+        return;
+
+    free(ctx->slots);
+    free(ctx);
+}
+
+void jitter_set_frame_ms(jitter_ctx *ctx, double frame_ms) {
+    if (frame_ms == ctx->frame_ms)
+        return;
+
+    log_debug("Frame duration: %.1f ms", frame_ms);
+    ctx->frame_ms = frame_ms;
+
+    jitter_update_target(ctx);
+}
+
+int jitter_put(jitter_ctx *ctx, uint64_t number, uint64_t timestamp, uint64_t arrival,
+               const uint8_t *data, size_t size) {
+    jitter_slot *slot;
+    int64_t transit;
+    int64_t delta;
+
+    if (size > JITTER_DATA_SIZE_MAX) {
+        log_error("Frame too big for jitter buffer: %zu", size);
+        return EXIT_FAILURE;
+    }
+
+    if (timestamp != 0) {
+        transit = (int64_t) (arrival - timestamp);
+
+        if (ctx->has_transit) {
+            delta = llabs(transit - ctx->transit);
+            ctx->jitter_ms += ((double) delta - ctx->jitter_ms) / JITTER_ESTIMATOR_GAIN;
+            jitter_update_target(ctx);
+        }
+
+        ctx->transit = transit;
+        ctx->has_transit = 1;
+    }
+
+    if (ctx->playing && number < ctx->next) {
+        log_trace("Late frame %llu", (unsigned long long) number);
+        ctx->late++;
+        return EXIT_SUCCESS;
+    }
+
+    if (ctx->buffered > 0 && (number >= ctx->next + ctx->slots_size || number + ctx->slots_size <= ctx->next)) {
+        log_debug("Frame %llu out of window, restarting", (unsigned long long) number);
+        jitter_reset(ctx);
+    }
+
+    if (ctx->buffered == 0 && !ctx->playing)
+        ctx->next = number;
+
+    slot = &ctx->slots[number % ctx->slots_size];
+    if (slot->full && slot->number == number) {
+        log_trace("Duplicated frame %llu", (unsigned long long) number);
+        ctx->duplicated++;
+        return EXIT_SUCCESS;
+    }
+
+    if (!slot->full)
+        ctx->buffered++;
+
+    slot->number = number;
+    slot->full = 1;
+    slot->size = size;
+    memcpy(slot->data, data, size);
+
+    if (!ctx->playing && number < ctx->next)
+        ctx->next = number;
+
+    ctx->received++;
+
+    return EXIT_SUCCESS;
+}
+
+jitter_result jitter_get(jitter_ctx *ctx, uint8_t *data, size_t *size) {
+    jitter_slot *slot;
+
+    if (!ctx->playing) {
+        if (ctx->buffered < ctx->target)
+            return JITTER_EMPTY;
+
+        log_debug("Starting playout with %zu frames", ctx->buffered);
+        ctx->playing = 1;
+        ctx->gaps = 0;
+    }
+
+    slot = &ctx->slots[ctx->next % ctx->slots_size];
+
+    if (ctx->buffered > ctx->target + JITTER_DRIFT_FRAMES && slot->full && slot->number == ctx->next) {
+        log_trace("Skipping frame %llu to reduce latency", (unsigned long long) ctx->next);
+        slot->full = 0;
+        ctx->buffered--;
+        ctx->next++;
+        ctx->skipped++;
+
+        slot = &ctx->slots[ctx->next % ctx->slots_size];
+    }
+
+    if (slot->full && slot->number == ctx->next) {
+        memcpy(data, slot->data, slot->size);
+        *size = slot->size;
+
+        slot->full = 0;
+        ctx->buffered--;
+        ctx->next++;
+        ctx->gaps = 0;
+        ctx->played++;
+
+        return JITTER_FRAME;
+    }
+
+    ctx->next++;
+    ctx->gaps++;
+
+    if (ctx->buffered == 0 && ctx->gaps > ctx->target) {
+        log_debug("Stream idle, stopping playout");
+        ctx->playing = 0;
+        return JITTER_EMPTY;
+    }
+
+    ctx->concealed++;
+
+    return JITTER_LOST;
+}
+
+static void jitter_update_target(jitter_ctx *ctx) {
+    double delay;
+    size_t target;
+
+    delay = ctx->latency_ms > 3 * ctx->jitter_ms ? ctx->latency_ms : 3 * ctx->jitter_ms;
+
+    target = ctx->frame_ms > 0 ? (size_t) ceil(delay / ctx->frame_ms) : 1;
+
+    if (target < 1)
+        target = 1;
+    if (target > ctx->slots_size / 2)
+        target = ctx->slots_size / 2;
+
+    ctx->target = target;
+}
+
+static void jitter_reset(jitter_ctx *ctx) {
+    size_t i;
+
+    for (i = 0; i < ctx->slots_size; i++)
+        ctx->slots[i].full = 0;
+
+    ctx->buffered = 0;
+    ctx->playing = 0;
+    ctx->gaps = 0;
+}
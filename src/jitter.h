@@ -0,0 +1,99 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__JITTER__H
+#define __RTLSDR_RADIO__JITTER__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Adaptive jitter buffer for received codec frames, keyed by payload number.
+ *
+ * Frames are stored in a ring of slots. Playout starts once the target
+ * depth is buffered, then every jitter_get returns the next number in
+ * sequence, either the received frame or a gap to be concealed. The target
+ * depth follows the interarrival jitter (RFC 3550 estimator), never below
+ * the configured latency and never above half of the ring.
+ *
+ * When the buffer grows beyond target + JITTER_DRIFT_FRAMES one frame is
+ * skipped at a time to bring latency back. After more consecutive gaps than
+ * the target depth with an empty buffer (the sender squelch closed) the
+ * buffer stops and waits for the next transmission.
+ */
+
+#define JITTER_DATA_SIZE_MAX 1024
+#define JITTER_DRIFT_FRAMES 2
+#define JITTER_ESTIMATOR_GAIN 16
+
+enum jitter_result_t {
+    JITTER_FRAME = 0,
+    JITTER_LOST = 1,
+    JITTER_EMPTY = 2
+};
+
+typedef enum jitter_result_t jitter_result;
+
+struct jitter_slot_t {
+    uint64_t number;
+    int full;
+
+    size_t size;
+    uint8_t data[JITTER_DATA_SIZE_MAX];
+};
+
+struct jitter_ctx_t {
+    size_t slots_size;
+    struct jitter_slot_t *slots;
+
+    double latency_ms;
+    double frame_ms;
+    double jitter_ms;
+
+    int64_t transit;
+    int has_transit;
+
+    uint64_t next;
+    size_t buffered;
+    size_t target;
+    size_t gaps;
+    int playing;
+
+    uint64_t received;
+    uint64_t played;
+    uint64_t concealed;
+    uint64_t late;
+    uint64_t duplicated;
+    uint64_t skipped;
+};
+
+typedef struct jitter_slot_t jitter_slot;
+typedef struct jitter_ctx_t jitter_ctx;
+
+jitter_ctx *jitter_init(size_t, uint32_t);
+
+void jitter_free(jitter_ctx *);
+
+void jitter_set_frame_ms(jitter_ctx *, double);
+
+int jitter_put(jitter_ctx *, uint64_t, uint64_t, uint64_t, const uint8_t *, size_t);
+
+jitter_result jitter_get(jitter_ctx *, uint8_t *, size_t *);
+
+#endif
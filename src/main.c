@@ -26,6 +26,9 @@
 #include "main_rx.h"
 #include "main_rx.h"
 #include "main_info.h"
+#include "main_survey.h"
+#include "main_play.h"
+#include "main_vote.h"
 #include "http.h"
 #include "ui.h"
 #include "cfg.h"
@@ -143,6 +146,22 @@ int main_program(int argc, char **argv) {
                 result = main_info();
                 break;
 
+            case MODE_SCAN:
+                result = main_rx();
+                break;
+
+            case MODE_SURVEY:
+                result = main_survey();
+                break;
+
+            case MODE_PLAY:
+                result = main_play();
+                break;
+
+            case MODE_VOTE:
+                result = main_vote();
+                break;
+
             default:
                 log_error("Mode not implemented");
                 result = EXIT_FAILURE;
@@ -0,0 +1,504 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/prctl.h>
+
+#include "main_play.h"
+#include "main.h"
+#include "cfg.h"
+#include "log.h"
+#include "audio.h"
+#include "wav.h"
+#include "codec.h"
+#include "network.h"
+#include "payload.h"
+#include "jitter.h"
+#include "fec.h"
+
+extern volatile int keep_running;
+extern cfg *conf;
+
+pthread_t play_receive_thread;
+
+pthread_mutex_t play_jitter_mutex;
+
+jitter_ctx *play_jitter;
+fec_ctx *play_fec;
+network_ctx *play_network;
+codec_ctx *play_codec;
+
+int play_codec_mode;
+size_t play_codec_pcm_size;
+size_t play_codec_data_size;
+
+audio_ctx *play_audio;
+wav_ctx *play_wav;
+
+uint8_t *play_frame;
+int16_t *play_pcm;
+int16_t *play_pcm_last;
+size_t play_pcm_last_size;
+
+static int main_play_codec(int);
+
+static void main_play_put(payload *, uint64_t, uint64_t);
+
+static void main_play_repair(payload *, uint32_t, uint32_t, uint64_t);
+
+static void main_play_deadline(struct timespec *, long);
+
+int main_play() {
+    int result;
+    pthread_attr_t attr;
+    int thread_result;
+
+    jitter_result status;
+    size_t frame_size;
+    size_t pcm_size;
+    size_t frames;
+    size_t repeats;
+    size_t f;
+    size_t i;
+    int mode;
+
+    struct timespec deadline;
+    struct timespec now;
+    struct timespec stats;
+
+    log_info("Main program play mode");
+
+    play_jitter = NULL;
+    play_fec = NULL;
+    play_network = NULL;
+    play_codec = NULL;
+    play_audio = NULL;
+    play_wav = NULL;
+    play_frame = NULL;
+    play_pcm = NULL;
+    play_pcm_last = NULL;
+    play_pcm_last_size = 0;
+
+    log_debug("Initializing mutex");
+    pthread_mutex_init(&play_jitter_mutex, NULL);
+
+    log_debug("Initializing codec");
+    if (main_play_codec(conf->codec2_mode) != EXIT_SUCCESS) {
+        main_play_end();
+        return EXIT_FAILURE;
+    }
+
+    play_codec_mode = conf->codec2_mode;
+
+    log_debug("Allocating frame buffer");
+    play_frame = (uint8_t *) calloc(JITTER_DATA_SIZE_MAX, sizeof(uint8_t));
+    if (play_frame == NULL) {
+        log_error("Unable to allocate frame buffer");
+        main_play_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Initializing jitter buffer");
+    play_jitter = jitter_init(MAIN_PLAY_SLOTS, conf->play_latency);
+    if (play_jitter == NULL) {
+        log_error("Unable to initialize jitter buffer");
+        main_play_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Initializing FEC context");
+    play_fec = fec_init(FEC_GROUP_SIZE_MAX, JITTER_DATA_SIZE_MAX);
+    if (play_fec == NULL) {
+        log_error("Unable to initialize FEC context");
+        main_play_end();
+        return EXIT_FAILURE;
+    }
+
+    if (conf->audio_monitor_enabled == FLAG_TRUE) {
+        log_debug("Initializing audio context");
+        play_audio = audio_init(conf->audio_monitor_device, MAIN_PLAY_SAMPLE_RATE, 1, SND_PCM_FORMAT_S16,
+                                conf->audio_frames_per_period);
+        if (play_audio == NULL) {
+            log_error("Unable to allocate audio context");
+            main_play_end();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (conf->audio_file_enabled == FLAG_TRUE) {
+        log_debug("Initializing wav context");
+        play_wav = wav_init(conf->audio_file_path, 1, MAIN_PLAY_SAMPLE_RATE, 16);
+        if (play_wav == NULL) {
+            log_error("Unable to allocate wav context");
+            main_play_end();
+            return EXIT_FAILURE;
+        }
+
+        log_debug("Opening WAV file");
+        wav_write_begin(play_wav);
+    }
+
+    log_debug("Binding network socket");
+    play_network = network_init(conf->play_address, conf->play_port);
+    if (play_network == NULL || network_socket_bind(play_network, MAIN_PLAY_SOCKET_BUFFER) != EXIT_SUCCESS) {
+        log_error("Unable to bind network socket");
+        main_play_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Starting play receive thread");
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+    pthread_create(&play_receive_thread, &attr, thread_play_receive, NULL);
+
+    result = EXIT_SUCCESS;
+    repeats = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    stats = deadline;
+
+    log_debug("Starting play loop");
+    while (keep_running) {
+        pthread_mutex_lock(&play_jitter_mutex);
+        status = jitter_get(play_jitter, play_frame, &frame_size);
+        mode = play_codec_mode;
+        pthread_mutex_unlock(&play_jitter_mutex);
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > stats.tv_sec
+            || (now.tv_sec == stats.tv_sec && now.tv_nsec >= stats.tv_nsec)) {
+            pthread_mutex_lock(&play_jitter_mutex);
+            log_info("Depth %zu/%zu - Jitter %.1f ms - Received %llu - Played %llu - Concealed %llu - Late %llu"
+                     " - Duplicated %llu - Skipped %llu - Recovered %llu",
+                     play_jitter->buffered, play_jitter->target, play_jitter->jitter_ms,
+                     (unsigned long long) play_jitter->received, (unsigned long long) play_jitter->played,
+                     (unsigned long long) play_jitter->concealed, (unsigned long long) play_jitter->late,
+                     (unsigned long long) play_jitter->duplicated, (unsigned long long) play_jitter->skipped,
+                     (unsigned long long) play_fec->recoveries);
+            pthread_mutex_unlock(&play_jitter_mutex);
+
+            stats = now;
+            main_play_deadline(&stats, MAIN_PLAY_STATS_MS * 1000000L);
+        }
+
+        if (status == JITTER_EMPTY) {
+            repeats = 0;
+            deadline = now;
+            main_play_deadline(&deadline, MAIN_PLAY_IDLE_MS * 1000000L);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+            continue;
+        }
+
+        if (mode != play_codec->mode && main_play_codec(mode) != EXIT_SUCCESS) {
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        if (status == JITTER_FRAME) {
+            frames = frame_size / play_codec->data_size;
+            for (f = 0; f < frames; f++)
+                codec_decode(play_codec, play_frame + f * play_codec->data_size,
+                             play_pcm + f * play_codec->pcm_size);
+
+            pcm_size = frames * play_codec->pcm_size;
+
+            memcpy(play_pcm_last, play_pcm, pcm_size * sizeof(int16_t));
+            play_pcm_last_size = pcm_size;
+            repeats = 0;
+        } else {
+            pcm_size = play_pcm_last_size > 0 ? play_pcm_last_size : play_codec->pcm_size;
+
+            if (conf->play_concealment == FLAG_TRUE && play_pcm_last_size > 0 && repeats < MAIN_PLAY_REPEAT_MAX) {
+                repeats++;
+                for (i = 0; i < pcm_size; i++)
+                    play_pcm[i] = (int16_t) (play_pcm_last[i] >> repeats);
+            } else {
+                memset(play_pcm, 0, pcm_size * sizeof(int16_t));
+            }
+        }
+
+        if (pcm_size == 0)
+            continue;
+
+        if (play_audio != NULL && audio_play_int16(play_audio, play_pcm, pcm_size) != EXIT_SUCCESS) {
+            log_error("Unable to play buffer");
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        if (play_wav != NULL)
+            wav_write_data_int16(play_wav, play_pcm, pcm_size);
+
+        if (conf->audio_stdout == FLAG_TRUE)
+            fwrite(play_pcm, sizeof(int16_t), pcm_size, stdout);
+
+        main_play_deadline(&deadline, (long) (pcm_size * 1000000000L / MAIN_PLAY_SAMPLE_RATE));
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    }
+
+    main_stop();
+
+    log_debug("Joining play receive thread");
+    pthread_join(play_receive_thread, (void **) &thread_result);
+    if (thread_result != EXIT_SUCCESS) {
+        log_error("Play receive thread exit without success");
+        result = EXIT_FAILURE;
+    }
+
+    main_play_end();
+
+    return result;
+}
+
+void main_play_end() {
+    log_info("Main program play mode ending");
+
+    if (play_network != NULL) {
+        log_debug("Closing network socket");
+        network_socket_close(play_network);
+        network_free(play_network);
+        play_network = NULL;
+    }
+
+    if (play_audio != NULL) {
+        log_debug("Freeing audio context");
+        audio_free(play_audio);
+        play_audio = NULL;
+    }
+
+    if (play_wav != NULL) {
+        log_debug("Closing WAV file");
+        wav_write_end(play_wav);
+
+        log_debug("Freeing WAV context");
+        wav_free(play_wav);
+        play_wav = NULL;
+    }
+
+    log_debug("Freeing play buffers");
+    jitter_free(play_jitter);
+    play_jitter = NULL;
+
+    fec_free(play_fec);
+    play_fec = NULL;
+
+    if (play_codec != NULL)
+        codec_free(play_codec);
+    play_codec = NULL;
+
+    free(play_frame);
+    play_frame = NULL;
+
+    free(play_pcm);
+    play_pcm = NULL;
+
+    free(play_pcm_last);
+    play_pcm_last = NULL;
+
+    pthread_mutex_destroy(&play_jitter_mutex);
+}
+
+void *thread_play_receive() {
+    int retval;
+
+    uint8_t *buffer;
+    ssize_t ln;
+    payload *p;
+    payload_v2_state state;
+    uint32_t channel;
+    uint32_t frames;
+    uint32_t mask;
+    uint32_t size;
+    uint64_t timestamp;
+    uint64_t arrival;
+    const uint8_t *cursor;
+    const uint8_t *end;
+    struct timespec now;
+
+    prctl(PR_SET_NAME, "receive");
+    log_info("Thread start");
+
+    retval = EXIT_SUCCESS;
+
+    memset(&state, 0, sizeof(state));
+
+    buffer = (uint8_t *) calloc(MAIN_PLAY_BUFFER_SIZE, sizeof(uint8_t));
+    p = payload_init();
+    if (buffer == NULL || p == NULL) {
+        log_error("Unable to allocate receive buffers");
+        retval = EXIT_FAILURE;
+    }
+
+    while (retval == EXIT_SUCCESS && keep_running) {
+        ln = network_socket_receive(play_network, buffer, MAIN_PLAY_BUFFER_SIZE);
+        if (ln == -1) {
+            retval = EXIT_FAILURE;
+            break;
+        } else if (ln == 0) {
+            continue;
+        }
+
+        timespec_get(&now, TIME_UTC);
+        arrival = (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+
+        end = buffer + ln;
+
+        switch (payload_get_version(buffer, (size_t) ln)) {
+            case 1:
+                if (memcmp(buffer, PAYLOAD_AGGREGATE_HEADER, strlen(PAYLOAD_AGGREGATE_HEADER)) == 0) {
+                    if (payload_aggregate_parse(p, buffer, (size_t) ln, &frames) != EXIT_SUCCESS
+                        || p->channel != conf->play_channel)
+                        break;
+
+                    timestamp = p->timestamp;
+                    cursor = p->data;
+                    for (; frames > 0; frames--) {
+                        if (payload_aggregate_parse_frame(p, &cursor, end) != EXIT_SUCCESS)
+                            break;
+
+                        main_play_put(p, timestamp, arrival);
+                        timestamp = 0;
+                    }
+                } else if (memcmp(buffer, PAYLOAD_REPAIR_HEADER, strlen(PAYLOAD_REPAIR_HEADER)) == 0) {
+                    if (payload_repair_parse(p, buffer, (size_t) ln, &mask, &size) != EXIT_SUCCESS
+                        || p->channel != conf->play_channel)
+                        break;
+
+                    main_play_repair(p, mask, size, arrival);
+                } else {
+                    if (payload_parse(p, buffer, (size_t) ln) != EXIT_SUCCESS || p->channel != conf->play_channel)
+                        break;
+
+                    main_play_put(p, p->timestamp, arrival);
+                }
+
+                break;
+
+            case 2:
+                if (payload_v2_get_channel(buffer, (size_t) ln, &channel) != EXIT_SUCCESS
+                    || channel != conf->play_channel
+                    || payload_v2_parse(p, &state, buffer, (size_t) ln) != EXIT_SUCCESS)
+                    break;
+
+                pthread_mutex_lock(&play_jitter_mutex);
+                play_codec_mode = p->codec_mode;
+                pthread_mutex_unlock(&play_jitter_mutex);
+
+                if (p->flags & PAYLOAD_V2_FLAG_AGGREGATE) {
+                    timestamp = p->timestamp;
+                    cursor = p->data;
+                    while (payload_v2_parse_frame(p, &state, &cursor, end) == EXIT_SUCCESS) {
+                        main_play_put(p, timestamp, arrival);
+                        timestamp = 0;
+                    }
+                } else {
+                    main_play_put(p, p->timestamp, arrival);
+                }
+
+                break;
+
+            default:
+                log_debug("Unknown payload of %zd bytes", ln);
+        }
+    }
+
+    payload_free(p);
+    free(buffer);
+
+    main_stop();
+
+    log_info("Thread end: %d", retval);
+
+    pthread_exit(&retval);
+}
+
+static int main_play_codec(int mode) {
+    log_debug("Initializing codec mode %d", mode);
+
+    if (play_codec != NULL)
+        codec_free(play_codec);
+
+    play_codec = codec_init(mode);
+    if (play_codec == NULL) {
+        log_error("Unable to allocate codec context");
+        return EXIT_FAILURE;
+    }
+
+    free(play_pcm);
+    free(play_pcm_last);
+
+    play_pcm = (int16_t *) calloc(JITTER_DATA_SIZE_MAX / play_codec->data_size * play_codec->pcm_size,
+                                  sizeof(int16_t));
+    play_pcm_last = (int16_t *) calloc(JITTER_DATA_SIZE_MAX / play_codec->data_size * play_codec->pcm_size,
+                                       sizeof(int16_t));
+    play_pcm_last_size = 0;
+
+    if (play_pcm == NULL || play_pcm_last == NULL) {
+        log_error("Unable to allocate PCM buffers");
+        return EXIT_FAILURE;
+    }
+
+    pthread_mutex_lock(&play_jitter_mutex);
+    play_codec_pcm_size = play_codec->pcm_size;
+    play_codec_data_size = play_codec->data_size;
+    pthread_mutex_unlock(&play_jitter_mutex);
+
+    return EXIT_SUCCESS;
+}
+
+static void main_play_put(payload *p, uint64_t timestamp, uint64_t arrival) {
+    size_t frames;
+
+    pthread_mutex_lock(&play_jitter_mutex);
+
+    frames = p->data_size / play_codec_data_size;
+    if (frames > 0)
+        jitter_set_frame_ms(play_jitter, (double) (frames * play_codec_pcm_size) * 1000 / MAIN_PLAY_SAMPLE_RATE);
+
+    jitter_put(play_jitter, p->number, timestamp, arrival, p->data, p->data_size);
+    fec_decode_frame(play_fec, p->number, timestamp, p->data, p->data_size);
+
+    pthread_mutex_unlock(&play_jitter_mutex);
+}
+
+static void main_play_repair(payload *p, uint32_t mask, uint32_t size, uint64_t arrival) {
+    fec_frame *frame;
+
+    pthread_mutex_lock(&play_jitter_mutex);
+
+    if (fec_decode_repair(play_fec, p->number, mask, p->timestamp, size, p->data, p->data_size) == FEC_RECOVERED) {
+        // The repair comes at the end of the group, its arrival says nothing about the network jitter
+        frame = &play_fec->recovered;
+        jitter_put(play_jitter, frame->number, 0, arrival, frame->data, frame->size);
+    }
+
+    pthread_mutex_unlock(&play_jitter_mutex);
+}
+
+static void main_play_deadline(struct timespec *ts, long ns) {
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= 1000000000L) {
+        ts->tv_nsec -= 1000000000L;
+        ts->tv_sec++;
+    }
+}
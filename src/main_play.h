@@ -0,0 +1,52 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__MAIN_PLAY__H
+#define __RTLSDR_RADIO__MAIN_PLAY__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MAIN_PLAY_SAMPLE_RATE 8000
+#define MAIN_PLAY_SOCKET_BUFFER (4 * 1024 * 1024)
+#define MAIN_PLAY_BUFFER_SIZE 65536
+#define MAIN_PLAY_SLOTS 64
+#define MAIN_PLAY_REPEAT_MAX 3
+#define MAIN_PLAY_IDLE_MS 5
+#define MAIN_PLAY_STATS_MS 1000
+
+/*
+ * Play mode receives the payloads sent by rx mode (v1, aggregated v1 and v2)
+ * for a single channel, reorders them in a jitter buffer and decodes them
+ * at the codec2 rate of 8 kHz.
+ *
+ * The receive thread only parses and stores frames, while the main loop
+ * pulls one frame per frame period on an absolute monotonic deadline, so
+ * playout is not paced by packet arrival. Lost frames are concealed by
+ * repeating the last decoded frame, halving its level each time, up to
+ * MAIN_PLAY_REPEAT_MAX times, then by silence.
+ */
+
+int main_play();
+
+void main_play_end();
+
+void *thread_play_receive();
+
+#endif
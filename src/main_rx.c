@@ -24,6 +24,7 @@
 #include <rtl-sdr.h>
 #include <math.h>
 #include <unistd.h>
+#include <errno.h>
 #include <sys/time.h>
 #include <sys/prctl.h>
 
@@ -35,7 +36,21 @@
 #include "device.h"
 #include "circbuf.h"
 #include "greatbuf.h"
+#include "decimate.h"
 #include "fir.h"
+#include "fir_design.h"
+#include "fixed.h"
+#include "nco.h"
+#include "channelizer.h"
+#include "squelch.h"
+#include "tone.h"
+#include "iqcorr.h"
+#include "agc.h"
+#include "spectrum.h"
+#include "iqsink.h"
+#include "control.h"
+#include "scan.h"
+#include "dsp.h"
 #include "fft.h"
 #include "resample.h"
 #include "codec.h"
@@ -43,6 +58,8 @@
 #include "wav.h"
 #include "payload.h"
 #include "network.h"
+#include "fec.h"
+#include "stream.h"
 #include "buildflags.h"
 
 extern volatile int keep_running;
@@ -80,6 +97,22 @@ pthread_t rx_codec_thread;
 pthread_t rx_network_thread;
 #endif
 
+#ifdef MAIN_RX_ENABLE_THREAD_SPECTRUM
+pthread_t rx_spectrum_thread;
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_IQ
+pthread_t rx_iq_thread;
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_CONTROL
+pthread_t rx_control_thread;
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_SCAN
+pthread_t rx_scan_thread;
+#endif
+
 pthread_mutex_t rx_ready_mutex;
 pthread_cond_t rx_ready_cond;
 
@@ -91,13 +124,26 @@ int rx_resample_ready;
 int rx_audio_ready;
 int rx_codec_ready;
 int rx_network_ready;
+int rx_spectrum_ready;
+int rx_iq_ready;
+int rx_control_ready;
+int rx_scan_ready;
 
 rtlsdr_dev_t *rx_device;
 FILE *rx_file;
 
 greatbuf_ctx *greatbuf;
 
-codec_ctx *ctx_codec;
+control_ctx *rx_control;
+scan_ctx *rx_scan;
+
+codec_ctx **ctx_codecs;
+
+size_t rx_channels;
+uint32_t *rx_channel_freqs;
+
+uint32_t rx_channel_sample_rate;
+size_t rx_channel_size;
 
 size_t rx_pcm_size;
 size_t rx_data_size;
@@ -105,6 +151,22 @@ size_t rx_data_size;
 size_t rx_min_pcm_size;
 size_t rx_min_codec_data_size;
 
+#ifdef MAIN_RX_ENABLE_THREAD_FILTER
+
+static int main_rx_filter_init(filter_mode, uint32_t, uint32_t, fft_rigor, fir_ctx ***, fft_ctx **, fft_ctx **);
+
+static void main_rx_filter_free(filter_mode, fir_ctx **, fft_ctx *, fft_ctx *);
+
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_NETWORK
+
+static int main_rx_network_flush(network_batch *, payload_v2_state *, uint8_t *, size_t *, uint32_t *);
+
+static int main_rx_network_repair(network_batch *, payload *, fec_ctx *, uint32_t);
+
+#endif
+
 int main_rx() {
     int result;
     pthread_attr_t attr;
@@ -117,41 +179,228 @@ int main_rx() {
 
     int thread_result;
 
+    uint32_t decimation_ratio;
     FP_FLOAT sample_pcm_ratio;
 
+    int64_t offset;
+    size_t c;
+
+    uint64_t scan_hops;
+    struct timespec scan_ts;
+    struct timespec scan_elapsed;
+
     log_info("Main program RX 2 mode");
 
     greatbuf = NULL;
+    rx_control = NULL;
+    rx_scan = NULL;
+    ctx_codecs = NULL;
+    rx_channel_freqs = NULL;
+
+    rx_channel_sample_rate = conf->channel_sample_rate;
+    if (rx_channel_sample_rate == 0)
+        rx_channel_sample_rate = conf->rtlsdr_device_sample_rate;
+
+    if (conf->rtlsdr_device_sample_rate % rx_channel_sample_rate != 0) {
+        log_error("Device sample rate %u is not a multiple of channel sample rate %u",
+                  conf->rtlsdr_device_sample_rate, rx_channel_sample_rate);
+        return EXIT_FAILURE;
+    }
+
+    decimation_ratio = conf->rtlsdr_device_sample_rate / rx_channel_sample_rate;
+    if (conf->rtlsdr_samples % decimation_ratio != 0) {
+        log_error("RTL-SDR samples %zu are not a multiple of decimation ratio %u",
+                  conf->rtlsdr_samples, decimation_ratio);
+        return EXIT_FAILURE;
+    }
+
+    rx_channel_size = conf->rtlsdr_samples / decimation_ratio;
+
+    log_debug("Decimation ratio: %u", decimation_ratio);
+    log_debug("Channel has %zu samples per iteration", rx_channel_size);
+
+    if (conf->channelizer_channels > 0) {
+#ifdef RTLSDR_RADIO_FIXED_POINT
+        log_error("Channelizer is not available in fixed point build");
+        return EXIT_FAILURE;
+#else
+        if (conf->channelizer_channels < CHANNELIZER_OVERSAMPLE
+            || conf->rtlsdr_device_sample_rate % conf->channelizer_channels != 0
+            || (conf->rtlsdr_device_sample_rate / (conf->channelizer_channels / CHANNELIZER_OVERSAMPLE))
+               % rx_channel_sample_rate != 0) {
+            log_error("Channelizer with %zu channels does not fit device rate %u and channel rate %u",
+                      conf->channelizer_channels, conf->rtlsdr_device_sample_rate, rx_channel_sample_rate);
+            return EXIT_FAILURE;
+        }
+
+        log_debug("Channelizer: %zu channels spaced %u Hz", conf->channelizer_channels,
+                  conf->rtlsdr_device_sample_rate / (uint32_t) conf->channelizer_channels);
+#endif
+    }
+
+    if (conf->spectrum == FLAG_TRUE
+        && (conf->spectrum_size > conf->rtlsdr_samples || conf->spectrum_rate == 0 || conf->spectrum_averages == 0)) {
+        log_error("Spectrum size %zu, rate %u and averages %zu do not fit %zu samples per iteration",
+                  conf->spectrum_size, conf->spectrum_rate, conf->spectrum_averages, conf->rtlsdr_samples);
+        return EXIT_FAILURE;
+    }
+
+    if (conf->iq == FLAG_TRUE
+        && (conf->iq_sample_rate == 0 || conf->rtlsdr_device_sample_rate % conf->iq_sample_rate != 0
+            || conf->rtlsdr_samples % (conf->rtlsdr_device_sample_rate / conf->iq_sample_rate) != 0
+            || (uint32_t) labs(conf->iq_offset) >= conf->rtlsdr_device_sample_rate / 2)) {
+        log_error("IQ sample rate %u and offset %d do not fit sample rate %u and %zu samples per iteration",
+                  conf->iq_sample_rate, conf->iq_offset, conf->rtlsdr_device_sample_rate, conf->rtlsdr_samples);
+        return EXIT_FAILURE;
+    }
+
+    if (conf->mode == MODE_SCAN
+        && (conf->scan_freqs_count == 0 || conf->channel_freqs_count > 0 || conf->squelch == SQUELCH_MODE_NONE)) {
+        log_error("Scan mode needs scan_freqs, a squelch and channels following the center frequency");
+        return EXIT_FAILURE;
+    }
+
+    if (conf->ctcss_tones_count > 1
+        && conf->ctcss_tones_count != (conf->channel_freqs_count > 0 ? conf->channel_freqs_count : 1)) {
+        log_error("ctcss_tones needs one tone for all channels or one tone per channel");
+        return EXIT_FAILURE;
+    }
+
+    for (c = 0; c < conf->ctcss_tones_count; c++) {
+        if (conf->ctcss_tones[c] != 0 && tone_index(conf->ctcss_tones[c]) < 0) {
+            log_error("Tone %u.%u Hz is not a standard CTCSS tone", conf->ctcss_tones[c] / 10,
+                      conf->ctcss_tones[c] % 10);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (conf->network_aggregate_frames == 0) {
+        log_error("network_aggregate_frames must be at least 1");
+        return EXIT_FAILURE;
+    }
+
+    if (conf->network_protocol == 2 && conf->network_aggregate_frames > PAYLOAD_V2_AGGREGATE_FRAMES_MAX) {
+        log_error("network_aggregate_frames must be at most %d with network_protocol 2",
+                  PAYLOAD_V2_AGGREGATE_FRAMES_MAX);
+        return EXIT_FAILURE;
+    }
+
+    if (conf->network_protocol != 1 && conf->network_protocol != 2) {
+        log_error("network_protocol must be 1 or 2");
+        return EXIT_FAILURE;
+    }
+
+    if (conf->network_fec != 0
+        && (conf->network_fec < FEC_GROUP_SIZE_MIN || conf->network_fec > FEC_GROUP_SIZE_MAX)) {
+        log_error("network_fec must be 0 or between %d and %d", FEC_GROUP_SIZE_MIN, FEC_GROUP_SIZE_MAX);
+        return EXIT_FAILURE;
+    }
+
+    if (conf->network_fec != 0 && (conf->network_aggregate_frames > 1 || conf->network_aggregate_time > 0)) {
+        log_error("network_fec needs network_aggregate_frames = 1 and network_aggregate_time = 0");
+        return EXIT_FAILURE;
+    }
+
+    if (conf->network_transport == NETWORK_TRANSPORT_TCP && conf->network_queue < 2) {
+        log_error("network_queue must be at least 2");
+        return EXIT_FAILURE;
+    }
 
-    sample_pcm_ratio = (FP_FLOAT) conf->rtlsdr_device_sample_rate / (FP_FLOAT) conf->audio_sample_rate;
-    rx_pcm_size = (size_t) ((FP_FLOAT) conf->rtlsdr_samples / sample_pcm_ratio);
+    sample_pcm_ratio = (FP_FLOAT) rx_channel_sample_rate / (FP_FLOAT) conf->audio_sample_rate;
+    rx_pcm_size = (size_t) ((FP_FLOAT) rx_channel_size / sample_pcm_ratio);
 
-    log_debug("Samples/PCM ratio: %0.2f", sample_pcm_ratio);
+    log_debug("Channel/PCM ratio: %0.2f", sample_pcm_ratio);
     log_debug("PCM has %zu samples per iteration", rx_pcm_size);
 
-    ctx_codec = codec_init(conf->codec2_mode);
-    if (ctx_codec == NULL) {
-        log_error("Unable to allocate codec context");
+    rx_channels = conf->channel_freqs_count > 0 ? conf->channel_freqs_count : 1;
+
+    log_debug("Allocating channel frequencies");
+    rx_channel_freqs = (uint32_t *) calloc(rx_channels, sizeof(uint32_t));
+    if (rx_channel_freqs == NULL) {
+        log_error("Unable to allocate channel frequencies");
+        main_rx_end();
+        return EXIT_FAILURE;
+    }
+
+    for (c = 0; c < rx_channels; c++) {
+        if (conf->channel_freqs_count > 0)
+            rx_channel_freqs[c] = conf->channel_freqs[c];
+        else
+            rx_channel_freqs[c] = conf->rtlsdr_device_center_freq;
+
+        offset = (int64_t) rx_channel_freqs[c] - conf->rtlsdr_device_center_freq;
+        if (llabs(offset) * 2 + rx_channel_sample_rate > conf->rtlsdr_device_sample_rate) {
+            log_error("Channel %zu at %u Hz is outside the captured band", c + 1, rx_channel_freqs[c]);
+            main_rx_end();
+            return EXIT_FAILURE;
+        }
+
+        log_debug("Channel %zu: %u Hz (offset %lld Hz)", c + 1, rx_channel_freqs[c], (long long) offset);
+    }
+
+    log_debug("Allocating codec contexts");
+    ctx_codecs = (codec_ctx **) calloc(rx_channels, sizeof(codec_ctx *));
+    if (ctx_codecs == NULL) {
+        log_error("Unable to allocate codec contexts");
         main_rx_end();
         return EXIT_FAILURE;
     }
 
-    rx_min_pcm_size = codec_get_pcm_size(ctx_codec);
+    for (c = 0; c < rx_channels; c++) {
+        ctx_codecs[c] = codec_init(conf->codec2_mode);
+        if (ctx_codecs[c] == NULL) {
+            log_error("Unable to allocate codec context");
+            main_rx_end();
+            return EXIT_FAILURE;
+        }
+    }
+
+    rx_min_pcm_size = codec_get_pcm_size(ctx_codecs[0]);
     log_debug("Codec PCM size: %zu", rx_min_pcm_size);
 
-    rx_min_codec_data_size = codec_get_data_size(ctx_codec);
+    rx_min_codec_data_size = codec_get_data_size(ctx_codecs[0]);
     log_debug("Codec data size: %zu", rx_min_codec_data_size);
 
     rx_data_size = rx_min_codec_data_size;
 
+    log_debug("Loading FFT wisdom");
+    if (fft_wisdom_init(conf->fft_wisdom_file) != EXIT_SUCCESS) {
+        log_error("Unable to load FFT wisdom");
+        main_rx_end();
+        return EXIT_FAILURE;
+    }
+
     log_debug("Initializing Great Buffer");
-    greatbuf = greatbuf_init(MAIN_RX_BUFFERS_SIZE, conf->rtlsdr_samples, rx_pcm_size, rx_data_size);
+    greatbuf = greatbuf_init(MAIN_RX_BUFFERS_SIZE, conf->rtlsdr_samples, rx_channel_size, rx_pcm_size, rx_data_size,
+                             rx_channels);
     if (greatbuf == NULL) {
         log_error("Unable to allocate Greatbuf");
         main_rx_end();
         return EXIT_FAILURE;
     }
 
+    log_debug("Initializing control context");
+    rx_control = control_init(conf, conf->control_port);
+    if (rx_control == NULL) {
+        log_error("Unable to allocate control context");
+        main_rx_end();
+        return EXIT_FAILURE;
+    }
+
+    if (conf->mode == MODE_SCAN) {
+        log_debug("Initializing scan context");
+        rx_scan = scan_init(conf->scan_freqs, conf->scan_freqs_count,
+                            ((size_t) conf->scan_dwell * rx_channel_sample_rate + 1000 * rx_channel_size - 1)
+                            / (1000 * rx_channel_size),
+                            ((size_t) conf->scan_resume * rx_channel_sample_rate + 1000 * rx_channel_size - 1)
+                            / (1000 * rx_channel_size));
+        if (rx_scan == NULL) {
+            log_error("Unable to allocate scan context");
+            main_rx_end();
+            return EXIT_FAILURE;
+        }
+    }
+
 #ifdef MAIN_RX_ENABLE_THREAD_READ
     rx_read_ready = 0;
 #else
@@ -200,6 +449,30 @@ int main_rx() {
     rx_network_ready = 1;
 #endif
 
+#ifdef MAIN_RX_ENABLE_THREAD_SPECTRUM
+    rx_spectrum_ready = 0;
+#else
+    rx_spectrum_ready = 1;
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_IQ
+    rx_iq_ready = 0;
+#else
+    rx_iq_ready = 1;
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_CONTROL
+    rx_control_ready = 0;
+#else
+    rx_control_ready = 1;
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_SCAN
+    rx_scan_ready = 0;
+#else
+    rx_scan_ready = 1;
+#endif
+
     log_debug("Initializing mutex");
     result = pthread_mutex_init(&rx_ready_mutex, NULL);
     if (result != 0) {
@@ -301,6 +574,26 @@ int main_rx() {
     pthread_create(&rx_network_thread, &attr, thread_rx_network, NULL);
 #endif
 
+#ifdef MAIN_RX_ENABLE_THREAD_SPECTRUM
+    log_debug("Starting RX 2 spectrum thread");
+    pthread_create(&rx_spectrum_thread, &attr, thread_rx_spectrum, NULL);
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_IQ
+    log_debug("Starting RX 2 IQ thread");
+    pthread_create(&rx_iq_thread, &attr, thread_rx_iq, NULL);
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_CONTROL
+    log_debug("Starting RX 2 control thread");
+    pthread_create(&rx_control_thread, &attr, thread_rx_control, NULL);
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_SCAN
+    log_debug("Starting RX 2 scan thread");
+    pthread_create(&rx_scan_thread, &attr, thread_rx_scan, NULL);
+#endif
+
     log_debug("Waiting for other threads to startup");
     main_rx_wait_init();
 
@@ -317,6 +610,9 @@ int main_rx() {
     sleep_req.tv_sec = 1;
     sleep_req.tv_nsec = 0;
 
+    scan_hops = 0;
+    timespec_get(&scan_ts, TIME_UTC);
+
     log_debug("Printing device infos");
     while (keep_running) {
         timespec_get(&ts, TIME_UTC);
@@ -336,6 +632,16 @@ int main_rx() {
         greatbuf_circbuf_status(greatbuf, GREATBUF_CIRCBUF_MONITOR);
         greatbuf_circbuf_status(greatbuf, GREATBUF_CIRCBUF_NETWORK);
 
+        if (rx_scan != NULL) {
+            utils_timespec_sub(&scan_ts, &ts, &scan_elapsed);
+            ui_message("Scan: %u Hz - %.1f channels/s\n", scan_frequency(rx_scan),
+                       (double) (rx_scan->hops - scan_hops)
+                       / ((double) scan_elapsed.tv_sec + (double) scan_elapsed.tv_nsec / 1e9));
+
+            scan_hops = rx_scan->hops;
+            scan_ts = ts;
+        }
+
         nanosleep(&sleep_req, &sleep_rem);
     }
 
@@ -417,12 +723,50 @@ int main_rx() {
     }
 #endif
 
+#ifdef MAIN_RX_ENABLE_THREAD_SPECTRUM
+    log_debug("Joining RX 2 spectrum thread");
+    pthread_join(rx_spectrum_thread, (void **) &thread_result);
+    if (thread_result != EXIT_SUCCESS) {
+        log_error("Spectrum thread exit without success");
+        result = EXIT_FAILURE;
+    }
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_IQ
+    log_debug("Joining RX 2 IQ thread");
+    pthread_join(rx_iq_thread, (void **) &thread_result);
+    if (thread_result != EXIT_SUCCESS) {
+        log_error("IQ thread exit without success");
+        result = EXIT_FAILURE;
+    }
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_CONTROL
+    log_debug("Joining RX 2 control thread");
+    pthread_join(rx_control_thread, (void **) &thread_result);
+    if (thread_result != EXIT_SUCCESS) {
+        log_error("Control thread exit without success");
+        result = EXIT_FAILURE;
+    }
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_SCAN
+    log_debug("Joining RX 2 scan thread");
+    pthread_join(rx_scan_thread, (void **) &thread_result);
+    if (thread_result != EXIT_SUCCESS) {
+        log_error("Scan thread exit without success");
+        result = EXIT_FAILURE;
+    }
+#endif
+
     main_rx_end();
 
     return result;
 }
 
 void main_rx_end() {
+    size_t c;
+
     log_info("Main program RX mode ending");
 
     switch (conf->source) {
@@ -438,12 +782,39 @@ void main_rx_end() {
             break;
     }
 
-    log_debug("Freeing codec context");
-    codec_free(ctx_codec);
+    if (ctx_codecs != NULL) {
+        log_debug("Freeing codec contexts");
+        for (c = 0; c < rx_channels; c++)
+            codec_free(ctx_codecs[c]);
+        free(ctx_codecs);
+        ctx_codecs = NULL;
+    }
+
+    log_debug("Freeing channel frequencies");
+    free(rx_channel_freqs);
+    rx_channel_freqs = NULL;
+
+    log_debug("Freeing scan context");
+    scan_free(rx_scan);
+    rx_scan = NULL;
+
+    log_debug("Freeing control context");
+    control_free(rx_control);
+    rx_control = NULL;
 
     log_debug("Freeing Great Buffer");
     greatbuf_free(greatbuf);
 
+    log_debug("Freeing FIR design cache");
+    fir_design_cache_free();
+
+    log_debug("Stopping FFT re-plan worker");
+    fft_replan_stop();
+
+    log_debug("Saving FFT wisdom");
+    fft_wisdom_save();
+    fft_wisdom_free();
+
     log_debug("Destroying mutex");
     pthread_mutex_destroy(&rx_ready_mutex);
 
@@ -462,7 +833,11 @@ void main_rx_wait_init() {
            || rx_resample_ready == 0
            || rx_audio_ready == 0
            || rx_codec_ready == 0
-           || rx_network_ready == 0)
+           || rx_network_ready == 0
+           || rx_spectrum_ready == 0
+           || rx_iq_ready == 0
+           || rx_control_ready == 0
+           || rx_scan_ready == 0)
         pthread_cond_wait(&rx_ready_cond, &rx_ready_mutex);
 
     log_debug("Unlocking mutex");
@@ -491,22 +866,82 @@ void *thread_rx_read() {
 
     unsigned long frame_duration;
 
+    control_params params;
+    uint64_t generation;
+    uint64_t read_generation;
+    uint32_t center_freq;
+    int tuner_gain;
+
+    uint8_t *settle_buffer;
+    int settle_len;
+
     prctl(PR_SET_NAME, "read");
     log_info("Thread start");
 
     retval = EXIT_SUCCESS;
 
+    settle_len = (int) ((uint64_t) conf->rtlsdr_settle * conf->rtlsdr_device_sample_rate / 1000 * 2);
+    settle_len = (settle_len + MAIN_RX_USB_BLOCK_SIZE - 1) / MAIN_RX_USB_BLOCK_SIZE * MAIN_RX_USB_BLOCK_SIZE;
+
+    log_debug("Allocating settle buffer of %d bytes", settle_len);
+    settle_buffer = (uint8_t *) calloc(settle_len > 0 ? (size_t) settle_len : 1, sizeof(uint8_t));
+    if (settle_buffer == NULL) {
+        log_error("Unable to allocate settle buffer");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
     log_debug("Waiting for other threads to init");
     rx_read_ready = 1;
     main_rx_wait_init();
 
     len = (int) conf->rtlsdr_samples * 2;
 
+    read_generation = 0;
+    center_freq = conf->rtlsdr_device_center_freq;
+    tuner_gain = conf->rtlsdr_device_tuner_gain;
+
     frame_duration = 1000000000 / (conf->rtlsdr_device_sample_rate / conf->rtlsdr_samples);
     log_debug("Frame duration: %zu nanosec", frame_duration);
 
     log_debug("Starting read loop");
     while (keep_running) {
+        generation = control_get(rx_control, &params);
+        if (generation != read_generation) {
+            read_generation = generation;
+
+            if (conf->source == SOURCE_RTLSDR && params.center_freq != center_freq) {
+                log_debug("Retuning RTL-SDR device to %u Hz", params.center_freq);
+                if (device_set_frequency(rx_device, params.center_freq) != EXIT_SUCCESS) {
+                    log_error("Unable to retune RTL-SDR device");
+                    retval = EXIT_FAILURE;
+                    break;
+                }
+
+                if (settle_len > 0) {
+                    log_trace("Discarding %d settling bytes", settle_len);
+                    result = rtlsdr_read_sync(rx_device, (void *) settle_buffer, settle_len, &bytes);
+                    if (result != 0) {
+                        log_error("Error %d discarding settling data from RTL-SDR device", result);
+                        retval = EXIT_FAILURE;
+                        break;
+                    }
+                }
+            }
+
+            if (conf->source == SOURCE_RTLSDR && params.tuner_gain != tuner_gain) {
+                log_debug("Setting RTL-SDR tuner gain to %d", params.tuner_gain);
+                if (device_set_gain(rx_device, params.tuner_gain) != EXIT_SUCCESS) {
+                    log_error("Unable to set RTL-SDR tuner gain");
+                    retval = EXIT_FAILURE;
+                    break;
+                }
+            }
+
+            center_freq = params.center_freq;
+            tuner_gain = params.tuner_gain;
+        }
+
         pos = greatbuf_head_acquire(greatbuf, GREATBUF_CIRCBUF_IQ);
         if (pos == -1) {
             log_error("Error acquiring IQ buffer head");
@@ -521,6 +956,7 @@ void *thread_rx_read() {
         item = greatbuf_item_get(greatbuf, pos);
         ts = &item->ts;
         iq_buffer = item->iq;
+        item->center_freq = center_freq;
 
         log_trace("Setting timestamp for item");
         timespec_get(ts, TIME_UTC);
@@ -571,6 +1007,8 @@ void *thread_rx_read() {
         }
     }
 
+    free(settle_buffer);
+
     main_stop();
 
     log_info("Thread end: %d", retval);
@@ -586,23 +1024,131 @@ void *thread_rx_samples() {
     int retval;
 
     ssize_t pos;
+    greatbuf_item *item;
     uint8_t *iq_buffer;
-    FP_FLOAT complex *samples_buffer;
     int len;
 
+    iqcorr_ctx *iq_ctx;
+    nco_ctx **nco_ctxs;
+    decimate_ctx **dec_ctxs;
+    greatbuf_complex *mixed;
+    greatbuf_complex *channel_input;
+    greatbuf_complex *channel_output;
+
+#ifndef RTLSDR_RADIO_FIXED_POINT
+    fir_design_params pfb_params;
+    const fir_design *pfb_design;
+#endif
+    channelizer_ctx *chan_ctx;
+    ssize_t *bins;
+
+    greatbuf_item *iq_item;
+    uint32_t center_freq;
+
+    int64_t offset;
+    size_t c;
+    int result;
+
     prctl(PR_SET_NAME, "samples");
     log_info("Thread start");
 
     iq_buffer = NULL;
-    samples_buffer = NULL;
 
     retval = EXIT_SUCCESS;
+    result = EXIT_SUCCESS;
+    chan_ctx = NULL;
+    iq_ctx = NULL;
+
+    if (conf->iq_correction == FLAG_TRUE) {
+        log_debug("Initializing IQ correction context");
+        iq_ctx = iqcorr_init();
+        if (iq_ctx == NULL) {
+            log_error("Unable to allocate IQ correction context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+    }
+
+    log_debug("Allocating channel contexts");
+    nco_ctxs = (nco_ctx **) calloc(rx_channels, sizeof(nco_ctx *));
+    dec_ctxs = (decimate_ctx **) calloc(rx_channels, sizeof(decimate_ctx *));
+    bins = (ssize_t *) calloc(rx_channels, sizeof(ssize_t));
+    mixed = (greatbuf_complex *) calloc(conf->rtlsdr_samples, sizeof(greatbuf_complex));
+    if (nco_ctxs == NULL || dec_ctxs == NULL || bins == NULL || mixed == NULL) {
+        log_error("Unable to allocate channel contexts");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+#ifndef RTLSDR_RADIO_FIXED_POINT
+    if (conf->channelizer_channels > 0) {
+        log_debug("Designing channelizer prototype filter");
+        pfb_params.type = conf->filter_design;
+        pfb_params.sample_rate = conf->rtlsdr_device_sample_rate;
+        pfb_params.cutoff = conf->rtlsdr_device_sample_rate / (uint32_t) conf->channelizer_channels / 2;
+        pfb_params.transition = pfb_params.cutoff / 2;
+        pfb_params.attenuation = conf->filter_attenuation;
+
+        pfb_design = fir_design_get(&pfb_params);
+        if (pfb_design == NULL) {
+            log_error("Unable to design channelizer prototype filter");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+
+        log_debug("Initializing channelizer context");
+        chan_ctx = channelizer_init(conf->rtlsdr_device_sample_rate, conf->channelizer_channels, conf->rtlsdr_samples,
+                                    pfb_design->taps, pfb_design->taps_size, conf->fft_planner);
+        if (chan_ctx == NULL) {
+            log_error("Unable to allocate channelizer context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+    }
+#endif
+
+    for (c = 0; c < rx_channels; c++) {
+        offset = (int64_t) rx_channel_freqs[c] - conf->rtlsdr_device_center_freq;
+
+        if (chan_ctx != NULL) {
+            log_debug("Routing channelizer bin to channel %zu", c + 1);
+            bins[c] = channelizer_bin(chan_ctx, offset);
+            if (bins[c] < 0) {
+                log_error("Channel %zu is not on the channelizer grid", c + 1);
+                retval = EXIT_FAILURE;
+                pthread_exit(&retval);
+            }
+
+            log_debug("Initializing decimate context for channel %zu", c + 1);
+            dec_ctxs[c] = decimate_init(channelizer_output_rate(chan_ctx), rx_channel_sample_rate,
+                                        chan_ctx->output_size);
+        } else {
+            log_debug("Initializing NCO context for channel %zu", c + 1);
+            nco_ctxs[c] = nco_init(conf->rtlsdr_device_sample_rate, (int32_t) offset);
+            if (nco_ctxs[c] == NULL) {
+                log_error("Unable to allocate NCO context");
+                retval = EXIT_FAILURE;
+                pthread_exit(&retval);
+            }
+
+            log_debug("Initializing decimate context for channel %zu", c + 1);
+            dec_ctxs[c] = decimate_init(conf->rtlsdr_device_sample_rate, rx_channel_sample_rate,
+                                        conf->rtlsdr_samples);
+        }
+
+        if (dec_ctxs[c] == NULL) {
+            log_error("Unable to allocate decimate context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+    }
 
     log_debug("Waiting for other threads to init");
     rx_samples_ready = 1;
     main_rx_wait_init();
 
     len = (int) conf->rtlsdr_samples * 2;
+    center_freq = conf->rtlsdr_device_center_freq;
 
     log_debug("Starting read loop");
     while (keep_running) {
@@ -616,7 +1162,8 @@ void *thread_rx_samples() {
             greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_IQ);
             break;
         }
-        iq_buffer = greatbuf_item_get(greatbuf, pos)->iq;
+        iq_item = greatbuf_item_get(greatbuf, pos);
+        iq_buffer = iq_item->iq;
 
         pos = greatbuf_head_acquire(greatbuf, GREATBUF_CIRCBUF_SAMPLES);
         if (pos == -1) {
@@ -630,15 +1177,106 @@ void *thread_rx_samples() {
             greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_SAMPLES);
             break;
         }
-        samples_buffer = greatbuf_item_get(greatbuf, pos)->samples;
+        item = greatbuf_item_get(greatbuf, pos);
 
+#ifdef RTLSDR_RADIO_FIXED_POINT
+        log_trace("Converting IQ to Q15 samples");
+        fixed_buffer_to_samples(iq_buffer, item->samples, len);
+#else
         log_trace("Converting IQ to complex samples");
-        device_buffer_to_samples(iq_buffer, samples_buffer, len);
+        device_buffer_to_samples(iq_buffer, item->samples, len);
+#endif
+
+        if (iq_item->center_freq != center_freq) {
+            center_freq = iq_item->center_freq;
+            log_debug("Moving channels to center frequency %u Hz", center_freq);
+
+            for (c = 0; c < rx_channels && result == EXIT_SUCCESS; c++) {
+                if (conf->channel_freqs_count == 0)
+                    rx_channel_freqs[c] = center_freq;
+
+                offset = (int64_t) rx_channel_freqs[c] - center_freq;
+
+                if (chan_ctx != NULL) {
+                    bins[c] = channelizer_bin(chan_ctx, offset);
+                    if (bins[c] < 0) {
+                        log_error("Channel %zu is not on the channelizer grid", c + 1);
+                        result = EXIT_FAILURE;
+                    }
+                } else {
+                    nco_set_offset(nco_ctxs[c], (int32_t) offset);
+                }
+            }
+        }
+
+        if (iq_ctx != NULL) {
+            log_trace("Correcting DC offset and IQ imbalance");
+#ifdef RTLSDR_RADIO_FIXED_POINT
+            iqcorr_do_fixed(iq_ctx, item->samples, conf->rtlsdr_samples);
+#else
+            iqcorr_do(iq_ctx, item->samples, conf->rtlsdr_samples);
+#endif
+        }
+
+#ifndef RTLSDR_RADIO_FIXED_POINT
+        if (chan_ctx != NULL) {
+            log_trace("Splitting band with channelizer");
+            result = channelizer_do(chan_ctx, item->samples, conf->rtlsdr_samples);
+
+            for (c = 0; c < rx_channels && result == EXIT_SUCCESS; c++) {
+                log_trace("Decimating channel %zu to channel rate", c + 1);
+                result = decimate_do(dec_ctxs[c], channelizer_get(chan_ctx, (size_t) bins[c]), chan_ctx->output_size,
+                                     item->channel + c * rx_channel_size);
+            }
+        }
+#endif
+
+        for (c = 0; c < rx_channels && chan_ctx == NULL && result == EXIT_SUCCESS; c++) {
+            channel_input = item->samples;
+            channel_output = item->channel + c * rx_channel_size;
+
+            if (nco_ctxs[c]->increment != 0) {
+                log_trace("Mixing channel %zu to baseband", c + 1);
+#ifdef RTLSDR_RADIO_FIXED_POINT
+                nco_mix_fixed(nco_ctxs[c], item->samples, conf->rtlsdr_samples, mixed);
+#else
+                nco_mix(nco_ctxs[c], item->samples, conf->rtlsdr_samples, mixed);
+#endif
+                channel_input = mixed;
+            }
+
+            log_trace("Decimating channel %zu to channel rate", c + 1);
+#ifdef RTLSDR_RADIO_FIXED_POINT
+            result = decimate_do_fixed(dec_ctxs[c], channel_input, conf->rtlsdr_samples, channel_output);
+#else
+            result = decimate_do(dec_ctxs[c], channel_input, conf->rtlsdr_samples, channel_output);
+#endif
+        }
 
         greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_IQ);
         greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_SAMPLES);
+
+        if (result != EXIT_SUCCESS) {
+            log_error("Unable to decimate samples");
+            retval = EXIT_FAILURE;
+            break;
+        }
     }
 
+    log_debug("Freeing channel contexts");
+    for (c = 0; c < rx_channels; c++) {
+        nco_free(nco_ctxs[c]);
+        decimate_free(dec_ctxs[c]);
+    }
+
+    free(nco_ctxs);
+    free(dec_ctxs);
+    free(bins);
+    free(mixed);
+
+    channelizer_free(chan_ctx);
+    iqcorr_free(iq_ctx);
+
     main_stop();
 
     log_info("Thread end: %d", retval);
@@ -654,10 +1292,29 @@ void *thread_rx_demod() {
     int retval;
 
     ssize_t pos;
+    greatbuf_item *item;
+
+    greatbuf_complex *samples_item;
+    greatbuf_real *demod_item;
+
+    greatbuf_complex *samples_buffer;
+    greatbuf_real *demod_buffer;
+
+    greatbuf_complex *prev_samples;
+    squelch_ctx **squelch_ctxs;
+    squelch_ctx *squelch_new;
+    size_t hang_blocks;
+    tone_ctx **tone_ctxs;
+    uint32_t tone;
+    uint32_t center_freq;
+    size_t c;
 
-    FP_FLOAT complex *samples_buffer;
-    FP_FLOAT *demod_buffer;
+    control_params params;
+    control_params current;
+    uint64_t generation;
+    uint64_t demod_generation;
 
+#ifndef RTLSDR_RADIO_FIXED_POINT
     FP_FLOAT complex product;
     FP_FLOAT complex prev_sample;
 
@@ -665,19 +1322,96 @@ void *thread_rx_demod() {
     FP_FLOAT imag;
 
     size_t j;
+#endif
 
     prctl(PR_SET_NAME, "demod");
     log_info("Thread start");
 
     retval = EXIT_SUCCESS;
-    prev_sample = 0 + 0 * I;
+
+    log_debug("Allocating previous samples");
+    prev_samples = (greatbuf_complex *) calloc(rx_channels, sizeof(greatbuf_complex));
+    squelch_ctxs = (squelch_ctx **) calloc(rx_channels, sizeof(squelch_ctx *));
+    tone_ctxs = (tone_ctx **) calloc(rx_channels, sizeof(tone_ctx *));
+    if (prev_samples == NULL || squelch_ctxs == NULL || tone_ctxs == NULL) {
+        log_error("Unable to allocate previous samples");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    demod_generation = control_get(rx_control, &current);
+    hang_blocks = (size_t) current.squelch_hang * rx_channel_sample_rate / 1000 / rx_channel_size;
+
+    for (c = 0; c < rx_channels; c++) {
+        log_debug("Initializing squelch context for channel %zu", c + 1);
+        squelch_ctxs[c] = squelch_init(current.squelch, current.squelch_level, current.squelch_hysteresis,
+                                       hang_blocks);
+        if (squelch_ctxs[c] == NULL) {
+            log_error("Unable to allocate squelch context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+
+        if (conf->ctcss_tones_count == 0)
+            continue;
+
+        tone = conf->ctcss_tones[conf->ctcss_tones_count > 1 ? c : 0];
+        if (tone == 0)
+            continue;
+
+        log_debug("Initializing tone context for channel %zu", c + 1);
+        tone_ctxs[c] = tone_init(rx_channel_sample_rate, tone);
+        if (tone_ctxs[c] == NULL) {
+            log_error("Unable to allocate tone context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+    }
 
     log_debug("Waiting for other threads to init");
     rx_demod_ready = 1;
     main_rx_wait_init();
 
+    center_freq = conf->rtlsdr_device_center_freq;
+
     log_debug("Starting demod loop");
     while (keep_running) {
+        generation = control_get(rx_control, &params);
+        if (generation != demod_generation) {
+            demod_generation = generation;
+
+            if (params.squelch != current.squelch
+                || params.squelch_level != current.squelch_level
+                || params.squelch_hysteresis != current.squelch_hysteresis
+                || params.squelch_hang != current.squelch_hang) {
+                log_debug("Rebuilding squelch contexts");
+                hang_blocks = (size_t) params.squelch_hang * rx_channel_sample_rate / 1000 / rx_channel_size;
+
+                for (c = 0; c < rx_channels; c++) {
+                    squelch_new = squelch_init(params.squelch, params.squelch_level, params.squelch_hysteresis,
+                                               hang_blocks);
+                    if (squelch_new == NULL) {
+                        log_error("Unable to allocate squelch context");
+                        retval = EXIT_FAILURE;
+                        break;
+                    }
+
+                    squelch_free(squelch_ctxs[c]);
+                    squelch_ctxs[c] = squelch_new;
+                }
+
+                if (retval != EXIT_SUCCESS)
+                    break;
+            }
+
+            if (params.modulation != current.modulation) {
+                log_debug("Switching modulation to %s", cfg_tochar_modulation(params.modulation));
+                memset(prev_samples, 0, rx_channels * sizeof(greatbuf_complex));
+            }
+
+            current = params;
+        }
+
         pos = greatbuf_tail_acquire(greatbuf, GREATBUF_CIRCBUF_SAMPLES);
         if (pos == -1) {
             log_error("Error acquiring samples buffer tail");
@@ -688,7 +1422,7 @@ void *thread_rx_demod() {
             greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_SAMPLES);
             break;
         }
-        samples_buffer = greatbuf_item_get(greatbuf, pos)->samples;
+        samples_item = greatbuf_item_get(greatbuf, pos)->channel;
 
         pos = greatbuf_head_acquire(greatbuf, GREATBUF_CIRCBUF_DEMOD);
         if (pos == -1) {
@@ -702,62 +1436,115 @@ void *thread_rx_demod() {
             greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_DEMOD);
             break;
         }
-        demod_buffer = greatbuf_item_get(greatbuf, pos)->demod;
+        item = greatbuf_item_get(greatbuf, pos);
+        demod_item = item->demod;
+
+        if (item->center_freq != center_freq) {
+            log_trace("Resetting squelch after retune");
+            center_freq = item->center_freq;
+
+            for (c = 0; c < rx_channels; c++) {
+                squelch_reset(squelch_ctxs[c]);
+                if (tone_ctxs[c] != NULL)
+                    tone_reset(tone_ctxs[c]);
+            }
+        }
+
+        for (c = 0; c < rx_channels; c++) {
+            samples_buffer = samples_item + c * rx_channel_size;
+            demod_buffer = demod_item + c * rx_channel_size;
+
+            log_trace("Updating squelch for channel %zu", c + 1);
+#ifdef RTLSDR_RADIO_FIXED_POINT
+            item->rms[c] = dsp_fixed_complex_rms(samples_buffer, rx_channel_size);
+#else
+            item->rms[c] = dsp_complex_rms(samples_buffer, rx_channel_size);
+#endif
+            item->squelch_open[c] = squelch_update(squelch_ctxs[c], item->rms[c]);
 
-        log_trace("Demodulating samples");
-        for (j = 0; j < conf->rtlsdr_samples; j++) {
-            switch (conf->modulation) {
+            log_trace("Demodulating channel %zu", c + 1);
+#ifdef RTLSDR_RADIO_FIXED_POINT
+            switch (current.modulation) {
                 case MOD_TYPE_FM:
-                    product = samples_buffer[j] * conj(prev_sample);
+                    fixed_fm_demod(samples_buffer, rx_channel_size, &prev_samples[c], demod_buffer);
+                    break;
+
+                case MOD_TYPE_AM:
+                    fixed_am_demod(samples_buffer, rx_channel_size, demod_buffer);
+                    break;
+
+                default:
+                    memset(demod_buffer, 0, rx_channel_size * sizeof(greatbuf_real));
+            }
+#else
+            prev_sample = prev_samples[c];
+
+            for (j = 0; j < rx_channel_size; j++) {
+                switch (current.modulation) {
+                    case MOD_TYPE_FM:
+                        product = samples_buffer[j] * conj(prev_sample);
 
 #ifdef RTLSDR_RADIO_FP_FLOAT
-                    real = crealf(product);
-                    imag = cimagf(product);
+                        real = crealf(product);
+                        imag = cimagf(product);
 
-                    if (real != 0 || imag != 0)
-                        demod_buffer[j] = atan2f(imag, real) / (float) M_PI;
-                    else
-                        demod_buffer[j] = 0;
+                        if (real != 0 || imag != 0)
+                            demod_buffer[j] = atan2f(imag, real) / (float) M_PI;
+                        else
+                            demod_buffer[j] = 0;
 #endif
 
 #ifdef RTLSDR_RADIO_FP_DOUBLE
-                    real = creal(product);
-                    imag = cimag(product);
+                        real = creal(product);
+                        imag = cimag(product);
 
-                    if (real != 0 || imag != 0)
-                        demod_buffer[j] = atan2(imag, real) / M_PI;
-                    else
-                        demod_buffer[j] = 0;
+                        if (real != 0 || imag != 0)
+                            demod_buffer[j] = atan2(imag, real) / M_PI;
+                        else
+                            demod_buffer[j] = 0;
 #endif
 
 #ifdef RTLSDR_RADIO_FP_LONG_DOUBLE
-                    real = creall(product);
-                    imag = cimagl(product);
+                        real = creall(product);
+                        imag = cimagl(product);
 
-                    if (real != 0 || imag != 0)
-                        demod_buffer[j] = atan2l(imag, real) / M_PI;
-                    else
-                        demod_buffer[j] = 0;
+                        if (real != 0 || imag != 0)
+                            demod_buffer[j] = atan2l(imag, real) / M_PI;
+                        else
+                            demod_buffer[j] = 0;
 #endif
 
-                    prev_sample = samples_buffer[j];
-                    break;
+                        prev_sample = samples_buffer[j];
+                        break;
 
-                case MOD_TYPE_AM:
+                    case MOD_TYPE_AM:
 
 #ifdef RTLSDR_RADIO_FP_FLOAT
-                    demod_buffer[j] = cabsf(samples_buffer[j]) / (float) M_SQRT2;
-#elifdef RTLSDR_RADIO_FP_DOUBLE
-                    demod_buffer[j] = cabs(samples_buffer[j]) / M_SQRT2;
-#elifdef RTLSDR_RADIO_FP_LONG_DOUBLE
-                    demod_buffer[j] = cabsl(samples_buffer[j]) / M_SQRT2;
+                        demod_buffer[j] = cabsf(samples_buffer[j]) / (float) M_SQRT2;
+#elif defined(RTLSDR_RADIO_FP_DOUBLE)
+                        demod_buffer[j] = cabs(samples_buffer[j]) / M_SQRT2;
+#elif defined(RTLSDR_RADIO_FP_LONG_DOUBLE)
+                        demod_buffer[j] = cabsl(samples_buffer[j]) / M_SQRT2;
 #else
-                    demod_buffer[j] = 0;
+                        demod_buffer[j] = 0;
 #endif
-                    break;
+                        break;
 
-                default:
-                    demod_buffer[j] = 0;
+                    default:
+                        demod_buffer[j] = 0;
+                }
+            }
+
+            prev_samples[c] = prev_sample;
+#endif
+
+            if (tone_ctxs[c] != NULL) {
+                log_trace("Detecting tone for channel %zu", c + 1);
+#ifdef RTLSDR_RADIO_FIXED_POINT
+                item->squelch_open[c] &= tone_update_fixed(tone_ctxs[c], demod_buffer, rx_channel_size);
+#else
+                item->squelch_open[c] &= tone_update(tone_ctxs[c], demod_buffer, rx_channel_size);
+#endif
             }
         }
 
@@ -765,6 +1552,15 @@ void *thread_rx_demod() {
         greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_DEMOD);
     }
 
+    for (c = 0; c < rx_channels; c++) {
+        squelch_free(squelch_ctxs[c]);
+        tone_free(tone_ctxs[c]);
+    }
+
+    free(tone_ctxs);
+    free(squelch_ctxs);
+    free(prev_samples);
+
     main_stop();
 
     log_info("Thread end: %d", retval);
@@ -781,12 +1577,28 @@ void *thread_rx_filter() {
 
     ssize_t pos;
 
-    FP_FLOAT *demod_buffer;
-    FP_FLOAT *filtered_buffer;
+    greatbuf_real *demod_item;
+    greatbuf_real *filtered_item;
+
+    greatbuf_real *demod_buffer;
+    greatbuf_real *filtered_buffer;
+
+    fir_ctx **fir_filter_ctxs;
+    fir_ctx **fir_new_ctxs;
 
     fft_ctx *fwd_fft_ctx;
     fft_ctx *bck_fft_ctx;
+    fft_ctx *fwd_new_ctx;
+    fft_ctx *bck_new_ctx;
+
+    control_params params;
+    control_params current;
+    uint64_t generation;
+    uint64_t filter_generation;
+
+    int result;
 
+    size_t c;
     size_t i;
     size_t half;
     size_t coeff_truncate;
@@ -795,38 +1607,16 @@ void *thread_rx_filter() {
     log_info("Thread start");
 
     retval = EXIT_SUCCESS;
-    half = conf->rtlsdr_samples / 2;
-    coeff_truncate = (conf->audio_sample_rate * conf->rtlsdr_samples) / conf->rtlsdr_device_sample_rate;
-
-    switch (conf->filter) {
-
-        case FILTER_MODE_NONE:
-            break;
+    half = rx_channel_size / 2;
 
-        case FILTER_MODE_FFT_SW:
-            log_debug("Initializing FFT forward context");
-            fwd_fft_ctx = fft_init(conf->rtlsdr_samples, FFTW_R2HC, FFT_DATA_TYPE_REAL);
-            if (fwd_fft_ctx == NULL) {
-                log_error("Unable to allocate FFT forward context");
-                retval = EXIT_FAILURE;
-                pthread_exit(&retval);
-            }
-
-            log_debug("Initializing FFT backward context");
-            bck_fft_ctx = fft_init(conf->rtlsdr_samples, FFTW_HC2R, FFT_DATA_TYPE_REAL);
-            if (bck_fft_ctx == NULL) {
-                log_error("Unable to allocate FFT backward context");
-                fft_free(fwd_fft_ctx);
-                retval = EXIT_FAILURE;
-                pthread_exit(&retval);
-            }
+    filter_generation = control_get(rx_control, &current);
+    coeff_truncate = (current.filter_cutoff * rx_channel_size) / rx_channel_sample_rate;
 
-            break;
-
-        default:
-            log_error("Not implemented");
-            retval = EXIT_FAILURE;
-            pthread_exit(&retval);
+    if (main_rx_filter_init(current.filter, current.filter_cutoff, current.filter_transition, conf->fft_planner,
+                            &fir_filter_ctxs, &fwd_fft_ctx, &bck_fft_ctx) != EXIT_SUCCESS) {
+        log_error("Unable to initialize filter");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
     }
 
     log_debug("Waiting for other threads to init");
@@ -835,6 +1625,34 @@ void *thread_rx_filter() {
 
     log_debug("Starting filter loop");
     while (keep_running) {
+        generation = control_get(rx_control, &params);
+        if (generation != filter_generation) {
+            filter_generation = generation;
+
+            if (params.filter != current.filter
+                || (params.filter == FILTER_MODE_FIR_SW && (params.filter_cutoff != current.filter_cutoff
+                                                            || params.filter_transition != current.filter_transition))) {
+                // Estimated FFT plans only, a rigorous plan would stall the block loop
+                log_debug("Rebuilding filter as %s", cfg_tochar_filter_mode(params.filter));
+                if (main_rx_filter_init(params.filter, params.filter_cutoff, params.filter_transition,
+                                        FFT_RIGOR_ESTIMATE, &fir_new_ctxs, &fwd_new_ctx, &bck_new_ctx) != EXIT_SUCCESS) {
+                    log_error("Unable to rebuild filter");
+                    retval = EXIT_FAILURE;
+                    break;
+                }
+
+                // While a re-plan may run, fft_free hands the old contexts to the re-plan worker
+                main_rx_filter_free(current.filter, fir_filter_ctxs, fwd_fft_ctx, bck_fft_ctx);
+
+                fir_filter_ctxs = fir_new_ctxs;
+                fwd_fft_ctx = fwd_new_ctx;
+                bck_fft_ctx = bck_new_ctx;
+            }
+
+            coeff_truncate = (params.filter_cutoff * rx_channel_size) / rx_channel_sample_rate;
+            current = params;
+        }
+
         pos = greatbuf_tail_acquire(greatbuf, GREATBUF_CIRCBUF_DEMOD);
         if (pos == -1) {
             log_error("Error acquiring demod buffer tail");
@@ -845,7 +1663,7 @@ void *thread_rx_filter() {
             greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_DEMOD);
             break;
         }
-        demod_buffer = greatbuf_item_get(greatbuf, pos)->demod;
+        demod_item = greatbuf_item_get(greatbuf, pos)->demod;
 
         pos = greatbuf_head_acquire(greatbuf, GREATBUF_CIRCBUF_FILTERED);
         if (pos == -1) {
@@ -859,60 +1677,177 @@ void *thread_rx_filter() {
             greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_FILTERED);
             break;
         }
-        filtered_buffer = greatbuf_item_get(greatbuf, pos)->filtered;
+        filtered_item = greatbuf_item_get(greatbuf, pos)->filtered;
 
-        log_trace("Filtering");
+        for (c = 0; c < rx_channels; c++) {
+            demod_buffer = demod_item + c * rx_channel_size;
+            filtered_buffer = filtered_item + c * rx_channel_size;
 
-        switch (conf->filter) {
+            log_trace("Filtering channel %zu", c + 1);
 
-            case FILTER_MODE_NONE:
-                log_trace("Copying data");
-                for (i = 0; i < conf->rtlsdr_samples; i++)
-                    filtered_buffer[i] = demod_buffer[i];
-                break;
+            switch (current.filter) {
+
+                case FILTER_MODE_NONE:
+                    log_trace("Copying data");
+                    for (i = 0; i < rx_channel_size; i++)
+                        filtered_buffer[i] = demod_buffer[i];
+                    break;
 
-            case FILTER_MODE_FFT_SW:
-                log_debug("Copying input values for forward FFT");
-                for (i = 0; i < conf->rtlsdr_samples; i++)
-                    fwd_fft_ctx->real_input[i] = demod_buffer[i];
+                case FILTER_MODE_FIR_SW:
+                    log_trace("Convolving with FIR kernel");
+#ifdef RTLSDR_RADIO_FIXED_POINT
+                    result = fir_convolve_fixed(fir_filter_ctxs[c], demod_buffer, rx_channel_size, filtered_buffer);
+#else
+                    result = fir_convolve(fir_filter_ctxs[c], demod_buffer, rx_channel_size, filtered_buffer);
+#endif
+                    if (result != EXIT_SUCCESS) {
+                        log_error("Unable to convolve with FIR kernel");
+                        retval = EXIT_FAILURE;
+                    }
+                    break;
 
-                log_trace("Computing forward FFT");
-                fft_compute(fwd_fft_ctx);
+                case FILTER_MODE_FFT_SW:
+                    log_debug("Copying input values for forward FFT");
+                    for (i = 0; i < rx_channel_size; i++)
+                        fwd_fft_ctx->real_input[i] = demod_buffer[i];
 
-                log_debug("Copying output values from forward FFT output to input values for backward FFT");
-                for (i = 0; i < conf->rtlsdr_samples; i++)
-                    bck_fft_ctx->real_input[i] = fwd_fft_ctx->real_output[i];
+                    log_trace("Computing forward FFT");
+                    fft_compute(fwd_fft_ctx);
 
-                log_trace("Adjusting coeffs");
-                for (i = coeff_truncate; i < half; i++) {
-                    bck_fft_ctx->real_input[i] = 0;
-                    bck_fft_ctx->real_input[conf->rtlsdr_samples - i] = 0;
-                }
+                    log_debug("Copying output values from forward FFT output to input values for backward FFT");
+                    for (i = 0; i < rx_channel_size; i++)
+                        bck_fft_ctx->real_input[i] = fwd_fft_ctx->real_output[i];
 
-                log_trace("Computing backward FFT");
-                fft_compute(bck_fft_ctx);
+                    log_trace("Adjusting coeffs");
+                    for (i = coeff_truncate; i < half; i++) {
+                        bck_fft_ctx->real_input[i] = 0;
+                        bck_fft_ctx->real_input[rx_channel_size - i] = 0;
+                    }
 
-                log_debug("Copying output values from backward FFT output");
-                for (i = 0; i < conf->rtlsdr_samples; i++)
-                    filtered_buffer[i] = bck_fft_ctx->real_output[i] / (FP_FLOAT) conf->rtlsdr_samples;
+                    log_trace("Computing backward FFT");
+                    fft_compute(bck_fft_ctx);
 
-                break;
+                    log_debug("Copying output values from backward FFT output");
+                    for (i = 0; i < rx_channel_size; i++)
+#ifdef RTLSDR_RADIO_FIXED_POINT
+                        filtered_buffer[i] = fixed_saturate((int32_t) (bck_fft_ctx->real_output[i] / (FP_FLOAT) rx_channel_size));
+#else
+                        filtered_buffer[i] = bck_fft_ctx->real_output[i] / (FP_FLOAT) rx_channel_size;
+#endif
 
-            default:
-                log_error("Not implemented");
-                retval = EXIT_FAILURE;
-                break;
+                    break;
+
+                default:
+                    log_error("Not implemented");
+                    retval = EXIT_FAILURE;
+                    break;
+            }
         }
 
         greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_DEMOD);
         greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_FILTERED);
     }
 
-    switch (conf->filter) {
+    main_rx_filter_free(current.filter, fir_filter_ctxs, fwd_fft_ctx, bck_fft_ctx);
+
+    main_stop();
+
+    log_info("Thread end: %d", retval);
+
+    pthread_exit(&retval);
+}
+
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_FILTER
+
+static int main_rx_filter_init(filter_mode mode, uint32_t cutoff, uint32_t transition, fft_rigor fft_planner,
+                               fir_ctx ***fir_filter_ctxs, fft_ctx **fwd_fft_ctx, fft_ctx **bck_fft_ctx) {
+    fir_design_params fir_params;
+    const fir_design *fir_filter_design;
+    size_t c;
+
+    *fir_filter_ctxs = NULL;
+    *fwd_fft_ctx = NULL;
+    *bck_fft_ctx = NULL;
+
+    switch (mode) {
 
         case FILTER_MODE_NONE:
             break;
 
+        case FILTER_MODE_FIR_SW:
+            log_debug("Designing FIR filter");
+            fir_params.type = conf->filter_design;
+            fir_params.sample_rate = rx_channel_sample_rate;
+            fir_params.cutoff = cutoff;
+            fir_params.transition = transition;
+            fir_params.attenuation = conf->filter_attenuation;
+
+            fir_filter_design = fir_design_get(&fir_params);
+            if (fir_filter_design == NULL) {
+                log_error("Unable to design FIR filter");
+                return EXIT_FAILURE;
+            }
+
+            log_debug("Initializing FIR contexts");
+            *fir_filter_ctxs = (fir_ctx **) calloc(rx_channels, sizeof(fir_ctx *));
+            if (*fir_filter_ctxs == NULL) {
+                log_error("Unable to allocate FIR contexts");
+                return EXIT_FAILURE;
+            }
+
+            for (c = 0; c < rx_channels; c++) {
+                (*fir_filter_ctxs)[c] = fir_init(fir_filter_design->taps, fir_filter_design->taps_size,
+                                                 rx_channel_size, 1);
+                if ((*fir_filter_ctxs)[c] == NULL) {
+                    log_error("Unable to allocate FIR context");
+                    main_rx_filter_free(mode, *fir_filter_ctxs, NULL, NULL);
+                    return EXIT_FAILURE;
+                }
+            }
+
+            break;
+
+        case FILTER_MODE_FFT_SW:
+            log_debug("Initializing FFT forward context");
+            *fwd_fft_ctx = fft_init(rx_channel_size, FFTW_R2HC, FFT_DATA_TYPE_REAL, fft_planner);
+            if (*fwd_fft_ctx == NULL) {
+                log_error("Unable to allocate FFT forward context");
+                return EXIT_FAILURE;
+            }
+
+            log_debug("Initializing FFT backward context");
+            *bck_fft_ctx = fft_init(rx_channel_size, FFTW_HC2R, FFT_DATA_TYPE_REAL, fft_planner);
+            if (*bck_fft_ctx == NULL) {
+                log_error("Unable to allocate FFT backward context");
+                fft_free(*fwd_fft_ctx);
+                return EXIT_FAILURE;
+            }
+
+            break;
+
+        default:
+            log_error("Not implemented");
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void main_rx_filter_free(filter_mode mode, fir_ctx **fir_filter_ctxs, fft_ctx *fwd_fft_ctx,
+                                fft_ctx *bck_fft_ctx) {
+    size_t c;
+
+    switch (mode) {
+
+        case FILTER_MODE_FIR_SW:
+            log_debug("Freeing FIR contexts");
+            for (c = 0; c < rx_channels; c++)
+                fir_free(fir_filter_ctxs[c]);
+            free(fir_filter_ctxs);
+            break;
+
         case FILTER_MODE_FFT_SW:
             log_debug("Freeing FFT forward context");
             fft_free(fwd_fft_ctx);
@@ -922,16 +1857,8 @@ void *thread_rx_filter() {
             break;
 
         default:
-            log_error("Not implemented");
-            retval = EXIT_FAILURE;
             break;
     }
-
-    main_stop();
-
-    log_info("Thread end: %d", retval);
-
-    pthread_exit(&retval);
 }
 
 #endif
@@ -942,19 +1869,44 @@ void *thread_rx_resample() {
     int retval;
 
     ssize_t pos;
+    greatbuf_item *item;
 
     resample_ctx *res_ctx;
+    agc_ctx **agc_ctxs;
 
-    FP_FLOAT *filtered_buffer;
+    greatbuf_real *filtered_buffer;
+    greatbuf_real *channel_buffer;
     int16_t *pcm_buffer;
 
+    size_t c;
+    int result;
+
     prctl(PR_SET_NAME, "resample");
     log_info("Thread start");
 
     retval = EXIT_SUCCESS;
+    result = EXIT_SUCCESS;
+
+    log_debug("Allocating AGC contexts");
+    agc_ctxs = (agc_ctx **) calloc(rx_channels, sizeof(agc_ctx *));
+    if (agc_ctxs == NULL) {
+        log_error("Unable to allocate AGC contexts");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    for (c = 0; c < rx_channels && conf->agc == FLAG_TRUE; c++) {
+        log_debug("Initializing AGC context for channel %zu", c + 1);
+        agc_ctxs[c] = agc_init(rx_channel_sample_rate, rx_channel_size, conf->agc_attack, conf->agc_decay);
+        if (agc_ctxs[c] == NULL) {
+            log_error("Unable to allocate AGC context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+    }
 
     log_debug("Initializing resample context");
-    res_ctx = resample_init(conf->rtlsdr_device_sample_rate, conf->audio_sample_rate);
+    res_ctx = resample_init(rx_channel_sample_rate, conf->audio_sample_rate);
     if (res_ctx == NULL) {
         log_error("Unable to allocate resample context");
         retval = EXIT_FAILURE;
@@ -991,7 +1943,8 @@ void *thread_rx_resample() {
             greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_PCM);
             break;
         }
-        pcm_buffer = greatbuf_item_get(greatbuf, pos)->pcm;
+        item = greatbuf_item_get(greatbuf, pos);
+        pcm_buffer = item->pcm;
 
         pos = greatbuf_head_acquire(greatbuf, GREATBUF_CIRCBUF_MONITOR);
         if (pos == -1) {
@@ -1003,14 +1956,49 @@ void *thread_rx_resample() {
             break;
         }
 
-        log_trace("Resampling");
-        resample_float_to_int16(res_ctx, filtered_buffer, conf->rtlsdr_samples, pcm_buffer, rx_pcm_size);
+        for (c = 0; c < rx_channels && result == EXIT_SUCCESS; c++) {
+            channel_buffer = filtered_buffer + c * rx_channel_size;
+
+            if (agc_ctxs[c] != NULL) {
+                log_trace("Applying AGC to channel %zu", c + 1);
+#ifdef RTLSDR_RADIO_FIXED_POINT
+                result = agc_perform_gain_fixed(agc_ctxs[c], channel_buffer, rx_channel_size);
+#else
+                result = agc_perform_gain(agc_ctxs[c], channel_buffer, rx_channel_size);
+#endif
+            }
+
+            if (!item->squelch_open[c]) {
+                memset(pcm_buffer + c * rx_pcm_size, 0, rx_pcm_size * sizeof(int16_t));
+                continue;
+            }
+
+            log_trace("Resampling channel %zu", c + 1);
+#ifdef RTLSDR_RADIO_FIXED_POINT
+            resample_int16(res_ctx, channel_buffer, rx_channel_size, pcm_buffer + c * rx_pcm_size, rx_pcm_size);
+#else
+            resample_float_to_int16(res_ctx, channel_buffer, rx_channel_size, pcm_buffer + c * rx_pcm_size,
+                                    rx_pcm_size);
+#endif
+        }
 
         greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_FILTERED);
         greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_PCM);
         greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_MONITOR);
+
+        if (result != EXIT_SUCCESS) {
+            log_error("Unable to apply AGC");
+            retval = EXIT_FAILURE;
+            break;
+        }
     }
 
+    log_debug("Freeing AGC contexts");
+    for (c = 0; c < rx_channels; c++)
+        agc_free(agc_ctxs[c]);
+
+    free(agc_ctxs);
+
     resample_free(res_ctx);
 
     main_stop();
@@ -1032,7 +2020,9 @@ void *thread_rx_codec() {
 
     size_t pcm_pos;
     int16_t *pcm;
+    int *frame_open;
 
+    size_t c;
     size_t i;
 
     prctl(PR_SET_NAME, "codec");
@@ -1042,8 +2032,9 @@ void *thread_rx_codec() {
 
     log_debug("Allocationg PCM buffer");
     pcm_pos = 0;
-    pcm = (int16_t *) calloc(rx_min_pcm_size, sizeof(int16_t));
-    if (pcm == NULL) {
+    pcm = (int16_t *) calloc(rx_min_pcm_size * rx_channels, sizeof(int16_t));
+    frame_open = (int *) calloc(rx_channels, sizeof(int));
+    if (pcm == NULL || frame_open == NULL) {
         log_error("Unable to allocate resample context");
         retval = EXIT_FAILURE;
         pthread_exit(&retval);
@@ -1080,15 +2071,27 @@ void *thread_rx_codec() {
         }
 
         item = greatbuf_item_get(greatbuf, pos);
-        item->contains_data = 0;
+
+        for (c = 0; c < rx_channels; c++) {
+            item->contains_data[c] = 0;
+            frame_open[c] |= item->squelch_open[c];
+        }
 
         for (i = 0; i < rx_pcm_size; i++) {
-            pcm[pcm_pos] = item->pcm[i];
+            for (c = 0; c < rx_channels; c++)
+                pcm[c * rx_min_pcm_size + pcm_pos] = item->pcm[c * rx_pcm_size + i];
             pcm_pos++;
 
             if (pcm_pos >= rx_min_pcm_size) {
-                codec_encode(ctx_codec, pcm, item->data);
-                item->contains_data = 1;
+                for (c = 0; c < rx_channels; c++) {
+                    if (frame_open[c]) {
+                        codec_encode(ctx_codecs[c], pcm + c * rx_min_pcm_size, item->data + c * rx_data_size);
+                        item->contains_data[c] = 1;
+                    }
+
+                    frame_open[c] = item->squelch_open[c];
+                }
+
                 pcm_pos = 0;
             }
         }
@@ -1097,6 +2100,9 @@ void *thread_rx_codec() {
         greatbuf_head_release(greatbuf, GREATBUF_CIRCBUF_CODEC);
     }
 
+    free(frame_open);
+    free(pcm);
+
     main_stop();
 
     log_info("Thread end: %d", retval);
@@ -1172,6 +2178,8 @@ void *thread_rx_audio() {
         }
 
         item = greatbuf_item_get(greatbuf, pos);
+
+        // Monitor, WAV file and stdout carry the first channel only
         pcm_buffer = item->pcm;
 
         if (conf->audio_monitor_enabled == FLAG_TRUE) {
@@ -1226,93 +2234,343 @@ void *thread_rx_network() {
     greatbuf_item *item;
 
     struct timespec now;
+    struct timespec elapsed;
 
     payload *p;
-    uint8_t network_buffer[4096];
-    size_t network_size;
+    payload_v2_state *states;
+    payload_v2_state *state;
+    uint8_t *header;
+    size_t header_size;
+
+    uint8_t *aggregate_buffers;
+    size_t *aggregate_sizes;
+    uint32_t *aggregate_frames;
+    struct timespec *aggregate_starts;
+    uint8_t *aggregate_buffer;
+    int aggregate;
+    int flush;
 
     network_ctx *ctx;
+    network_batch *batch;
+    stream_ctx *stream;
+    fec_ctx **fecs;
+
+    size_t c;
 
     prctl(PR_SET_NAME, "network");
     log_info("Thread start");
 
     retval = EXIT_SUCCESS;
     count = 0;
+    ctx = NULL;
+    stream = NULL;
+    fecs = NULL;
 
-    log_debug("Initializing network context");
-    ctx = network_init(conf->network_server, conf->network_port);
-    if (ctx == NULL) {
-        log_error("Unable to initialize network context");
-        retval = EXIT_FAILURE;
-        pthread_exit(&retval);
-    }
+    log_debug("Allocating payload");
+    p = payload_init();
 
-    log_debug("Closing network socket");
-    result = network_socket_open(ctx);
-    if (result == EXIT_FAILURE) {
-        log_error("Unable to open network socket");
+    log_debug("Initializing network batch");
+    batch = network_batch_init(conf->network_fec > 0 ? 2 * rx_channels : rx_channels,
+                               PAYLOAD_V2_HEADER_SIZE_MAX > payload_get_header_size(p)
+                               ? PAYLOAD_V2_HEADER_SIZE_MAX : payload_get_header_size(p));
+    if (batch == NULL) {
+        log_error("Unable to initialize network batch");
         retval = EXIT_FAILURE;
         pthread_exit(&retval);
     }
 
-    log_debug("Allocating payload");
-    p = payload_init();
-
-    log_debug("Zeroing network buffer");
-    bzero(network_buffer, 4096);
-    network_size = 0;
-
-    log_debug("Waiting for other threads to init");
-    rx_network_ready = 1;
-    main_rx_wait_init();
+    if (conf->network_transport == NETWORK_TRANSPORT_TCP) {
+        log_debug("Initializing stream context");
+        stream = stream_init(conf->network_server, conf->network_port, conf->network_queue,
+                             batch->header_size + MAIN_RX_NETWORK_BUFFER_SIZE);
+        if (stream == NULL) {
+            log_error("Unable to initialize stream context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+    } else {
+        log_debug("Initializing network context");
+        ctx = network_init(conf->network_server, conf->network_port);
+        if (ctx == NULL) {
+            log_error("Unable to initialize network context");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
 
-    log_debug("Starting read loop");
-    while (keep_running) {
-        pos = greatbuf_tail_acquire(greatbuf, GREATBUF_CIRCBUF_CODEC);
-        if (pos == -1) {
-            log_error("Error acquiring codec buffer tail");
-            greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_CODEC);
+        log_debug("Setting multicast options");
+        result = network_set_multicast(ctx, (int) conf->network_multicast_ttl, conf->network_multicast_interface);
+        if (result == EXIT_FAILURE) {
+            log_error("Unable to set multicast options");
             retval = EXIT_FAILURE;
-            break;
-        } else if (pos == -2) {
-            greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_CODEC);
-            break;
+            pthread_exit(&retval);
         }
 
-        item = greatbuf_item_get(greatbuf, pos);
+        log_debug("Opening network socket");
+        result = network_socket_open(ctx);
+        if (result == EXIT_FAILURE) {
+            log_error("Unable to open network socket");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+
+        log_debug("Adding network destinations");
+        for (c = 0; c < conf->network_destinations_count; c++) {
+            result = network_destination_add(ctx, conf->network_destinations[c],
+                                             conf->network_destinations_ports[c] > 0
+                                             ? conf->network_destinations_ports[c] : conf->network_port);
+            if (result == EXIT_FAILURE) {
+                log_error("Unable to add network destination");
+                retval = EXIT_FAILURE;
+                pthread_exit(&retval);
+            }
+        }
+    }
+
+    log_debug("Allocating v2 payload states");
+    states = (payload_v2_state *) calloc(rx_channels, sizeof(payload_v2_state));
+    if (states == NULL) {
+        log_error("Unable to allocate v2 payload states");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    if (conf->network_fec > 0) {
+        log_debug("Initializing FEC contexts");
+        fecs = (fec_ctx **) calloc(rx_channels, sizeof(fec_ctx *));
+        if (fecs == NULL) {
+            log_error("Unable to allocate FEC contexts");
+            retval = EXIT_FAILURE;
+            pthread_exit(&retval);
+        }
+
+        for (c = 0; c < rx_channels; c++) {
+            fecs[c] = fec_init(conf->network_fec, rx_data_size);
+            if (fecs[c] == NULL) {
+                log_error("Unable to initialize FEC context");
+                retval = EXIT_FAILURE;
+                pthread_exit(&retval);
+            }
+        }
+    }
+
+    aggregate = conf->network_aggregate_frames > 1 || conf->network_aggregate_time > 0;
+
+    log_debug("Allocating aggregation buffers");
+    aggregate_buffers = (uint8_t *) calloc(rx_channels * MAIN_RX_NETWORK_BUFFER_SIZE, sizeof(uint8_t));
+    aggregate_sizes = (size_t *) calloc(rx_channels, sizeof(size_t));
+    aggregate_frames = (uint32_t *) calloc(rx_channels, sizeof(uint32_t));
+    aggregate_starts = (struct timespec *) calloc(rx_channels, sizeof(struct timespec));
+    if (aggregate_buffers == NULL || aggregate_sizes == NULL || aggregate_frames == NULL || aggregate_starts == NULL) {
+        log_error("Unable to allocate aggregation buffers");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    log_debug("Waiting for other threads to init");
+    rx_network_ready = 1;
+    main_rx_wait_init();
+
+    log_debug("Starting read loop");
+    while (keep_running) {
+        pos = greatbuf_tail_acquire(greatbuf, GREATBUF_CIRCBUF_CODEC);
+        if (pos == -1) {
+            log_error("Error acquiring codec buffer tail");
+            greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_CODEC);
+            retval = EXIT_FAILURE;
+            break;
+        } else if (pos == -2) {
+            greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_CODEC);
+            break;
+        }
+
+        item = greatbuf_item_get(greatbuf, pos);
 
         log_trace("Setting delay for item");
         timespec_get(&now, TIME_UTC);
         utils_timespec_sub(&item->ts, &now, &item->delay);
 
-        if (item->contains_data == 1) {
+        for (c = 0; c < rx_channels; c++)
+            if (item->contains_data[c] == 1)
+                break;
+
+        if (c < rx_channels) {
             item->number = count;
             count++;
+        }
+
+        for (c = 0; c < rx_channels; c++) {
+            state = conf->network_protocol == 2 ? &states[c] : NULL;
+
+            if (item->contains_data[c] == 1) {
+                payload_set_numbers(p, 1, item->number);
+                payload_set_timestamp(p, &item->ts);
+                payload_set_rms(p, item->rms[c]);
+                payload_set_channel_frequency(p, (uint32_t) c + 1,
+                                              conf->channel_freqs_count > 0 ? rx_channel_freqs[c] : item->center_freq);
+                payload_set_codec_flags(p, (uint8_t) conf->codec2_mode,
+                                        item->squelch_open[c] ? PAYLOAD_V2_FLAG_SQUELCH : 0);
+                payload_set_data_size(p, (uint32_t) item->data_size);
+            }
+
+            if (!aggregate) {
+                if (item->contains_data[c] != 1) {
+                    if (fecs != NULL && fec_flush(fecs[c]) == FEC_REPAIR)
+                        main_rx_network_repair(batch, p, fecs[c], (uint32_t) c + 1);
+
+                    continue;
+                }
+
+                // A delta coded packet is useless once the previous one is lost: with FEC every packet is a key
+                if (state != NULL && fecs != NULL)
+                    state->valid = 0;
+
+                header = network_batch_header(batch);
+                if (state != NULL)
+                    payload_v2_serialize_header(p, state, header, batch->header_size, &header_size);
+                else
+                    payload_serialize_header(p, header, batch->header_size, &header_size);
+
+                result = network_batch_add(batch, header_size, item->data + c * item->data_size, item->data_size);
+                if (result == EXIT_FAILURE) {
+                    log_error("Unable to queue data");
+                    retval = EXIT_FAILURE;
+                    break;
+                }
+
+                if (fecs != NULL
+                    && fec_encode(fecs[c], item->number, p->timestamp, item->data + c * item->data_size,
+                                  item->data_size) == FEC_REPAIR) {
+                    result = main_rx_network_repair(batch, p, fecs[c], (uint32_t) c + 1);
+                    if (result == EXIT_FAILURE) {
+                        log_error("Unable to queue repair");
+                        retval = EXIT_FAILURE;
+                        break;
+                    }
+                }
+
+                continue;
+            }
 
-            payload_set_numbers(p, 1, item->number);
-            payload_set_timestamp(p, &item->ts);
-            payload_set_rms(p, item->rms);
-            payload_set_channel_frequency(p, 1, 1);
-            payload_set_data(p, item->data, item->data_size);
+            aggregate_buffer = aggregate_buffers + c * MAIN_RX_NETWORK_BUFFER_SIZE;
+
+            if (item->contains_data[c] == 1) {
+                if (aggregate_frames[c] == 0) {
+                    log_trace("Beginning aggregation for channel %zu", c + 1);
+                    if (state != NULL)
+                        payload_v2_aggregate_begin(p, state, aggregate_buffer, MAIN_RX_NETWORK_BUFFER_SIZE,
+                                                   &aggregate_sizes[c]);
+                    else
+                        payload_aggregate_begin(p, aggregate_buffer, MAIN_RX_NETWORK_BUFFER_SIZE,
+                                                &aggregate_sizes[c]);
+                    aggregate_starts[c] = item->ts;
+                }
+
+                if (state != NULL)
+                    result = payload_v2_aggregate_add(state, aggregate_buffer, MAIN_RX_NETWORK_BUFFER_SIZE,
+                                                      &aggregate_sizes[c], item->number,
+                                                      item->data + c * item->data_size, (uint32_t) item->data_size);
+                else
+                    result = payload_aggregate_add(aggregate_buffer, MAIN_RX_NETWORK_BUFFER_SIZE, &aggregate_sizes[c],
+                                                   item->number, item->data + c * item->data_size,
+                                                   (uint32_t) item->data_size);
+                if (result == EXIT_FAILURE) {
+                    log_error("Unable to aggregate data");
+                    retval = EXIT_FAILURE;
+                    break;
+                }
+
+                aggregate_frames[c]++;
+            }
 
-            payload_serialize(p, network_buffer, 4096, &network_size);
+            if (aggregate_frames[c] == 0)
+                continue;
 
-            result = network_socket_send(ctx, network_buffer, network_size);
+            utils_timespec_sub(&aggregate_starts[c], &item->ts, &elapsed);
+
+            flush = payload_aggregate_is_due(item->squelch_open[c], aggregate_frames[c],
+                                             conf->network_aggregate_frames,
+                                             (uint64_t) (elapsed.tv_sec * 1000 + elapsed.tv_nsec / 1000000),
+                                             conf->network_aggregate_time, aggregate_sizes[c],
+                                             state != NULL
+                                             ? payload_v2_get_frame_size((uint32_t) item->data_size)
+                                             : payload_aggregate_get_frame_size((uint32_t) item->data_size),
+                                             MAIN_RX_NETWORK_BUFFER_SIZE);
+
+            if (!flush)
+                continue;
+
+            log_trace("Flushing %u aggregated frames for channel %zu", aggregate_frames[c], c + 1);
+            result = main_rx_network_flush(batch, state, aggregate_buffer, &aggregate_sizes[c], &aggregate_frames[c]);
             if (result == EXIT_FAILURE) {
-                log_error("Unable to send data");
+                log_error("Unable to queue data");
                 retval = EXIT_FAILURE;
                 break;
             }
         }
 
+        if (retval == EXIT_SUCCESS && batch->count > 0) {
+            log_trace("Sending %zu packets", batch->count);
+            if (stream != NULL)
+                stream_push_batch(stream, batch);
+            else if (network_socket_send_batch(ctx, batch) == EXIT_FAILURE)
+                log_warn("Unable to send data");
+        }
+
         greatbuf_tail_release(greatbuf, GREATBUF_CIRCBUF_CODEC);
+
+        if (retval != EXIT_SUCCESS)
+            break;
+    }
+
+    if (retval == EXIT_SUCCESS) {
+        log_debug("Flushing pending aggregated frames");
+        for (c = 0; c < rx_channels; c++)
+            if (aggregate_frames[c] > 0)
+                main_rx_network_flush(batch, conf->network_protocol == 2 ? &states[c] : NULL,
+                                      aggregate_buffers + c * MAIN_RX_NETWORK_BUFFER_SIZE,
+                                      &aggregate_sizes[c], &aggregate_frames[c]);
+
+        if (batch->count > 0) {
+            if (stream != NULL)
+                stream_push_batch(stream, batch);
+            else
+                network_socket_send_batch(ctx, batch);
+        }
     }
 
-    log_debug("Closing network socket");
-    network_socket_close(ctx);
+    if (stream != NULL) {
+        stream_print_stats(stream);
 
-    log_debug("Freeing network context");
-    network_free(ctx);
+        log_debug("Freeing stream context");
+        stream_free(stream);
+    } else {
+        network_print_stats(ctx);
+
+        log_debug("Closing network socket");
+        network_socket_close(ctx);
+
+        log_debug("Freeing network context");
+        network_free(ctx);
+    }
+
+    log_debug("Freeing network batch");
+    network_batch_free(batch);
+
+    log_debug("Freeing v2 payload states");
+    free(states);
+
+    if (fecs != NULL) {
+        log_debug("Freeing FEC contexts");
+        for (c = 0; c < rx_channels; c++)
+            fec_free(fecs[c]);
+        free(fecs);
+    }
+
+    log_debug("Freeing aggregation buffers");
+    free(aggregate_starts);
+    free(aggregate_frames);
+    free(aggregate_sizes);
+    free(aggregate_buffers);
 
     log_debug("Freeing payload");
     payload_free(p);
@@ -1324,4 +2582,511 @@ void *thread_rx_network() {
     pthread_exit(&retval);
 }
 
+static int main_rx_network_flush(network_batch *batch, payload_v2_state *state, uint8_t *buffer, size_t *size,
+                                 uint32_t *frames) {
+    int result;
+
+    if (state != NULL)
+        payload_v2_aggregate_end(state, buffer);
+    else
+        payload_aggregate_end(buffer, *frames);
+
+    result = network_batch_add(batch, 0, buffer, *size);
+
+    *size = 0;
+    *frames = 0;
+
+    return result;
+}
+
+static int main_rx_network_repair(network_batch *batch, payload *p, fec_ctx *fec, uint32_t channel) {
+    uint8_t *header;
+    size_t header_size;
+
+    header = network_batch_header(batch);
+    if (header == NULL) {
+        log_error("No space left in batch");
+        return EXIT_FAILURE;
+    }
+
+    p->receiver = 1;
+    p->number = fec->repair.base;
+    p->timestamp = fec->repair.timestamp;
+    p->channel = channel;
+    p->data_size = fec->repair.data_size;
+
+    payload_repair_serialize_header(p, fec->repair.mask, fec->repair.size, header, batch->header_size, &header_size);
+
+    return network_batch_add(batch, header_size, fec->repair.data, fec->repair.data_size);
+}
+
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_SPECTRUM
+
+void *thread_rx_spectrum() {
+    int retval;
+    int result;
+
+    ssize_t pos;
+    ssize_t last_pos;
+    greatbuf_item *item;
+    uint64_t produced;
+    uint64_t last_produced;
+    size_t blocks;
+    size_t offset;
+
+    struct timespec deadline;
+    struct timespec now;
+    long period;
+
+    spectrum_ctx *ctx;
+    network_ctx *net_ctx;
+
+    uint8_t *network_buffer;
+    size_t network_size;
+
+    prctl(PR_SET_NAME, "spectrum");
+    log_info("Thread start");
+
+    retval = EXIT_SUCCESS;
+
+    if (conf->spectrum != FLAG_TRUE) {
+        log_debug("Spectrum disabled");
+        rx_spectrum_ready = 1;
+        main_rx_wait_init();
+        pthread_exit(&retval);
+    }
+
+    log_debug("Initializing spectrum context");
+    ctx = spectrum_init(conf->spectrum_size, conf->spectrum_averages, conf->fft_planner);
+    if (ctx == NULL) {
+        log_error("Unable to initialize spectrum context");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    log_debug("Initializing spectrum network context");
+    net_ctx = network_init(conf->spectrum_server, conf->spectrum_port);
+    if (net_ctx == NULL || network_socket_open(net_ctx) != EXIT_SUCCESS) {
+        log_error("Unable to open spectrum socket");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    log_debug("Allocating spectrum buffer");
+    network_buffer = (uint8_t *) calloc(spectrum_get_size(ctx), sizeof(uint8_t));
+    if (network_buffer == NULL) {
+        log_error("Unable to allocate spectrum buffer");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    period = 1000000000L / (long) conf->spectrum_rate;
+    last_produced = 0;
+
+    log_debug("Waiting for other threads to init");
+    rx_spectrum_ready = 1;
+    main_rx_wait_init();
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    log_debug("Starting spectrum loop");
+    while (keep_running) {
+        deadline.tv_nsec += period;
+        while (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > deadline.tv_sec || (now.tv_sec == deadline.tv_sec && now.tv_nsec > deadline.tv_nsec)) {
+            log_trace("Spectrum behind schedule, skipping frames");
+            deadline = now;
+        } else {
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+        }
+
+        last_pos = greatbuf_head_last(greatbuf, GREATBUF_CIRCBUF_SAMPLES, &produced);
+        if (last_pos < 0 || produced == last_produced)
+            continue;
+
+        log_trace("Computing spectrum");
+        result = EXIT_SUCCESS;
+
+        for (blocks = 0; !spectrum_ready(ctx) && blocks < produced - last_produced && result == EXIT_SUCCESS;
+             blocks++) {
+            pos = (last_pos + MAIN_RX_BUFFERS_SIZE - (ssize_t) (blocks % MAIN_RX_BUFFERS_SIZE)) % MAIN_RX_BUFFERS_SIZE;
+            item = greatbuf_item_get(greatbuf, (size_t) pos);
+
+            for (offset = 0; offset + ctx->size <= item->samples_size && !spectrum_ready(ctx)
+                             && result == EXIT_SUCCESS; offset += ctx->size) {
+#ifdef RTLSDR_RADIO_FIXED_POINT
+                result = spectrum_add_fixed(ctx, item->samples + offset);
+#else
+                result = spectrum_add(ctx, item->samples + offset);
+#endif
+            }
+        }
+
+        last_produced = produced;
+
+        if (result != EXIT_SUCCESS) {
+            log_error("Unable to compute spectrum");
+            retval = EXIT_FAILURE;
+            break;
+        }
+
+        if (!spectrum_ready(ctx))
+            continue;
+
+        item = greatbuf_item_get(greatbuf, (size_t) last_pos);
+
+        result = spectrum_serialize(ctx, &item->ts, item->center_freq,
+                                    conf->rtlsdr_device_sample_rate, network_buffer, spectrum_get_size(ctx),
+                                    &network_size);
+        if (result != EXIT_SUCCESS) {
+            log_error("Unable to serialize spectrum");
+            retval = EXIT_FAILURE;
+            break;
+        }
+
+        log_trace("Sending spectrum");
+        network_socket_send(net_ctx, network_buffer, network_size);
+    }
+
+    free(network_buffer);
+
+    network_socket_close(net_ctx);
+    network_free(net_ctx);
+
+    spectrum_free(ctx);
+
+    main_stop();
+
+    log_info("Thread end: %d", retval);
+
+    pthread_exit(&retval);
+}
+
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_IQ
+
+void *thread_rx_iq() {
+    int retval;
+    int result;
+
+    ssize_t pos;
+    ssize_t last_pos;
+    greatbuf_item *item;
+    uint64_t produced;
+    uint64_t processed;
+    uint64_t skipped;
+    uint64_t blocks;
+    uint64_t b;
+    size_t k;
+
+    struct timespec deadline;
+    struct timespec now;
+
+    iqsink_ctx *ctx;
+    iqsink_packet *packet;
+    network_ctx *net_ctx;
+    network_batch *batch;
+    uint8_t *header;
+    size_t header_size;
+
+    prctl(PR_SET_NAME, "iq");
+    log_info("Thread start");
+
+    retval = EXIT_SUCCESS;
+
+    if (conf->iq != FLAG_TRUE) {
+        log_debug("IQ sink disabled");
+        rx_iq_ready = 1;
+        main_rx_wait_init();
+        pthread_exit(&retval);
+    }
+
+    log_debug("Initializing IQ sink context");
+    ctx = iqsink_init(conf->rtlsdr_device_sample_rate, conf->iq_sample_rate, conf->iq_offset, conf->rtlsdr_samples,
+                      conf->iq_format, conf->iq_gain);
+    if (ctx == NULL) {
+        log_error("Unable to initialize IQ sink context");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    log_debug("Initializing IQ network context");
+    net_ctx = network_init(conf->iq_server, conf->iq_port);
+    if (net_ctx == NULL || network_socket_open(net_ctx) != EXIT_SUCCESS) {
+        log_error("Unable to open IQ socket");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    log_debug("Initializing IQ network batch");
+    batch = network_batch_init(ctx->packets_size, IQSINK_HEADER_SIZE);
+    if (batch == NULL) {
+        log_error("Unable to initialize IQ network batch");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    skipped = 0;
+
+    log_debug("Waiting for other threads to init");
+    rx_iq_ready = 1;
+    main_rx_wait_init();
+
+    greatbuf_head_last(greatbuf, GREATBUF_CIRCBUF_SAMPLES, &processed);
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    log_debug("Starting IQ loop");
+    while (keep_running) {
+        deadline.tv_nsec += MAIN_RX_IQ_POLL_MS * 1000000L;
+        while (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > deadline.tv_sec || (now.tv_sec == deadline.tv_sec && now.tv_nsec > deadline.tv_nsec))
+            deadline = now;
+        else
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+
+        last_pos = greatbuf_head_last(greatbuf, GREATBUF_CIRCBUF_SAMPLES, &produced);
+        if (last_pos < 0 || produced == processed)
+            continue;
+
+        blocks = produced - processed;
+        processed = produced;
+
+        if (blocks > MAIN_RX_IQ_BLOCKS_MAX) {
+            log_warn("IQ sink behind schedule, skipping %llu blocks", (unsigned long long) blocks - 1);
+            iqsink_skip(ctx, blocks - 1);
+            skipped += blocks - 1;
+            blocks = 1;
+        }
+
+        result = EXIT_SUCCESS;
+
+        for (b = blocks; b > 0 && result == EXIT_SUCCESS; b--) {
+            pos = (last_pos + MAIN_RX_BUFFERS_SIZE - (ssize_t) ((b - 1) % MAIN_RX_BUFFERS_SIZE)) % MAIN_RX_BUFFERS_SIZE;
+            item = greatbuf_item_get(greatbuf, (size_t) pos);
+
+            log_trace("Processing IQ block");
+#ifdef RTLSDR_RADIO_FIXED_POINT
+            result = iqsink_process_fixed(ctx, item->samples);
+#else
+            result = iqsink_process(ctx, item->samples);
+#endif
+
+            for (k = 0; k < ctx->packets_count && result == EXIT_SUCCESS; k++) {
+                packet = &ctx->packets[k];
+                header = network_batch_header(batch);
+                iqsink_serialize_header(ctx, packet, &item->ts, item->center_freq, header, batch->header_size,
+                                        &header_size);
+                result = network_batch_add(batch, header_size, packet->data, packet->data_size);
+            }
+
+            if (result == EXIT_SUCCESS && batch->count > 0) {
+                log_trace("Sending %zu IQ packets", batch->count);
+                if (network_socket_send_batch(net_ctx, batch) == EXIT_FAILURE)
+                    log_warn("Unable to send IQ samples");
+            }
+        }
+
+        if (result != EXIT_SUCCESS) {
+            log_error("Unable to process IQ samples");
+            retval = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    log_info("IQ blocks skipped: %llu", (unsigned long long) skipped);
+    network_print_stats(net_ctx);
+
+    network_batch_free(batch);
+
+    network_socket_close(net_ctx);
+    network_free(net_ctx);
+
+    iqsink_free(ctx);
+
+    main_stop();
+
+    log_info("Thread end: %d", retval);
+
+    pthread_exit(&retval);
+}
+
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_CONTROL
+
+void *thread_rx_control() {
+    int retval;
+
+    char message[CONTROL_MESSAGE_SIZE];
+    char reply[32];
+    ssize_t received;
+    struct sockaddr_storage sender;
+    socklen_t sender_len;
+
+    control_params params;
+    uint64_t generation;
+
+    prctl(PR_SET_NAME, "control");
+    log_info("Thread start");
+
+    retval = EXIT_SUCCESS;
+
+    if (conf->control_port == 0) {
+        log_debug("Control disabled");
+        rx_control_ready = 1;
+        main_rx_wait_init();
+        pthread_exit(&retval);
+    }
+
+    if (control_socket_open(rx_control) != EXIT_SUCCESS) {
+        log_error("Unable to open control socket");
+        retval = EXIT_FAILURE;
+        pthread_exit(&retval);
+    }
+
+    log_debug("Waiting for other threads to init");
+    rx_control_ready = 1;
+    main_rx_wait_init();
+
+    log_debug("Starting control loop");
+    while (keep_running) {
+        received = control_socket_receive(rx_control, message, sizeof(message), &sender, &sender_len);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                continue;
+
+            log_error("Error %d receiving control message: %s", errno, strerror(errno));
+            retval = EXIT_FAILURE;
+            break;
+        }
+
+        log_debug("Received control message of %zd bytes", received);
+
+        control_get(rx_control, &params);
+
+        if (control_parse(&params, message) != EXIT_SUCCESS
+            || control_check(&params, conf, rx_channels, rx_channel_sample_rate) != EXIT_SUCCESS) {
+            log_warn("Control message rejected");
+            strcpy(reply, "ERR\n");
+        } else {
+            generation = control_publish(rx_control, &params);
+            snprintf(reply, sizeof(reply), "OK %llu\n", (unsigned long long) generation);
+        }
+
+        control_socket_reply(rx_control, reply, &sender, sender_len);
+    }
+
+    control_socket_close(rx_control);
+
+    main_stop();
+
+    log_info("Thread end: %d", retval);
+
+    pthread_exit(&retval);
+}
+
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_SCAN
+
+void *thread_rx_scan() {
+    int retval;
+
+    ssize_t pos;
+    ssize_t last_pos;
+    greatbuf_item *item;
+    uint64_t produced;
+    uint64_t last_produced;
+    uint64_t blocks;
+    uint64_t b;
+
+    control_params params;
+    struct timespec block_duration;
+    struct timespec start;
+    struct timespec now;
+    struct timespec elapsed;
+
+    prctl(PR_SET_NAME, "scan");
+    log_info("Thread start");
+
+    retval = EXIT_SUCCESS;
+
+    if (rx_scan == NULL) {
+        log_debug("Scan disabled");
+        rx_scan_ready = 1;
+        main_rx_wait_init();
+        pthread_exit(&retval);
+    }
+
+    block_duration.tv_sec = 0;
+    block_duration.tv_nsec = (long) (1000000000ULL * conf->rtlsdr_samples / conf->rtlsdr_device_sample_rate);
+
+    log_debug("Waiting for other threads to init");
+    rx_scan_ready = 1;
+    main_rx_wait_init();
+
+    log_debug("Tuning to first scan frequency");
+    control_get(rx_control, &params);
+    params.center_freq = scan_frequency(rx_scan);
+    control_publish(rx_control, &params);
+
+    greatbuf_head_last(greatbuf, GREATBUF_CIRCBUF_DEMOD, &last_produced);
+    timespec_get(&start, TIME_UTC);
+
+    log_debug("Starting scan loop");
+    while (keep_running) {
+        nanosleep(&block_duration, NULL);
+
+        last_pos = greatbuf_head_last(greatbuf, GREATBUF_CIRCBUF_DEMOD, &produced);
+        if (last_pos < 0 || produced == last_produced)
+            continue;
+
+        blocks = produced - last_produced;
+        if (blocks > MAIN_RX_BUFFERS_SIZE)
+            blocks = MAIN_RX_BUFFERS_SIZE;
+
+        last_produced = produced;
+
+        for (b = blocks; b > 0; b--) {
+            pos = (last_pos + MAIN_RX_BUFFERS_SIZE - (ssize_t) (b - 1)) % MAIN_RX_BUFFERS_SIZE;
+            item = greatbuf_item_get(greatbuf, (size_t) pos);
+
+            if (item->center_freq != scan_frequency(rx_scan))
+                continue;
+
+            if (scan_update(rx_scan, item->squelch_open[0])) {
+                log_debug("Hopping to %u Hz", scan_frequency(rx_scan));
+                control_get(rx_control, &params);
+                params.center_freq = scan_frequency(rx_scan);
+                control_publish(rx_control, &params);
+                break;
+            }
+        }
+    }
+
+    timespec_get(&now, TIME_UTC);
+    utils_timespec_sub(&start, &now, &elapsed);
+    log_info("Scanned %llu channels in %ld.%03ld s", (unsigned long long) rx_scan->hops,
+             (long) elapsed.tv_sec, elapsed.tv_nsec / 1000000);
+
+    main_stop();
+
+    log_info("Thread end: %d", retval);
+
+    pthread_exit(&retval);
+}
+
 #endif
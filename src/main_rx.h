@@ -21,6 +21,10 @@
 #define __RTLSDR_RADIO__MAIN_RX__H
 
 #define MAIN_RX_BUFFERS_SIZE 2048
+#define MAIN_RX_USB_BLOCK_SIZE 512
+#define MAIN_RX_NETWORK_BUFFER_SIZE 4096
+#define MAIN_RX_IQ_POLL_MS 5
+#define MAIN_RX_IQ_BLOCKS_MAX (MAIN_RX_BUFFERS_SIZE / 2)
 
 #define MAIN_RX_ENABLE_THREAD_READ
 #define MAIN_RX_ENABLE_THREAD_SAMPLES
@@ -30,6 +34,10 @@
 #define MAIN_RX_ENABLE_THREAD_CODEC
 #define MAIN_RX_ENABLE_THREAD_AUDIO
 #define MAIN_RX_ENABLE_THREAD_NETWORK
+#define MAIN_RX_ENABLE_THREAD_SPECTRUM
+#define MAIN_RX_ENABLE_THREAD_IQ
+#define MAIN_RX_ENABLE_THREAD_CONTROL
+#define MAIN_RX_ENABLE_THREAD_SCAN
 
 int main_rx();
 
@@ -69,4 +77,20 @@ void *thread_rx_audio();
 void *thread_rx_network();
 #endif
 
+#ifdef MAIN_RX_ENABLE_THREAD_SPECTRUM
+void *thread_rx_spectrum();
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_IQ
+void *thread_rx_iq();
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_CONTROL
+void *thread_rx_control();
+#endif
+
+#ifdef MAIN_RX_ENABLE_THREAD_SCAN
+void *thread_rx_scan();
+#endif
+
 #endif
@@ -0,0 +1,412 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <rtl-sdr.h>
+#include <sys/prctl.h>
+
+#include "main_survey.h"
+#include "main.h"
+#include "cfg.h"
+#include "log.h"
+#include "device.h"
+#include "iqcorr.h"
+#include "spectrum.h"
+#include "survey.h"
+#include "fft.h"
+#include "utils.h"
+
+extern volatile int keep_running;
+extern cfg *conf;
+
+pthread_t survey_read_thread;
+
+pthread_mutex_t survey_slots_mutex;
+pthread_cond_t survey_slots_cond;
+
+main_survey_slot survey_slots[MAIN_SURVEY_SLOTS];
+int survey_read_done;
+
+rtlsdr_dev_t *survey_device;
+survey_ctx *survey_plan;
+FILE *survey_file;
+
+spectrum_ctx *survey_spectrum;
+iqcorr_ctx *survey_iq_ctx;
+FP_FLOAT complex *survey_samples;
+FP_FLOAT *survey_levels;
+
+int survey_read_len;
+int survey_settle_len;
+
+static void main_survey_wait(int);
+
+int main_survey() {
+    int result;
+    pthread_attr_t attr;
+    int thread_result;
+
+    main_survey_slot *slot;
+    size_t tail;
+    size_t hop;
+    size_t a;
+
+    struct timespec sweep_start;
+    struct timespec now;
+    struct timespec elapsed;
+
+    log_info("Main program survey mode");
+
+    survey_device = NULL;
+    survey_plan = NULL;
+    survey_file = NULL;
+    survey_spectrum = NULL;
+    survey_iq_ctx = NULL;
+    survey_samples = NULL;
+    survey_levels = NULL;
+
+    memset(survey_slots, 0, sizeof(survey_slots));
+
+    if (conf->source != SOURCE_RTLSDR) {
+        log_error("Survey needs an RTL-SDR source");
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Planning survey hops");
+    survey_plan = survey_init(conf->survey_start, conf->survey_stop, conf->rtlsdr_device_sample_rate,
+                              conf->survey_size, conf->survey_crop);
+    if (survey_plan == NULL || conf->survey_averages == 0) {
+        log_error("Unable to plan survey");
+        main_survey_end();
+        return EXIT_FAILURE;
+    }
+
+    survey_read_len = (int) (conf->survey_size * conf->survey_averages * 2);
+    survey_read_len = (survey_read_len + MAIN_SURVEY_USB_BLOCK_SIZE - 1)
+                      / MAIN_SURVEY_USB_BLOCK_SIZE * MAIN_SURVEY_USB_BLOCK_SIZE;
+
+    survey_settle_len = (int) ((uint64_t) conf->rtlsdr_settle * conf->rtlsdr_device_sample_rate / 1000 * 2);
+    survey_settle_len = (survey_settle_len + MAIN_SURVEY_USB_BLOCK_SIZE - 1)
+                        / MAIN_SURVEY_USB_BLOCK_SIZE * MAIN_SURVEY_USB_BLOCK_SIZE;
+
+    log_debug("Allocating survey slots");
+    for (tail = 0; tail < MAIN_SURVEY_SLOTS; tail++) {
+        survey_slots[tail].iq = (uint8_t *) calloc((size_t) survey_read_len, sizeof(uint8_t));
+        if (survey_slots[tail].iq == NULL) {
+            log_error("Unable to allocate survey slot");
+            main_survey_end();
+            return EXIT_FAILURE;
+        }
+    }
+
+    log_debug("Allocating survey buffers");
+    survey_samples = (FP_FLOAT complex *) calloc((size_t) survey_read_len / 2, sizeof(FP_FLOAT complex));
+    survey_levels = (FP_FLOAT *) calloc(conf->survey_size, sizeof(FP_FLOAT));
+    if (survey_samples == NULL || survey_levels == NULL) {
+        log_error("Unable to allocate survey buffers");
+        main_survey_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Loading FFT wisdom");
+    if (fft_wisdom_init(conf->fft_wisdom_file) != EXIT_SUCCESS) {
+        log_error("Unable to load FFT wisdom");
+        main_survey_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Initializing spectrum context");
+    survey_spectrum = spectrum_init(conf->survey_size, conf->survey_averages, conf->fft_planner);
+    if (survey_spectrum == NULL) {
+        log_error("Unable to initialize spectrum context");
+        main_survey_end();
+        return EXIT_FAILURE;
+    }
+
+    if (conf->iq_correction == FLAG_TRUE) {
+        log_debug("Initializing IQ correction context");
+        survey_iq_ctx = iqcorr_init();
+        if (survey_iq_ctx == NULL) {
+            log_error("Unable to allocate IQ correction context");
+            main_survey_end();
+            return EXIT_FAILURE;
+        }
+    }
+
+    log_debug("Opening survey output");
+    if (strcmp(conf->survey_output, "-") == 0)
+        survey_file = stdout;
+    else
+        survey_file = fopen(conf->survey_output, conf->survey_format == SURVEY_FORMAT_BINARY ? "wb" : "w");
+
+    if (survey_file == NULL) {
+        log_error("Unable to open survey output %s", conf->survey_output);
+        main_survey_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Opening RTL-SDR device");
+    if (device_open(&survey_device, conf->rtlsdr_device_id) != EXIT_SUCCESS) {
+        log_error("Unable to open RTL-SDR device");
+        main_survey_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Setting RTL-SDR device params");
+    if (device_set_params(survey_device, conf->rtlsdr_device_sample_rate, conf->rtlsdr_device_freq_correction,
+                          conf->rtlsdr_device_tuner_gain_mode, conf->rtlsdr_device_tuner_gain,
+                          conf->rtlsdr_device_agc_mode) != EXIT_SUCCESS) {
+        log_error("Unable to set RTL-SDR device params");
+        main_survey_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Initializing mutex");
+    pthread_mutex_init(&survey_slots_mutex, NULL);
+    pthread_cond_init(&survey_slots_cond, NULL);
+    survey_read_done = 0;
+
+    log_debug("Starting survey read thread");
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+    pthread_create(&survey_read_thread, &attr, thread_survey_read, NULL);
+
+    result = EXIT_SUCCESS;
+    tail = 0;
+    hop = 0;
+    timespec_get(&sweep_start, TIME_UTC);
+
+    log_debug("Starting survey loop");
+    while (keep_running) {
+        slot = &survey_slots[tail];
+
+        pthread_mutex_lock(&survey_slots_mutex);
+        while (keep_running && !slot->full && !survey_read_done)
+            main_survey_wait(MAIN_SURVEY_WAIT_MS);
+        pthread_mutex_unlock(&survey_slots_mutex);
+
+        if (!slot->full)
+            break;
+
+        log_trace("Computing hop at %u Hz", slot->frequency);
+        device_buffer_to_samples(slot->iq, survey_samples, (size_t) survey_read_len);
+
+        if (survey_iq_ctx != NULL)
+            iqcorr_do(survey_iq_ctx, survey_samples, conf->survey_size * conf->survey_averages);
+
+        for (a = 0; a < conf->survey_averages && result == EXIT_SUCCESS; a++)
+            result = spectrum_add(survey_spectrum, survey_samples + a * conf->survey_size);
+
+        if (result == EXIT_SUCCESS)
+            result = spectrum_levels(survey_spectrum, survey_levels);
+
+        if (result == EXIT_SUCCESS)
+            result = survey_write(survey_plan, conf->survey_format, survey_file, &slot->ts, slot->frequency,
+                                  conf->survey_size * conf->survey_averages, survey_levels);
+
+        pthread_mutex_lock(&survey_slots_mutex);
+        slot->full = 0;
+        pthread_mutex_unlock(&survey_slots_mutex);
+        pthread_cond_broadcast(&survey_slots_cond);
+
+        if (result != EXIT_SUCCESS) {
+            log_error("Unable to compute survey hop");
+            break;
+        }
+
+        tail = (tail + 1) % MAIN_SURVEY_SLOTS;
+        hop++;
+
+        if (hop == survey_plan->hops) {
+            fflush(survey_file);
+
+            timespec_get(&now, TIME_UTC);
+            utils_timespec_sub(&sweep_start, &now, &elapsed);
+            log_info("Sweep of %zu hops in %ld.%03ld s", hop, (long) elapsed.tv_sec, elapsed.tv_nsec / 1000000);
+
+            hop = 0;
+            sweep_start = now;
+        }
+    }
+
+    main_stop();
+
+    log_debug("Joining survey read thread");
+    pthread_join(survey_read_thread, (void **) &thread_result);
+    if (thread_result != EXIT_SUCCESS) {
+        log_error("Survey read thread exit without success");
+        result = EXIT_FAILURE;
+    }
+
+    pthread_mutex_destroy(&survey_slots_mutex);
+    pthread_cond_destroy(&survey_slots_cond);
+
+    main_survey_end();
+
+    return result;
+}
+
+void main_survey_end() {
+    size_t s;
+
+    log_info("Main program survey mode ending");
+
+    if (survey_device != NULL) {
+        log_debug("Closing RTL-SDR device");
+        device_close(survey_device);
+        survey_device = NULL;
+    }
+
+    if (survey_file != NULL && survey_file != stdout) {
+        log_debug("Closing survey output");
+        fclose(survey_file);
+    }
+    survey_file = NULL;
+
+    log_debug("Freeing survey buffers");
+    iqcorr_free(survey_iq_ctx);
+    survey_iq_ctx = NULL;
+
+    spectrum_free(survey_spectrum);
+    survey_spectrum = NULL;
+
+    free(survey_samples);
+    survey_samples = NULL;
+
+    free(survey_levels);
+    survey_levels = NULL;
+
+    log_debug("Freeing survey slots");
+    for (s = 0; s < MAIN_SURVEY_SLOTS; s++) {
+        free(survey_slots[s].iq);
+        survey_slots[s].iq = NULL;
+    }
+
+    survey_free(survey_plan);
+    survey_plan = NULL;
+
+    log_debug("Stopping FFT re-plan worker");
+    fft_replan_stop();
+
+    log_debug("Saving FFT wisdom");
+    fft_wisdom_save();
+    fft_wisdom_free();
+}
+
+void *thread_survey_read() {
+    int retval;
+    int result;
+    int bytes;
+
+    uint8_t *settle_buffer;
+    main_survey_slot *slot;
+    uint32_t frequency;
+    uint32_t loop;
+    size_t head;
+    size_t hop;
+
+    prctl(PR_SET_NAME, "survey");
+    log_info("Thread start");
+
+    retval = EXIT_SUCCESS;
+    head = 0;
+
+    settle_buffer = (uint8_t *) calloc(survey_settle_len > 0 ? (size_t) survey_settle_len : 1, sizeof(uint8_t));
+    if (settle_buffer == NULL) {
+        log_error("Unable to allocate settle buffer");
+        retval = EXIT_FAILURE;
+    }
+
+    for (loop = 0; retval == EXIT_SUCCESS && keep_running
+                   && (conf->survey_loops == 0 || loop < conf->survey_loops); loop++) {
+        for (hop = 0; hop < survey_plan->hops && keep_running; hop++) {
+            frequency = survey_hop_frequency(survey_plan, hop);
+
+            log_trace("Tuning hop %zu to %u Hz", hop, frequency);
+            if (device_set_frequency(survey_device, frequency) != EXIT_SUCCESS) {
+                log_error("Unable to tune RTL-SDR device");
+                retval = EXIT_FAILURE;
+                break;
+            }
+
+            if (survey_settle_len > 0) {
+                result = rtlsdr_read_sync(survey_device, (void *) settle_buffer, survey_settle_len, &bytes);
+                if (result != 0) {
+                    log_error("Error %d discarding settling data from RTL-SDR device", result);
+                    retval = EXIT_FAILURE;
+                    break;
+                }
+            }
+
+            slot = &survey_slots[head];
+
+            pthread_mutex_lock(&survey_slots_mutex);
+            while (keep_running && slot->full)
+                main_survey_wait(MAIN_SURVEY_WAIT_MS);
+            pthread_mutex_unlock(&survey_slots_mutex);
+
+            if (!keep_running)
+                break;
+
+            timespec_get(&slot->ts, TIME_UTC);
+            slot->frequency = frequency;
+
+            result = rtlsdr_read_sync(survey_device, (void *) slot->iq, survey_read_len, &bytes);
+            if (result != 0 || bytes != survey_read_len) {
+                log_error("Error %d reading data from RTL-SDR device", result);
+                retval = EXIT_FAILURE;
+                break;
+            }
+
+            pthread_mutex_lock(&survey_slots_mutex);
+            slot->full = 1;
+            pthread_mutex_unlock(&survey_slots_mutex);
+            pthread_cond_broadcast(&survey_slots_cond);
+
+            head = (head + 1) % MAIN_SURVEY_SLOTS;
+        }
+    }
+
+    free(settle_buffer);
+
+    pthread_mutex_lock(&survey_slots_mutex);
+    survey_read_done = 1;
+    pthread_mutex_unlock(&survey_slots_mutex);
+    pthread_cond_broadcast(&survey_slots_cond);
+
+    log_info("Thread end: %d", retval);
+
+    pthread_exit(&retval);
+}
+
+static void main_survey_wait(int ms) {
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += (long) ms * 1000000L;
+    while (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_nsec -= 1000000000L;
+        deadline.tv_sec++;
+    }
+
+    pthread_cond_timedwait(&survey_slots_cond, &survey_slots_mutex, &deadline);
+}
@@ -0,0 +1,54 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__MAIN_SURVEY__H
+#define __RTLSDR_RADIO__MAIN_SURVEY__H
+
+#include <stdint.h>
+#include <time.h>
+
+#define MAIN_SURVEY_SLOTS 2
+#define MAIN_SURVEY_USB_BLOCK_SIZE 512
+#define MAIN_SURVEY_WAIT_MS 100
+
+/*
+ * Survey hops are read into MAIN_SURVEY_SLOTS slots by the read thread,
+ * which retunes to the next hop as soon as a read completes, so that the
+ * tuner settles and the next USB read runs while the main thread computes
+ * the FFT of the previous hop.
+ */
+
+struct main_survey_slot_t {
+    uint8_t *iq;
+
+    uint32_t frequency;
+    struct timespec ts;
+
+    int full;
+};
+
+typedef struct main_survey_slot_t main_survey_slot;
+
+int main_survey();
+
+void main_survey_end();
+
+void *thread_survey_read();
+
+#endif
@@ -0,0 +1,479 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include "main_vote.h"
+#include "main.h"
+#include "cfg.h"
+#include "log.h"
+#include "codec.h"
+#include "network.h"
+#include "vote.h"
+
+extern volatile int keep_running;
+extern cfg *conf;
+
+vote_ctx *vote;
+network_ctx *vote_network;
+network_ctx *vote_output;
+network_batch *vote_batch;
+main_vote_source *vote_sources;
+
+payload *vote_payload;
+payload_v2_state vote_output_state;
+uint8_t *vote_output_buffer;
+
+size_t vote_codec_pcm_size;
+size_t vote_codec_data_size;
+
+int vote_epoll_fd;
+int vote_timer_fd;
+
+static int main_vote_lookup(const struct sockaddr_storage *, socklen_t);
+
+static void main_vote_packet(size_t, const uint8_t *, size_t, uint64_t);
+
+static void main_vote_put(size_t, payload *, uint64_t, uint64_t, uint64_t);
+
+static int main_vote_emit(vote_result *);
+
+static uint64_t main_vote_now();
+
+int main_vote() {
+    int result;
+    codec_ctx *codec;
+    struct epoll_event event;
+    struct epoll_event events[2];
+    struct itimerspec tick;
+    uint64_t expirations;
+    uint64_t now;
+    uint64_t stats;
+    vote_result selection;
+    vote_status status;
+    int received;
+    int source;
+    int n;
+    int e;
+    size_t r;
+
+    log_info("Main program vote mode");
+
+    vote = NULL;
+    vote_network = NULL;
+    vote_output = NULL;
+    vote_batch = NULL;
+    vote_sources = NULL;
+    vote_payload = NULL;
+    vote_output_buffer = NULL;
+    vote_epoll_fd = -1;
+    vote_timer_fd = -1;
+
+    memset(&vote_output_state, 0, sizeof(vote_output_state));
+
+    if (conf->network_port == conf->vote_port) {
+        log_error("network_port must differ from vote_port");
+        return EXIT_FAILURE;
+    }
+
+    if (conf->network_protocol != 1 && conf->network_protocol != 2) {
+        log_error("Network protocol must be 1 or 2");
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Reading codec frame sizes");
+    codec = codec_init(conf->codec2_mode);
+    if (codec == NULL) {
+        log_error("Unable to allocate codec context");
+        return EXIT_FAILURE;
+    }
+
+    vote_codec_pcm_size = codec_get_pcm_size(codec);
+    vote_codec_data_size = codec_get_data_size(codec);
+    codec_free(codec);
+
+    log_debug("Initializing voting combiner");
+    vote = vote_init(conf->vote_receivers, MAIN_VOTE_SLOTS, conf->vote_window);
+    vote_sources = (main_vote_source *) calloc(conf->vote_receivers, sizeof(main_vote_source));
+    vote_payload = payload_init();
+    vote_output_buffer = (uint8_t *) calloc(MAIN_VOTE_BUFFER_SIZE, sizeof(uint8_t));
+    vote_batch = network_batch_init(MAIN_VOTE_BATCH, MAIN_VOTE_BUFFER_SIZE);
+    if (vote == NULL || vote_sources == NULL || vote_payload == NULL || vote_output_buffer == NULL
+        || vote_batch == NULL) {
+        log_error("Unable to allocate voting buffers");
+        main_vote_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Binding network socket");
+    vote_network = network_init(conf->vote_address, conf->vote_port);
+    if (vote_network == NULL || network_socket_bind(vote_network, MAIN_VOTE_SOCKET_BUFFER) != EXIT_SUCCESS) {
+        log_error("Unable to bind network socket");
+        main_vote_end();
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Opening output socket");
+    vote_output = network_init(conf->network_server, conf->network_port);
+    if (vote_output == NULL
+        || network_set_multicast(vote_output, (int) conf->network_multicast_ttl,
+                                 conf->network_multicast_interface) != EXIT_SUCCESS
+        || network_socket_open(vote_output) != EXIT_SUCCESS) {
+        log_error("Unable to open output socket");
+        main_vote_end();
+        return EXIT_FAILURE;
+    }
+
+    for (r = 0; r < conf->network_destinations_count; r++) {
+        if (network_destination_add(vote_output, conf->network_destinations[r],
+                                    conf->network_destinations_ports[r] > 0
+                                    ? conf->network_destinations_ports[r] : conf->network_port) != EXIT_SUCCESS) {
+            log_error("Unable to add output destination");
+            main_vote_end();
+            return EXIT_FAILURE;
+        }
+    }
+
+    log_debug("Creating decision timer");
+    vote_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (vote_timer_fd == -1) {
+        log_error("Unable to create decision timer");
+        main_vote_end();
+        return EXIT_FAILURE;
+    }
+
+    tick.it_interval.tv_sec = 0;
+    tick.it_interval.tv_nsec = MAIN_VOTE_TICK_MS * 1000000L;
+    tick.it_value = tick.it_interval;
+    timerfd_settime(vote_timer_fd, 0, &tick, NULL);
+
+    log_debug("Creating epoll instance");
+    vote_epoll_fd = epoll_create1(0);
+    if (vote_epoll_fd == -1) {
+        log_error("Unable to create epoll instance");
+        main_vote_end();
+        return EXIT_FAILURE;
+    }
+
+    event.events = EPOLLIN;
+    event.data.fd = vote_network->sck;
+    e = epoll_ctl(vote_epoll_fd, EPOLL_CTL_ADD, vote_network->sck, &event);
+
+    event.events = EPOLLIN;
+    event.data.fd = vote_timer_fd;
+    if (e != 0 || epoll_ctl(vote_epoll_fd, EPOLL_CTL_ADD, vote_timer_fd, &event) != 0) {
+        log_error("Unable to register epoll events");
+        main_vote_end();
+        return EXIT_FAILURE;
+    }
+
+    result = EXIT_SUCCESS;
+    stats = main_vote_now() + MAIN_VOTE_STATS_MS;
+
+    log_debug("Starting vote loop");
+    while (keep_running && result == EXIT_SUCCESS) {
+        n = epoll_wait(vote_epoll_fd, events, 2, MAIN_VOTE_WAIT_MS);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+
+            log_error("Error waiting for events");
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        for (e = 0; e < n; e++) {
+            if (events[e].data.fd == vote_network->sck) {
+                do {
+                    received = network_socket_receive_batch(vote_network, vote_batch);
+                    if (received == -1) {
+                        result = EXIT_FAILURE;
+                        break;
+                    }
+
+                    now = main_vote_now();
+
+                    for (r = 0; r < vote_batch->count; r++) {
+                        source = main_vote_lookup(&vote_batch->addresses[r],
+                                                  vote_batch->messages[r].msg_hdr.msg_namelen);
+                        if (source == -1)
+                            continue;
+
+                        main_vote_packet((size_t) source, vote_batch->headers + r * vote_batch->header_size,
+                                         vote_batch->messages[r].msg_len, now);
+                    }
+                } while (received == MAIN_VOTE_BATCH);
+            } else if (events[e].data.fd == vote_timer_fd) {
+                if (read(vote_timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+                    continue;
+
+                now = main_vote_now();
+
+                do {
+                    status = vote_select(vote, now, &selection);
+                    if (status == VOTE_FRAME && main_vote_emit(&selection) != EXIT_SUCCESS) {
+                        result = EXIT_FAILURE;
+                        break;
+                    }
+                } while (status != VOTE_EMPTY);
+
+                if (now >= stats) {
+                    log_info("Selected %llu - Lost %llu - Late %llu - Latency avg %.1f ms max %llu ms",
+                             (unsigned long long) vote->selected, (unsigned long long) vote->lost,
+                             (unsigned long long) vote->late,
+                             vote->latency_count > 0 ? (double) vote->latency_sum / (double) vote->latency_count : 0,
+                             (unsigned long long) vote->latency_max);
+
+                    for (r = 0; r < vote->receivers_size; r++)
+                        if (vote->receivers[r].used)
+                            log_debug("Receiver %u - Received %llu - Selected %llu - Late %llu",
+                                      vote->receivers[r].id, (unsigned long long) vote->receivers[r].received,
+                                      (unsigned long long) vote->receivers[r].selected,
+                                      (unsigned long long) vote->receivers[r].late);
+
+                    vote->latency_sum = 0;
+                    vote->latency_count = 0;
+                    vote->latency_max = 0;
+
+                    stats = now + MAIN_VOTE_STATS_MS;
+                }
+            }
+        }
+    }
+
+    main_stop();
+
+    main_vote_end();
+
+    return result;
+}
+
+void main_vote_end() {
+    log_info("Main program vote mode ending");
+
+    if (vote_epoll_fd != -1) {
+        log_debug("Closing epoll instance");
+        close(vote_epoll_fd);
+        vote_epoll_fd = -1;
+    }
+
+    if (vote_timer_fd != -1) {
+        log_debug("Closing decision timer");
+        close(vote_timer_fd);
+        vote_timer_fd = -1;
+    }
+
+    if (vote_network != NULL) {
+        log_debug("Closing network socket");
+        network_socket_close(vote_network);
+        network_free(vote_network);
+        vote_network = NULL;
+    }
+
+    if (vote_output != NULL) {
+        network_print_stats(vote_output);
+
+        log_debug("Closing output socket");
+        network_socket_close(vote_output);
+        network_free(vote_output);
+        vote_output = NULL;
+    }
+
+    log_debug("Freeing voting buffers");
+    network_batch_free(vote_batch);
+    vote_batch = NULL;
+
+    if (vote_payload != NULL)
+        payload_free(vote_payload);
+    vote_payload = NULL;
+
+    free(vote_output_buffer);
+    vote_output_buffer = NULL;
+
+    free(vote_sources);
+    vote_sources = NULL;
+
+    vote_free(vote);
+    vote = NULL;
+}
+
+static int main_vote_lookup(const struct sockaddr_storage *address, socklen_t address_len) {
+    size_t s;
+
+    for (s = 0; s < conf->vote_receivers && vote_sources[s].used; s++)
+        if (vote_sources[s].address_len == address_len && memcmp(&vote_sources[s].address, address, address_len) == 0)
+            return (int) s;
+
+    if (s == conf->vote_receivers) {
+        log_trace("Too many receivers, dropping packet");
+        return -1;
+    }
+
+    log_info("New receiver %zu", s);
+
+    vote_sources[s].used = 1;
+    memcpy(&vote_sources[s].address, address, address_len);
+    vote_sources[s].address_len = address_len;
+
+    return (int) s;
+}
+
+static void main_vote_packet(size_t source, const uint8_t *buffer, size_t buffer_size, uint64_t arrival) {
+    payload *p;
+    payload_v2_state *state;
+    uint32_t channel;
+    uint32_t frames;
+    uint64_t timestamp;
+    uint64_t first;
+    const uint8_t *cursor;
+    const uint8_t *end;
+
+    p = vote_payload;
+    state = &vote_sources[source].state;
+    end = buffer + buffer_size;
+
+    switch (payload_get_version(buffer, buffer_size)) {
+        case 1:
+            if (memcmp(buffer, PAYLOAD_AGGREGATE_HEADER, strlen(PAYLOAD_AGGREGATE_HEADER)) == 0) {
+                if (payload_aggregate_parse(p, buffer, buffer_size, &frames) != EXIT_SUCCESS
+                    || p->channel != conf->vote_channel)
+                    return;
+
+                vote_sources[source].frequency = p->frequency;
+                timestamp = p->timestamp;
+                cursor = p->data;
+
+                for (first = UINT64_MAX; frames > 0; frames--) {
+                    if (payload_aggregate_parse_frame(p, &cursor, end) != EXIT_SUCCESS)
+                        break;
+
+                    if (first == UINT64_MAX)
+                        first = p->number;
+
+                    main_vote_put(source, p, timestamp, first, arrival);
+                }
+            } else if (memcmp(buffer, PAYLOAD_REPAIR_HEADER, strlen(PAYLOAD_REPAIR_HEADER)) == 0) {
+                log_trace("Ignoring repair payload, losses are covered by the other receivers");
+            } else {
+                if (payload_parse(p, buffer, buffer_size) != EXIT_SUCCESS || p->channel != conf->vote_channel)
+                    return;
+
+                vote_sources[source].frequency = p->frequency;
+                main_vote_put(source, p, p->timestamp, p->number, arrival);
+            }
+
+            return;
+
+        case 2:
+            if (payload_v2_get_channel(buffer, buffer_size, &channel) != EXIT_SUCCESS
+                || channel != conf->vote_channel
+                || payload_v2_parse(p, state, buffer, buffer_size) != EXIT_SUCCESS)
+                return;
+
+            vote_sources[source].frequency = p->frequency;
+
+            if (p->flags & PAYLOAD_V2_FLAG_AGGREGATE) {
+                timestamp = p->timestamp;
+                cursor = p->data;
+
+                for (first = UINT64_MAX; payload_v2_parse_frame(p, state, &cursor, end) == EXIT_SUCCESS;) {
+                    if (first == UINT64_MAX)
+                        first = p->number;
+
+                    main_vote_put(source, p, timestamp, first, arrival);
+                }
+            } else {
+                main_vote_put(source, p, p->timestamp, p->number, arrival);
+            }
+
+            return;
+
+        default:
+            log_trace("Unknown payload of %zu bytes", buffer_size);
+    }
+}
+
+static void main_vote_put(size_t source, payload *p, uint64_t timestamp, uint64_t first, uint64_t arrival) {
+    double frame_ms;
+    size_t frames;
+
+    frames = p->data_size / vote_codec_data_size;
+    if (frames == 0)
+        return;
+
+    frame_ms = (double) (frames * vote_codec_pcm_size) * 1000 / MAIN_VOTE_SAMPLE_RATE;
+    vote_set_frame_ms(vote, frame_ms);
+
+    // Aggregated frames share the timestamp of the first one
+    timestamp += (uint64_t) ((double) (p->number - first) * frame_ms + 0.5);
+
+    vote_put(vote, source, p->receiver, timestamp, arrival, p->rms, p->data, p->data_size);
+}
+
+static int main_vote_emit(vote_result *selection) {
+    payload *p;
+    size_t header_size;
+    int result;
+
+    p = vote_payload;
+
+    payload_set_numbers(p, vote->receivers[selection->receiver].id, selection->key);
+    p->timestamp = selection->timestamp;
+    payload_set_rms(p, selection->rms);
+    payload_set_channel_frequency(p, conf->vote_channel, vote_sources[selection->receiver].frequency);
+    payload_set_codec_flags(p, (uint8_t) conf->codec2_mode, PAYLOAD_V2_FLAG_SQUELCH);
+    payload_set_data_size(p, (uint32_t) selection->size);
+
+    if (conf->network_protocol == 2)
+        result = payload_v2_serialize_header(p, &vote_output_state, vote_output_buffer, MAIN_VOTE_BUFFER_SIZE,
+                                             &header_size);
+    else
+        result = payload_serialize_header(p, vote_output_buffer, MAIN_VOTE_BUFFER_SIZE, &header_size);
+
+    if (result != EXIT_SUCCESS || header_size + selection->size > MAIN_VOTE_BUFFER_SIZE) {
+        log_error("Unable to serialize combined frame");
+        return EXIT_FAILURE;
+    }
+
+    memcpy(vote_output_buffer + header_size, selection->data, selection->size);
+
+    // Errors are counted per destination, a failed send only loses this frame
+    if (network_socket_send(vote_output, vote_output_buffer, header_size + selection->size) != EXIT_SUCCESS) {
+        log_warn("Unable to send combined frame");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static uint64_t main_vote_now() {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+
+    return (uint64_t) ts.tv_sec * 1000 + (uint64_t) ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,64 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__MAIN_VOTE__H
+#define __RTLSDR_RADIO__MAIN_VOTE__H
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include "payload.h"
+
+#define MAIN_VOTE_SAMPLE_RATE 8000
+#define MAIN_VOTE_SOCKET_BUFFER (4 * 1024 * 1024)
+#define MAIN_VOTE_BUFFER_SIZE 8192
+#define MAIN_VOTE_BATCH 32
+#define MAIN_VOTE_SLOTS 64
+#define MAIN_VOTE_TICK_MS 5
+#define MAIN_VOTE_WAIT_MS 200
+#define MAIN_VOTE_STATS_MS 1000
+
+/*
+ * Vote mode receives the payloads of several receivers on one socket and
+ * emits a single stream to network_server/network_port, choosing for every
+ * frame period the receiver with the highest rms (see vote.h).
+ *
+ * Everything runs in one thread around epoll: the socket is drained with
+ * recvmmsg when readable, and a timerfd ticking every MAIN_VOTE_TICK_MS
+ * drives the decisions. Receivers are told apart by source address, which
+ * also keeps a v2 state per receiver.
+ */
+
+struct main_vote_source_t {
+    int used;
+
+    struct sockaddr_storage address;
+    socklen_t address_len;
+
+    uint32_t frequency;
+    payload_v2_state state;
+};
+
+typedef struct main_vote_source_t main_vote_source;
+
+int main_vote();
+
+void main_vote_end();
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <math.h>
+
+#include "nco.h"
+#include "log.h"
+
+nco_ctx *nco_init(uint32_t sample_rate, int32_t offset) {
+    nco_ctx *ctx;
+    double phase;
+    size_t i;
+
+    log_info("Initializing NCO context");
+
+    if (sample_rate == 0) {
+        log_error("Invalid sample rate");
+        return NULL;
+    }
+
+    log_debug("Allocating NCO context");
+    ctx = (nco_ctx *) malloc(sizeof(nco_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate NCO context");
+        return NULL;
+    }
+
+    ctx->sample_rate = sample_rate;
+    ctx->phase = 0;
+
+    log_debug("Allocating phase tables");
+    ctx->table = (FP_FLOAT complex *) calloc(NCO_TABLE_SIZE, sizeof(FP_FLOAT complex));
+    ctx->table_fixed = (fixed_complex *) calloc(NCO_TABLE_SIZE, sizeof(fixed_complex));
+    if (ctx->table == NULL || ctx->table_fixed == NULL) {
+        log_error("Unable to allocate phase tables");
+        nco_free(ctx);
+        return NULL;
+    }
+
+    log_debug("Computing phase tables");
+    for (i = 0; i < NCO_TABLE_SIZE; i++) {
+        phase = 2 * M_PI * (double) i / NCO_TABLE_SIZE;
+        ctx->table[i] = (FP_FLOAT) cos(phase) + (FP_FLOAT) sin(phase) * I;
+        ctx->table_fixed[i].i = fixed_from_float((FP_FLOAT) cos(phase));
+        ctx->table_fixed[i].q = fixed_from_float((FP_FLOAT) sin(phase));
+    }
+
+    nco_set_offset(ctx, offset);
+
+    return ctx;
+}
+
+void nco_free(nco_ctx *ctx) {
+    log_info("Freeing NCO context");
+
+    if (ctx == NULL)
+        return;
+
+    if (ctx->table != NULL)
+        free(ctx->table);
+
+    if (ctx->table_fixed != NULL)
+        free(ctx->table_fixed);
+
+    free(ctx);
+}
+
+void nco_set_offset(nco_ctx *ctx, int32_t offset) {
+    int64_t increment;
+
+    log_debug("Setting NCO offset to %d Hz", offset);
+
+    ctx->offset = offset;
+
+    increment = (int64_t) llround(-(double) offset * 4294967296.0 / (double) ctx->sample_rate);
+    ctx->increment = (uint32_t) increment;
+}
+
+void nco_mix(nco_ctx *ctx, const FP_FLOAT complex *input, size_t size, FP_FLOAT complex *output) {
+    uint32_t phase;
+    size_t i;
+
+    phase = ctx->phase;
+
+    for (i = 0; i < size; i++) {
+        output[i] = input[i] * ctx->table[phase >> (32 - NCO_TABLE_BITS)];
+        phase += ctx->increment;
+    }
+
+    ctx->phase = phase;
+}
+
+void nco_mix_fixed(nco_ctx *ctx, const fixed_complex *input, size_t size, fixed_complex *output) {
+    const fixed_complex *lo;
+    uint32_t phase;
+    int32_t i_acc;
+    int32_t q_acc;
+    size_t i;
+
+    phase = ctx->phase;
+
+    for (i = 0; i < size; i++) {
+        lo = &ctx->table_fixed[phase >> (32 - NCO_TABLE_BITS)];
+
+        i_acc = (int32_t) input[i].i * lo->i - (int32_t) input[i].q * lo->q;
+        q_acc = (int32_t) input[i].i * lo->q + (int32_t) input[i].q * lo->i;
+
+        output[i].i = fixed_saturate((i_acc + FIXED_Q15_HALF) >> FIXED_Q15_SHIFT);
+        output[i].q = fixed_saturate((q_acc + FIXED_Q15_HALF) >> FIXED_Q15_SHIFT);
+
+        phase += ctx->increment;
+    }
+
+    ctx->phase = phase;
+}
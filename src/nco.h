@@ -0,0 +1,65 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__NCO__H
+#define __RTLSDR_RADIO__NCO__H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <complex.h>
+
+#include "buildflags.h"
+#include "fixed.h"
+
+/*
+ * Numerically controlled oscillator used to move a channel, sitting at some
+ * offset from the tuned center frequency, down to baseband.
+ *
+ * The phase is a 32 bit accumulator wrapping once per cycle; its top
+ * NCO_TABLE_BITS bits index a precomputed table of unit phasors, so mixing
+ * costs one complex multiply per sample.
+ */
+
+#define NCO_TABLE_BITS 12
+#define NCO_TABLE_SIZE (1 << NCO_TABLE_BITS)
+
+struct nco_ctx_t {
+    uint32_t sample_rate;
+    int32_t offset;
+
+    uint32_t phase;
+    uint32_t increment;
+
+    FP_FLOAT complex *table;
+    fixed_complex *table_fixed;
+};
+
+typedef struct nco_ctx_t nco_ctx;
+
+nco_ctx *nco_init(uint32_t, int32_t);
+
+void nco_free(nco_ctx *);
+
+void nco_set_offset(nco_ctx *, int32_t);
+
+void nco_mix(nco_ctx *, const FP_FLOAT complex *, size_t, FP_FLOAT complex *);
+
+void nco_mix_fixed(nco_ctx *, const fixed_complex *, size_t, fixed_complex *);
+
+#endif
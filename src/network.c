@@ -17,15 +17,29 @@
  */
 
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <malloc.h>
 #include <unistd.h>
+#include <errno.h>
+#include <sys/un.h>
+#include <net/if.h>
+#include <netinet/in.h>
 
 #include "network.h"
 #include "log.h"
 
+static int network_resolve(const char *, uint16_t, int *, struct sockaddr_storage *, socklen_t *);
+
+static int network_resolve_unix(const char *, int *, struct sockaddr_storage *, socklen_t *);
+
+static void network_multicast_setup(network_ctx *, int, struct sockaddr_storage *);
+
+static int network_destination_append(network_ctx *, int, struct sockaddr_storage *, socklen_t);
+
 network_ctx *network_init(const char *address, uint16_t port) {
     network_ctx *ctx;
     size_t ln;
@@ -50,34 +64,129 @@ network_ctx *network_init(const char *address, uint16_t port) {
     log_debug("Initializing socket descriptor");
     ctx->sck = -1;
 
+    ctx->multicast_ttl = NETWORK_MULTICAST_TTL_DEFAULT;
+    ctx->multicast_interface = NULL;
+
+    ctx->destinations_count = 0;
+    ctx->destinations = NULL;
+
     return ctx;
 }
 
 void network_free(network_ctx *ctx) {
     log_info("Freeing");
 
+    if (ctx == NULL)
+        return;
+
     log_debug("Deallocating address");
-    if (ctx->address != NULL)
-        free(ctx->address);
+    free(ctx->address);
+
+    free(ctx->multicast_interface);
+    free(ctx->destinations);
 
     log_debug("Deallocating context");
-    if (ctx != NULL)
-        free(ctx);
+    free(ctx);
+}
+
+int network_set_multicast(network_ctx *ctx, int ttl, const char *interface) {
+    log_info("Setting multicast options");
+
+    free(ctx->multicast_interface);
+    ctx->multicast_interface = NULL;
+
+    ctx->multicast_ttl = ttl;
+
+    if (interface != NULL && strlen(interface) > 0) {
+        if (if_nametoindex(interface) == 0) {
+            log_error("Unknown network interface: %s", interface);
+            return EXIT_FAILURE;
+        }
+
+        ctx->multicast_interface = strdup(interface);
+    }
+
+    return EXIT_SUCCESS;
 }
 
 int network_socket_open(network_ctx *ctx) {
+    log_info("Opening socket");
+
+    if (ctx->address[0] == '/')
+        return network_socket_open_unix(ctx);
+
+    if (network_resolve(ctx->address, ctx->port, &ctx->sck, &ctx->sockaddr, &ctx->sockaddr_len) != EXIT_SUCCESS) {
+        log_error("Socket creation failed");
+        return EXIT_FAILURE;
+    }
+
+    network_multicast_setup(ctx, ctx->sck, &ctx->sockaddr);
+
+    return network_destination_append(ctx, ctx->sck, &ctx->sockaddr, ctx->sockaddr_len);
+}
+
+int network_socket_open_unix(network_ctx *ctx) {
+    log_info("Opening UNIX socket");
+
+    if (network_resolve_unix(ctx->address, &ctx->sck, &ctx->sockaddr, &ctx->sockaddr_len) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    return network_destination_append(ctx, ctx->sck, &ctx->sockaddr, ctx->sockaddr_len);
+}
+
+int network_destination_add(network_ctx *ctx, const char *address, uint16_t port) {
+    struct sockaddr_storage sockaddr;
+    socklen_t sockaddr_len;
+    int sck;
+    int result;
+
+    log_info("Adding destination %s:%u", address, port);
+
+    if (address[0] == '/')
+        result = network_resolve_unix(address, &sck, &sockaddr, &sockaddr_len);
+    else
+        result = network_resolve(address, port, &sck, &sockaddr, &sockaddr_len);
+
+    if (result != EXIT_SUCCESS) {
+        log_error("Unable to open destination %s", address);
+        return EXIT_FAILURE;
+    }
+
+    network_multicast_setup(ctx, sck, &sockaddr);
+
+    if (network_destination_append(ctx, sck, &sockaddr, sockaddr_len) != EXIT_SUCCESS) {
+        close(sck);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void network_print_stats(network_ctx *ctx) {
+    size_t d;
+
+    for (d = 0; d < ctx->destinations_count; d++)
+        log_info("Destination %zu - Sent %llu - Dropped %llu - Errors %llu", d,
+                 (unsigned long long) ctx->destinations[d].sent,
+                 (unsigned long long) ctx->destinations[d].dropped,
+                 (unsigned long long) ctx->destinations[d].errors);
+}
+
+int network_socket_bind(network_ctx *ctx, int receive_buffer) {
     int result;
     char port[6];
     struct addrinfo hints;
     struct addrinfo *addresses_list;
     struct addrinfo *address;
+    struct timeval timeout;
 
-    log_info("Opening socket");
+    log_info("Binding socket");
 
     log_debug("Preparing socket hints");
     memset(&hints, '\0', sizeof(hints));
     hints.ai_family = AF_UNSPEC;
     hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE;
 
     log_debug("Resolving address");
     sprintf(port, "%u", ctx->port);
@@ -95,17 +204,35 @@ int network_socket_open(network_ctx *ctx) {
             continue;
         }
 
-        memcpy(&ctx->sockaddr, address->ai_addr, sizeof(struct sockaddr));
-        ctx->sockaddr_len = address->ai_addrlen;
+        if (bind(ctx->sck, address->ai_addr, address->ai_addrlen) == 0) {
+            memcpy(&ctx->sockaddr, address->ai_addr, address->ai_addrlen);
+            ctx->sockaddr_len = address->ai_addrlen;
+            break;
+        }
 
-        break;
+        log_warn("Socket bind failed");
+        network_socket_close(ctx);
     }
 
     log_debug("Freeing Address Infos list");
     freeaddrinfo(addresses_list);
 
     if (address == NULL) {
-        log_error("Socket creation failed");
+        log_error("Socket bind failed");
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Setting receive buffer");
+    if (setsockopt(ctx->sck, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer)) != 0) {
+        log_warn("Unable to set receive buffer");
+    }
+
+    log_debug("Setting receive timeout");
+    timeout.tv_sec = 0;
+    timeout.tv_usec = NETWORK_RECEIVE_TIMEOUT_MS * 1000;
+    if (setsockopt(ctx->sck, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) {
+        log_error("Unable to set receive timeout");
+        network_socket_close(ctx);
         return EXIT_FAILURE;
     }
 
@@ -113,6 +240,18 @@ int network_socket_open(network_ctx *ctx) {
 }
 
 void network_socket_close(network_ctx *ctx) {
+    size_t d;
+
+    for (d = 0; d < ctx->destinations_count; d++)
+        if (ctx->destinations[d].sck != ctx->sck) {
+            log_debug("Closing destination socket");
+            close(ctx->destinations[d].sck);
+        }
+
+    free(ctx->destinations);
+    ctx->destinations = NULL;
+    ctx->destinations_count = 0;
+
     if (ctx->sck != -1) {
         log_debug("Closing socket");
         close(ctx->sck);
@@ -122,14 +261,346 @@ void network_socket_close(network_ctx *ctx) {
 }
 
 int network_socket_send(network_ctx *ctx, uint8_t *data, size_t data_size) {
+    network_destination *destination;
     ssize_t sent_bytes;
+    size_t failed;
+    size_t d;
 
-    sent_bytes = sendto(ctx->sck, (void *) data, data_size, 0, &ctx->sockaddr, ctx->sockaddr_len);
+    if (ctx->destinations_count == 0) {
+        sent_bytes = sendto(ctx->sck, (void *) data, data_size, 0, (struct sockaddr *) &ctx->sockaddr,
+                            ctx->sockaddr_len);
 
-    if (sent_bytes != (ssize_t) data_size) {
+        if (sent_bytes != (ssize_t) data_size) {
+            log_error("Unable to sent all data to server");
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    failed = 0;
+
+    for (d = 0; d < ctx->destinations_count; d++) {
+        destination = &ctx->destinations[d];
+
+        sent_bytes = sendto(destination->sck, (void *) data, data_size, MSG_DONTWAIT,
+                            (struct sockaddr *) &destination->sockaddr, destination->sockaddr_len);
+
+        if (sent_bytes == (ssize_t) data_size) {
+            destination->sent++;
+        } else if (sent_bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            destination->dropped++;
+        } else {
+            log_debug("Unable to send data to destination %zu", d);
+            destination->errors++;
+            failed++;
+        }
+    }
+
+    if (failed == ctx->destinations_count) {
         log_error("Unable to sent all data to server");
         return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;
 }
+
+int network_socket_send_batch(network_ctx *ctx, network_batch *batch) {
+    network_destination *destination;
+    size_t d;
+    size_t i;
+    size_t j;
+    size_t expected;
+    size_t failed;
+    int sent;
+
+    failed = 0;
+
+    for (d = 0; d < ctx->destinations_count; d++) {
+        destination = &ctx->destinations[d];
+
+        for (i = 0; i < batch->count; i++) {
+            batch->messages[i].msg_hdr.msg_name = &destination->sockaddr;
+            batch->messages[i].msg_hdr.msg_namelen = destination->sockaddr_len;
+        }
+
+        for (i = 0; i < batch->count; i += (size_t) sent) {
+            sent = sendmmsg(destination->sck, batch->messages + i, (unsigned int) (batch->count - i), MSG_DONTWAIT);
+            if (sent <= 0) {
+                if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    destination->dropped += batch->count - i;
+                } else {
+                    log_debug("Unable to send batch to destination %zu", d);
+                    destination->errors++;
+                    failed++;
+                }
+
+                break;
+            }
+
+            for (j = i; j < i + (size_t) sent; j++) {
+                expected = batch->iovecs[j * NETWORK_BATCH_IOVECS].iov_len
+                           + batch->iovecs[j * NETWORK_BATCH_IOVECS + 1].iov_len;
+                if (batch->messages[j].msg_len == expected)
+                    destination->sent++;
+                else
+                    destination->errors++;
+            }
+        }
+    }
+
+    batch->count = 0;
+
+    if (ctx->destinations_count > 0 && failed == ctx->destinations_count) {
+        log_error("Unable to send batch to server");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+ssize_t network_socket_receive(network_ctx *ctx, uint8_t *data, size_t data_size) {
+    ssize_t received_bytes;
+
+    received_bytes = recv(ctx->sck, (void *) data, data_size, 0);
+
+    if (received_bytes == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+
+        log_error("Unable to receive data");
+        return -1;
+    }
+
+    return received_bytes;
+}
+
+int network_socket_receive_batch(network_ctx *ctx, network_batch *batch) {
+    size_t i;
+    int received;
+
+    for (i = 0; i < batch->size; i++) {
+        batch->iovecs[i * NETWORK_BATCH_IOVECS].iov_len = batch->header_size;
+        batch->iovecs[i * NETWORK_BATCH_IOVECS + 1].iov_base = NULL;
+        batch->iovecs[i * NETWORK_BATCH_IOVECS + 1].iov_len = 0;
+
+        batch->messages[i].msg_hdr.msg_name = &batch->addresses[i];
+        batch->messages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+    }
+
+    batch->count = 0;
+
+    received = recvmmsg(ctx->sck, batch->messages, (unsigned int) batch->size, MSG_DONTWAIT, NULL);
+    if (received == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+
+        log_error("Unable to receive batch");
+        return -1;
+    }
+
+    batch->count = (size_t) received;
+
+    return received;
+}
+
+network_batch *network_batch_init(size_t size, size_t header_size) {
+    network_batch *batch;
+    size_t i;
+
+    log_info("Initializing batch");
+
+    log_debug("Allocating batch");
+    batch = (network_batch *) calloc(1, sizeof(network_batch));
+    if (batch == NULL) {
+        log_error("Unable to allocate batch");
+        return NULL;
+    }
+
+    batch->size = size;
+    batch->count = 0;
+    batch->header_size = header_size;
+
+    log_debug("Allocating batch buffers");
+    batch->headers = (uint8_t *) calloc(size * header_size, sizeof(uint8_t));
+    batch->iovecs = (struct iovec *) calloc(size * NETWORK_BATCH_IOVECS, sizeof(struct iovec));
+    batch->messages = (struct mmsghdr *) calloc(size, sizeof(struct mmsghdr));
+    batch->addresses = (struct sockaddr_storage *) calloc(size, sizeof(struct sockaddr_storage));
+    if (batch->headers == NULL || batch->iovecs == NULL || batch->messages == NULL || batch->addresses == NULL) {
+        log_error("Unable to allocate batch buffers");
+        network_batch_free(batch);
+        return NULL;
+    }
+
+    for (i = 0; i < size; i++) {
+        batch->iovecs[i * NETWORK_BATCH_IOVECS].iov_base = batch->headers + i * header_size;
+        batch->messages[i].msg_hdr.msg_iov = batch->iovecs + i * NETWORK_BATCH_IOVECS;
+        batch->messages[i].msg_hdr.msg_iovlen = NETWORK_BATCH_IOVECS;
+    }
+
+    return batch;
+}
+
+void network_batch_free(network_batch *batch) {
+    log_info("Freeing batch");
+
+    if (batch == NULL)
+        return;
+
+    free(batch->addresses);
+    free(batch->messages);
+    free(batch->iovecs);
+    free(batch->headers);
+
+    free(batch);
+}
+
+uint8_t *network_batch_header(network_batch *batch) {
+    if (batch->count == batch->size)
+        return NULL;
+
+    return batch->headers + batch->count * batch->header_size;
+}
+
+int network_batch_add(network_batch *batch, size_t header_size, uint8_t *data, size_t data_size) {
+    struct iovec *iovecs;
+
+    if (batch->count == batch->size || header_size > batch->header_size) {
+        log_error("No space left in batch");
+        return EXIT_FAILURE;
+    }
+
+    iovecs = batch->iovecs + batch->count * NETWORK_BATCH_IOVECS;
+    iovecs[0].iov_len = header_size;
+    iovecs[1].iov_base = data;
+    iovecs[1].iov_len = data_size;
+
+    batch->count++;
+
+    return EXIT_SUCCESS;
+}
+
+static int network_resolve(const char *address, uint16_t port, int *sck, struct sockaddr_storage *sockaddr,
+                           socklen_t *sockaddr_len) {
+    int result;
+    char service[6];
+    struct addrinfo hints;
+    struct addrinfo *addresses_list;
+    struct addrinfo *item;
+
+    log_debug("Preparing socket hints");
+    memset(&hints, '\0', sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    log_debug("Resolving address");
+    sprintf(service, "%u", port);
+    result = getaddrinfo(address, service, &hints, &addresses_list);
+    if (result != 0) {
+        log_error("Error %d in getaddrinfo: %s", result, gai_strerror(result));
+        return EXIT_FAILURE;
+    }
+
+    for (item = addresses_list; item != NULL; item = item->ai_next) {
+        log_debug("Creating socket");
+        *sck = socket(item->ai_family, item->ai_socktype, item->ai_protocol);
+        if (*sck == -1) {
+            log_warn("Socket creation failed");
+            continue;
+        }
+
+        memcpy(sockaddr, item->ai_addr, item->ai_addrlen);
+        *sockaddr_len = item->ai_addrlen;
+
+        break;
+    }
+
+    log_debug("Freeing Address Infos list");
+    freeaddrinfo(addresses_list);
+
+    return item != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int network_resolve_unix(const char *address, int *sck, struct sockaddr_storage *sockaddr,
+                                socklen_t *sockaddr_len) {
+    struct sockaddr_un *sockaddr_un;
+
+    if (strlen(address) >= sizeof(sockaddr_un->sun_path)) {
+        log_error("UNIX socket path too long");
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Creating socket");
+    *sck = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (*sck == -1) {
+        log_error("Socket creation failed");
+        return EXIT_FAILURE;
+    }
+
+    log_debug("Preparing socket address");
+    memset(sockaddr, '\0', sizeof(struct sockaddr_storage));
+    sockaddr_un = (struct sockaddr_un *) sockaddr;
+    sockaddr_un->sun_family = AF_UNIX;
+    strcpy(sockaddr_un->sun_path, address);
+    *sockaddr_len = sizeof(struct sockaddr_un);
+
+    return EXIT_SUCCESS;
+}
+
+static void network_multicast_setup(network_ctx *ctx, int sck, struct sockaddr_storage *sockaddr) {
+    struct ip_mreqn mreqn;
+    int index;
+
+    index = ctx->multicast_interface != NULL ? (int) if_nametoindex(ctx->multicast_interface) : 0;
+
+    if (sockaddr->ss_family == AF_INET
+        && IN_MULTICAST(ntohl(((struct sockaddr_in *) sockaddr)->sin_addr.s_addr))) {
+        log_debug("Setting IPv4 multicast TTL %d", ctx->multicast_ttl);
+        if (setsockopt(sck, IPPROTO_IP, IP_MULTICAST_TTL, &ctx->multicast_ttl, sizeof(int)) != 0) {
+            log_warn("Unable to set multicast TTL");
+        }
+
+        if (index > 0) {
+            memset(&mreqn, 0, sizeof(mreqn));
+            mreqn.imr_ifindex = index;
+            if (setsockopt(sck, IPPROTO_IP, IP_MULTICAST_IF, &mreqn, sizeof(mreqn)) != 0) {
+                log_warn("Unable to set multicast interface");
+            }
+        }
+    } else if (sockaddr->ss_family == AF_INET6
+               && IN6_IS_ADDR_MULTICAST(&((struct sockaddr_in6 *) sockaddr)->sin6_addr)) {
+        log_debug("Setting IPv6 multicast hops %d", ctx->multicast_ttl);
+        if (setsockopt(sck, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &ctx->multicast_ttl, sizeof(int)) != 0) {
+            log_warn("Unable to set multicast hops");
+        }
+
+        if (index > 0 && setsockopt(sck, IPPROTO_IPV6, IPV6_MULTICAST_IF, &index, sizeof(int)) != 0) {
+            log_warn("Unable to set multicast interface");
+        }
+    }
+}
+
+static int network_destination_append(network_ctx *ctx, int sck, struct sockaddr_storage *sockaddr,
+                                      socklen_t sockaddr_len) {
+    network_destination *destinations;
+    network_destination *destination;
+
+    destinations = (network_destination *) realloc(ctx->destinations,
+                                                   sizeof(network_destination) * (ctx->destinations_count + 1));
+    if (destinations == NULL) {
+        log_error("Unable to allocate destination");
+        return EXIT_FAILURE;
+    }
+
+    ctx->destinations = destinations;
+
+    destination = &ctx->destinations[ctx->destinations_count];
+    memset(destination, 0, sizeof(network_destination));
+    destination->sck = sck;
+    memcpy(&destination->sockaddr, sockaddr, sockaddr_len);
+    destination->sockaddr_len = sockaddr_len;
+
+    ctx->destinations_count++;
+
+    return EXIT_SUCCESS;
+}
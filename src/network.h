@@ -26,7 +26,47 @@
 #include <time.h>
 #include <netdb.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
+/*
+ * Datagram sockets. An address starting with '/' is the path of a UNIX
+ * datagram socket (the port is ignored), anything else is resolved as an
+ * UDP host.
+ *
+ * A batch collects datagrams made of a header, written in place in the
+ * batch, and an optional data block referenced by pointer, and sends them
+ * all with a single sendmmsg. Referenced data must stay valid until the
+ * batch is sent.
+ *
+ * A bound socket receives datagrams on the local address, with the kernel
+ * receive buffer enlarged to absorb bursts. Receiving times out after
+ * NETWORK_RECEIVE_TIMEOUT_MS so that the caller can check for shutdown.
+ * The same batch can also drain a bound socket with a single recvmmsg:
+ * each header buffer receives one datagram, together with its source.
+ *
+ * A context sends to a list of destinations: the opened address is the
+ * first one, network_destination_add appends others, each with its own
+ * socket. Multicast destinations get the context TTL and interface. Sends
+ * never block: a full socket buffer counts as drop and an error is counted
+ * per destination, so a dead endpoint never stalls the others. Sending
+ * fails only when every destination failed.
+ */
+
+#define NETWORK_BATCH_IOVECS 2
+
+#define NETWORK_RECEIVE_TIMEOUT_MS 200
+#define NETWORK_MULTICAST_TTL_DEFAULT 1
+
+struct network_destination_t {
+    int sck;
+
+    struct sockaddr_storage sockaddr;
+    socklen_t sockaddr_len;
+
+    uint64_t sent;
+    uint64_t dropped;
+    uint64_t errors;
+};
 
 struct network_ctx_t {
     char *address;
@@ -34,20 +74,64 @@ struct network_ctx_t {
 
     int sck;
 
-    struct sockaddr sockaddr;
+    struct sockaddr_storage sockaddr;
     socklen_t sockaddr_len;
+
+    int multicast_ttl;
+    char *multicast_interface;
+
+    size_t destinations_count;
+    struct network_destination_t *destinations;
 };
 
+struct network_batch_t {
+    size_t size;
+    size_t count;
+
+    size_t header_size;
+    uint8_t *headers;
+
+    struct iovec *iovecs;
+    struct mmsghdr *messages;
+    struct sockaddr_storage *addresses;
+};
+
+typedef struct network_destination_t network_destination;
 typedef struct network_ctx_t network_ctx;
+typedef struct network_batch_t network_batch;
 
 network_ctx *network_init(const char *, uint16_t);
 
 void network_free(network_ctx *);
 
+int network_set_multicast(network_ctx *, int, const char *);
+
+int network_destination_add(network_ctx *, const char *, uint16_t);
+
+void network_print_stats(network_ctx *);
+
 int network_socket_open(network_ctx *ctx);
 
+int network_socket_open_unix(network_ctx *ctx);
+
+int network_socket_bind(network_ctx *ctx, int);
+
 void network_socket_close(network_ctx *ctx);
 
 int network_socket_send(network_ctx *ctx, uint8_t *, size_t);
 
+int network_socket_send_batch(network_ctx *ctx, network_batch *);
+
+ssize_t network_socket_receive(network_ctx *ctx, uint8_t *, size_t);
+
+int network_socket_receive_batch(network_ctx *ctx, network_batch *);
+
+network_batch *network_batch_init(size_t, size_t);
+
+void network_batch_free(network_batch *);
+
+uint8_t *network_batch_header(network_batch *);
+
+int network_batch_add(network_batch *, size_t, uint8_t *, size_t);
+
 #endif
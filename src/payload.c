@@ -16,13 +16,28 @@
  *
  */
 
+
 #include <stdlib.h>
 #include <malloc.h>
 #include <string.h>
+#include <endian.h>
 
 #include "payload.h"
 #include "log.h"
-#include "utils.h"
+
+static inline void payload_store_uint32(uint8_t *, uint32_t);
+
+static inline void payload_store_uint64(uint8_t *, uint64_t);
+
+static inline uint32_t payload_load_uint32(const uint8_t *);
+
+static inline uint64_t payload_load_uint64(const uint8_t *);
+
+static size_t payload_store_varint(uint8_t *, uint64_t);
+
+static int payload_load_varint(const uint8_t **, const uint8_t *, uint64_t *);
+
+static int payload_v2_write_header(payload *, payload_v2_state *, uint8_t *, size_t, size_t *);
 
 payload *payload_init() {
     payload *p;
@@ -48,6 +63,9 @@ payload *payload_init() {
 
     p->rms = 0;
 
+    p->codec_mode = 0;
+    p->flags = 0;
+
     p->data_size = 0;
     p->data = NULL;
 
@@ -57,10 +75,6 @@ payload *payload_init() {
 void payload_free(payload *p) {
     log_debug("Freeing payload");
 
-    log_trace("Freeing data buffer_int16");
-    if (p->data != NULL)
-        free(p->data);
-
     log_trace("Freeing payload");
     free(p);
 }
@@ -103,97 +117,643 @@ int payload_set_channel_frequency(payload *p, uint32_t channel, uint32_t frequen
     return EXIT_SUCCESS;
 }
 
-int payload_set_data(payload *p, uint8_t *data, uint32_t data_size) {
+int payload_set_data(payload *p, const uint8_t *data, uint32_t data_size) {
     log_info("Setting data");
 
-    log_debug("Allocating data");
-    p->data = (uint8_t *) realloc(p->data, data_size * sizeof(uint8_t));
+    p->data = data;
+    p->data_size = data_size;
+
+    return EXIT_SUCCESS;
+}
 
-    log_debug("Copying data");
-    memcpy(p->data, data, data_size);
+int payload_set_data_size(payload *p, uint32_t data_size) {
+    log_info("Setting data size");
 
-    log_debug("Setting data samples_size");
     p->data_size = data_size;
 
     return EXIT_SUCCESS;
 }
 
+int payload_set_codec_flags(payload *p, uint8_t codec_mode, uint8_t flags) {
+    log_info("Setting codec mode and flags");
+
+    p->codec_mode = codec_mode;
+    p->flags = flags;
+
+    return EXIT_SUCCESS;
+}
+
 size_t payload_get_size(payload *p) {
+    log_info("Getting payload samples_size");
+
+    return PAYLOAD_HEADER_SIZE + p->data_size;
+}
+
+int payload_serialize(payload *p, uint8_t *buffer, size_t buffer_size, size_t *bytes_written) {
     size_t ln;
 
-    log_info("Getting payload samples_size");
+    log_info("Serializing payload");
 
-    ln = 0;
+    ln = payload_get_size(p);
+    if (buffer_size < ln) {
+        log_error("Not enough space for payload serialization");
+        return EXIT_FAILURE;
+    }
 
-    ln += sizeof(PAYLOAD_HEADER);
+    payload_serialize_header(p, buffer, buffer_size, &ln);
 
-    ln += sizeof(uint32_t);
-    ln += sizeof(uint64_t);
+    log_debug("Adds data");
+    memcpy(buffer + ln, p->data, p->data_size);
+    ln += p->data_size;
+
+    log_debug("Sets bytes_written");
+    *bytes_written = ln;
+
+    return EXIT_SUCCESS;
+}
+
+size_t payload_get_header_size(payload *p) {
+    (void) p;
+
+    return PAYLOAD_HEADER_SIZE;
+}
+
+int payload_serialize_header(payload *p, uint8_t *buffer, size_t buffer_size, size_t *bytes_written) {
+    log_info("Serializing payload header");
+
+    if (buffer_size < PAYLOAD_HEADER_SIZE) {
+        log_error("Not enough space for payload header serialization");
+        return EXIT_FAILURE;
+    }
+
+    memcpy(buffer, PAYLOAD_HEADER, strlen(PAYLOAD_HEADER));
+    payload_store_uint32(buffer + PAYLOAD_OFFSET_RECEIVER, p->receiver);
+    payload_store_uint64(buffer + PAYLOAD_OFFSET_NUMBER, p->number);
+    payload_store_uint64(buffer + PAYLOAD_OFFSET_TIMESTAMP, p->timestamp);
+    payload_store_uint32(buffer + PAYLOAD_OFFSET_CHANNEL, p->channel);
+    payload_store_uint32(buffer + PAYLOAD_OFFSET_FREQUENCY, p->frequency);
+    memcpy(buffer + PAYLOAD_OFFSET_RMS, &p->rms, PAYLOAD_OFFSET_DATA_SIZE - PAYLOAD_OFFSET_RMS);
+    payload_store_uint32(buffer + PAYLOAD_OFFSET_DATA_SIZE, p->data_size);
+
+    *bytes_written = PAYLOAD_HEADER_SIZE;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_parse(payload *p, const uint8_t *buffer, size_t buffer_size) {
+    log_info("Parsing payload");
+
+    if (buffer_size < PAYLOAD_HEADER_SIZE || memcmp(buffer, PAYLOAD_HEADER, strlen(PAYLOAD_HEADER)) != 0) {
+        log_error("Not a payload");
+        return EXIT_FAILURE;
+    }
+
+    p->receiver = payload_load_uint32(buffer + PAYLOAD_OFFSET_RECEIVER);
+    p->number = payload_load_uint64(buffer + PAYLOAD_OFFSET_NUMBER);
+    p->timestamp = payload_load_uint64(buffer + PAYLOAD_OFFSET_TIMESTAMP);
+    p->channel = payload_load_uint32(buffer + PAYLOAD_OFFSET_CHANNEL);
+    p->frequency = payload_load_uint32(buffer + PAYLOAD_OFFSET_FREQUENCY);
+    p->rms = 0;
+    p->data_size = payload_load_uint32(buffer + PAYLOAD_OFFSET_DATA_SIZE);
+
+    if (buffer_size - PAYLOAD_HEADER_SIZE < p->data_size) {
+        log_error("Truncated payload");
+        return EXIT_FAILURE;
+    }
+
+    p->data = buffer + PAYLOAD_HEADER_SIZE;
+
+    return EXIT_SUCCESS;
+}
+
+size_t payload_aggregate_get_header_size() {
+    return PAYLOAD_AGGREGATE_HEADER_SIZE;
+}
+
+size_t payload_aggregate_get_frame_size(uint32_t data_size) {
+    return sizeof(uint64_t) + sizeof(uint32_t) + data_size;
+}
+
+/*
+ * Tells whether a pending aggregate must be sent: when the squelch closes,
+ * so tails are not delayed, or when the frames, time (ms, 0 for no limit)
+ * or buffer limits are hit. Blocks where no codec frame completed do not
+ * count.
+ */
+int payload_aggregate_is_due(int open, uint32_t frames, uint32_t frames_max, uint64_t elapsed, uint32_t time_max,
+                             size_t size, size_t frame_size, size_t buffer_size) {
+    if (frames == 0)
+        return 0;
+
+    return !open
+           || frames >= frames_max
+           || (time_max > 0 && elapsed >= time_max)
+           || size + frame_size > buffer_size;
+}
+
+int payload_aggregate_begin(payload *p, uint8_t *buffer, size_t buffer_size, size_t *bytes_written) {
+    log_info("Beginning aggregated payload");
+
+    if (buffer_size < PAYLOAD_AGGREGATE_HEADER_SIZE) {
+        log_error("Not enough space for aggregated payload header");
+        return EXIT_FAILURE;
+    }
+
+    memcpy(buffer, PAYLOAD_AGGREGATE_HEADER, strlen(PAYLOAD_AGGREGATE_HEADER));
+    payload_store_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_RECEIVER, p->receiver);
+    payload_store_uint64(buffer + PAYLOAD_AGGREGATE_OFFSET_TIMESTAMP, p->timestamp);
+    payload_store_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_CHANNEL, p->channel);
+    payload_store_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_FREQUENCY, p->frequency);
+    memcpy(buffer + PAYLOAD_AGGREGATE_OFFSET_RMS, &p->rms, sizeof(float));
+    payload_store_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_FRAMES, 0);
+
+    *bytes_written = PAYLOAD_AGGREGATE_HEADER_SIZE;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_aggregate_add(uint8_t *buffer, size_t buffer_size, size_t *bytes_written,
+                          uint64_t number, const uint8_t *data, uint32_t data_size) {
+    size_t ln;
+
+    log_info("Adding frame to aggregated payload");
+
+    ln = *bytes_written;
+    if (buffer_size < ln + payload_aggregate_get_frame_size(data_size)) {
+        log_error("Not enough space for aggregated frame");
+        return EXIT_FAILURE;
+    }
 
+    payload_store_uint64(buffer + ln, number);
     ln += sizeof(uint64_t);
 
-    ln += sizeof(uint32_t);
+    payload_store_uint32(buffer + ln, data_size);
     ln += sizeof(uint32_t);
 
-    ln += sizeof(float);
+    memcpy(buffer + ln, data, data_size);
+    ln += data_size;
 
-    ln += sizeof(uint32_t);
-    ln += p->data_size;
+    *bytes_written = ln;
 
-    return ln;
+    return EXIT_SUCCESS;
 }
 
-int payload_serialize(payload *p, uint8_t *buffer, size_t buffer_size, size_t *bytes_written) {
+int payload_aggregate_end(uint8_t *buffer, uint32_t frames) {
+    log_info("Ending aggregated payload");
+
+    payload_store_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_FRAMES, frames);
+
+    return EXIT_SUCCESS;
+}
+
+int payload_aggregate_parse(payload *p, const uint8_t *buffer, size_t buffer_size, uint32_t *frames) {
+    log_info("Parsing aggregated payload");
+
+    if (buffer_size < PAYLOAD_AGGREGATE_HEADER_SIZE
+        || memcmp(buffer, PAYLOAD_AGGREGATE_HEADER, strlen(PAYLOAD_AGGREGATE_HEADER)) != 0) {
+        log_error("Not an aggregated payload");
+        return EXIT_FAILURE;
+    }
+
+    p->receiver = payload_load_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_RECEIVER);
+    p->timestamp = payload_load_uint64(buffer + PAYLOAD_AGGREGATE_OFFSET_TIMESTAMP);
+    p->channel = payload_load_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_CHANNEL);
+    p->frequency = payload_load_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_FREQUENCY);
+    memcpy(&p->rms, buffer + PAYLOAD_AGGREGATE_OFFSET_RMS, sizeof(float));
+    *frames = payload_load_uint32(buffer + PAYLOAD_AGGREGATE_OFFSET_FRAMES);
+
+    p->data_size = (uint32_t) (buffer_size - PAYLOAD_AGGREGATE_HEADER_SIZE);
+    p->data = buffer + PAYLOAD_AGGREGATE_HEADER_SIZE;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_aggregate_parse_frame(payload *p, const uint8_t **cursor, const uint8_t *end) {
+    uint32_t size;
+
+    if (end - *cursor < (ptrdiff_t) payload_aggregate_get_frame_size(0)) {
+        log_error("Truncated aggregated frame");
+        return EXIT_FAILURE;
+    }
+
+    p->number = payload_load_uint64(*cursor);
+    size = payload_load_uint32(*cursor + sizeof(uint64_t));
+    *cursor += payload_aggregate_get_frame_size(0);
+
+    if ((size_t) (end - *cursor) < size) {
+        log_error("Truncated aggregated frame");
+        return EXIT_FAILURE;
+    }
+
+    p->data_size = size;
+    p->data = *cursor;
+
+    *cursor += size;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_repair_serialize_header(payload *p, uint32_t mask, uint32_t size, uint8_t *buffer, size_t buffer_size,
+                                    size_t *bytes_written) {
+    log_info("Serializing repair payload header");
+
+    if (buffer_size < PAYLOAD_REPAIR_HEADER_SIZE) {
+        log_error("Not enough space for repair payload header serialization");
+        return EXIT_FAILURE;
+    }
+
+    memcpy(buffer, PAYLOAD_REPAIR_HEADER, strlen(PAYLOAD_REPAIR_HEADER));
+    payload_store_uint32(buffer + PAYLOAD_REPAIR_OFFSET_RECEIVER, p->receiver);
+    payload_store_uint64(buffer + PAYLOAD_REPAIR_OFFSET_NUMBER, p->number);
+    payload_store_uint64(buffer + PAYLOAD_REPAIR_OFFSET_TIMESTAMP, p->timestamp);
+    payload_store_uint32(buffer + PAYLOAD_REPAIR_OFFSET_CHANNEL, p->channel);
+    payload_store_uint32(buffer + PAYLOAD_REPAIR_OFFSET_MASK, mask);
+    payload_store_uint32(buffer + PAYLOAD_REPAIR_OFFSET_SIZE, size);
+    payload_store_uint32(buffer + PAYLOAD_REPAIR_OFFSET_DATA_SIZE, p->data_size);
+
+    *bytes_written = PAYLOAD_REPAIR_HEADER_SIZE;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_repair_parse(payload *p, const uint8_t *buffer, size_t buffer_size, uint32_t *mask, uint32_t *size) {
+    log_info("Parsing repair payload");
+
+    if (buffer_size < PAYLOAD_REPAIR_HEADER_SIZE
+        || memcmp(buffer, PAYLOAD_REPAIR_HEADER, strlen(PAYLOAD_REPAIR_HEADER)) != 0) {
+        log_error("Not a repair payload");
+        return EXIT_FAILURE;
+    }
+
+    p->receiver = payload_load_uint32(buffer + PAYLOAD_REPAIR_OFFSET_RECEIVER);
+    p->number = payload_load_uint64(buffer + PAYLOAD_REPAIR_OFFSET_NUMBER);
+    p->timestamp = payload_load_uint64(buffer + PAYLOAD_REPAIR_OFFSET_TIMESTAMP);
+    p->channel = payload_load_uint32(buffer + PAYLOAD_REPAIR_OFFSET_CHANNEL);
+    *mask = payload_load_uint32(buffer + PAYLOAD_REPAIR_OFFSET_MASK);
+    *size = payload_load_uint32(buffer + PAYLOAD_REPAIR_OFFSET_SIZE);
+    p->data_size = payload_load_uint32(buffer + PAYLOAD_REPAIR_OFFSET_DATA_SIZE);
+
+    if (buffer_size - PAYLOAD_REPAIR_HEADER_SIZE < p->data_size) {
+        log_error("Truncated repair payload");
+        return EXIT_FAILURE;
+    }
+
+    p->data = buffer + PAYLOAD_REPAIR_HEADER_SIZE;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_get_version(const uint8_t *buffer, size_t buffer_size) {
+    if (buffer_size >= 3 && memcmp(buffer, PAYLOAD_HEADER, strlen(PAYLOAD_HEADER)) == 0)
+        return 1;
+
+    if (buffer_size >= 3 && memcmp(buffer, PAYLOAD_AGGREGATE_HEADER, strlen(PAYLOAD_AGGREGATE_HEADER)) == 0)
+        return 1;
+
+    if (buffer_size >= 3 && memcmp(buffer, PAYLOAD_REPAIR_HEADER, strlen(PAYLOAD_REPAIR_HEADER)) == 0)
+        return 1;
+
+    if (buffer_size >= 5 && buffer[0] == PAYLOAD_V2_MAGIC && buffer[1] == PAYLOAD_V2_VERSION)
+        return 2;
+
+    return -1;
+}
+
+size_t payload_v2_get_frame_size(uint32_t data_size) {
+    return 2 * PAYLOAD_VARINT_SIZE_MAX + data_size;
+}
+
+int payload_v2_serialize_header(payload *p, payload_v2_state *state, uint8_t *buffer, size_t buffer_size,
+                                size_t *bytes_written) {
     size_t ln;
 
-    log_info("Serializing payload");
+    log_info("Serializing v2 payload header");
 
-    ln = payload_get_size(p);
-    if (buffer_size < ln) {
-        log_error("Not enough space for payload serialization");
+    p->flags &= (uint8_t) ~PAYLOAD_V2_FLAG_AGGREGATE;
+
+    if (payload_v2_write_header(p, state, buffer, buffer_size, &ln) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    ln += payload_store_varint(buffer + ln, p->data_size);
+
+    *bytes_written = ln;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_v2_parse(payload *p, payload_v2_state *state, const uint8_t *buffer, size_t buffer_size) {
+    const uint8_t *cursor;
+    const uint8_t *end;
+    uint64_t value;
+    uint64_t delta;
+    uint16_t rms;
+    uint8_t check;
+
+    log_info("Parsing v2 payload");
+
+    if (payload_get_version(buffer, buffer_size) != 2) {
+        log_error("Not a v2 payload");
         return EXIT_FAILURE;
     }
 
-    ln = 0;
+    p->flags = buffer[2];
+    p->codec_mode = buffer[3];
+    check = buffer[4];
 
-    log_debug("Adds header");
-    strcpy((char *) buffer + ln, PAYLOAD_HEADER);
-    ln += strlen(PAYLOAD_HEADER);
+    cursor = buffer + 5;
+    end = buffer + buffer_size;
 
-    log_debug("Adds receiver number");
-    utils_uint32_to_be(buffer + ln, p->receiver);
-    ln += sizeof(uint32_t);
+    if (payload_load_varint(&cursor, end, &value) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+    p->channel = (uint32_t) value;
+
+    if (p->flags & PAYLOAD_V2_FLAG_KEY) {
+        if (payload_load_varint(&cursor, end, &value) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+        state->receiver = (uint32_t) value;
+
+        if (payload_load_varint(&cursor, end, &state->number) != EXIT_SUCCESS
+            || payload_load_varint(&cursor, end, &state->timestamp) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+
+        if (payload_load_varint(&cursor, end, &value) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+        state->frequency = (uint32_t) value;
+
+        state->valid = 1;
+    } else {
+        if (payload_load_varint(&cursor, end, &delta) != EXIT_SUCCESS
+            || payload_load_varint(&cursor, end, &value) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+
+        if (!state->valid || (uint8_t) (state->number + delta) != check) {
+            log_error("Previous packet lost, waiting for a key packet");
+            state->valid = 0;
+            return EXIT_FAILURE;
+        }
+
+        state->number += delta;
+        state->timestamp += (uint64_t) ((int64_t) (value >> 1) ^ -(int64_t) (value & 1));
+    }
 
-    log_debug("Adds payload number");
-    utils_uint64_to_be(buffer + ln, p->number);
-    ln += sizeof(uint64_t);
+    if (end - cursor < 2) {
+        log_error("Truncated v2 payload");
+        return EXIT_FAILURE;
+    }
 
-    log_debug("Adds timestamp");
-    utils_uint64_to_be(buffer + ln, p->timestamp);
-    ln += sizeof(uint64_t);
+    memcpy(&rms, cursor, sizeof(uint16_t));
+    rms = le16toh(rms);
+    cursor += sizeof(uint16_t);
 
-    log_debug("Adds channel");
-    utils_uint32_to_be(buffer + ln, p->channel);
-    ln += sizeof(uint32_t);
+    p->receiver = state->receiver;
+    p->number = state->number;
+    p->timestamp = state->timestamp;
+    p->frequency = state->frequency;
+    p->rms = (float) rms / 65535.0f;
 
-    log_debug("Adds frequency");
-    utils_uint32_to_be(buffer + ln, p->frequency);
-    ln += sizeof(uint32_t);
+    if (p->flags & PAYLOAD_V2_FLAG_AGGREGATE) {
+        if (cursor == end) {
+            log_error("Truncated v2 payload");
+            return EXIT_FAILURE;
+        }
 
-    log_debug("Adds rms");
-    memcpy(buffer + ln, &p->rms, sizeof(float));
-    ln += sizeof(uint8_t);
+        state->frames = *cursor;
+        state->frame_number = p->number;
+        cursor++;
 
-    log_debug("Adds data samples_size");
-    utils_uint32_to_be(buffer + ln, p->data_size);
-    ln += sizeof(uint32_t);
+        p->data_size = (uint32_t) (end - cursor);
+        p->data = cursor;
 
-    log_debug("Adds data");
-    memcpy(buffer + ln, p->data, p->data_size);
-    ln += p->data_size;
+        return EXIT_SUCCESS;
+    }
+
+    if (payload_load_varint(&cursor, end, &value) != EXIT_SUCCESS || (uint64_t) (end - cursor) < value) {
+        log_error("Truncated v2 payload");
+        return EXIT_FAILURE;
+    }
+
+    p->data_size = (uint32_t) value;
+    p->data = cursor;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_v2_get_channel(const uint8_t *buffer, size_t buffer_size, uint32_t *channel) {
+    const uint8_t *cursor;
+    uint64_t value;
+
+    if (payload_get_version(buffer, buffer_size) != 2)
+        return EXIT_FAILURE;
+
+    cursor = buffer + 5;
+    if (payload_load_varint(&cursor, buffer + buffer_size, &value) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    *channel = (uint32_t) value;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_v2_parse_frame(payload *p, payload_v2_state *state, const uint8_t **cursor, const uint8_t *end) {
+    uint64_t delta;
+    uint64_t size;
+
+    if (state->frames == 0)
+        return EXIT_FAILURE;
+
+    if (payload_load_varint(cursor, end, &delta) != EXIT_SUCCESS
+        || payload_load_varint(cursor, end, &size) != EXIT_SUCCESS
+        || (uint64_t) (end - *cursor) < size) {
+        log_error("Truncated v2 frame");
+        state->frames = 0;
+        return EXIT_FAILURE;
+    }
+
+    state->frame_number += delta;
+    state->frames--;
+
+    p->number = state->frame_number;
+    p->data_size = (uint32_t) size;
+    p->data = *cursor;
+
+    *cursor += size;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_v2_aggregate_begin(payload *p, payload_v2_state *state, uint8_t *buffer, size_t buffer_size,
+                               size_t *bytes_written) {
+    size_t ln;
+
+    log_info("Beginning v2 aggregated payload");
+
+    p->flags |= PAYLOAD_V2_FLAG_AGGREGATE;
+
+    if (payload_v2_write_header(p, state, buffer, buffer_size, &ln) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    state->frames_offset = ln;
+    state->frames = 0;
+    state->frame_number = p->number;
+
+    buffer[ln++] = 0;
+
+    *bytes_written = ln;
+
+    return EXIT_SUCCESS;
+}
+
+int payload_v2_aggregate_add(payload_v2_state *state, uint8_t *buffer, size_t buffer_size, size_t *bytes_written,
+                             uint64_t number, const uint8_t *data, uint32_t data_size) {
+    size_t ln;
+
+    log_info("Adding frame to v2 aggregated payload");
+
+    ln = *bytes_written;
+    if (state->frames == PAYLOAD_V2_AGGREGATE_FRAMES_MAX
+        || buffer_size < ln + payload_v2_get_frame_size(data_size)) {
+        log_error("Not enough space for aggregated frame");
+        return EXIT_FAILURE;
+    }
+
+    ln += payload_store_varint(buffer + ln, number - state->frame_number);
+    ln += payload_store_varint(buffer + ln, data_size);
+
+    memcpy(buffer + ln, data, data_size);
+    ln += data_size;
+
+    state->frame_number = number;
+    state->frames++;
 
-    log_debug("Sets bytes_written");
     *bytes_written = ln;
 
     return EXIT_SUCCESS;
 }
+
+int payload_v2_aggregate_end(payload_v2_state *state, uint8_t *buffer) {
+    log_info("Ending v2 aggregated payload");
+
+    buffer[state->frames_offset] = (uint8_t) state->frames;
+
+    return EXIT_SUCCESS;
+}
+
+static int payload_v2_write_header(payload *p, payload_v2_state *state, uint8_t *buffer, size_t buffer_size,
+                                   size_t *bytes_written) {
+    int64_t timestamp_delta;
+    uint16_t rms;
+    FP_FLOAT clipped;
+    size_t ln;
+    int key;
+
+    if (buffer_size < PAYLOAD_V2_HEADER_SIZE_MAX) {
+        log_error("Not enough space for v2 payload header serialization");
+        return EXIT_FAILURE;
+    }
+
+    key = !state->valid
+          || state->packets % PAYLOAD_V2_KEY_INTERVAL == 0
+          || p->receiver != state->receiver
+          || p->frequency != state->frequency
+          || p->number < state->number;
+
+    if (key)
+        p->flags |= PAYLOAD_V2_FLAG_KEY;
+    else
+        p->flags &= (uint8_t) ~PAYLOAD_V2_FLAG_KEY;
+
+    buffer[0] = PAYLOAD_V2_MAGIC;
+    buffer[1] = PAYLOAD_V2_VERSION;
+    buffer[2] = p->flags;
+    buffer[3] = p->codec_mode;
+    buffer[4] = (uint8_t) p->number;
+    ln = 5;
+
+    ln += payload_store_varint(buffer + ln, p->channel);
+
+    if (key) {
+        ln += payload_store_varint(buffer + ln, p->receiver);
+        ln += payload_store_varint(buffer + ln, p->number);
+        ln += payload_store_varint(buffer + ln, p->timestamp);
+        ln += payload_store_varint(buffer + ln, p->frequency);
+    } else {
+        timestamp_delta = (int64_t) (p->timestamp - state->timestamp);
+        ln += payload_store_varint(buffer + ln, p->number - state->number);
+        ln += payload_store_varint(buffer + ln,
+                                   ((uint64_t) timestamp_delta << 1) ^ (uint64_t) (timestamp_delta >> 63));
+    }
+
+    clipped = p->rms < 0 ? 0 : (p->rms > 1 ? 1 : p->rms);
+    rms = htole16((uint16_t) (clipped * 65535));
+    memcpy(buffer + ln, &rms, sizeof(uint16_t));
+    ln += sizeof(uint16_t);
+
+    state->valid = 1;
+    state->packets++;
+    state->number = p->number;
+    state->timestamp = p->timestamp;
+    state->receiver = p->receiver;
+    state->frequency = p->frequency;
+
+    *bytes_written = ln;
+
+    return EXIT_SUCCESS;
+}
+
+static inline void payload_store_uint32(uint8_t *buffer, uint32_t value) {
+    value = htole32(value);
+    memcpy(buffer, &value, sizeof(uint32_t));
+}
+
+static inline void payload_store_uint64(uint8_t *buffer, uint64_t value) {
+    value = htole64(value);
+    memcpy(buffer, &value, sizeof(uint64_t));
+}
+
+static inline uint32_t payload_load_uint32(const uint8_t *buffer) {
+    uint32_t value;
+
+    memcpy(&value, buffer, sizeof(uint32_t));
+
+    return le32toh(value);
+}
+
+static inline uint64_t payload_load_uint64(const uint8_t *buffer) {
+    uint64_t value;
+
+    memcpy(&value, buffer, sizeof(uint64_t));
+
+    return le64toh(value);
+}
+
+static size_t payload_store_varint(uint8_t *buffer, uint64_t value) {
+    size_t ln;
+
+    ln = 0;
+
+    while (value >= 0x80) {
+        buffer[ln++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+
+    buffer[ln++] = (uint8_t) value;
+
+    return ln;
+}
+
+static int payload_load_varint(const uint8_t **cursor, const uint8_t *end, uint64_t *value) {
+    unsigned int shift;
+
+    *value = 0;
+
+    for (shift = 0; *cursor < end && shift < 64; shift += 7) {
+        *value |= (uint64_t) (**cursor & 0x7f) << shift;
+
+        if ((*(*cursor)++ & 0x80) == 0)
+            return EXIT_SUCCESS;
+    }
+
+    log_error("Truncated varint");
+
+    return EXIT_FAILURE;
+}
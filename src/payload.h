@@ -24,7 +24,40 @@
 
 # 0         1         2         3         4         5         6
 # 0123456789012345678901234567890123456789012345678901234567890123456789
-# GFPrrrrNNNNNNNNttttttttCCCCffffRRRRdddd...
+# GFPrrrrNNNNNNNNttttttttCCCCffffRssssdddd...
+
+The v1 layout is kept byte for byte as it has always been sent: only the
+first byte of the float rms (R) survives, overwritten by the data size, so
+parsed v1 packets carry no rms. Use v2 when the rms matters (vote mode).
+
+Aggregated payload, with nnnn frames each made of number, size and data:
+
+# GFArrrrttttttttCCCCffffRRRRnnnnNNNNNNNNdddd...NNNNNNNNdddd...
+
+Repair payload, with the XOR parity of the frames of a group (see fec.h),
+the group base number, the mask of the covered frames, the XOR of their
+timestamps and sizes and the parity size:
+
+# GFRrrrrNNNNNNNNttttttttCCCCMMMMSSSSdddd...
+
+Fields are stored at fixed offsets, least significant byte first, as the
+utils_*_to_be helpers always did. The data is never owned by the payload:
+payload_set_data and payload_parse only reference it, so it must outlive
+the payload use.
+
+Version 2 (v2) starts with 'G' and the version byte, then flags, codec
+mode and the low byte of the packet number (k), followed by varints:
+
+# G2FMk channel [receiver number timestamp frequency | Dnumber Dtimestamp] RR size data...
+
+Key packets (PAYLOAD_V2_FLAG_KEY) carry the absolute values. The others
+carry the number and the timestamp (zigzag) as deltas from the previous
+packet of the same channel. They are decoded only if the receiver holds
+that packet, which the low number byte confirms. RR is the rms in Q16.
+
+An aggregated v2 packet (PAYLOAD_V2_FLAG_AGGREGATE) replaces size and data
+with a frames count byte and, for each frame, the varint number delta from
+the previous frame, the varint size and the data.
 
  */
 
@@ -36,6 +69,47 @@
 #include "buildflags.h"
 
 #define PAYLOAD_HEADER "GFP"
+#define PAYLOAD_AGGREGATE_HEADER "GFA"
+#define PAYLOAD_REPAIR_HEADER "GFR"
+
+#define PAYLOAD_OFFSET_RECEIVER 3
+#define PAYLOAD_OFFSET_NUMBER 7
+#define PAYLOAD_OFFSET_TIMESTAMP 15
+#define PAYLOAD_OFFSET_CHANNEL 23
+#define PAYLOAD_OFFSET_FREQUENCY 27
+#define PAYLOAD_OFFSET_RMS 31
+#define PAYLOAD_OFFSET_DATA_SIZE 32
+#define PAYLOAD_HEADER_SIZE 36
+
+#define PAYLOAD_AGGREGATE_OFFSET_RECEIVER 3
+#define PAYLOAD_AGGREGATE_OFFSET_TIMESTAMP 7
+#define PAYLOAD_AGGREGATE_OFFSET_CHANNEL 15
+#define PAYLOAD_AGGREGATE_OFFSET_FREQUENCY 19
+#define PAYLOAD_AGGREGATE_OFFSET_RMS 23
+#define PAYLOAD_AGGREGATE_OFFSET_FRAMES 27
+#define PAYLOAD_AGGREGATE_HEADER_SIZE 31
+
+#define PAYLOAD_REPAIR_OFFSET_RECEIVER 3
+#define PAYLOAD_REPAIR_OFFSET_NUMBER 7
+#define PAYLOAD_REPAIR_OFFSET_TIMESTAMP 15
+#define PAYLOAD_REPAIR_OFFSET_CHANNEL 23
+#define PAYLOAD_REPAIR_OFFSET_MASK 27
+#define PAYLOAD_REPAIR_OFFSET_SIZE 31
+#define PAYLOAD_REPAIR_OFFSET_DATA_SIZE 35
+#define PAYLOAD_REPAIR_HEADER_SIZE 39
+
+#define PAYLOAD_V2_MAGIC 'G'
+#define PAYLOAD_V2_VERSION 2
+
+#define PAYLOAD_V2_FLAG_KEY 0x01
+#define PAYLOAD_V2_FLAG_SQUELCH 0x02
+#define PAYLOAD_V2_FLAG_AGGREGATE 0x04
+
+#define PAYLOAD_V2_KEY_INTERVAL 50
+#define PAYLOAD_V2_AGGREGATE_FRAMES_MAX 255
+
+#define PAYLOAD_VARINT_SIZE_MAX 10
+#define PAYLOAD_V2_HEADER_SIZE_MAX (5 + 7 * PAYLOAD_VARINT_SIZE_MAX + 2 + 1)
 
 struct payload_t {
     uint32_t receiver;
@@ -48,11 +122,30 @@ struct payload_t {
 
     float rms;
 
+    uint8_t codec_mode;
+    uint8_t flags;
+
     uint32_t data_size;
-    uint8_t *data;
+    const uint8_t *data;
+};
+
+struct payload_v2_state_t {
+    int valid;
+    uint32_t packets;
+
+    uint64_t number;
+    uint64_t timestamp;
+
+    uint32_t receiver;
+    uint32_t frequency;
+
+    size_t frames_offset;
+    uint32_t frames;
+    uint64_t frame_number;
 };
 
 typedef struct payload_t payload;
+typedef struct payload_v2_state_t payload_v2_state;
 
 payload *payload_init();
 
@@ -66,10 +159,58 @@ int payload_set_rms(payload *, FP_FLOAT);
 
 int payload_set_channel_frequency(payload *, uint32_t, uint32_t);
 
-int payload_set_data(payload *, uint8_t *, uint32_t);
+int payload_set_data(payload *, const uint8_t *, uint32_t);
+
+int payload_set_data_size(payload *, uint32_t);
+
+int payload_set_codec_flags(payload *, uint8_t, uint8_t);
 
 size_t payload_get_size(payload *);
 
 int payload_serialize(payload *, uint8_t *, size_t, size_t *);
 
+size_t payload_get_header_size(payload *);
+
+int payload_serialize_header(payload *, uint8_t *, size_t, size_t *);
+
+int payload_parse(payload *, const uint8_t *, size_t);
+
+size_t payload_aggregate_get_header_size();
+
+size_t payload_aggregate_get_frame_size(uint32_t);
+
+int payload_aggregate_begin(payload *, uint8_t *, size_t, size_t *);
+
+int payload_aggregate_add(uint8_t *, size_t, size_t *, uint64_t, const uint8_t *, uint32_t);
+
+int payload_aggregate_is_due(int, uint32_t, uint32_t, uint64_t, uint32_t, size_t, size_t, size_t);
+
+int payload_aggregate_end(uint8_t *, uint32_t);
+
+int payload_aggregate_parse(payload *, const uint8_t *, size_t, uint32_t *);
+
+int payload_aggregate_parse_frame(payload *, const uint8_t **, const uint8_t *);
+
+int payload_repair_serialize_header(payload *, uint32_t, uint32_t, uint8_t *, size_t, size_t *);
+
+int payload_repair_parse(payload *, const uint8_t *, size_t, uint32_t *, uint32_t *);
+
+int payload_get_version(const uint8_t *, size_t);
+
+size_t payload_v2_get_frame_size(uint32_t);
+
+int payload_v2_serialize_header(payload *, payload_v2_state *, uint8_t *, size_t, size_t *);
+
+int payload_v2_parse(payload *, payload_v2_state *, const uint8_t *, size_t);
+
+int payload_v2_get_channel(const uint8_t *, size_t, uint32_t *);
+
+int payload_v2_parse_frame(payload *, payload_v2_state *, const uint8_t **, const uint8_t *);
+
+int payload_v2_aggregate_begin(payload *, payload_v2_state *, uint8_t *, size_t, size_t *);
+
+int payload_v2_aggregate_add(payload_v2_state *, uint8_t *, size_t, size_t *, uint64_t, const uint8_t *, uint32_t);
+
+int payload_v2_aggregate_end(payload_v2_state *, uint8_t *);
+
 #endif
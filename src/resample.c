@@ -94,3 +94,21 @@ int resample_float_to_int16(resample_ctx *ctx,
 
     return EXIT_SUCCESS;
 }
+
+int resample_int16(resample_ctx *ctx,
+                   const int16_t *input, size_t input_size,
+                   int16_t *output, size_t output_size) {
+    size_t i;
+    size_t shift;
+
+    log_trace("Resampling");
+
+    for (i = 0; i < output_size; i++) {
+        shift = ctx->ratio * i;
+        if (shift >= input_size)
+            break;
+        output[i] = input[shift];
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -44,4 +44,6 @@ int resample_do(resample_ctx *ctx, const int8_t *, size_t, int8_t *, size_t);
 
 int resample_float_to_int16(resample_ctx *ctx, const FP_FLOAT *, size_t, int16_t *, size_t);
 
+int resample_int16(resample_ctx *ctx, const int16_t *, size_t, int16_t *, size_t);
+
 #endif
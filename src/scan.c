@@ -0,0 +1,102 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+
+#include "scan.h"
+#include "log.h"
+
+scan_ctx *scan_init(const uint32_t *freqs, size_t freqs_count, size_t dwell_blocks, size_t resume_blocks) {
+    scan_ctx *ctx;
+
+    log_info("Initializing scan context");
+
+    if (freqs_count == 0) {
+        log_error("No frequencies to scan");
+        return NULL;
+    }
+
+    log_debug("Allocating scan context");
+    ctx = (scan_ctx *) malloc(sizeof(scan_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate scan context");
+        return NULL;
+    }
+
+    log_debug("Allocating frequencies");
+    ctx->freqs = (uint32_t *) calloc(freqs_count, sizeof(uint32_t));
+    if (ctx->freqs == NULL) {
+        log_error("Unable to allocate frequencies");
+        free(ctx);
+        return NULL;
+    }
+
+    memcpy(ctx->freqs, freqs, freqs_count * sizeof(uint32_t));
+    ctx->freqs_count = freqs_count;
+    ctx->index = 0;
+
+    ctx->dwell_blocks = dwell_blocks > 0 ? dwell_blocks : 1;
+    ctx->resume_blocks = resume_blocks > 0 ? resume_blocks : 1;
+
+    ctx->state = SCAN_STATE_LISTEN;
+    ctx->blocks = 0;
+
+    ctx->hops = 0;
+
+    log_debug("Frequencies: %zu - Dwell: %zu blocks - Resume: %zu blocks",
+              ctx->freqs_count, ctx->dwell_blocks, ctx->resume_blocks);
+
+    return ctx;
+}
+
+void scan_free(scan_ctx *ctx) {
+    log_info("Freeing scan context");
+
+    if (ctx == NULL)
+        return;
+
+    free(ctx->freqs);
+    free(ctx);
+}
+
+uint32_t scan_frequency(scan_ctx *ctx) {
+    return ctx->freqs[ctx->index];
+}
+
+int scan_update(scan_ctx *ctx, int open) {
+    if (open) {
+        ctx->state = SCAN_STATE_DWELL;
+        ctx->blocks = 0;
+        return 0;
+    }
+
+    ctx->blocks++;
+
+    if (ctx->blocks < (ctx->state == SCAN_STATE_DWELL ? ctx->resume_blocks : ctx->dwell_blocks))
+        return 0;
+
+    ctx->index = (ctx->index + 1) % ctx->freqs_count;
+    ctx->state = SCAN_STATE_LISTEN;
+    ctx->blocks = 0;
+    ctx->hops++;
+
+    return 1;
+}
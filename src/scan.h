@@ -0,0 +1,67 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__SCAN__H
+#define __RTLSDR_RADIO__SCAN__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Scanner state machine, fed with the squelch state of every block received
+ * on the current frequency.
+ *
+ * While listening, a block with the squelch open starts a dwell; after
+ * dwell_blocks closed blocks the scanner hops to the next frequency. While
+ * dwelling, the scanner resumes the hop only after resume_blocks closed
+ * blocks in a row.
+ */
+
+enum scan_state_t {
+    SCAN_STATE_LISTEN = 0,
+    SCAN_STATE_DWELL = 1
+};
+
+typedef enum scan_state_t scan_state;
+
+struct scan_ctx_t {
+    uint32_t *freqs;
+    size_t freqs_count;
+    size_t index;
+
+    size_t dwell_blocks;
+    size_t resume_blocks;
+
+    scan_state state;
+    size_t blocks;
+
+    uint64_t hops;
+};
+
+typedef struct scan_ctx_t scan_ctx;
+
+scan_ctx *scan_init(const uint32_t *, size_t, size_t, size_t);
+
+void scan_free(scan_ctx *);
+
+uint32_t scan_frequency(scan_ctx *);
+
+int scan_update(scan_ctx *, int);
+
+#endif
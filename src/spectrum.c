@@ -0,0 +1,253 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "spectrum.h"
+#include "log.h"
+#include "utils.h"
+
+static int spectrum_compute(spectrum_ctx *);
+
+static void spectrum_reset(spectrum_ctx *);
+
+spectrum_ctx *spectrum_init(size_t size, size_t averages, fft_rigor rigor) {
+    spectrum_ctx *ctx;
+    double x;
+    size_t i;
+
+    log_info("Initializing spectrum context");
+
+    if (size < 2 || size > UINT16_MAX || averages == 0) {
+        log_error("Invalid spectrum size or averages");
+        return NULL;
+    }
+
+    log_debug("Allocating spectrum context");
+    ctx = (spectrum_ctx *) calloc(1, sizeof(spectrum_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate spectrum context");
+        return NULL;
+    }
+
+    ctx->size = size;
+    ctx->averages = averages;
+    ctx->count = 0;
+    ctx->number = 0;
+
+    log_debug("Allocating buffers");
+    ctx->window = (FP_FLOAT *) calloc(size, sizeof(FP_FLOAT));
+    ctx->input = (FP_FLOAT complex *) calloc(size, sizeof(FP_FLOAT complex));
+    ctx->output = (FP_FLOAT complex *) calloc(size, sizeof(FP_FLOAT complex));
+    ctx->power = (FP_FLOAT *) calloc(size, sizeof(FP_FLOAT));
+    if (ctx->window == NULL || ctx->input == NULL || ctx->output == NULL || ctx->power == NULL) {
+        log_error("Unable to allocate buffers");
+        spectrum_free(ctx);
+        return NULL;
+    }
+
+    log_debug("Computing window");
+    ctx->window_power = 0;
+    for (i = 0; i < size; i++) {
+        x = 2 * M_PI * (double) i / (double) size;
+        ctx->window[i] = (FP_FLOAT) (0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x) - 0.01168 * cos(3 * x));
+        ctx->window_power += ctx->window[i];
+    }
+    ctx->window_power *= ctx->window_power;
+
+    log_debug("Initializing FFT");
+    ctx->fft = fft_init(size, FFTW_FORWARD, FFT_DATA_TYPE_COMPLEX, rigor);
+    if (ctx->fft == NULL) {
+        log_error("Unable to initialize FFT");
+        spectrum_free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+void spectrum_free(spectrum_ctx *ctx) {
+    log_info("Freeing spectrum context");
+
+    if (ctx == NULL)
+        return;
+
+    if (ctx->fft != NULL)
+        fft_free(ctx->fft);
+
+    if (ctx->window != NULL)
+        free(ctx->window);
+
+    if (ctx->input != NULL)
+        free(ctx->input);
+
+    if (ctx->output != NULL)
+        free(ctx->output);
+
+    if (ctx->power != NULL)
+        free(ctx->power);
+
+    free(ctx);
+}
+
+int spectrum_add(spectrum_ctx *ctx, const FP_FLOAT complex *samples) {
+    size_t i;
+
+    for (i = 0; i < ctx->size; i++)
+        ctx->input[i] = samples[i] * ctx->window[i];
+
+    return spectrum_compute(ctx);
+}
+
+int spectrum_add_fixed(spectrum_ctx *ctx, const fixed_complex *samples) {
+    FP_FLOAT scale;
+    size_t i;
+
+    for (i = 0; i < ctx->size; i++) {
+        scale = ctx->window[i] / FIXED_Q15_ONE;
+        ctx->input[i] = (FP_FLOAT) samples[i].i * scale + (FP_FLOAT) samples[i].q * scale * I;
+    }
+
+    return spectrum_compute(ctx);
+}
+
+int spectrum_ready(spectrum_ctx *ctx) {
+    return ctx->count >= ctx->averages;
+}
+
+size_t spectrum_get_size(spectrum_ctx *ctx) {
+    size_t ln;
+
+    ln = 0;
+
+    ln += strlen(SPECTRUM_HEADER);
+
+    ln += sizeof(uint64_t);
+    ln += sizeof(uint64_t);
+
+    ln += sizeof(uint32_t);
+    ln += sizeof(uint32_t);
+
+    ln += sizeof(uint16_t);
+    ln += ctx->size;
+
+    return ln;
+}
+
+int spectrum_levels(spectrum_ctx *ctx, FP_FLOAT *levels) {
+    size_t i;
+
+    if (ctx->count == 0) {
+        log_error("No spectrum levels available");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < ctx->size; i++)
+        levels[i] = ctx->power[(i + (ctx->size + 1) / 2) % ctx->size] / (FP_FLOAT) ctx->count;
+
+    spectrum_reset(ctx);
+
+    return EXIT_SUCCESS;
+}
+
+int spectrum_serialize(spectrum_ctx *ctx, struct timespec *ts, uint32_t frequency, uint32_t sample_rate,
+                       uint8_t *buffer, size_t buffer_size, size_t *bytes_written) {
+    FP_FLOAT level;
+    size_t ln;
+    size_t i;
+
+    log_debug("Serializing spectrum");
+
+    if (ctx->count == 0) {
+        log_error("No spectrum to serialize");
+        return EXIT_FAILURE;
+    }
+
+    if (buffer_size < spectrum_get_size(ctx)) {
+        log_error("Not enough space for spectrum serialization");
+        return EXIT_FAILURE;
+    }
+
+    ln = 0;
+
+    memcpy(buffer + ln, SPECTRUM_HEADER, strlen(SPECTRUM_HEADER));
+    ln += strlen(SPECTRUM_HEADER);
+
+    utils_uint64_to_be(buffer + ln, ctx->number);
+    ln += sizeof(uint64_t);
+
+    utils_uint64_to_be(buffer + ln, (uint64_t) ts->tv_sec * 1000 + (uint64_t) ts->tv_nsec / 1000000);
+    ln += sizeof(uint64_t);
+
+    utils_uint32_to_be(buffer + ln, frequency);
+    ln += sizeof(uint32_t);
+
+    utils_uint32_to_be(buffer + ln, sample_rate);
+    ln += sizeof(uint32_t);
+
+    utils_uint16_to_be(buffer + ln, (uint16_t) ctx->size);
+    ln += sizeof(uint16_t);
+
+    for (i = 0; i < ctx->size; i++) {
+        level = ctx->power[(i + (ctx->size + 1) / 2) % ctx->size] / (FP_FLOAT) ctx->count;
+        level = (level - (FP_FLOAT) SPECTRUM_DB_MIN) * SPECTRUM_DB_STEPS;
+
+        if (level < 0)
+            buffer[ln + i] = 0;
+        else if (level > UINT8_MAX)
+            buffer[ln + i] = UINT8_MAX;
+        else
+            buffer[ln + i] = (uint8_t) lround((double) level);
+    }
+    ln += ctx->size;
+
+    spectrum_reset(ctx);
+
+    *bytes_written = ln;
+
+    return EXIT_SUCCESS;
+}
+
+static int spectrum_compute(spectrum_ctx *ctx) {
+    FP_FLOAT power;
+    size_t i;
+
+    if (fft_complex_compute(ctx->fft, ctx->input, ctx->output) != EXIT_SUCCESS) {
+        log_error("Unable to compute FFT");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < ctx->size; i++) {
+        power = creal(ctx->output[i]) * creal(ctx->output[i]) + cimag(ctx->output[i]) * cimag(ctx->output[i]);
+        ctx->power[i] += (FP_FLOAT) (10 * log10((double) (power / ctx->window_power) + SPECTRUM_POWER_MIN));
+    }
+
+    ctx->count++;
+
+    return EXIT_SUCCESS;
+}
+
+static void spectrum_reset(spectrum_ctx *ctx) {
+    memset(ctx->power, 0, ctx->size * sizeof(FP_FLOAT));
+    ctx->count = 0;
+    ctx->number++;
+}
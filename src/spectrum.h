@@ -0,0 +1,98 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef __RTLSDR_RADIO__SPECTRUM__H
+#define __RTLSDR_RADIO__SPECTRUM__H
+
+/*
+
+# 0         1         2         3
+# 0123456789012345678901234567890123456
+# GFSNNNNNNNNttttttttFFFFRRRRBBbbbb...
+
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <complex.h>
+#include <time.h>
+
+#include "buildflags.h"
+#include "cfg.h"
+#include "fft.h"
+#include "fixed.h"
+
+/*
+ * Band spectrum for waterfall displays.
+ *
+ * Each spectrum_add runs a Blackman-Harris windowed FFT over size samples
+ * and accumulates the power of every bin in dB, so that averages frames
+ * are averaged in the log domain. spectrum_serialize writes the average
+ * with bins ordered from -fs/2 to +fs/2, each one quantized to a byte in
+ * SPECTRUM_DB_STEPS steps per dB above SPECTRUM_DB_MIN, and starts a new
+ * average. 0 dB is a full scale tone.
+ *
+ * spectrum_levels gives the same average as plain dB values, in the same
+ * bin order, and starts a new average as well.
+ */
+
+#define SPECTRUM_HEADER "GFS"
+
+#define SPECTRUM_DB_MIN -127.5
+#define SPECTRUM_DB_STEPS 2
+#define SPECTRUM_POWER_MIN 1e-15
+
+struct spectrum_ctx_t {
+    size_t size;
+    size_t averages;
+    size_t count;
+
+    uint64_t number;
+
+    FP_FLOAT *window;
+    FP_FLOAT window_power;
+
+    fft_ctx *fft;
+
+    FP_FLOAT complex *input;
+    FP_FLOAT complex *output;
+
+    FP_FLOAT *power;
+};
+
+typedef struct spectrum_ctx_t spectrum_ctx;
+
+spectrum_ctx *spectrum_init(size_t, size_t, fft_rigor);
+
+void spectrum_free(spectrum_ctx *);
+
+int spectrum_add(spectrum_ctx *, const FP_FLOAT complex *);
+
+int spectrum_add_fixed(spectrum_ctx *, const fixed_complex *);
+
+int spectrum_ready(spectrum_ctx *);
+
+size_t spectrum_get_size(spectrum_ctx *);
+
+int spectrum_levels(spectrum_ctx *, FP_FLOAT *);
+
+int spectrum_serialize(spectrum_ctx *, struct timespec *, uint32_t, uint32_t, uint8_t *, size_t, size_t *);
+
+#endif
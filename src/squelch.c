@@ -0,0 +1,111 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <math.h>
+
+#include "squelch.h"
+#include "log.h"
+
+squelch_ctx *squelch_init(squelch_mode mode, int level, uint32_t hysteresis, size_t hang_blocks) {
+    squelch_ctx *ctx;
+
+    log_info("Initializing squelch context");
+
+    log_debug("Allocating squelch context");
+    ctx = (squelch_ctx *) malloc(sizeof(squelch_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate squelch context");
+        return NULL;
+    }
+
+    ctx->mode = mode;
+    ctx->open_level = (FP_FLOAT) level;
+    ctx->close_level = (FP_FLOAT) level - (FP_FLOAT) hysteresis;
+    ctx->hang_blocks = hang_blocks;
+    ctx->hang = 0;
+    ctx->noise = 0;
+    ctx->open = mode == SQUELCH_MODE_NONE;
+
+    log_debug("Open level: %.1f dB - Close level: %.1f dB - Hang: %zu blocks",
+              (double) ctx->open_level, (double) ctx->close_level, ctx->hang_blocks);
+
+    return ctx;
+}
+
+void squelch_free(squelch_ctx *ctx) {
+    log_info("Freeing squelch context");
+
+    if (ctx == NULL)
+        return;
+
+    free(ctx);
+}
+
+void squelch_reset(squelch_ctx *ctx) {
+    ctx->hang = 0;
+    ctx->noise = 0;
+    ctx->open = ctx->mode == SQUELCH_MODE_NONE;
+}
+
+int squelch_update(squelch_ctx *ctx, FP_FLOAT rms) {
+    FP_FLOAT power;
+    FP_FLOAT level;
+
+    power = rms * rms;
+    if (power < SQUELCH_POWER_MIN)
+        power = SQUELCH_POWER_MIN;
+
+    switch (ctx->mode) {
+        case SQUELCH_MODE_RMS:
+            level = 10 * log10(power);
+            break;
+
+        case SQUELCH_MODE_SNR:
+            if (ctx->noise == 0 || power < ctx->noise)
+                ctx->noise = power;
+            else if (!ctx->open)
+                ctx->noise *= (FP_FLOAT) SQUELCH_NOISE_RISE;
+
+            level = 10 * log10(power / ctx->noise);
+            break;
+
+        default:
+            return 1;
+    }
+
+    if (level >= ctx->open_level || (ctx->open && level >= ctx->close_level)) {
+        if (!ctx->open) {
+            log_debug("Squelch open at %.1f dB", (double) level);
+        }
+
+        ctx->open = 1;
+        ctx->hang = ctx->hang_blocks;
+    } else if (ctx->open) {
+        if (ctx->hang > 0) {
+            ctx->hang--;
+        } else {
+            log_debug("Squelch closed at %.1f dB", (double) level);
+            ctx->open = 0;
+        }
+    }
+
+    return ctx->open;
+}
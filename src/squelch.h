@@ -0,0 +1,67 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__SQUELCH__H
+#define __RTLSDR_RADIO__SQUELCH__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "buildflags.h"
+#include "cfg.h"
+
+/*
+ * Block squelch. Each block level is compared, in dB, against the open
+ * threshold (level) and the close threshold (level - hysteresis); once
+ * below the close threshold the squelch stays open for hang_blocks more
+ * blocks.
+ *
+ * In RMS mode the level is the block RMS in dBFS; in SNR mode it is the
+ * block power over a noise floor estimate which follows any drop at once
+ * and rises by SQUELCH_NOISE_RISE per block, only while closed.
+ */
+
+#define SQUELCH_NOISE_RISE 1.0023
+#define SQUELCH_POWER_MIN 1e-12
+
+struct squelch_ctx_t {
+    squelch_mode mode;
+
+    FP_FLOAT open_level;
+    FP_FLOAT close_level;
+
+    size_t hang_blocks;
+    size_t hang;
+
+    FP_FLOAT noise;
+
+    int open;
+};
+
+typedef struct squelch_ctx_t squelch_ctx;
+
+squelch_ctx *squelch_init(squelch_mode, int, uint32_t, size_t);
+
+void squelch_free(squelch_ctx *);
+
+void squelch_reset(squelch_ctx *);
+
+int squelch_update(squelch_ctx *, FP_FLOAT);
+
+#endif
@@ -0,0 +1,465 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <endian.h>
+#include <poll.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+
+#include "stream.h"
+#include "log.h"
+
+static void *stream_thread(void *);
+
+static int stream_connect(stream_ctx *);
+
+static void stream_disconnect(stream_ctx *);
+
+static int stream_write(stream_ctx *);
+
+static void stream_wait(stream_ctx *, int);
+
+static void stream_wake(stream_ctx *);
+
+stream_ctx *stream_init(const char *address, uint16_t port, size_t queue_size, size_t frame_size) {
+    stream_ctx *ctx;
+
+    log_info("Initializing stream context");
+
+    if (queue_size < 2) {
+        log_error("Stream queue needs at least 2 frames");
+        return NULL;
+    }
+
+    log_debug("Allocating stream context");
+    ctx = (stream_ctx *) calloc(1, sizeof(stream_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate stream context");
+        return NULL;
+    }
+
+    ctx->address = strdup(address);
+    ctx->port = port;
+    ctx->sck = -1;
+    ctx->backoff_ms = STREAM_BACKOFF_MIN_MS;
+
+    ctx->queue_size = queue_size;
+    ctx->frame_size = STREAM_LENGTH_SIZE + frame_size;
+
+    log_debug("Allocating stream queue");
+    ctx->frames = (uint8_t *) calloc(queue_size * ctx->frame_size, sizeof(uint8_t));
+    ctx->sizes = (size_t *) calloc(queue_size, sizeof(size_t));
+    ctx->wake_fd = eventfd(0, EFD_NONBLOCK);
+    if (ctx->address == NULL || ctx->frames == NULL || ctx->sizes == NULL || ctx->wake_fd == -1) {
+        log_error("Unable to allocate stream queue");
+        if (ctx->wake_fd != -1)
+            close(ctx->wake_fd);
+        free(ctx->sizes);
+        free(ctx->frames);
+        free(ctx->address);
+        free(ctx);
+        return NULL;
+    }
+
+    pthread_mutex_init(&ctx->mutex, NULL);
+
+    log_debug("Starting stream thread");
+    ctx->running = 1;
+    if (pthread_create(&ctx->thread, NULL, stream_thread, ctx) != 0) {
+        log_error("Unable to start stream thread");
+        ctx->running = 0;
+        stream_free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+void stream_free(stream_ctx *ctx) {
+    int running;
+
+    log_info("Freeing stream context");
+
+    if (ctx == NULL)
+        return;
+
+    pthread_mutex_lock(&ctx->mutex);
+    running = ctx->running;
+    ctx->running = 0;
+    pthread_mutex_unlock(&ctx->mutex);
+
+    if (running) {
+        log_debug("Joining stream thread");
+        stream_wake(ctx);
+        pthread_join(ctx->thread, NULL);
+    }
+
+    if (ctx->sck != -1)
+        close(ctx->sck);
+
+    close(ctx->wake_fd);
+    pthread_mutex_destroy(&ctx->mutex);
+
+    free(ctx->sizes);
+    free(ctx->frames);
+    free(ctx->address);
+    free(ctx);
+}
+
+int stream_push(stream_ctx *ctx, const uint8_t *header, size_t header_size, const uint8_t *data, size_t data_size) {
+    uint8_t *frame;
+    uint32_t length;
+    size_t size;
+    size_t next;
+
+    size = STREAM_LENGTH_SIZE + header_size + data_size;
+
+    pthread_mutex_lock(&ctx->mutex);
+
+    if (size > ctx->frame_size) {
+        ctx->dropped++;
+        pthread_mutex_unlock(&ctx->mutex);
+        log_error("Frame of %zu bytes too big for stream", size);
+        return EXIT_FAILURE;
+    }
+
+    if (ctx->count == ctx->queue_size) {
+        if (ctx->offset > 0) {
+            // Keep the frame being written, drop the one after it
+            next = (ctx->head + 1) % ctx->queue_size;
+            memcpy(ctx->frames + next * ctx->frame_size, ctx->frames + ctx->head * ctx->frame_size,
+                   ctx->sizes[ctx->head]);
+            ctx->sizes[next] = ctx->sizes[ctx->head];
+            ctx->head = next;
+        } else {
+            ctx->head = (ctx->head + 1) % ctx->queue_size;
+        }
+
+        ctx->count--;
+        ctx->dropped++;
+    }
+
+    frame = ctx->frames + ((ctx->head + ctx->count) % ctx->queue_size) * ctx->frame_size;
+
+    length = htole32((uint32_t) (header_size + data_size));
+    memcpy(frame, &length, STREAM_LENGTH_SIZE);
+    memcpy(frame + STREAM_LENGTH_SIZE, header, header_size);
+    if (data_size > 0)
+        memcpy(frame + STREAM_LENGTH_SIZE + header_size, data, data_size);
+
+    ctx->sizes[(ctx->head + ctx->count) % ctx->queue_size] = size;
+    ctx->count++;
+    ctx->queued++;
+
+    pthread_mutex_unlock(&ctx->mutex);
+
+    stream_wake(ctx);
+
+    return EXIT_SUCCESS;
+}
+
+int stream_push_batch(stream_ctx *ctx, network_batch *batch) {
+    struct iovec *iovecs;
+    size_t i;
+    int result;
+
+    result = EXIT_SUCCESS;
+
+    for (i = 0; i < batch->count; i++) {
+        iovecs = batch->iovecs + i * NETWORK_BATCH_IOVECS;
+        if (stream_push(ctx, (uint8_t *) iovecs[0].iov_base, iovecs[0].iov_len,
+                        (uint8_t *) iovecs[1].iov_base, iovecs[1].iov_len) != EXIT_SUCCESS)
+            result = EXIT_FAILURE;
+    }
+
+    batch->count = 0;
+
+    return result;
+}
+
+void stream_print_stats(stream_ctx *ctx) {
+    pthread_mutex_lock(&ctx->mutex);
+    log_info("Stream - Queued %llu - Sent %llu - Dropped %llu - Connections %llu",
+             (unsigned long long) ctx->queued, (unsigned long long) ctx->sent,
+             (unsigned long long) ctx->dropped, (unsigned long long) ctx->connections);
+    pthread_mutex_unlock(&ctx->mutex);
+}
+
+static void *stream_thread(void *arg) {
+    stream_ctx *ctx;
+    struct pollfd fds[2];
+    uint8_t discard[64];
+    ssize_t ln;
+    socklen_t error_len;
+    int error;
+    int running;
+    int pending;
+
+    ctx = (stream_ctx *) arg;
+
+    prctl(PR_SET_NAME, "stream");
+    log_info("Thread start");
+
+    for (;;) {
+        pthread_mutex_lock(&ctx->mutex);
+        running = ctx->running;
+        pending = ctx->count > 0;
+        pthread_mutex_unlock(&ctx->mutex);
+
+        if (!running)
+            break;
+
+        if (ctx->sck == -1 && stream_connect(ctx) != EXIT_SUCCESS) {
+            stream_wait(ctx, (int) ctx->backoff_ms);
+            continue;
+        }
+
+        fds[0].fd = ctx->sck;
+        fds[0].events = ctx->connected ? (short) (POLLIN | (pending ? POLLOUT : 0)) : POLLOUT;
+        fds[0].revents = 0;
+        fds[1].fd = ctx->wake_fd;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+
+        if (poll(fds, 2, STREAM_POLL_MS) == -1 && errno != EINTR) {
+            log_error("Error polling stream socket");
+            continue;
+        }
+
+        if (fds[1].revents & POLLIN)
+            stream_wait(ctx, 0);
+
+        if (!ctx->connected) {
+            if (!(fds[0].revents & (POLLOUT | POLLERR | POLLHUP)))
+                continue;
+
+            error = 0;
+            error_len = sizeof(error);
+            getsockopt(ctx->sck, SOL_SOCKET, SO_ERROR, &error, &error_len);
+            if (error != 0) {
+                log_debug("Unable to connect to %s:%u: %s", ctx->address, ctx->port, strerror(error));
+                stream_disconnect(ctx);
+                continue;
+            }
+
+            log_info("Connected to %s:%u", ctx->address, ctx->port);
+            ctx->connected = 1;
+            ctx->backoff_ms = STREAM_BACKOFF_MIN_MS;
+
+            pthread_mutex_lock(&ctx->mutex);
+            ctx->connections++;
+            pthread_mutex_unlock(&ctx->mutex);
+
+            continue;
+        }
+
+        if (fds[0].revents & (POLLERR | POLLHUP)) {
+            log_warn("Stream connection lost");
+            stream_disconnect(ctx);
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            ln = recv(ctx->sck, discard, sizeof(discard), MSG_DONTWAIT);
+            if (ln == 0 || (ln == -1 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                log_warn("Stream connection closed by peer");
+                stream_disconnect(ctx);
+                continue;
+            }
+        }
+
+        if ((fds[0].revents & POLLOUT) && stream_write(ctx) != EXIT_SUCCESS) {
+            log_warn("Stream write failed");
+            stream_disconnect(ctx);
+        }
+    }
+
+    log_info("Thread end");
+
+    return NULL;
+}
+
+static int stream_connect(stream_ctx *ctx) {
+    int result;
+    int flag;
+    char port[6];
+    struct addrinfo hints;
+    struct addrinfo *addresses_list;
+    struct addrinfo *address;
+
+    log_debug("Connecting to %s:%u", ctx->address, ctx->port);
+
+    memset(&hints, '\0', sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    sprintf(port, "%u", ctx->port);
+    result = getaddrinfo(ctx->address, port, &hints, &addresses_list);
+    if (result != 0) {
+        log_error("Error %d in getaddrinfo: %s", result, gai_strerror(result));
+        ctx->backoff_ms = ctx->backoff_ms * 2 < STREAM_BACKOFF_MAX_MS ? ctx->backoff_ms * 2 : STREAM_BACKOFF_MAX_MS;
+        return EXIT_FAILURE;
+    }
+
+    for (address = addresses_list; address != NULL; address = address->ai_next) {
+        ctx->sck = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK, address->ai_protocol);
+        if (ctx->sck == -1)
+            continue;
+
+        flag = 1;
+        setsockopt(ctx->sck, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+        if (connect(ctx->sck, address->ai_addr, address->ai_addrlen) == 0) {
+            ctx->connected = 1;
+            break;
+        }
+
+        if (errno == EINPROGRESS) {
+            ctx->connected = 0;
+            break;
+        }
+
+        close(ctx->sck);
+        ctx->sck = -1;
+    }
+
+    freeaddrinfo(addresses_list);
+
+    if (ctx->sck == -1) {
+        ctx->backoff_ms = ctx->backoff_ms * 2 < STREAM_BACKOFF_MAX_MS ? ctx->backoff_ms * 2 : STREAM_BACKOFF_MAX_MS;
+        return EXIT_FAILURE;
+    }
+
+    if (ctx->connected) {
+        log_info("Connected to %s:%u", ctx->address, ctx->port);
+        ctx->backoff_ms = STREAM_BACKOFF_MIN_MS;
+
+        pthread_mutex_lock(&ctx->mutex);
+        ctx->connections++;
+        pthread_mutex_unlock(&ctx->mutex);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void stream_disconnect(stream_ctx *ctx) {
+    close(ctx->sck);
+    ctx->sck = -1;
+    ctx->connected = 0;
+
+    pthread_mutex_lock(&ctx->mutex);
+    ctx->offset = 0;
+    pthread_mutex_unlock(&ctx->mutex);
+
+    log_debug("Reconnecting in %u ms", ctx->backoff_ms);
+    stream_wait(ctx, (int) ctx->backoff_ms);
+
+    ctx->backoff_ms = ctx->backoff_ms * 2 < STREAM_BACKOFF_MAX_MS ? ctx->backoff_ms * 2 : STREAM_BACKOFF_MAX_MS;
+}
+
+static int stream_write(stream_ctx *ctx) {
+    uint8_t *frame;
+    size_t size;
+    ssize_t ln;
+    int result;
+
+    result = EXIT_SUCCESS;
+
+    pthread_mutex_lock(&ctx->mutex);
+
+    while (ctx->count > 0) {
+        frame = ctx->frames + ctx->head * ctx->frame_size;
+        size = ctx->sizes[ctx->head];
+
+        ln = send(ctx->sck, frame + ctx->offset, size - ctx->offset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (ln == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                result = EXIT_FAILURE;
+            break;
+        }
+
+        ctx->offset += (size_t) ln;
+        if (ctx->offset < size)
+            break;
+
+        ctx->head = (ctx->head + 1) % ctx->queue_size;
+        ctx->count--;
+        ctx->offset = 0;
+        ctx->sent++;
+    }
+
+    pthread_mutex_unlock(&ctx->mutex);
+
+    return result;
+}
+
+static void stream_wait(stream_ctx *ctx, int ms) {
+    struct pollfd fd;
+    struct timespec now;
+    int64_t deadline;
+    int64_t remaining;
+    uint64_t value;
+    int running;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    deadline = (int64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000 + ms;
+
+    fd.fd = ctx->wake_fd;
+    fd.events = POLLIN;
+
+    // New frames wake the thread up too, only a stop request cuts the wait short
+    for (;;) {
+        while (read(ctx->wake_fd, &value, sizeof(value)) == sizeof(value));
+
+        pthread_mutex_lock(&ctx->mutex);
+        running = ctx->running;
+        pthread_mutex_unlock(&ctx->mutex);
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        remaining = deadline - ((int64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000);
+
+        if (!running || remaining <= 0)
+            break;
+
+        fd.revents = 0;
+        poll(&fd, 1, (int) remaining);
+    }
+}
+
+static void stream_wake(stream_ctx *ctx) {
+    uint64_t value;
+
+    value = 1;
+    if (write(ctx->wake_fd, &value, sizeof(value)) != sizeof(value)) {
+        log_trace("Stream already woken up");
+    }
+}
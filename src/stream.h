@@ -0,0 +1,87 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__STREAM__H
+#define __RTLSDR_RADIO__STREAM__H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "network.h"
+
+/*
+ * TCP output for payloads. Every datagram is sent as a frame made of its
+ * size (uint32, same byte order as the payload fields) followed by the
+ * datagram itself.
+ *
+ * Producers copy frames into a bounded queue and never block on the
+ * network: when the queue is full the oldest frame not yet being written
+ * is dropped and counted. A writer thread owned by the context connects,
+ * writes with non-blocking sends driven by poll and, on any error,
+ * reconnects with an exponential backoff. A frame cut by a disconnection
+ * is sent again from the start on the new connection.
+ */
+
+#define STREAM_LENGTH_SIZE 4
+#define STREAM_BACKOFF_MIN_MS 100
+#define STREAM_BACKOFF_MAX_MS 5000
+#define STREAM_POLL_MS 200
+
+struct stream_ctx_t {
+    char *address;
+    uint16_t port;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    int running;
+
+    int sck;
+    int connected;
+    int wake_fd;
+    uint32_t backoff_ms;
+
+    size_t queue_size;
+    size_t frame_size;
+    uint8_t *frames;
+    size_t *sizes;
+
+    size_t head;
+    size_t count;
+    size_t offset;
+
+    uint64_t queued;
+    uint64_t sent;
+    uint64_t dropped;
+    uint64_t connections;
+};
+
+typedef struct stream_ctx_t stream_ctx;
+
+stream_ctx *stream_init(const char *, uint16_t, size_t, size_t);
+
+void stream_free(stream_ctx *);
+
+int stream_push(stream_ctx *, const uint8_t *, size_t, const uint8_t *, size_t);
+
+int stream_push_batch(stream_ctx *, network_batch *);
+
+void stream_print_stats(stream_ctx *);
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <math.h>
+
+#include "survey.h"
+#include "spectrum.h"
+#include "utils.h"
+#include "log.h"
+
+static int survey_write_csv(survey_ctx *, FILE *, const struct timespec *, uint32_t, size_t, const FP_FLOAT *);
+
+static int survey_write_binary(survey_ctx *, FILE *, const struct timespec *, uint32_t, const FP_FLOAT *);
+
+survey_ctx *survey_init(uint32_t start, uint32_t stop, uint32_t sample_rate, size_t size, uint32_t crop) {
+    survey_ctx *ctx;
+
+    log_info("Initializing survey context");
+
+    if (stop <= start || sample_rate == 0 || size < 4 || size > UINT16_MAX || crop >= 50) {
+        log_error("Invalid survey range, size or crop");
+        return NULL;
+    }
+
+    log_debug("Allocating survey context");
+    ctx = (survey_ctx *) malloc(sizeof(survey_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate survey context");
+        return NULL;
+    }
+
+    ctx->start = start;
+    ctx->stop = stop;
+    ctx->sample_rate = sample_rate;
+
+    ctx->size = size;
+    ctx->crop = size * crop / 100;
+    ctx->bins = size - 2 * ctx->crop;
+
+    ctx->bin_width = (double) sample_rate / (double) size;
+    ctx->hop_width = ctx->bin_width * (double) ctx->bins;
+
+    ctx->hops = (size_t) ceil((double) (stop - start) / ctx->hop_width);
+
+    log_debug("Hops: %zu - Bins per hop: %zu - Bin width: %.1f Hz", ctx->hops, ctx->bins, ctx->bin_width);
+
+    return ctx;
+}
+
+void survey_free(survey_ctx *ctx) {
+    log_info("Freeing survey context");
+
+    if (ctx == NULL)
+        return;
+
+    free(ctx);
+}
+
+uint32_t survey_hop_frequency(survey_ctx *ctx, size_t hop) {
+    double low;
+
+    low = (double) ctx->start + (double) hop * ctx->hop_width;
+
+    return (uint32_t) lround(low + ((double) (ctx->size / 2) - (double) ctx->crop) * ctx->bin_width);
+}
+
+double survey_hop_low(survey_ctx *ctx, uint32_t frequency) {
+    return (double) frequency - ((double) (ctx->size / 2) - (double) ctx->crop) * ctx->bin_width;
+}
+
+int survey_write(survey_ctx *ctx, survey_format format, FILE *fd, const struct timespec *ts, uint32_t frequency,
+                 size_t samples, const FP_FLOAT *levels) {
+    switch (format) {
+        case SURVEY_FORMAT_CSV:
+            return survey_write_csv(ctx, fd, ts, frequency, samples, levels);
+
+        case SURVEY_FORMAT_BINARY:
+            return survey_write_binary(ctx, fd, ts, frequency, levels);
+
+        default:
+            log_error("Survey format not implemented");
+            return EXIT_FAILURE;
+    }
+}
+
+static int survey_write_csv(survey_ctx *ctx, FILE *fd, const struct timespec *ts, uint32_t frequency,
+                            size_t samples, const FP_FLOAT *levels) {
+    char datetime[32];
+    struct tm timeinfo;
+    double low;
+    size_t i;
+
+    gmtime_r(&ts->tv_sec, &timeinfo);
+    strftime(datetime, sizeof(datetime), "%Y-%m-%d, %H:%M:%S", &timeinfo);
+
+    low = survey_hop_low(ctx, frequency);
+
+    fprintf(fd, "%s, %.0f, %.0f, %.2f, %zu", datetime, low, low + ctx->hop_width, ctx->bin_width, samples);
+
+    for (i = 0; i < ctx->bins; i++)
+        fprintf(fd, ", %.2f", (double) levels[ctx->crop + i]);
+
+    if (fprintf(fd, "\n") < 0) {
+        log_error("Unable to write survey line");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int survey_write_binary(survey_ctx *ctx, FILE *fd, const struct timespec *ts, uint32_t frequency,
+                               const FP_FLOAT *levels) {
+    uint8_t header[3 + 8 + 4 + 4 + 2];
+    uint8_t *bins;
+    FP_FLOAT level;
+    size_t ln;
+    size_t i;
+
+    ln = 0;
+
+    memcpy(header + ln, SURVEY_HEADER, strlen(SURVEY_HEADER));
+    ln += strlen(SURVEY_HEADER);
+
+    utils_uint64_to_be(header + ln, (uint64_t) ts->tv_sec * 1000 + (uint64_t) ts->tv_nsec / 1000000);
+    ln += sizeof(uint64_t);
+
+    utils_uint32_to_be(header + ln, (uint32_t) lround(survey_hop_low(ctx, frequency)));
+    ln += sizeof(uint32_t);
+
+    utils_uint32_to_be(header + ln, (uint32_t) lround(ctx->bin_width * 1000));
+    ln += sizeof(uint32_t);
+
+    utils_uint16_to_be(header + ln, (uint16_t) ctx->bins);
+    ln += sizeof(uint16_t);
+
+    bins = (uint8_t *) malloc(ctx->bins);
+    if (bins == NULL) {
+        log_error("Unable to allocate survey record");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < ctx->bins; i++) {
+        level = (levels[ctx->crop + i] - (FP_FLOAT) SPECTRUM_DB_MIN) * SPECTRUM_DB_STEPS;
+
+        if (level < 0)
+            bins[i] = 0;
+        else if (level > UINT8_MAX)
+            bins[i] = UINT8_MAX;
+        else
+            bins[i] = (uint8_t) lround((double) level);
+    }
+
+    if (fwrite(header, sizeof(uint8_t), ln, fd) != ln || fwrite(bins, sizeof(uint8_t), ctx->bins, fd) != ctx->bins) {
+        log_error("Unable to write survey record");
+        free(bins);
+        return EXIT_FAILURE;
+    }
+
+    free(bins);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__SURVEY__H
+#define __RTLSDR_RADIO__SURVEY__H
+
+/*
+
+# 0         1         2         3
+# 0123456789012345678901234567890123
+# GFWttttttttLLLLSSSSBBbbbb...
+
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "buildflags.h"
+#include "cfg.h"
+
+/*
+ * Hop plan and output of a wideband power survey.
+ *
+ * The range from start to stop is covered by hops of size FFT bins each,
+ * dropping crop percent of the bins on each edge, where the tuner filter
+ * rolls off, so that kept bins of adjacent hops are contiguous.
+ *
+ * Every hop is written as one CSV line (rtl_power layout: date, time, low
+ * Hz, high Hz, bin width Hz, samples, dB...) or as one binary record with
+ * the timestamp in ms, the first bin frequency, the bin width in mHz and
+ * one byte per bin quantized like the spectrum frames.
+ */
+
+#define SURVEY_HEADER "GFW"
+
+struct survey_ctx_t {
+    uint32_t start;
+    uint32_t stop;
+    uint32_t sample_rate;
+
+    size_t size;
+    size_t crop;
+    size_t bins;
+
+    double bin_width;
+    double hop_width;
+
+    size_t hops;
+};
+
+typedef struct survey_ctx_t survey_ctx;
+
+survey_ctx *survey_init(uint32_t, uint32_t, uint32_t, size_t, uint32_t);
+
+void survey_free(survey_ctx *);
+
+uint32_t survey_hop_frequency(survey_ctx *, size_t);
+
+double survey_hop_low(survey_ctx *, uint32_t);
+
+int survey_write(survey_ctx *, survey_format, FILE *, const struct timespec *, uint32_t, size_t, const FP_FLOAT *);
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <math.h>
+
+#include "tone.h"
+#include "fixed.h"
+#include "log.h"
+
+static const uint16_t tone_ctcss[TONE_COUNT] = {
+        670, 693, 719, 744, 770, 797, 825, 854, 885, 915,
+        948, 974, 1000, 1035, 1072, 1109, 1148, 1188, 1230, 1273,
+        1318, 1365, 1413, 1462, 1500, 1514, 1567, 1598, 1622, 1655,
+        1679, 1713, 1738, 1773, 1799, 1835, 1862, 1899, 1928, 1966,
+        1995, 2035, 2065, 2107, 2181, 2257, 2291, 2336, 2418, 2503,
+        2541
+};
+
+static void tone_push(tone_ctx *, FP_FLOAT);
+
+static void tone_evaluate(tone_ctx *);
+
+ssize_t tone_index(uint32_t tone) {
+    size_t i;
+
+    for (i = 0; i < TONE_COUNT; i++)
+        if (tone_ctcss[i] == tone)
+            return (ssize_t) i;
+
+    return -1;
+}
+
+tone_ctx *tone_init(uint32_t sample_rate, uint32_t tone) {
+    tone_ctx *ctx;
+    ssize_t target;
+    double rate;
+    size_t i;
+
+    log_info("Initializing tone context");
+
+    target = tone_index(tone);
+    if (target < 0) {
+        log_error("Tone %u.%u Hz is not a standard CTCSS tone", tone / 10, tone % 10);
+        return NULL;
+    }
+
+    log_debug("Allocating tone context");
+    ctx = (tone_ctx *) calloc(1, sizeof(tone_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate tone context");
+        return NULL;
+    }
+
+    ctx->decimation = sample_rate / TONE_RATE > 0 ? sample_rate / TONE_RATE : 1;
+    rate = (double) sample_rate / (double) ctx->decimation;
+
+    ctx->window = (size_t) (rate * TONE_WINDOW_MS / 1000);
+    ctx->target = (size_t) target;
+
+    for (i = 0; i < TONE_COUNT; i++)
+        ctx->coeff[i] = (FP_FLOAT) (2 * cos(2 * M_PI * tone_ctcss[i] / 10.0 / rate));
+
+    log_debug("Decimation: %zu - Window: %zu samples at %.1f Hz", ctx->decimation, ctx->window, rate);
+
+    return ctx;
+}
+
+void tone_free(tone_ctx *ctx) {
+    log_info("Freeing tone context");
+
+    if (ctx == NULL)
+        return;
+
+    free(ctx);
+}
+
+void tone_reset(tone_ctx *ctx) {
+    size_t i;
+
+    ctx->decimation_count = 0;
+    ctx->accumulator = 0;
+    ctx->accumulator_fixed = 0;
+
+    ctx->window_count = 0;
+    ctx->energy = 0;
+
+    for (i = 0; i < TONE_COUNT; i++) {
+        ctx->s1[i] = 0;
+        ctx->s2[i] = 0;
+    }
+
+    ctx->open = 0;
+}
+
+int tone_update(tone_ctx *ctx, const FP_FLOAT *audio, size_t size) {
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        ctx->accumulator += audio[i];
+
+        if (++ctx->decimation_count == ctx->decimation) {
+            tone_push(ctx, ctx->accumulator / (FP_FLOAT) ctx->decimation);
+            ctx->accumulator = 0;
+            ctx->decimation_count = 0;
+        }
+    }
+
+    return ctx->open;
+}
+
+int tone_update_fixed(tone_ctx *ctx, const int16_t *audio, size_t size) {
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        ctx->accumulator_fixed += audio[i];
+
+        if (++ctx->decimation_count == ctx->decimation) {
+            tone_push(ctx, (FP_FLOAT) ctx->accumulator_fixed / (FP_FLOAT) ctx->decimation / FIXED_Q15_ONE);
+            ctx->accumulator_fixed = 0;
+            ctx->decimation_count = 0;
+        }
+    }
+
+    return ctx->open;
+}
+
+static void tone_push(tone_ctx *ctx, FP_FLOAT sample) {
+    FP_FLOAT s0;
+    size_t i;
+
+    for (i = 0; i < TONE_COUNT; i++) {
+        s0 = sample + ctx->coeff[i] * ctx->s1[i] - ctx->s2[i];
+        ctx->s2[i] = ctx->s1[i];
+        ctx->s1[i] = s0;
+    }
+
+    ctx->energy += sample * sample;
+
+    if (++ctx->window_count == ctx->window)
+        tone_evaluate(ctx);
+}
+
+static void tone_evaluate(tone_ctx *ctx) {
+    FP_FLOAT power[TONE_COUNT];
+    FP_FLOAT strongest;
+    FP_FLOAT reference;
+    size_t i;
+
+    strongest = 0;
+
+    for (i = 0; i < TONE_COUNT; i++) {
+        power[i] = ctx->s1[i] * ctx->s1[i] + ctx->s2[i] * ctx->s2[i] - ctx->coeff[i] * ctx->s1[i] * ctx->s2[i];
+        if (power[i] > strongest)
+            strongest = power[i];
+
+        ctx->s1[i] = 0;
+        ctx->s2[i] = 0;
+    }
+
+    reference = ctx->energy * (FP_FLOAT) ctx->window / 2;
+
+    ctx->open = reference > 0
+                && power[ctx->target] >= (FP_FLOAT) TONE_ENERGY_RATIO * reference
+                && power[ctx->target] >= (FP_FLOAT) TONE_NEIGHBOUR_RATIO * strongest;
+
+    log_trace("Tone power ratio: %.3f - Open: %d", (double) (reference > 0 ? power[ctx->target] / reference : 0),
+              ctx->open);
+
+    ctx->energy = 0;
+    ctx->window_count = 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__TONE__H
+#define __RTLSDR_RADIO__TONE__H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "buildflags.h"
+
+/*
+ * CTCSS tone detector on demodulated audio.
+ *
+ * Audio is decimated by plain accumulation to about TONE_RATE and fed to a
+ * bank of Goertzel filters, one per standard CTCSS tone. Every
+ * TONE_WINDOW_MS the bank is evaluated: the gate opens when the wanted tone
+ * carries at least TONE_ENERGY_RATIO of the decimated energy and is within
+ * TONE_NEIGHBOUR_RATIO of the strongest tone, since the closest standard
+ * tones are nearer than the bin width of the window. The decision then
+ * holds until the next window.
+ *
+ * Tones are expressed in tenths of Hz.
+ */
+
+#define TONE_COUNT 51
+#define TONE_RATE 1000
+#define TONE_WINDOW_MS 400
+#define TONE_ENERGY_RATIO 0.1
+#define TONE_NEIGHBOUR_RATIO 0.5
+
+struct tone_ctx_t {
+    size_t decimation;
+    size_t decimation_count;
+    FP_FLOAT accumulator;
+    int32_t accumulator_fixed;
+
+    size_t window;
+    size_t window_count;
+
+    size_t target;
+
+    FP_FLOAT coeff[TONE_COUNT];
+    FP_FLOAT s1[TONE_COUNT];
+    FP_FLOAT s2[TONE_COUNT];
+    FP_FLOAT energy;
+
+    int open;
+};
+
+typedef struct tone_ctx_t tone_ctx;
+
+ssize_t tone_index(uint32_t);
+
+tone_ctx *tone_init(uint32_t, uint32_t);
+
+void tone_free(tone_ctx *);
+
+void tone_reset(tone_ctx *);
+
+int tone_update(tone_ctx *, const FP_FLOAT *, size_t);
+
+int tone_update_fixed(tone_ctx *, const int16_t *, size_t);
+
+#endif
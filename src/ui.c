@@ -106,6 +106,10 @@ void ui_help() {
     ui_message("    -m | --mode              Working mode (%s)\n", cfg_tochar_work_mode(CONFIG_MODE_DEFAULT));
     ui_message("                             - rx (Receiver)\n");
     ui_message("                             - info (Devices info)\n");
+    ui_message("                             - scan (Receiver scanning scan_freqs)\n");
+    ui_message("                             - survey (Wideband power survey)\n");
+    ui_message("                             - play (Decode and play received audio)\n");
+    ui_message("                             - vote (Combine the streams of several receivers)\n");
     ui_message("\n");
     ui_message("\n");
     ui_message("\n");
@@ -137,12 +137,8 @@ int utils_rtrim(char *dst, char *src, size_t size) {
 
     strncpy(dst, src, size);
 
-    s = dst;
-    while (*s != '\0') s++;
-    s--;
-
-    while (s != src && isspace(*s)) s--;
-    s++;
+    s = dst + strlen(dst);
+    while (s != dst && isspace(*(s - 1))) s--;
     *s = '\0';
 
     return EXIT_SUCCESS;
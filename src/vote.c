@@ -0,0 +1,243 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+#include <math.h>
+
+#include "vote.h"
+#include "log.h"
+
+static uint64_t vote_key(vote_ctx *, uint64_t);
+
+vote_ctx *vote_init(size_t receivers_size, size_t slots_size, uint32_t window_ms) {
+    vote_ctx *ctx;
+    size_t r;
+
+    log_info("Initializing voting combiner");
+
+    if (receivers_size == 0 || slots_size < 2) {
+        log_error("Voting combiner needs at least 1 receiver and 2 slots");
+        return NULL;
+    }
+
+    log_debug("Allocating voting combiner context");
+    ctx = (vote_ctx *) calloc(1, sizeof(vote_ctx));
+    if (ctx == NULL) {
+        log_error("Unable to allocate voting combiner context");
+        return NULL;
+    }
+
+    ctx->receivers_size = receivers_size;
+    ctx->slots_size = slots_size;
+    ctx->window_ms = window_ms;
+
+    log_debug("Allocating receivers and slots");
+    ctx->receivers = (vote_receiver *) calloc(receivers_size, sizeof(vote_receiver));
+    ctx->pending = (vote_pending *) calloc(slots_size, sizeof(vote_pending));
+    if (ctx->receivers == NULL || ctx->pending == NULL) {
+        log_error("Unable to allocate receivers and slots");
+        vote_free(ctx);
+        return NULL;
+    }
+
+    for (r = 0; r < receivers_size; r++) {
+        ctx->receivers[r].frames = (vote_frame *) calloc(slots_size, sizeof(vote_frame));
+        if (ctx->receivers[r].frames == NULL) {
+            log_error("Unable to allocate receiver ring");
+            vote_free(ctx);
+            return NULL;
+        }
+    }
+
+    return ctx;
+}
+
+void vote_free(vote_ctx *ctx) {
+    size_t r;
+
+    log_info("Freeing voting combiner");
+
+    if (ctx == NULL)
+        return;
+
+    if (ctx->receivers != NULL)
+        for (r = 0; r < ctx->receivers_size; r++)
+            free(ctx->receivers[r].frames);
+
+    free(ctx->receivers);
+    free(ctx->pending);
+    free(ctx);
+}
+
+void vote_set_frame_ms(vote_ctx *ctx, double frame_ms) {
+    if (frame_ms == ctx->frame_ms)
+        return;
+
+    log_debug("Frame duration: %.1f ms", frame_ms);
+    ctx->frame_ms = frame_ms;
+    ctx->started = 0;
+}
+
+int vote_put(vote_ctx *ctx, size_t receiver, uint32_t id, uint64_t timestamp, uint64_t arrival, float rms,
+             const uint8_t *data, size_t size) {
+    vote_receiver *rcv;
+    vote_frame *frame;
+    vote_pending *pending;
+    uint64_t key;
+
+    if (receiver >= ctx->receivers_size || size > VOTE_DATA_SIZE_MAX || ctx->frame_ms <= 0) {
+        log_error("Unable to store frame of %zu bytes from receiver %zu", size, receiver);
+        return EXIT_FAILURE;
+    }
+
+    rcv = &ctx->receivers[receiver];
+    rcv->used = 1;
+    rcv->id = id;
+    rcv->last_arrival = arrival;
+
+    if (!ctx->started) {
+        ctx->phase_ms = fmod((double) timestamp, ctx->frame_ms);
+        ctx->started = 1;
+        ctx->next = vote_key(ctx, timestamp);
+        ctx->last = ctx->next;
+    }
+
+    key = vote_key(ctx, timestamp);
+
+    if (key < ctx->next) {
+        log_trace("Late frame %llu from receiver %u", (unsigned long long) key, id);
+        rcv->late++;
+        ctx->late++;
+        return EXIT_SUCCESS;
+    }
+
+    if (ctx->last < ctx->next && key > ctx->next) {
+        // Nothing pending, the keys since the last transmission are idle time and not lost frames
+        log_debug("Frame %llu starts a new transmission", (unsigned long long) key);
+        ctx->next = key;
+    } else if (key >= ctx->next + ctx->slots_size) {
+        log_debug("Frame %llu out of window, resynchronizing", (unsigned long long) key);
+        ctx->next = key + 1 - ctx->slots_size;
+    }
+
+    if (key > ctx->last)
+        ctx->last = key;
+
+    frame = &rcv->frames[key % ctx->slots_size];
+    if (frame->full && frame->key == key)
+        return EXIT_SUCCESS;
+
+    frame->key = key;
+    frame->full = 1;
+    frame->timestamp = timestamp;
+    frame->rms = rms;
+    frame->size = size;
+    memcpy(frame->data, data, size);
+
+    pending = &ctx->pending[key % ctx->slots_size];
+    if (!pending->used || pending->key != key) {
+        pending->key = key;
+        pending->used = 1;
+        pending->first_arrival = arrival;
+        pending->count = 0;
+    }
+
+    pending->count++;
+    rcv->received++;
+
+    return EXIT_SUCCESS;
+}
+
+vote_status vote_select(vote_ctx *ctx, uint64_t now, vote_result *result) {
+    vote_pending *pending;
+    vote_receiver *rcv;
+    vote_frame *frame;
+    vote_frame *best;
+    size_t active;
+    size_t r;
+
+    if (!ctx->started)
+        return VOTE_EMPTY;
+
+    pending = &ctx->pending[ctx->next % ctx->slots_size];
+    if (!pending->used || pending->key != ctx->next) {
+        if (ctx->last <= ctx->next)
+            return VOTE_EMPTY;
+
+        log_trace("No receiver delivered frame %llu", (unsigned long long) ctx->next);
+        ctx->next++;
+        ctx->lost++;
+        return VOTE_LOST;
+    }
+
+    active = 0;
+    for (r = 0; r < ctx->receivers_size; r++)
+        if (ctx->receivers[r].used && ctx->receivers[r].last_arrival + VOTE_RECEIVER_TIMEOUT_MS >= now)
+            active++;
+
+    if (pending->count < active && now < pending->first_arrival + ctx->window_ms)
+        return VOTE_EMPTY;
+
+    best = NULL;
+    for (r = 0; r < ctx->receivers_size; r++) {
+        rcv = &ctx->receivers[r];
+        frame = &rcv->frames[ctx->next % ctx->slots_size];
+        if (!frame->full || frame->key != ctx->next)
+            continue;
+
+        frame->full = 0;
+
+        if (best == NULL || frame->rms > best->rms) {
+            best = frame;
+            result->receiver = r;
+        }
+    }
+
+    pending->used = 0;
+
+    if (best == NULL) {
+        ctx->next++;
+        ctx->lost++;
+        return VOTE_LOST;
+    }
+
+    result->key = ctx->next;
+    result->timestamp = best->timestamp;
+    result->rms = best->rms;
+    result->data = best->data;
+    result->size = best->size;
+    result->latency = now > pending->first_arrival ? now - pending->first_arrival : 0;
+
+    ctx->receivers[result->receiver].selected++;
+    ctx->next++;
+    ctx->selected++;
+
+    ctx->latency_sum += result->latency;
+    ctx->latency_count++;
+    if (result->latency > ctx->latency_max)
+        ctx->latency_max = result->latency;
+
+    return VOTE_FRAME;
+}
+
+static uint64_t vote_key(vote_ctx *ctx, uint64_t timestamp) {
+    return (uint64_t) floor(((double) timestamp - ctx->phase_ms) / ctx->frame_ms + 0.5);
+}
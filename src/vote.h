@@ -0,0 +1,135 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__VOTE__H
+#define __RTLSDR_RADIO__VOTE__H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Voting combiner for the streams of several receivers on the same channel.
+ *
+ * Frames are aligned by timestamp: the first frame fixes the phase, then
+ * every timestamp is rounded to a key counting frame periods, so frames of
+ * different receivers within half a frame map to the same key. Receiver
+ * clocks are expected to be synchronized (NTP or better).
+ *
+ * Each receiver owns a preallocated ring of slots indexed by key. A key is
+ * decided as soon as every active receiver delivered it, or window ms after
+ * its first arrival, picking the frame with the highest rms. The selection
+ * latency is the time between the first arrival and the decision.
+ */
+
+#define VOTE_DATA_SIZE_MAX 1024
+#define VOTE_RECEIVER_TIMEOUT_MS 1000
+
+enum vote_status_t {
+    VOTE_FRAME = 0,
+    VOTE_LOST = 1,
+    VOTE_EMPTY = 2
+};
+
+typedef enum vote_status_t vote_status;
+
+struct vote_frame_t {
+    uint64_t key;
+    int full;
+
+    uint64_t timestamp;
+    float rms;
+
+    size_t size;
+    uint8_t data[VOTE_DATA_SIZE_MAX];
+};
+
+struct vote_pending_t {
+    uint64_t key;
+    int used;
+
+    uint64_t first_arrival;
+    size_t count;
+};
+
+struct vote_receiver_t {
+    int used;
+    uint32_t id;
+    uint64_t last_arrival;
+
+    struct vote_frame_t *frames;
+
+    uint64_t received;
+    uint64_t late;
+    uint64_t selected;
+};
+
+struct vote_ctx_t {
+    size_t receivers_size;
+    struct vote_receiver_t *receivers;
+
+    size_t slots_size;
+    struct vote_pending_t *pending;
+
+    uint32_t window_ms;
+    double frame_ms;
+    double phase_ms;
+
+    int started;
+    uint64_t next;
+    uint64_t last;
+
+    uint64_t selected;
+    uint64_t lost;
+    uint64_t late;
+
+    uint64_t latency_sum;
+    uint64_t latency_count;
+    uint64_t latency_max;
+};
+
+struct vote_result_t {
+    size_t receiver;
+    uint64_t key;
+
+    uint64_t timestamp;
+    float rms;
+
+    const uint8_t *data;
+    size_t size;
+
+    uint64_t latency;
+};
+
+typedef struct vote_frame_t vote_frame;
+typedef struct vote_pending_t vote_pending;
+typedef struct vote_receiver_t vote_receiver;
+typedef struct vote_ctx_t vote_ctx;
+typedef struct vote_result_t vote_result;
+
+vote_ctx *vote_init(size_t, size_t, uint32_t);
+
+void vote_free(vote_ctx *);
+
+void vote_set_frame_ms(vote_ctx *, double);
+
+int vote_put(vote_ctx *, size_t, uint32_t, uint64_t, uint64_t, float, const uint8_t *, size_t);
+
+vote_status vote_select(vote_ctx *, uint64_t, vote_result *);
+
+#endif
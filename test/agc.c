@@ -0,0 +1,157 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "agc.h"
+#include "../src/fixed.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_agc_init),
+        cmocka_unit_test(test_agc_peak),
+        cmocka_unit_test(test_agc_level),
+        cmocka_unit_test(test_agc_level_fixed),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("agc", tests, NULL, NULL);
+}
+
+void test_agc_init(void **state) {
+    (void) state;
+
+    agc_ctx *ctx;
+
+    assert_null(agc_init(0, TEST_AGC_INPUT_SIZE, TEST_AGC_ATTACK, TEST_AGC_DECAY));
+    assert_null(agc_init(TEST_AGC_SAMPLE_RATE, 0, TEST_AGC_ATTACK, TEST_AGC_DECAY));
+
+    ctx = agc_init(TEST_AGC_SAMPLE_RATE, TEST_AGC_INPUT_SIZE, TEST_AGC_ATTACK, TEST_AGC_DECAY);
+    assert_non_null(ctx);
+    assert_int_equal(AGC_SEGMENTS, ctx->segments);
+    assert_int_equal(TEST_AGC_INPUT_SIZE / AGC_SEGMENTS, ctx->segment_size);
+    agc_free(ctx);
+
+    ctx = agc_init(TEST_AGC_SAMPLE_RATE, TEST_AGC_INPUT_SIZE + 1, 0, TEST_AGC_DECAY);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->segments);
+    assert_true(ctx->attack == 1);
+    agc_free(ctx);
+}
+
+void test_agc_peak(void **state) {
+    (void) state;
+
+    FP_FLOAT data[TEST_AGC_INPUT_SIZE + 3];
+    int16_t data_fixed[TEST_AGC_INPUT_SIZE + 3];
+    size_t i;
+
+    for (i = 0; i < TEST_AGC_INPUT_SIZE + 3; i++) {
+        data[i] = (FP_FLOAT) (i % 2 == 0 ? 0.25 : -0.25);
+        data_fixed[i] = (int16_t) (i % 2 == 0 ? 100 : -100);
+    }
+
+    data[17] = (FP_FLOAT) -0.75;
+    data_fixed[17] = -3000;
+    assert_true(agc_peak(data, TEST_AGC_INPUT_SIZE + 3) == (FP_FLOAT) 0.75);
+    assert_int_equal(3000, agc_peak_fixed(data_fixed, TEST_AGC_INPUT_SIZE + 3));
+
+    data[TEST_AGC_INPUT_SIZE + 2] = (FP_FLOAT) 0.8;
+    assert_true(agc_peak(data, TEST_AGC_INPUT_SIZE + 3) == (FP_FLOAT) 0.8);
+}
+
+void test_agc_level(void **state) {
+    (void) state;
+
+    agc_ctx *ctx;
+    FP_FLOAT data[TEST_AGC_INPUT_SIZE];
+    double amplitude;
+    double peak;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = agc_init(TEST_AGC_SAMPLE_RATE, TEST_AGC_INPUT_SIZE, TEST_AGC_ATTACK, TEST_AGC_DECAY);
+    assert_non_null(ctx);
+
+    n = 0;
+
+    for (i = 0; i < TEST_AGC_ITERATIONS; i++) {
+        amplitude = i < TEST_AGC_ITERATIONS / 2 ? TEST_AGC_QUIET : TEST_AGC_LOUD;
+
+        for (j = 0; j < TEST_AGC_INPUT_SIZE; j++) {
+            data[j] = (FP_FLOAT) (amplitude * sin(2 * M_PI * TEST_AGC_TONE * (double) n / TEST_AGC_SAMPLE_RATE));
+            n++;
+        }
+
+        assert_int_equal(EXIT_SUCCESS, agc_perform_gain(ctx, data, TEST_AGC_INPUT_SIZE));
+
+        peak = agc_peak(data, TEST_AGC_INPUT_SIZE);
+        assert_true(peak <= 1 + 1e-6);
+
+        if (i == TEST_AGC_ITERATIONS / 2 - 1 || i == TEST_AGC_ITERATIONS - 1)
+            assert_true(fabs(peak - AGC_TARGET) < 0.05);
+    }
+
+    assert_int_equal(EXIT_FAILURE, agc_perform_gain(ctx, data, TEST_AGC_INPUT_SIZE / 2));
+
+    agc_free(ctx);
+}
+
+void test_agc_level_fixed(void **state) {
+    (void) state;
+
+    agc_ctx *ctx;
+    int16_t data[TEST_AGC_INPUT_SIZE];
+    double amplitude;
+    int16_t peak;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = agc_init(TEST_AGC_SAMPLE_RATE, TEST_AGC_INPUT_SIZE, TEST_AGC_ATTACK, TEST_AGC_DECAY);
+    assert_non_null(ctx);
+
+    n = 0;
+
+    for (i = 0; i < TEST_AGC_ITERATIONS; i++) {
+        amplitude = i < TEST_AGC_ITERATIONS / 2 ? TEST_AGC_QUIET : TEST_AGC_LOUD;
+
+        for (j = 0; j < TEST_AGC_INPUT_SIZE; j++) {
+            data[j] = (int16_t) lround(amplitude * FIXED_Q15_ONE
+                                       * sin(2 * M_PI * TEST_AGC_TONE * (double) n / TEST_AGC_SAMPLE_RATE));
+            n++;
+        }
+
+        assert_int_equal(EXIT_SUCCESS, agc_perform_gain_fixed(ctx, data, TEST_AGC_INPUT_SIZE));
+
+        peak = agc_peak_fixed(data, TEST_AGC_INPUT_SIZE);
+
+        if (i == TEST_AGC_ITERATIONS / 2 - 1 || i == TEST_AGC_ITERATIONS - 1)
+            assert_true(fabs((double) peak / FIXED_Q15_ONE - AGC_TARGET) < 0.05);
+    }
+
+    agc_free(ctx);
+}
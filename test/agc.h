@@ -0,0 +1,44 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef __RTLSDR_RADIO__AGC__H__TEST
+#define __RTLSDR_RADIO__AGC__H__TEST
+
+#include "../src/agc.h"
+
+#define TEST_AGC_SAMPLE_RATE 32000
+#define TEST_AGC_TONE 1000
+#define TEST_AGC_INPUT_SIZE 256
+#define TEST_AGC_ITERATIONS 100
+#define TEST_AGC_ATTACK 5
+#define TEST_AGC_DECAY 50
+
+#define TEST_AGC_QUIET 0.01
+#define TEST_AGC_LOUD 0.9
+
+void test_agc_init(void **);
+
+void test_agc_peak(void **);
+
+void test_agc_level(void **);
+
+void test_agc_level_fixed(void **);
+
+#endif
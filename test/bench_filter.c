@@ -0,0 +1,145 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "bench_filter.h"
+
+int main() {
+    const uint32_t transitions[] = BENCH_FILTER_TRANSITIONS;
+    fir_design_params params;
+    const fir_design *design;
+    FP_FLOAT *input;
+    FP_FLOAT *output;
+    size_t i;
+
+    input = (FP_FLOAT *) calloc(BENCH_FILTER_INPUT_SIZE, sizeof(FP_FLOAT));
+    output = (FP_FLOAT *) calloc(BENCH_FILTER_INPUT_SIZE, sizeof(FP_FLOAT));
+    if (input == NULL || output == NULL)
+        return EXIT_FAILURE;
+
+    for (i = 0; i < BENCH_FILTER_INPUT_SIZE; i++)
+        input[i] = (FP_FLOAT) sin(0.01 * (double) i);
+
+    printf("Block size: %d samples - Iterations: %d\n", BENCH_FILTER_INPUT_SIZE, BENCH_FILTER_ITERATIONS);
+
+    printf("FFT:                     %10.1f ns/sample\n", bench_filter_fft(input, output));
+
+    params.type = FIR_DESIGN_TYPE_KAISER;
+    params.sample_rate = BENCH_FILTER_SAMPLE_RATE;
+    params.cutoff = BENCH_FILTER_CUTOFF;
+    params.attenuation = BENCH_FILTER_ATTENUATION;
+
+    for (i = 0; i < sizeof(transitions) / sizeof(uint32_t); i++) {
+        params.transition = transitions[i];
+
+        design = fir_design_get(&params);
+        if (design == NULL)
+            continue;
+
+        printf("FIR %4u Hz (%4zu taps): %10.1f ns/sample\n",
+               transitions[i], design->taps_size, bench_filter_fir(design, input, output));
+    }
+
+    fir_design_cache_free();
+
+    free(input);
+    free(output);
+
+    return EXIT_SUCCESS;
+}
+
+static double bench_filter_now() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+double bench_filter_fir(const fir_design *design, const FP_FLOAT *input, FP_FLOAT *output) {
+    fir_ctx *ctx;
+    double start;
+    double stop;
+    size_t i;
+
+    ctx = fir_init(design->taps, design->taps_size, BENCH_FILTER_INPUT_SIZE, 1);
+    if (ctx == NULL)
+        return NAN;
+
+    start = bench_filter_now();
+    for (i = 0; i < BENCH_FILTER_ITERATIONS; i++)
+        fir_convolve(ctx, input, BENCH_FILTER_INPUT_SIZE, output);
+    stop = bench_filter_now();
+
+    fir_free(ctx);
+
+    return (stop - start) / ((double) BENCH_FILTER_ITERATIONS * BENCH_FILTER_INPUT_SIZE);
+}
+
+double bench_filter_fft(const FP_FLOAT *input, FP_FLOAT *output) {
+    fft_ctx *fwd_ctx;
+    fft_ctx *bck_ctx;
+    double start;
+    double stop;
+    size_t truncate;
+    size_t half;
+    size_t i;
+    size_t j;
+
+    fwd_ctx = fft_init(BENCH_FILTER_INPUT_SIZE, FFTW_R2HC, FFT_DATA_TYPE_REAL, FFT_RIGOR_MEASURE);
+    bck_ctx = fft_init(BENCH_FILTER_INPUT_SIZE, FFTW_HC2R, FFT_DATA_TYPE_REAL, FFT_RIGOR_MEASURE);
+
+    fft_wait_replan(fwd_ctx);
+    fft_wait_replan(bck_ctx);
+
+    half = BENCH_FILTER_INPUT_SIZE / 2;
+    truncate = (BENCH_FILTER_CUTOFF * BENCH_FILTER_INPUT_SIZE) / BENCH_FILTER_SAMPLE_RATE;
+
+    start = bench_filter_now();
+    for (i = 0; i < BENCH_FILTER_ITERATIONS; i++) {
+        for (j = 0; j < BENCH_FILTER_INPUT_SIZE; j++)
+            fwd_ctx->real_input[j] = input[j];
+
+        fft_compute(fwd_ctx);
+
+        for (j = 0; j < BENCH_FILTER_INPUT_SIZE; j++)
+            bck_ctx->real_input[j] = fwd_ctx->real_output[j];
+
+        for (j = truncate; j < half; j++) {
+            bck_ctx->real_input[j] = 0;
+            bck_ctx->real_input[BENCH_FILTER_INPUT_SIZE - j] = 0;
+        }
+
+        fft_compute(bck_ctx);
+
+        for (j = 0; j < BENCH_FILTER_INPUT_SIZE; j++)
+            output[j] = bck_ctx->real_output[j] / (FP_FLOAT) BENCH_FILTER_INPUT_SIZE;
+    }
+    stop = bench_filter_now();
+
+    fft_free(fwd_ctx);
+    fft_free(bck_ctx);
+    fft_replan_stop();
+
+    return (stop - start) / ((double) BENCH_FILTER_ITERATIONS * BENCH_FILTER_INPUT_SIZE);
+}
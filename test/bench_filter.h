@@ -0,0 +1,48 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__BENCH_FILTER__H__TEST
+#define __RTLSDR_RADIO__BENCH_FILTER__H__TEST
+
+#include <stddef.h>
+
+#include "../src/fir.h"
+#include "../src/fir_design.h"
+#include "../src/fft.h"
+
+/*
+ * Not a test: compares the FIR filter mode, with Kaiser designs of growing
+ * length, with the FFT filter mode on the same block size.
+ */
+
+#define BENCH_FILTER_INPUT_SIZE 2048
+#define BENCH_FILTER_ITERATIONS 2000
+
+#define BENCH_FILTER_SAMPLE_RATE 32000
+#define BENCH_FILTER_CUTOFF 3500
+#define BENCH_FILTER_ATTENUATION 60
+#define BENCH_FILTER_TRANSITIONS {4000, 2000, 1000, 500, 250}
+
+static double bench_filter_now();
+
+double bench_filter_fir(const fir_design *, const FP_FLOAT *, FP_FLOAT *);
+
+double bench_filter_fft(const FP_FLOAT *, FP_FLOAT *);
+
+#endif
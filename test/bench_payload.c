@@ -0,0 +1,131 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bench_payload.h"
+
+int main() {
+    payload *p;
+    uint8_t data[BENCH_PAYLOAD_DATA_SIZE];
+    uint8_t *buffer;
+    struct timespec ts;
+    size_t i;
+
+    p = payload_init();
+    buffer = (uint8_t *) calloc(BENCH_PAYLOAD_BUFFER_SIZE, sizeof(uint8_t));
+    if (p == NULL || buffer == NULL)
+        return EXIT_FAILURE;
+
+    for (i = 0; i < BENCH_PAYLOAD_DATA_SIZE; i++)
+        data[i] = (uint8_t) i;
+
+    timespec_get(&ts, TIME_UTC);
+
+    payload_set_numbers(p, 1, 0);
+    payload_set_timestamp(p, &ts);
+    payload_set_rms(p, 0.5);
+    payload_set_channel_frequency(p, 1, 145500000);
+    payload_set_data(p, data, BENCH_PAYLOAD_DATA_SIZE);
+
+    printf("Data size: %d bytes - Iterations: %d\n", BENCH_PAYLOAD_DATA_SIZE, BENCH_PAYLOAD_ITERATIONS);
+
+    printf("Serialize header: %12.0f packets/s\n", bench_payload_serialize_header(p, buffer));
+    printf("Serialize:        %12.0f packets/s\n", bench_payload_serialize(p, buffer));
+    printf("Parse:            %12.0f packets/s\n", bench_payload_parse(p, buffer));
+
+    payload_free(p);
+    free(buffer);
+
+    return EXIT_SUCCESS;
+}
+
+static double bench_payload_now() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+double bench_payload_serialize_header(payload *p, uint8_t *buffer) {
+    double start;
+    double stop;
+    size_t written;
+    size_t i;
+
+    start = bench_payload_now();
+    for (i = 0; i < BENCH_PAYLOAD_ITERATIONS; i++) {
+        p->number = i;
+        payload_serialize_header(p, buffer, BENCH_PAYLOAD_BUFFER_SIZE, &written);
+    }
+    stop = bench_payload_now();
+
+    return (double) BENCH_PAYLOAD_ITERATIONS * 1e9 / (stop - start);
+}
+
+double bench_payload_serialize(payload *p, uint8_t *buffer) {
+    double start;
+    double stop;
+    size_t written;
+    size_t i;
+
+    start = bench_payload_now();
+    for (i = 0; i < BENCH_PAYLOAD_ITERATIONS; i++) {
+        p->number = i;
+        payload_serialize(p, buffer, BENCH_PAYLOAD_BUFFER_SIZE, &written);
+    }
+    stop = bench_payload_now();
+
+    return (double) BENCH_PAYLOAD_ITERATIONS * 1e9 / (stop - start);
+}
+
+double bench_payload_parse(payload *p, uint8_t *buffer) {
+    payload *parsed;
+    double start;
+    double stop;
+    size_t written;
+    uint64_t sum;
+    size_t i;
+
+    parsed = payload_init();
+    if (parsed == NULL)
+        return 0;
+
+    payload_serialize(p, buffer, BENCH_PAYLOAD_BUFFER_SIZE, &written);
+
+    sum = 0;
+
+    start = bench_payload_now();
+    for (i = 0; i < BENCH_PAYLOAD_ITERATIONS; i++) {
+        buffer[PAYLOAD_OFFSET_NUMBER] = (uint8_t) i;
+        payload_parse(parsed, buffer, written);
+        sum += parsed->number + parsed->data[0];
+    }
+    stop = bench_payload_now();
+
+    payload_free(parsed);
+
+    if (sum == 0)
+        printf("Unexpected parse results\n");
+
+    return (double) BENCH_PAYLOAD_ITERATIONS * 1e9 / (stop - start);
+}
@@ -0,0 +1,45 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__BENCH_PAYLOAD__H__TEST
+#define __RTLSDR_RADIO__BENCH_PAYLOAD__H__TEST
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../src/payload.h"
+
+/*
+ * Not a test: measures GFP serialization and parsing in packets per
+ * second, with a codec2 3200 frame as data.
+ */
+
+#define BENCH_PAYLOAD_DATA_SIZE 8
+#define BENCH_PAYLOAD_BUFFER_SIZE 4096
+#define BENCH_PAYLOAD_ITERATIONS 10000000
+
+static double bench_payload_now();
+
+double bench_payload_serialize_header(payload *, uint8_t *);
+
+double bench_payload_serialize(payload *, uint8_t *);
+
+double bench_payload_parse(payload *, uint8_t *);
+
+#endif
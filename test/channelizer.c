@@ -0,0 +1,153 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "channelizer.h"
+#include "../src/fir_design.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_channelizer_init),
+        cmocka_unit_test(test_channelizer_bin),
+        cmocka_unit_test(test_channelizer_tone),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("channelizer", tests, NULL, NULL);
+}
+
+static channelizer_ctx *test_channelizer_create() {
+    channelizer_ctx *ctx;
+    FP_FLOAT *taps;
+    size_t taps_size;
+    double spacing;
+
+    spacing = (double) TEST_CHANNELIZER_SAMPLE_RATE / TEST_CHANNELIZER_CHANNELS;
+
+    taps = fir_design_kaiser(spacing / 2 / TEST_CHANNELIZER_SAMPLE_RATE, spacing / 4 / TEST_CHANNELIZER_SAMPLE_RATE,
+                             60, &taps_size);
+    if (taps == NULL)
+        return NULL;
+
+    ctx = channelizer_init(TEST_CHANNELIZER_SAMPLE_RATE, TEST_CHANNELIZER_CHANNELS, TEST_CHANNELIZER_INPUT_SIZE,
+                           taps, taps_size, FFT_RIGOR_ESTIMATE);
+
+    free(taps);
+
+    return ctx;
+}
+
+void test_channelizer_init(void **state) {
+    (void) state;
+
+    channelizer_ctx *ctx;
+    FP_FLOAT taps[1] = {1};
+
+    assert_null(channelizer_init(TEST_CHANNELIZER_SAMPLE_RATE, 15, TEST_CHANNELIZER_INPUT_SIZE, taps, 1,
+                                 FFT_RIGOR_ESTIMATE));
+    assert_null(channelizer_init(TEST_CHANNELIZER_SAMPLE_RATE, TEST_CHANNELIZER_CHANNELS, 100, taps, 1,
+                                 FFT_RIGOR_ESTIMATE));
+
+    ctx = test_channelizer_create();
+    assert_non_null(ctx);
+
+    assert_int_equal(TEST_CHANNELIZER_SAMPLE_RATE / TEST_CHANNELIZER_CHANNELS, channelizer_spacing(ctx));
+    assert_int_equal(2 * TEST_CHANNELIZER_SAMPLE_RATE / TEST_CHANNELIZER_CHANNELS, channelizer_output_rate(ctx));
+    assert_int_equal(TEST_CHANNELIZER_INPUT_SIZE * 2 / TEST_CHANNELIZER_CHANNELS, ctx->output_size);
+
+    channelizer_free(ctx);
+}
+
+void test_channelizer_bin(void **state) {
+    (void) state;
+
+    channelizer_ctx *ctx;
+    int64_t spacing;
+
+    ctx = test_channelizer_create();
+    assert_non_null(ctx);
+
+    spacing = channelizer_spacing(ctx);
+
+    assert_int_equal(0, channelizer_bin(ctx, 0));
+    assert_int_equal(3, channelizer_bin(ctx, 3 * spacing));
+    assert_int_equal(TEST_CHANNELIZER_CHANNELS - 2, channelizer_bin(ctx, -2 * spacing));
+    assert_int_equal(-1, channelizer_bin(ctx, spacing / 2));
+    assert_int_equal(-1, channelizer_bin(ctx, TEST_CHANNELIZER_CHANNELS / 2 * spacing));
+
+    channelizer_free(ctx);
+}
+
+void test_channelizer_tone(void **state) {
+    (void) state;
+
+    channelizer_ctx *ctx;
+    FP_FLOAT complex input[TEST_CHANNELIZER_INPUT_SIZE];
+    const FP_FLOAT complex *output;
+    double freq;
+    double phase;
+    double peak;
+    size_t n;
+    size_t i;
+    size_t j;
+    size_t k;
+
+    ctx = test_channelizer_create();
+    assert_non_null(ctx);
+
+    freq = (double) TEST_CHANNELIZER_BIN * channelizer_spacing(ctx) + TEST_CHANNELIZER_TONE;
+    n = 0;
+
+    for (i = 0; i < TEST_CHANNELIZER_ITERATIONS; i++) {
+        for (j = 0; j < TEST_CHANNELIZER_INPUT_SIZE; j++) {
+            phase = 2 * M_PI * freq * (double) n / TEST_CHANNELIZER_SAMPLE_RATE;
+            input[j] = (FP_FLOAT) cos(phase) + (FP_FLOAT) sin(phase) * I;
+            n++;
+        }
+
+        assert_int_equal(EXIT_SUCCESS, channelizer_do(ctx, input, TEST_CHANNELIZER_INPUT_SIZE));
+    }
+
+    for (k = 0; k < TEST_CHANNELIZER_CHANNELS; k++) {
+        output = channelizer_get(ctx, k);
+
+        peak = 0;
+        for (j = 0; j < ctx->output_size; j++)
+            if (cabs(output[j]) > peak)
+                peak = cabs(output[j]);
+
+        if (k == TEST_CHANNELIZER_BIN)
+            assert_true(fabs(peak - 1) < 1e-2);
+        else
+            assert_true(peak < 1e-2);
+    }
+
+    output = channelizer_get(ctx, TEST_CHANNELIZER_BIN);
+    for (j = 1; j < ctx->output_size; j++)
+        assert_true(fabs(carg(output[j] / output[j - 1])
+                         - 2 * M_PI * TEST_CHANNELIZER_TONE / channelizer_output_rate(ctx)) < 1e-2);
+
+    channelizer_free(ctx);
+}
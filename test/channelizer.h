@@ -0,0 +1,39 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__CHANNELIZER__H__TEST
+#define __RTLSDR_RADIO__CHANNELIZER__H__TEST
+
+#include "../src/channelizer.h"
+
+#define TEST_CHANNELIZER_SAMPLE_RATE 400000
+#define TEST_CHANNELIZER_CHANNELS 16
+#define TEST_CHANNELIZER_INPUT_SIZE 1024
+#define TEST_CHANNELIZER_ITERATIONS 8
+
+#define TEST_CHANNELIZER_BIN 3
+#define TEST_CHANNELIZER_TONE 2000
+
+void test_channelizer_init(void **);
+
+void test_channelizer_bin(void **);
+
+void test_channelizer_tone(void **);
+
+#endif
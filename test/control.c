@@ -0,0 +1,281 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "control.h"
+
+cfg *conf;
+
+static int test_control_parse_string(control_params *, const char *);
+
+static void *test_control_publisher(void *);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_control_parse, test_control_setup, test_control_teardown),
+        cmocka_unit_test_setup_teardown(test_control_parse_malformed, test_control_setup, test_control_teardown),
+        cmocka_unit_test_setup_teardown(test_control_check, test_control_setup, test_control_teardown),
+        cmocka_unit_test_setup_teardown(test_control_check_channelizer, test_control_setup, test_control_teardown),
+        cmocka_unit_test_setup_teardown(test_control_publish, test_control_setup, test_control_teardown),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("control", tests, NULL, NULL);
+}
+
+int test_control_setup(void **state) {
+    (void) state;
+
+    conf = (cfg *) calloc(1, sizeof(cfg));
+    if (conf == NULL)
+        return -1;
+
+    conf->rtlsdr_device_sample_rate = TEST_CONTROL_SAMPLE_RATE;
+    conf->rtlsdr_device_center_freq = TEST_CONTROL_CENTER_FREQ;
+    conf->filter = FILTER_MODE_NONE;
+
+    return 0;
+}
+
+int test_control_teardown(void **state) {
+    (void) state;
+
+    free(conf->channel_freqs);
+    free(conf);
+
+    return 0;
+}
+
+void test_control_parse(void **state) {
+    (void) state;
+
+    control_ctx *ctx;
+    control_params params;
+
+    ctx = control_init(conf, 0);
+    assert_non_null(ctx);
+
+    assert_int_equal(0, control_get(ctx, &params));
+    assert_int_equal(TEST_CONTROL_CENTER_FREQ, params.center_freq);
+
+    assert_int_equal(EXIT_SUCCESS, test_control_parse_string(
+            &params,
+            "rtlsdr_device_center_freq 145500000\n"
+            "# comment\n"
+            "\n"
+            "rtlsdr_device_tuner_gain   -10  \r\n"
+            "modulation am\n"
+            "squelch snr\n"
+            "squelch_level -20\n"
+            "squelch_hysteresis 4\n"
+            "squelch_hang 12\n"
+            "filter fir_sw\n"
+            "filter_cutoff 3000\n"
+            "filter_transition 500"));
+
+    assert_int_equal(145500000, params.center_freq);
+    assert_int_equal(-10, params.tuner_gain);
+    assert_int_equal(MOD_TYPE_AM, params.modulation);
+    assert_int_equal(SQUELCH_MODE_SNR, params.squelch);
+    assert_int_equal(-20, params.squelch_level);
+    assert_int_equal(4, params.squelch_hysteresis);
+    assert_int_equal(12, params.squelch_hang);
+    assert_int_equal(FILTER_MODE_FIR_SW, params.filter);
+    assert_int_equal(3000, params.filter_cutoff);
+    assert_int_equal(500, params.filter_transition);
+
+    control_free(ctx);
+}
+
+void test_control_parse_malformed(void **state) {
+    (void) state;
+
+    control_params params;
+    size_t i;
+    const char *messages[] = {
+            "rtlsdr_device_center_freq",
+            "rtlsdr_device_center_freq abc",
+            "rtlsdr_device_center_freq 145m",
+            "rtlsdr_device_center_freq 0",
+            "rtlsdr_device_center_freq -145000000",
+            "rtlsdr_device_center_freq 5000000000",
+            "modulation usb",
+            "squelch on",
+            "squelch_hysteresis -1",
+            "squelch_hang -1",
+            "filter lowpass",
+            "filter_cutoff 0",
+            "filter_transition -5",
+            "rtlsdr_device_sample_rate 1024000",
+            "unknown_key 1",
+            "modulation fm\nsquelch_level x",
+    };
+
+    for (i = 0; i < sizeof(messages) / sizeof(messages[0]); i++) {
+        memset(&params, 0, sizeof(params));
+        assert_int_equal(EXIT_FAILURE, test_control_parse_string(&params, messages[i]));
+    }
+}
+
+void test_control_check(void **state) {
+    (void) state;
+
+    control_ctx *ctx;
+    control_params params;
+
+    ctx = control_init(conf, 0);
+    assert_non_null(ctx);
+
+    control_get(ctx, &params);
+    assert_int_equal(EXIT_SUCCESS, control_check(&params, conf, 1, TEST_CONTROL_CHANNEL_SAMPLE_RATE));
+
+    params.filter = FILTER_MODE_FIR_SW;
+    params.filter_cutoff = TEST_CONTROL_CHANNEL_SAMPLE_RATE / 2 - 1;
+    assert_int_equal(EXIT_SUCCESS, control_check(&params, conf, 1, TEST_CONTROL_CHANNEL_SAMPLE_RATE));
+    params.filter_cutoff = TEST_CONTROL_CHANNEL_SAMPLE_RATE / 2;
+    assert_int_equal(EXIT_FAILURE, control_check(&params, conf, 1, TEST_CONTROL_CHANNEL_SAMPLE_RATE));
+    params.filter = FILTER_MODE_NONE;
+
+    conf->channel_freqs = (uint32_t *) malloc(sizeof(uint32_t) * 2);
+    assert_non_null(conf->channel_freqs);
+    conf->channel_freqs_count = 2;
+    conf->channel_freqs[0] = TEST_CONTROL_CENTER_FREQ - 500000;
+    conf->channel_freqs[1] = TEST_CONTROL_CENTER_FREQ + 500000;
+    assert_int_equal(EXIT_SUCCESS, control_check(&params, conf, 2, TEST_CONTROL_CHANNEL_SAMPLE_RATE));
+
+    // A retune leaving a channel out of the captured band is refused
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 600000;
+    assert_int_equal(EXIT_FAILURE, control_check(&params, conf, 2, TEST_CONTROL_CHANNEL_SAMPLE_RATE));
+
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 500000
+                         - (TEST_CONTROL_SAMPLE_RATE - TEST_CONTROL_CHANNEL_SAMPLE_RATE) / 2;
+    assert_int_equal(EXIT_SUCCESS, control_check(&params, conf, 2, TEST_CONTROL_CHANNEL_SAMPLE_RATE));
+    params.center_freq -= 1;
+    assert_int_equal(EXIT_FAILURE, control_check(&params, conf, 2, TEST_CONTROL_CHANNEL_SAMPLE_RATE));
+
+    control_free(ctx);
+}
+
+void test_control_check_channelizer(void **state) {
+    (void) state;
+
+    control_params params;
+    uint32_t spacing;
+
+    conf->channelizer_channels = 8;
+    spacing = TEST_CONTROL_SAMPLE_RATE / 8;
+
+    conf->channel_freqs = (uint32_t *) malloc(sizeof(uint32_t));
+    assert_non_null(conf->channel_freqs);
+    conf->channel_freqs_count = 1;
+    conf->channel_freqs[0] = TEST_CONTROL_CENTER_FREQ + spacing;
+
+    memset(&params, 0, sizeof(params));
+    params.filter = FILTER_MODE_NONE;
+
+    params.center_freq = TEST_CONTROL_CENTER_FREQ;
+    assert_int_equal(EXIT_SUCCESS, control_check(&params, conf, 1, spacing));
+
+    // Off the grid
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 1000;
+    assert_int_equal(EXIT_FAILURE, control_check(&params, conf, 1, spacing));
+
+    // On the grid, up to the outermost bins
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 5 * spacing;
+    assert_int_equal(EXIT_FAILURE, control_check(&params, conf, 1, spacing));
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 4 * spacing;
+    assert_int_equal(EXIT_SUCCESS, control_check(&params, conf, 1, spacing));
+    params.center_freq = TEST_CONTROL_CENTER_FREQ - 3 * spacing;
+    assert_int_equal(EXIT_FAILURE, control_check(&params, conf, 1, spacing));
+    params.center_freq = TEST_CONTROL_CENTER_FREQ - 2 * spacing;
+    assert_int_equal(EXIT_SUCCESS, control_check(&params, conf, 1, spacing));
+}
+
+void test_control_publish(void **state) {
+    (void) state;
+
+    control_ctx *ctx;
+    control_params params;
+    control_params seen;
+    pthread_t thread;
+    uint64_t generation;
+
+    ctx = control_init(conf, 0);
+    assert_non_null(ctx);
+
+    generation = control_get(ctx, &seen);
+    assert_int_equal(0, generation);
+
+    params = seen;
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 25000;
+    assert_int_equal(1, control_publish(ctx, &params));
+
+    // A taken copy is not touched by later publishes
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 50000;
+    assert_int_equal(2, control_publish(ctx, &params));
+    assert_int_equal(TEST_CONTROL_CENTER_FREQ, seen.center_freq);
+
+    generation = control_get(ctx, &seen);
+    assert_int_equal(2, generation);
+    assert_int_equal(TEST_CONTROL_CENTER_FREQ + 50000, seen.center_freq);
+
+    // A reader polling the generation sees the whole set published with it
+    assert_int_equal(0, pthread_create(&thread, NULL, test_control_publisher, ctx));
+
+    while (control_get(ctx, &seen) == generation);
+
+    assert_int_equal(3, control_get(ctx, &seen));
+    assert_int_equal(TEST_CONTROL_CENTER_FREQ + 75000, seen.center_freq);
+    assert_int_equal(-15, seen.squelch_level);
+    assert_int_equal(MOD_TYPE_AM, seen.modulation);
+
+    assert_int_equal(0, pthread_join(thread, NULL));
+
+    control_free(ctx);
+}
+
+static int test_control_parse_string(control_params *params, const char *message) {
+    char buffer[TEST_CONTROL_MESSAGE_SIZE];
+
+    strncpy(buffer, message, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    return control_parse(params, buffer);
+}
+
+static void *test_control_publisher(void *data) {
+    control_ctx *ctx;
+    control_params params;
+
+    ctx = (control_ctx *) data;
+
+    control_get(ctx, &params);
+    params.center_freq = TEST_CONTROL_CENTER_FREQ + 75000;
+    params.squelch_level = -15;
+    params.modulation = MOD_TYPE_AM;
+    control_publish(ctx, &params);
+
+    return NULL;
+}
@@ -0,0 +1,44 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__CONTROL__H__TEST
+#define __RTLSDR_RADIO__CONTROL__H__TEST
+
+#include "../src/control.h"
+
+#define TEST_CONTROL_SAMPLE_RATE 2048000
+#define TEST_CONTROL_CENTER_FREQ 145000000
+#define TEST_CONTROL_CHANNEL_SAMPLE_RATE 32000
+#define TEST_CONTROL_MESSAGE_SIZE 256
+
+int test_control_setup(void **);
+
+int test_control_teardown(void **);
+
+void test_control_parse(void **);
+
+void test_control_parse_malformed(void **);
+
+void test_control_check(void **);
+
+void test_control_check_channelizer(void **);
+
+void test_control_publish(void **);
+
+#endif
@@ -0,0 +1,281 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "decimate.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_decimate_init, test_decimate_setup, test_decimate_teardown),
+        cmocka_unit_test(test_decimate_stages),
+        cmocka_unit_test(test_decimate_invalid_rates),
+        cmocka_unit_test_setup_teardown(test_decimate_dc_gain, test_decimate_setup, test_decimate_teardown),
+        cmocka_unit_test_setup_teardown(test_decimate_stopband, test_decimate_setup, test_decimate_teardown),
+        cmocka_unit_test_setup_teardown(test_decimate_dc_gain_fixed, test_decimate_setup, test_decimate_teardown),
+        cmocka_unit_test(test_decimate_fir),
+        cmocka_unit_test(test_decimate_fir_fixed),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("decimate", tests, NULL, NULL);
+}
+
+static int test_decimate_setup(void **state) {
+    decimate_ctx *ctx;
+
+    ctx = decimate_init(TEST_DECIMATE_SRC_RATE, TEST_DECIMATE_DST_RATE, TEST_DECIMATE_INPUT_SIZE);
+    if (ctx == NULL)
+        return EXIT_FAILURE;
+
+    *state = (void *) ctx;
+
+    return EXIT_SUCCESS;
+}
+
+static int test_decimate_teardown(void **state) {
+    decimate_ctx *ctx;
+
+    ctx = (decimate_ctx *) *state;
+    if (ctx != NULL)
+        decimate_free(ctx);
+
+    return EXIT_SUCCESS;
+}
+
+void test_decimate_init(void **state) {
+    decimate_ctx *ctx;
+
+    ctx = (decimate_ctx *) *state;
+
+    assert_non_null(ctx);
+
+    assert_int_equal(TEST_DECIMATE_SRC_RATE / TEST_DECIMATE_DST_RATE, ctx->ratio);
+    assert_int_equal(4, ctx->cic.ratio);
+    assert_int_equal(4, ctx->halfband_stages);
+
+    assert_int_equal(TEST_DECIMATE_INPUT_SIZE / ctx->ratio,
+                     decimate_compute_output_size(ctx, TEST_DECIMATE_INPUT_SIZE));
+}
+
+void test_decimate_stages(void **state) {
+    (void) state;
+
+    decimate_ctx *ctx;
+
+    ctx = decimate_init(256000, 32000, 2048);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->cic.ratio);
+    assert_int_equal(3, ctx->halfband_stages);
+    decimate_free(ctx);
+
+    ctx = decimate_init(250000, 50000, 2000);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->cic.ratio);
+    assert_int_equal(0, ctx->halfband_stages);
+    assert_int_equal(5, ctx->fir.ratio);
+    decimate_free(ctx);
+
+    ctx = decimate_init(TEST_DECIMATE_FIR_SRC_RATE, TEST_DECIMATE_DST_RATE, TEST_DECIMATE_FIR_INPUT_SIZE);
+    assert_non_null(ctx);
+    assert_int_equal(25, ctx->cic.ratio);
+    assert_int_equal(0, ctx->halfband_stages);
+    assert_int_equal(3, ctx->fir.ratio);
+    decimate_free(ctx);
+
+    ctx = decimate_init(TEST_DECIMATE_SRC_RATE, TEST_DECIMATE_DST_RATE, TEST_DECIMATE_INPUT_SIZE);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->fir.ratio);
+    decimate_free(ctx);
+
+    ctx = decimate_init(256000, 256000, 2048);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->ratio);
+    decimate_free(ctx);
+}
+
+void test_decimate_invalid_rates(void **state) {
+    (void) state;
+
+    assert_null(decimate_init(256000, 30000, 2048));
+    assert_null(decimate_init(256000, 0, 2048));
+    assert_null(decimate_init(256000, 32000, 2044));
+}
+
+void test_decimate_dc_gain(void **state) {
+    decimate_ctx *ctx;
+    FP_FLOAT complex input[TEST_DECIMATE_INPUT_SIZE];
+    FP_FLOAT complex output[TEST_DECIMATE_INPUT_SIZE];
+    size_t output_size;
+    size_t i;
+
+    ctx = (decimate_ctx *) *state;
+    output_size = decimate_compute_output_size(ctx, TEST_DECIMATE_INPUT_SIZE);
+
+    for (i = 0; i < TEST_DECIMATE_INPUT_SIZE; i++)
+        input[i] = 0.5 - 0.25 * I;
+
+    for (i = 0; i < TEST_DECIMATE_ITERATIONS; i++)
+        assert_int_equal(EXIT_SUCCESS, decimate_do(ctx, input, TEST_DECIMATE_INPUT_SIZE, output));
+
+    for (i = 0; i < output_size; i++) {
+        assert_true(fabs(creal(output[i]) - 0.5) < 1e-3);
+        assert_true(fabs(cimag(output[i]) + 0.25) < 1e-3);
+    }
+}
+
+void test_decimate_stopband(void **state) {
+    decimate_ctx *ctx;
+    FP_FLOAT complex input[TEST_DECIMATE_INPUT_SIZE];
+    FP_FLOAT complex output[TEST_DECIMATE_INPUT_SIZE];
+    size_t output_size;
+    size_t n;
+    size_t j;
+    size_t i;
+    double phase;
+    double power;
+
+    ctx = (decimate_ctx *) *state;
+    output_size = decimate_compute_output_size(ctx, TEST_DECIMATE_INPUT_SIZE);
+
+    n = 0;
+    power = 0;
+
+    for (i = 0; i < TEST_DECIMATE_ITERATIONS; i++) {
+        for (j = 0; j < TEST_DECIMATE_INPUT_SIZE; j++) {
+            phase = 2 * M_PI * 100000.0 * (double) n / TEST_DECIMATE_SRC_RATE;
+            input[j] = (FP_FLOAT) cos(phase) + (FP_FLOAT) sin(phase) * I;
+            n++;
+        }
+
+        decimate_do(ctx, input, TEST_DECIMATE_INPUT_SIZE, output);
+    }
+
+    for (i = 0; i < output_size; i++)
+        power += pow(cabs(output[i]), 2);
+
+    power /= (double) output_size;
+
+    assert_true(power < 1e-4);
+}
+
+void test_decimate_dc_gain_fixed(void **state) {
+    decimate_ctx *ctx;
+    fixed_complex input[TEST_DECIMATE_INPUT_SIZE];
+    fixed_complex output[TEST_DECIMATE_INPUT_SIZE];
+    size_t output_size;
+    size_t i;
+
+    ctx = (decimate_ctx *) *state;
+    output_size = decimate_compute_output_size(ctx, TEST_DECIMATE_INPUT_SIZE);
+
+    for (i = 0; i < TEST_DECIMATE_INPUT_SIZE; i++) {
+        input[i].i = FIXED_Q15_HALF;
+        input[i].q = -FIXED_Q15_HALF / 2;
+    }
+
+    for (i = 0; i < TEST_DECIMATE_ITERATIONS; i++)
+        assert_int_equal(EXIT_SUCCESS, decimate_do_fixed(ctx, input, TEST_DECIMATE_INPUT_SIZE, output));
+
+    for (i = 0; i < output_size; i++) {
+        assert_true(abs(output[i].i - FIXED_Q15_HALF) < 32);
+        assert_true(abs(output[i].q + FIXED_Q15_HALF / 2) < 32);
+    }
+}
+
+void test_decimate_fir(void **state) {
+    (void) state;
+
+    // Passband edge keeps its level once the CIC droop is compensated
+    assert_true(fabs(test_decimate_fir_tone(0)) < 0.1);
+    assert_true(fabs(test_decimate_fir_tone(DECIMATE_FIR_PASSBAND * TEST_DECIMATE_DST_RATE / 2)) < 1);
+
+    // A tone folding onto the channel is rejected
+    assert_true(test_decimate_fir_tone(TEST_DECIMATE_DST_RATE * 3 / 4) < -60);
+}
+
+void test_decimate_fir_fixed(void **state) {
+    (void) state;
+
+    decimate_ctx *ctx;
+    fixed_complex input[TEST_DECIMATE_FIR_INPUT_SIZE];
+    fixed_complex output[TEST_DECIMATE_FIR_INPUT_SIZE];
+    size_t output_size;
+    size_t i;
+
+    ctx = decimate_init(TEST_DECIMATE_FIR_SRC_RATE, TEST_DECIMATE_DST_RATE, TEST_DECIMATE_FIR_INPUT_SIZE);
+    assert_non_null(ctx);
+    output_size = decimate_compute_output_size(ctx, TEST_DECIMATE_FIR_INPUT_SIZE);
+
+    for (i = 0; i < TEST_DECIMATE_FIR_INPUT_SIZE; i++) {
+        input[i].i = FIXED_Q15_HALF;
+        input[i].q = -FIXED_Q15_HALF / 2;
+    }
+
+    for (i = 0; i < TEST_DECIMATE_ITERATIONS; i++)
+        assert_int_equal(EXIT_SUCCESS, decimate_do_fixed(ctx, input, TEST_DECIMATE_FIR_INPUT_SIZE, output));
+
+    for (i = 0; i < output_size; i++) {
+        assert_true(abs(output[i].i - FIXED_Q15_HALF) < 64);
+        assert_true(abs(output[i].q + FIXED_Q15_HALF / 2) < 64);
+    }
+
+    decimate_free(ctx);
+}
+
+static double test_decimate_fir_tone(double frequency) {
+    decimate_ctx *ctx;
+    FP_FLOAT complex input[TEST_DECIMATE_FIR_INPUT_SIZE];
+    FP_FLOAT complex output[TEST_DECIMATE_FIR_INPUT_SIZE];
+    size_t output_size;
+    size_t n;
+    size_t j;
+    size_t i;
+    double phase;
+    double power;
+
+    ctx = decimate_init(TEST_DECIMATE_FIR_SRC_RATE, TEST_DECIMATE_DST_RATE, TEST_DECIMATE_FIR_INPUT_SIZE);
+    assert_non_null(ctx);
+    output_size = decimate_compute_output_size(ctx, TEST_DECIMATE_FIR_INPUT_SIZE);
+
+    n = 0;
+    power = 0;
+
+    for (i = 0; i < TEST_DECIMATE_ITERATIONS; i++) {
+        for (j = 0; j < TEST_DECIMATE_FIR_INPUT_SIZE; j++) {
+            phase = 2 * M_PI * frequency * (double) n / TEST_DECIMATE_FIR_SRC_RATE;
+            input[j] = (FP_FLOAT) cos(phase) + (FP_FLOAT) sin(phase) * I;
+            n++;
+        }
+
+        assert_int_equal(EXIT_SUCCESS, decimate_do(ctx, input, TEST_DECIMATE_FIR_INPUT_SIZE, output));
+    }
+
+    for (i = 0; i < output_size; i++)
+        power += pow(cabs(output[i]), 2);
+
+    decimate_free(ctx);
+
+    return 10 * log10(power / (double) output_size);
+}
@@ -0,0 +1,56 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__DECIMATE__H__TEST
+#define __RTLSDR_RADIO__DECIMATE__H__TEST
+
+#include "../src/decimate.h"
+
+#define TEST_DECIMATE_SRC_RATE 2048000
+#define TEST_DECIMATE_DST_RATE 32000
+#define TEST_DECIMATE_INPUT_SIZE 2048
+
+#define TEST_DECIMATE_FIR_SRC_RATE 2400000
+#define TEST_DECIMATE_FIR_INPUT_SIZE 2400
+
+#define TEST_DECIMATE_ITERATIONS 16
+
+static int test_decimate_setup(void **);
+
+static int test_decimate_teardown(void **);
+
+void test_decimate_init(void **);
+
+void test_decimate_stages(void **);
+
+void test_decimate_invalid_rates(void **);
+
+void test_decimate_dc_gain(void **);
+
+void test_decimate_stopband(void **);
+
+void test_decimate_dc_gain_fixed(void **);
+
+void test_decimate_fir(void **);
+
+void test_decimate_fir_fixed(void **);
+
+static double test_decimate_fir_tone(double);
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "fec.h"
+
+static void test_fec_frame(uint8_t *, uint64_t);
+
+static fec_result test_fec_repair(fec_ctx *, fec_ctx *);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_fec_init),
+        cmocka_unit_test(test_fec_encode),
+        cmocka_unit_test(test_fec_recover),
+        cmocka_unit_test(test_fec_recover_size),
+        cmocka_unit_test(test_fec_unrecoverable),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("fec", tests, NULL, NULL);
+}
+
+void test_fec_init(void **state) {
+    (void) state;
+
+    fec_ctx *ctx;
+
+    assert_null(fec_init(1, TEST_FEC_FRAME_SIZE));
+    assert_null(fec_init(FEC_GROUP_SIZE_MAX + 1, TEST_FEC_FRAME_SIZE));
+    assert_null(fec_init(TEST_FEC_GROUP_SIZE, 0));
+
+    ctx = fec_init(TEST_FEC_GROUP_SIZE, TEST_FEC_FRAME_SIZE);
+    assert_non_null(ctx);
+    assert_int_equal(FEC_NONE, fec_flush(ctx));
+
+    fec_free(ctx);
+}
+
+void test_fec_encode(void **state) {
+    (void) state;
+
+    fec_ctx *ctx;
+    uint8_t data[TEST_FEC_FRAME_SIZE];
+    uint64_t n;
+
+    ctx = fec_init(TEST_FEC_GROUP_SIZE, TEST_FEC_FRAME_SIZE);
+    assert_non_null(ctx);
+
+    for (n = 8; n < 11; n++) {
+        test_fec_frame(data, n);
+        assert_int_equal(FEC_NONE, fec_encode(ctx, n, TEST_FEC_EPOCH + n * 40, data, TEST_FEC_FRAME_SIZE));
+    }
+
+    test_fec_frame(data, 11);
+    assert_int_equal(FEC_REPAIR, fec_encode(ctx, 11, TEST_FEC_EPOCH + 11 * 40, data, TEST_FEC_FRAME_SIZE));
+    assert_int_equal(8, ctx->repair.base);
+    assert_int_equal(0x0F, ctx->repair.mask);
+    assert_int_equal(TEST_FEC_FRAME_SIZE, ctx->repair.data_size);
+    assert_int_equal(0, ctx->repair.size);
+
+    // A group left behind is completed by the first frame of a later one
+    test_fec_frame(data, 12);
+    assert_int_equal(FEC_NONE, fec_encode(ctx, 12, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE));
+    assert_int_equal(FEC_NONE, fec_encode(ctx, 12, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE));
+    assert_int_equal(FEC_NONE, fec_encode(ctx, 14, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE));
+    assert_int_equal(FEC_REPAIR, fec_encode(ctx, 17, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE));
+    assert_int_equal(12, ctx->repair.base);
+    assert_int_equal(0x05, ctx->repair.mask);
+
+    // Single frame groups get no repair
+    assert_int_equal(FEC_NONE, fec_encode(ctx, 21, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE));
+    assert_int_equal(FEC_NONE, fec_flush(ctx));
+    assert_int_equal(2, ctx->repairs);
+
+    assert_int_equal(FEC_NONE, fec_encode(ctx, 24, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE + 1));
+    assert_int_equal(FEC_NONE, fec_flush(ctx));
+
+    fec_free(ctx);
+}
+
+void test_fec_recover(void **state) {
+    (void) state;
+
+    fec_ctx *encoder;
+    fec_ctx *decoder;
+    uint8_t data[TEST_FEC_FRAME_SIZE];
+    uint64_t n;
+
+    encoder = fec_init(TEST_FEC_GROUP_SIZE, TEST_FEC_FRAME_SIZE);
+    decoder = fec_init(FEC_GROUP_SIZE_MAX, TEST_FEC_FRAME_SIZE);
+    assert_non_null(encoder);
+    assert_non_null(decoder);
+
+    for (n = 0; n < TEST_FEC_GROUP_SIZE; n++) {
+        test_fec_frame(data, n);
+        fec_encode(encoder, n, TEST_FEC_EPOCH + n * 40, data, TEST_FEC_FRAME_SIZE);
+        if (n != 2)
+            fec_decode_frame(decoder, n, TEST_FEC_EPOCH + n * 40, data, TEST_FEC_FRAME_SIZE);
+    }
+
+    assert_int_equal(FEC_RECOVERED, test_fec_repair(encoder, decoder));
+    assert_int_equal(2, decoder->recovered.number);
+    assert_int_equal(TEST_FEC_EPOCH + 80, decoder->recovered.timestamp);
+    assert_int_equal(TEST_FEC_FRAME_SIZE, decoder->recovered.size);
+
+    test_fec_frame(data, 2);
+    assert_memory_equal(data, decoder->recovered.data, TEST_FEC_FRAME_SIZE);
+    assert_int_equal(1, decoder->recoveries);
+
+    // Nothing is missing anymore
+    assert_int_equal(FEC_NONE, test_fec_repair(encoder, decoder));
+    assert_int_equal(1, decoder->recoveries);
+
+    fec_free(decoder);
+    fec_free(encoder);
+}
+
+void test_fec_recover_size(void **state) {
+    (void) state;
+
+    fec_ctx *encoder;
+    fec_ctx *decoder;
+    uint8_t data[TEST_FEC_FRAME_SIZE];
+
+    encoder = fec_init(TEST_FEC_GROUP_SIZE, TEST_FEC_FRAME_SIZE);
+    decoder = fec_init(FEC_GROUP_SIZE_MAX, TEST_FEC_FRAME_SIZE);
+    assert_non_null(encoder);
+    assert_non_null(decoder);
+
+    test_fec_frame(data, 4);
+    fec_encode(encoder, 4, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE);
+    fec_decode_frame(decoder, 4, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE);
+
+    test_fec_frame(data, 5);
+    fec_encode(encoder, 5, TEST_FEC_EPOCH + 40, data, 3);
+
+    assert_int_equal(FEC_REPAIR, fec_flush(encoder));
+    assert_int_equal(TEST_FEC_FRAME_SIZE, encoder->repair.data_size);
+
+    assert_int_equal(FEC_RECOVERED, test_fec_repair(encoder, decoder));
+    assert_int_equal(5, decoder->recovered.number);
+    assert_int_equal(3, decoder->recovered.size);
+    assert_memory_equal(data, decoder->recovered.data, 3);
+
+    fec_free(decoder);
+    fec_free(encoder);
+}
+
+void test_fec_unrecoverable(void **state) {
+    (void) state;
+
+    fec_ctx *encoder;
+    fec_ctx *decoder;
+    uint8_t data[TEST_FEC_FRAME_SIZE];
+    uint64_t n;
+
+    encoder = fec_init(TEST_FEC_GROUP_SIZE, TEST_FEC_FRAME_SIZE);
+    decoder = fec_init(FEC_GROUP_SIZE_MAX, TEST_FEC_FRAME_SIZE);
+    assert_non_null(encoder);
+    assert_non_null(decoder);
+
+    for (n = 0; n < TEST_FEC_GROUP_SIZE; n++) {
+        test_fec_frame(data, n);
+        fec_encode(encoder, n, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE);
+        if (n == 0 || n == 3)
+            fec_decode_frame(decoder, n, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE);
+    }
+
+    assert_int_equal(FEC_NONE, test_fec_repair(encoder, decoder));
+    assert_int_equal(1, decoder->failures);
+
+    // Frames older than the history are gone
+    for (n = FEC_HISTORY; n < FEC_HISTORY + 2; n++)
+        fec_decode_frame(decoder, n, TEST_FEC_EPOCH, data, TEST_FEC_FRAME_SIZE);
+
+    assert_int_equal(FEC_NONE, test_fec_repair(encoder, decoder));
+    assert_int_equal(2, decoder->failures);
+    assert_int_equal(0, decoder->recoveries);
+
+    fec_free(decoder);
+    fec_free(encoder);
+}
+
+static void test_fec_frame(uint8_t *data, uint64_t number) {
+    size_t i;
+
+    for (i = 0; i < TEST_FEC_FRAME_SIZE; i++)
+        data[i] = (uint8_t) (number * 31 + i * 7);
+}
+
+static fec_result test_fec_repair(fec_ctx *encoder, fec_ctx *decoder) {
+    return fec_decode_repair(decoder, encoder->repair.base, encoder->repair.mask, encoder->repair.timestamp,
+                             encoder->repair.size, encoder->repair.data, encoder->repair.data_size);
+}
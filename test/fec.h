@@ -0,0 +1,39 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__FEC__H__TEST
+#define __RTLSDR_RADIO__FEC__H__TEST
+
+#include "../src/fec.h"
+
+#define TEST_FEC_GROUP_SIZE 4
+#define TEST_FEC_FRAME_SIZE 8
+#define TEST_FEC_EPOCH 1600000000000ULL
+
+void test_fec_init(void **);
+
+void test_fec_encode(void **);
+
+void test_fec_recover(void **);
+
+void test_fec_recover_size(void **);
+
+void test_fec_unrecoverable(void **);
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "fft.h"
+
+static void test_fft_tone(FFT_FLOAT complex *);
+
+static void test_fft_check(const FFT_FLOAT complex *, const FFT_FLOAT complex *);
+
+static void test_fft_wisdom_path(char *, size_t);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_fft_estimate),
+        cmocka_unit_test(test_fft_replan),
+        cmocka_unit_test(test_fft_wisdom),
+        cmocka_unit_test(test_fft_handover),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("fft", tests, NULL, NULL);
+}
+
+void test_fft_estimate(void **state) {
+    (void) state;
+
+    fft_ctx *ctx;
+    FFT_FLOAT complex input[TEST_FFT_SIZE];
+    FFT_FLOAT complex output[TEST_FFT_SIZE];
+    size_t i;
+
+    assert_int_equal(EXIT_SUCCESS, fft_wisdom_init(NULL));
+
+    ctx = fft_init(TEST_FFT_SIZE, FFTW_FORWARD, FFT_DATA_TYPE_COMPLEX, FFT_RIGOR_ESTIMATE);
+    assert_non_null(ctx);
+    assert_non_null(ctx->plan);
+    assert_int_equal(FFT_REPLAN_NONE, ctx->replan_state);
+
+    test_fft_tone(input);
+    assert_int_equal(EXIT_SUCCESS, fft_complex_compute(ctx, input, output));
+
+    for (i = 0; i < TEST_FFT_SIZE; i++)
+        if (i == TEST_FFT_BIN)
+            assert_true(fabs((double) cabs(output[i]) - TEST_FFT_SIZE) < TEST_FFT_TOLERANCE);
+        else
+            assert_true(fabs((double) cabs(output[i])) < TEST_FFT_TOLERANCE);
+
+    fft_free(ctx);
+}
+
+void test_fft_replan(void **state) {
+    (void) state;
+
+    fft_ctx *ctx;
+    FFT_plan estimated;
+    FFT_FLOAT complex input[TEST_FFT_SIZE];
+    FFT_FLOAT complex before[TEST_FFT_SIZE];
+    FFT_FLOAT complex after[TEST_FFT_SIZE];
+    char path[64];
+
+    test_fft_wisdom_path(path, sizeof(path));
+    FFT_forget_wisdom();
+    assert_int_equal(EXIT_SUCCESS, fft_wisdom_init(path));
+
+    ctx = fft_init(TEST_FFT_SIZE, FFTW_FORWARD, FFT_DATA_TYPE_COMPLEX, FFT_RIGOR_MEASURE);
+    assert_non_null(ctx);
+
+    fft_wait_replan(ctx);
+    assert_int_equal(FFT_REPLAN_NONE, ctx->replan_state);
+    assert_int_equal(1, ctx->replan_ready);
+    assert_non_null(ctx->replan);
+
+    // The re-planned FFT has been saved to the wisdom file
+    assert_int_equal(0, access(path, R_OK));
+
+    test_fft_tone(input);
+
+    estimated = ctx->plan;
+    memcpy(ctx->complex_input, input, sizeof(input));
+    FFT_execute_dft(ctx->plan, ctx->complex_input, ctx->complex_output);
+    memcpy(before, ctx->complex_output, sizeof(before));
+
+    // The next compute swaps the plans and gives the same result
+    assert_int_equal(EXIT_SUCCESS, fft_complex_compute(ctx, input, after));
+    assert_int_equal(0, ctx->replan_ready);
+    assert_ptr_not_equal(estimated, ctx->plan);
+    assert_ptr_equal(estimated, ctx->replan);
+
+    test_fft_check(before, after);
+
+    fft_free(ctx);
+    fft_replan_stop();
+
+    fft_wisdom_free();
+    unlink(path);
+}
+
+void test_fft_wisdom(void **state) {
+    (void) state;
+
+    fft_ctx *ctx;
+    FFT_FLOAT complex input[TEST_FFT_SIZE];
+    FFT_FLOAT complex first[TEST_FFT_SIZE];
+    FFT_FLOAT complex second[TEST_FFT_SIZE];
+    char path[64];
+
+    test_fft_wisdom_path(path, sizeof(path));
+    FFT_forget_wisdom();
+    assert_int_equal(EXIT_SUCCESS, fft_wisdom_init(path));
+
+    ctx = fft_init(TEST_FFT_SIZE, FFTW_BACKWARD, FFT_DATA_TYPE_COMPLEX, FFT_RIGOR_MEASURE);
+    assert_non_null(ctx);
+    fft_wait_replan(ctx);
+
+    test_fft_tone(input);
+    assert_int_equal(EXIT_SUCCESS, fft_complex_compute(ctx, input, first));
+
+    fft_free(ctx);
+    fft_replan_stop();
+
+    // Once reloaded, the wisdom gives the rigorous plan right away
+    FFT_forget_wisdom();
+    assert_int_equal(EXIT_SUCCESS, fft_wisdom_init(path));
+
+    ctx = fft_init(TEST_FFT_SIZE, FFTW_BACKWARD, FFT_DATA_TYPE_COMPLEX, FFT_RIGOR_MEASURE);
+    assert_non_null(ctx);
+    assert_int_equal(FFT_REPLAN_NONE, ctx->replan_state);
+    assert_null(ctx->replan);
+
+    assert_int_equal(EXIT_SUCCESS, fft_complex_compute(ctx, input, second));
+    test_fft_check(first, second);
+
+    fft_free(ctx);
+    fft_replan_stop();
+
+    fft_wisdom_free();
+    unlink(path);
+}
+
+void test_fft_handover(void **state) {
+    (void) state;
+
+    fft_ctx *first;
+    fft_ctx *second;
+    char path[64];
+
+    test_fft_wisdom_path(path, sizeof(path));
+    FFT_forget_wisdom();
+    assert_int_equal(EXIT_SUCCESS, fft_wisdom_init(path));
+
+    first = fft_init(TEST_FFT_SIZE, FFTW_FORWARD, FFT_DATA_TYPE_COMPLEX, FFT_RIGOR_MEASURE);
+    second = fft_init(TEST_FFT_SIZE * 2, FFTW_FORWARD, FFT_DATA_TYPE_COMPLEX, FFT_RIGOR_MEASURE);
+    assert_non_null(first);
+    assert_non_null(second);
+
+    // Freeing never waits for the re-plan, the worker discards it and frees the context
+    fft_free(first);
+    fft_free(second);
+
+    fft_replan_stop();
+
+    fft_wisdom_free();
+    unlink(path);
+}
+
+static void test_fft_tone(FFT_FLOAT complex *input) {
+    size_t i;
+
+    for (i = 0; i < TEST_FFT_SIZE; i++)
+        input[i] = (FFT_FLOAT) cos(2 * M_PI * TEST_FFT_BIN * (double) i / TEST_FFT_SIZE)
+                   + (FFT_FLOAT) sin(2 * M_PI * TEST_FFT_BIN * (double) i / TEST_FFT_SIZE) * I;
+}
+
+static void test_fft_check(const FFT_FLOAT complex *expected, const FFT_FLOAT complex *actual) {
+    size_t i;
+
+    for (i = 0; i < TEST_FFT_SIZE; i++)
+        assert_true(fabs((double) cabs(expected[i] - actual[i])) < TEST_FFT_TOLERANCE);
+}
+
+static void test_fft_wisdom_path(char *path, size_t size) {
+    snprintf(path, size, "/tmp/rtlsdr-radio-test-fft-%d.wisdom", getpid());
+    unlink(path);
+}
@@ -0,0 +1,39 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__FFT__H__TEST
+#define __RTLSDR_RADIO__FFT__H__TEST
+
+#include "../src/fft.h"
+
+#define TEST_FFT_SIZE 64
+#define TEST_FFT_BIN 5
+#define TEST_FFT_TOLERANCE 1e-3
+
+#define FFT_forget_wisdom CONCAT(FFT_prefix, _forget_wisdom)
+
+void test_fft_estimate(void **);
+
+void test_fft_replan(void **);
+
+void test_fft_wisdom(void **);
+
+void test_fft_handover(void **);
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "fir.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_fir_init),
+        cmocka_unit_test(test_fir_invalid),
+        cmocka_unit_test(test_fir_dot),
+        cmocka_unit_test(test_fir_impulse),
+        cmocka_unit_test(test_fir_decimation),
+        cmocka_unit_test(test_fir_impulse_fixed),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("fir", tests, NULL, NULL);
+}
+
+static void test_fir_kernel(FP_FLOAT *kernel) {
+    size_t i;
+
+    for (i = 0; i < TEST_FIR_KERNEL_SIZE; i++)
+        kernel[i] = (FP_FLOAT) (i + 1) / TEST_FIR_KERNEL_SIZE;
+}
+
+void test_fir_init(void **state) {
+    (void) state;
+
+    fir_ctx *ctx;
+    FP_FLOAT kernel[TEST_FIR_KERNEL_SIZE];
+
+    test_fir_kernel(kernel);
+
+    ctx = fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, 1);
+    assert_non_null(ctx);
+
+    assert_int_equal(TEST_FIR_KERNEL_SIZE, ctx->kernel_size);
+    assert_int_equal(TEST_FIR_KERNEL_SIZE - 1 + TEST_FIR_INPUT_SIZE, ctx->buffer_size);
+    assert_true(ctx->kernel[0] == kernel[TEST_FIR_KERNEL_SIZE - 1]);
+    assert_true(ctx->kernel[TEST_FIR_KERNEL_SIZE - 1] == kernel[0]);
+
+    assert_int_equal(TEST_FIR_INPUT_SIZE, fir_compute_output_size(ctx, TEST_FIR_INPUT_SIZE));
+
+    fir_free(ctx);
+}
+
+void test_fir_invalid(void **state) {
+    (void) state;
+
+    fir_ctx *ctx;
+    FP_FLOAT kernel[TEST_FIR_KERNEL_SIZE];
+    FP_FLOAT buffer[TEST_FIR_INPUT_SIZE];
+
+    test_fir_kernel(kernel);
+
+    assert_null(fir_init(kernel, 0, TEST_FIR_INPUT_SIZE, 1));
+    assert_null(fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, 0));
+    assert_null(fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, 3));
+
+    ctx = fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, TEST_FIR_DECIMATION);
+    assert_non_null(ctx);
+    assert_int_equal(EXIT_FAILURE, fir_convolve(ctx, buffer, TEST_FIR_INPUT_SIZE * 2, buffer));
+    assert_int_equal(EXIT_FAILURE, fir_convolve(ctx, buffer, TEST_FIR_INPUT_SIZE - 1, buffer));
+    fir_free(ctx);
+}
+
+void test_fir_dot(void **state) {
+    (void) state;
+
+    FP_FLOAT a[TEST_FIR_KERNEL_SIZE];
+    FP_FLOAT b[TEST_FIR_KERNEL_SIZE];
+    double expected;
+    size_t size;
+    size_t i;
+
+    for (i = 0; i < TEST_FIR_KERNEL_SIZE; i++) {
+        a[i] = (FP_FLOAT) sin((double) i);
+        b[i] = (FP_FLOAT) cos((double) i * 0.5);
+    }
+
+    for (size = 0; size <= TEST_FIR_KERNEL_SIZE; size++) {
+        expected = 0;
+        for (i = 0; i < size; i++)
+            expected += a[i] * b[i];
+
+        assert_true(fabs((double) fir_dot(a, b, size) - expected) < 1e-4);
+    }
+}
+
+void test_fir_impulse(void **state) {
+    (void) state;
+
+    fir_ctx *ctx;
+    FP_FLOAT kernel[TEST_FIR_KERNEL_SIZE];
+    FP_FLOAT input[TEST_FIR_INPUT_SIZE];
+    FP_FLOAT output[TEST_FIR_INPUT_SIZE * TEST_FIR_BLOCKS];
+    size_t i;
+
+    test_fir_kernel(kernel);
+
+    ctx = fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, 1);
+    assert_non_null(ctx);
+
+    for (i = 0; i < TEST_FIR_BLOCKS; i++) {
+        memset(input, 0, sizeof(input));
+        if (i == 0)
+            input[0] = 1;
+
+        assert_int_equal(EXIT_SUCCESS,
+                         fir_convolve(ctx, input, TEST_FIR_INPUT_SIZE, output + i * TEST_FIR_INPUT_SIZE));
+    }
+
+    for (i = 0; i < TEST_FIR_INPUT_SIZE * TEST_FIR_BLOCKS; i++)
+        if (i < TEST_FIR_KERNEL_SIZE)
+            assert_true(fabs((double) (output[i] - kernel[i])) < 1e-6);
+        else
+            assert_true(output[i] == 0);
+
+    fir_free(ctx);
+}
+
+void test_fir_decimation(void **state) {
+    (void) state;
+
+    fir_ctx *full_ctx;
+    fir_ctx *dec_ctx;
+    FP_FLOAT kernel[TEST_FIR_KERNEL_SIZE];
+    FP_FLOAT input[TEST_FIR_INPUT_SIZE];
+    FP_FLOAT full[TEST_FIR_INPUT_SIZE];
+    FP_FLOAT dec[TEST_FIR_INPUT_SIZE / TEST_FIR_DECIMATION];
+    size_t n;
+    size_t i;
+    size_t j;
+
+    test_fir_kernel(kernel);
+
+    full_ctx = fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, 1);
+    dec_ctx = fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, TEST_FIR_DECIMATION);
+    assert_non_null(full_ctx);
+    assert_non_null(dec_ctx);
+
+    assert_int_equal(TEST_FIR_INPUT_SIZE / TEST_FIR_DECIMATION,
+                     fir_compute_output_size(dec_ctx, TEST_FIR_INPUT_SIZE));
+
+    n = 0;
+
+    for (i = 0; i < TEST_FIR_BLOCKS; i++) {
+        for (j = 0; j < TEST_FIR_INPUT_SIZE; j++) {
+            input[j] = (FP_FLOAT) sin(0.3 * (double) n);
+            n++;
+        }
+
+        assert_int_equal(EXIT_SUCCESS, fir_convolve(full_ctx, input, TEST_FIR_INPUT_SIZE, full));
+        assert_int_equal(EXIT_SUCCESS, fir_convolve(dec_ctx, input, TEST_FIR_INPUT_SIZE, dec));
+
+        for (j = 0; j < TEST_FIR_INPUT_SIZE / TEST_FIR_DECIMATION; j++)
+            assert_true(fabs((double) (dec[j] - full[(j + 1) * TEST_FIR_DECIMATION - 1])) < 1e-5);
+    }
+
+    fir_free(full_ctx);
+    fir_free(dec_ctx);
+}
+
+void test_fir_impulse_fixed(void **state) {
+    (void) state;
+
+    fir_ctx *ctx;
+    FP_FLOAT kernel[TEST_FIR_KERNEL_SIZE];
+    int16_t input[TEST_FIR_INPUT_SIZE];
+    int16_t output[TEST_FIR_INPUT_SIZE * TEST_FIR_BLOCKS];
+    size_t i;
+
+    test_fir_kernel(kernel);
+
+    ctx = fir_init(kernel, TEST_FIR_KERNEL_SIZE, TEST_FIR_INPUT_SIZE, 1);
+    assert_non_null(ctx);
+
+    for (i = 0; i < TEST_FIR_BLOCKS; i++) {
+        memset(input, 0, sizeof(input));
+        if (i == 0)
+            input[0] = FIXED_Q15_HALF;
+
+        assert_int_equal(EXIT_SUCCESS,
+                         fir_convolve_fixed(ctx, input, TEST_FIR_INPUT_SIZE, output + i * TEST_FIR_INPUT_SIZE));
+    }
+
+    for (i = 0; i < TEST_FIR_INPUT_SIZE * TEST_FIR_BLOCKS; i++)
+        if (i < TEST_FIR_KERNEL_SIZE)
+            assert_true(fabs((double) output[i] - (double) kernel[i] * FIXED_Q15_HALF) <= 2);
+        else
+            assert_int_equal(0, output[i]);
+
+    fir_free(ctx);
+}
@@ -0,0 +1,42 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__FIR__H__TEST
+#define __RTLSDR_RADIO__FIR__H__TEST
+
+#include "../src/fir.h"
+
+#define TEST_FIR_KERNEL_SIZE 37
+#define TEST_FIR_INPUT_SIZE 16
+#define TEST_FIR_BLOCKS 4
+#define TEST_FIR_DECIMATION 4
+
+void test_fir_init(void **);
+
+void test_fir_invalid(void **);
+
+void test_fir_dot(void **);
+
+void test_fir_impulse(void **);
+
+void test_fir_decimation(void **);
+
+void test_fir_impulse_fixed(void **);
+
+#endif
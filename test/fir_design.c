@@ -0,0 +1,187 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "fir_design.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_fir_design_windowed_sinc),
+        cmocka_unit_test(test_fir_design_kaiser),
+        cmocka_unit_test(test_fir_design_equiripple),
+        cmocka_unit_test(test_fir_design_minimum_taps),
+        cmocka_unit_test(test_fir_design_cache),
+        cmocka_unit_test(test_fir_design_invalid),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("fir_design", tests, NULL, NULL);
+}
+
+static double test_fir_design_response(const fir_design *design, double freq) {
+    double re;
+    double im;
+    size_t i;
+
+    re = 0;
+    im = 0;
+
+    for (i = 0; i < design->taps_size; i++) {
+        re += (double) design->taps[i] * cos(2 * M_PI * freq * (double) i);
+        im -= (double) design->taps[i] * sin(2 * M_PI * freq * (double) i);
+    }
+
+    return sqrt(re * re + im * im);
+}
+
+static void test_fir_design_check(fir_design_type type, double tolerance) {
+    fir_design_params params;
+    fir_design *design;
+    double pass;
+    double stop;
+    double freq;
+    double gain;
+    size_t i;
+
+    params.type = type;
+    params.sample_rate = TEST_FIR_DESIGN_SAMPLE_RATE;
+    params.cutoff = TEST_FIR_DESIGN_CUTOFF;
+    params.transition = TEST_FIR_DESIGN_TRANSITION;
+    params.attenuation = TEST_FIR_DESIGN_ATTENUATION;
+
+    design = fir_design_compute(&params);
+    assert_non_null(design);
+    assert_int_equal(1, design->taps_size % 2);
+
+    for (i = 0; i < design->taps_size / 2; i++)
+        assert_true(fabs((double) (design->taps[i] - design->taps[design->taps_size - 1 - i])) < 1e-9);
+
+    pass = (TEST_FIR_DESIGN_CUTOFF - TEST_FIR_DESIGN_TRANSITION / 2.0) / TEST_FIR_DESIGN_SAMPLE_RATE;
+    stop = (TEST_FIR_DESIGN_CUTOFF + TEST_FIR_DESIGN_TRANSITION / 2.0) / TEST_FIR_DESIGN_SAMPLE_RATE;
+
+    for (i = 0; i <= TEST_FIR_DESIGN_POINTS; i++) {
+        freq = pass * (double) i / TEST_FIR_DESIGN_POINTS;
+        gain = test_fir_design_response(design, freq);
+        assert_true(fabs(gain - 1) < 0.02);
+
+        freq = stop + (0.5 - stop) * (double) i / TEST_FIR_DESIGN_POINTS;
+        gain = 20 * log10(test_fir_design_response(design, freq));
+        assert_true(gain < -TEST_FIR_DESIGN_ATTENUATION + tolerance);
+    }
+
+    fir_design_free(design);
+}
+
+void test_fir_design_windowed_sinc(void **state) {
+    (void) state;
+
+    test_fir_design_check(FIR_DESIGN_TYPE_WINDOWED_SINC, 0);
+}
+
+void test_fir_design_kaiser(void **state) {
+    (void) state;
+
+    test_fir_design_check(FIR_DESIGN_TYPE_KAISER, 0.5);
+}
+
+void test_fir_design_equiripple(void **state) {
+    (void) state;
+
+    test_fir_design_check(FIR_DESIGN_TYPE_EQUIRIPPLE, 0.5);
+}
+
+void test_fir_design_minimum_taps(void **state) {
+    (void) state;
+
+    fir_design_params params;
+    fir_design *kaiser;
+    fir_design *equiripple;
+
+    params.sample_rate = TEST_FIR_DESIGN_SAMPLE_RATE;
+    params.cutoff = TEST_FIR_DESIGN_CUTOFF;
+    params.transition = TEST_FIR_DESIGN_TRANSITION;
+    params.attenuation = TEST_FIR_DESIGN_ATTENUATION;
+
+    params.type = FIR_DESIGN_TYPE_KAISER;
+    kaiser = fir_design_compute(&params);
+    assert_non_null(kaiser);
+
+    params.type = FIR_DESIGN_TYPE_EQUIRIPPLE;
+    equiripple = fir_design_compute(&params);
+    assert_non_null(equiripple);
+
+    assert_true(equiripple->taps_size < kaiser->taps_size);
+
+    fir_design_free(kaiser);
+    fir_design_free(equiripple);
+}
+
+void test_fir_design_cache(void **state) {
+    (void) state;
+
+    fir_design_params params;
+    const fir_design *first;
+    const fir_design *second;
+    const fir_design *other;
+
+    params.type = FIR_DESIGN_TYPE_KAISER;
+    params.sample_rate = TEST_FIR_DESIGN_SAMPLE_RATE;
+    params.cutoff = TEST_FIR_DESIGN_CUTOFF;
+    params.transition = TEST_FIR_DESIGN_TRANSITION;
+    params.attenuation = TEST_FIR_DESIGN_ATTENUATION;
+
+    first = fir_design_get(&params);
+    second = fir_design_get(&params);
+    assert_non_null(first);
+    assert_ptr_equal(first, second);
+
+    params.sample_rate *= 2;
+    other = fir_design_get(&params);
+    assert_non_null(other);
+    assert_ptr_not_equal(first, other);
+    assert_true(other->taps_size > first->taps_size);
+
+    fir_design_cache_free();
+}
+
+void test_fir_design_invalid(void **state) {
+    (void) state;
+
+    fir_design_params params;
+
+    params.type = FIR_DESIGN_TYPE_KAISER;
+    params.sample_rate = TEST_FIR_DESIGN_SAMPLE_RATE;
+    params.cutoff = TEST_FIR_DESIGN_SAMPLE_RATE / 2;
+    params.transition = TEST_FIR_DESIGN_TRANSITION;
+    params.attenuation = TEST_FIR_DESIGN_ATTENUATION;
+    assert_null(fir_design_compute(&params));
+
+    params.cutoff = TEST_FIR_DESIGN_CUTOFF;
+    params.transition = 0;
+    assert_null(fir_design_compute(&params));
+
+    params.transition = 2 * TEST_FIR_DESIGN_CUTOFF;
+    assert_null(fir_design_compute(&params));
+}
@@ -0,0 +1,48 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__FIR_DESIGN__H__TEST
+#define __RTLSDR_RADIO__FIR_DESIGN__H__TEST
+
+#include "../src/fir_design.h"
+
+#define TEST_FIR_DESIGN_SAMPLE_RATE 32000
+#define TEST_FIR_DESIGN_CUTOFF 3500
+#define TEST_FIR_DESIGN_TRANSITION 1500
+#define TEST_FIR_DESIGN_ATTENUATION 60
+
+#define TEST_FIR_DESIGN_POINTS 500
+
+static double test_fir_design_response(const fir_design *, double);
+
+static void test_fir_design_check(fir_design_type, double);
+
+void test_fir_design_windowed_sinc(void **);
+
+void test_fir_design_kaiser(void **);
+
+void test_fir_design_equiripple(void **);
+
+void test_fir_design_minimum_taps(void **);
+
+void test_fir_design_cache(void **);
+
+void test_fir_design_invalid(void **);
+
+#endif
@@ -55,6 +55,9 @@ const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_greatbuf_circbuf_rotation_head_acquire,
                                         test_greatbuf_circbuf_setup,
                                         test_greatbuf_circbuf_teardown),
+        cmocka_unit_test_setup_teardown(test_greatbuf_circbuf_head_last,
+                                        test_greatbuf_circbuf_setup,
+                                        test_greatbuf_circbuf_teardown),
         cmocka_unit_test_setup_teardown(test_greatbuf_init, test_greatbuf_setup, test_greatbuf_teardown),
 };
 
@@ -93,8 +96,10 @@ static int test_greatbuf_setup(void **state) {
 
     test_state->ctx = greatbuf_init(TEST_GREATBUF_BUFFER_SIZE,
                                     TEST_GREATBUF_RTLSDR_SAMPLES,
+                                    TEST_GREATBUF_CHANNEL_SAMPLES,
                                     TEST_GREATBUF_PCM_SAMPLES,
-                                    TEST_GREATBUF_DATA_SIZE);
+                                    TEST_GREATBUF_DATA_SIZE,
+                                    TEST_GREATBUF_CHANNELS);
     if (test_state->ctx == NULL) {
         free(test_state);
         return EXIT_FAILURE;
@@ -295,6 +300,33 @@ void test_greatbuf_circbuf_rotation_head_acquire(void **state) {
     assert_int_equal(TEST_GREATBUF_MULTIPLE_ITERATIONS * 4, ctx->free);
 }
 
+void test_greatbuf_circbuf_head_last(void **state) {
+    greatbuf_circbuf *ctx;
+    uint64_t produced;
+    ssize_t pos;
+    size_t i;
+
+    ctx = (greatbuf_circbuf *) *state;
+
+    pos = greatbuf_circbuf_head_last(ctx, &produced);
+    assert_int_equal(-1, pos);
+    assert_int_equal(0, produced);
+
+    for (i = 0; i < TEST_GREATBUF_CIRCBUF_SIZE + 3; i++) {
+        greatbuf_circbuf_head_acquire(ctx);
+        greatbuf_circbuf_head_release(ctx);
+
+        pos = greatbuf_circbuf_head_last(ctx, &produced);
+        assert_int_equal(i % TEST_GREATBUF_CIRCBUF_SIZE, pos);
+        assert_int_equal(i + 1, produced);
+
+        greatbuf_circbuf_tail_acquire(ctx);
+        greatbuf_circbuf_tail_release(ctx);
+    }
+
+    assert_int_equal(TEST_GREATBUF_CIRCBUF_SIZE, ctx->free);
+}
+
 void test_greatbuf_init(void **state) {
     test_greatbuf_state *test_state;
     greatbuf_ctx *ctx;
@@ -305,4 +337,12 @@ void test_greatbuf_init(void **state) {
     assert_non_null(ctx);
     assert_int_equal(TEST_GREATBUF_BUFFER_SIZE, ctx->size);
     assert_non_null(ctx->items);
+
+    assert_int_equal(TEST_GREATBUF_RTLSDR_SAMPLES, ctx->items[0]->samples_size);
+    assert_int_equal(TEST_GREATBUF_CHANNEL_SAMPLES, ctx->items[0]->channel_size);
+    assert_int_equal(TEST_GREATBUF_CHANNELS, ctx->items[0]->channels);
+    assert_non_null(ctx->items[0]->channel);
+
+    ctx->items[0]->pcm[TEST_GREATBUF_PCM_SAMPLES * TEST_GREATBUF_CHANNELS - 1] = 1;
+    ctx->items[0]->data[TEST_GREATBUF_DATA_SIZE * TEST_GREATBUF_CHANNELS - 1] = 1;
 }
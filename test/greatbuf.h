@@ -27,8 +27,10 @@
 
 #define TEST_GREATBUF_BUFFER_SIZE 1024
 #define TEST_GREATBUF_RTLSDR_SAMPLES 1024
+#define TEST_GREATBUF_CHANNEL_SAMPLES 128
 #define TEST_GREATBUF_PCM_SAMPLES 1024
 #define TEST_GREATBUF_DATA_SIZE 1024
+#define TEST_GREATBUF_CHANNELS 3
 
 #define TEST_GREATBUF_MULTIPLE_ITERATIONS 128
 
@@ -62,6 +64,8 @@ void test_greatbuf_circbuf_max_head_acquire(void **);
 
 void test_greatbuf_circbuf_rotation_head_acquire(void **);
 
+void test_greatbuf_circbuf_head_last(void **);
+
 void test_greatbuf_init(void **);
 
 #endif
@@ -0,0 +1,166 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <math.h>
+
+#include "iqcorr.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_iqcorr_init),
+        cmocka_unit_test(test_iqcorr_correct),
+        cmocka_unit_test(test_iqcorr_correct_fixed),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("iqcorr", tests, NULL, NULL);
+}
+
+void test_iqcorr_init(void **state) {
+    (void) state;
+
+    iqcorr_ctx *ctx;
+    FP_FLOAT complex samples[TEST_IQCORR_INPUT_SIZE];
+    size_t i;
+
+    ctx = iqcorr_init();
+    assert_non_null(ctx);
+    assert_int_equal(0, ctx->primed);
+
+    for (i = 0; i < TEST_IQCORR_INPUT_SIZE; i++)
+        samples[i] = 0;
+
+    iqcorr_do(ctx, samples, TEST_IQCORR_INPUT_SIZE);
+    assert_int_equal(1, ctx->primed);
+
+    for (i = 0; i < TEST_IQCORR_INPUT_SIZE; i++)
+        assert_true(cabs(samples[i]) < 1e-6);
+
+    iqcorr_free(ctx);
+}
+
+void test_iqcorr_correct(void **state) {
+    (void) state;
+
+    iqcorr_ctx *ctx;
+    FP_FLOAT complex samples[TEST_IQCORR_INPUT_SIZE];
+    double phase;
+    double mean_i;
+    double mean_q;
+    double power_i;
+    double power_q;
+    double cross;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = iqcorr_init();
+    assert_non_null(ctx);
+
+    n = 0;
+    mean_i = 0;
+    mean_q = 0;
+    power_i = 0;
+    power_q = 0;
+    cross = 0;
+
+    for (i = 0; i < TEST_IQCORR_ITERATIONS; i++) {
+        for (j = 0; j < TEST_IQCORR_INPUT_SIZE; j++) {
+            phase = 2 * M_PI * TEST_IQCORR_TONE * (double) n / TEST_IQCORR_SAMPLE_RATE;
+            samples[j] = (FP_FLOAT) (0.5 * cos(phase) + TEST_IQCORR_DC_I)
+                         + (FP_FLOAT) (0.5 * TEST_IQCORR_GAIN * sin(phase + TEST_IQCORR_SKEW) + TEST_IQCORR_DC_Q) * I;
+            n++;
+        }
+
+        iqcorr_do(ctx, samples, TEST_IQCORR_INPUT_SIZE);
+    }
+
+    for (j = 0; j < TEST_IQCORR_INPUT_SIZE; j++) {
+        mean_i += creal(samples[j]);
+        mean_q += cimag(samples[j]);
+        power_i += creal(samples[j]) * creal(samples[j]);
+        power_q += cimag(samples[j]) * cimag(samples[j]);
+        cross += creal(samples[j]) * cimag(samples[j]);
+    }
+
+    assert_true(fabs(mean_i / TEST_IQCORR_INPUT_SIZE) < 1e-3);
+    assert_true(fabs(mean_q / TEST_IQCORR_INPUT_SIZE) < 1e-3);
+    assert_true(fabs(power_q / power_i - 1) < 1e-2);
+    assert_true(fabs(cross / power_i) < 1e-2);
+
+    iqcorr_free(ctx);
+}
+
+void test_iqcorr_correct_fixed(void **state) {
+    (void) state;
+
+    iqcorr_ctx *ctx;
+    fixed_complex samples[TEST_IQCORR_INPUT_SIZE];
+    double phase;
+    double mean_i;
+    double mean_q;
+    double power_i;
+    double power_q;
+    double cross;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = iqcorr_init();
+    assert_non_null(ctx);
+
+    n = 0;
+    mean_i = 0;
+    mean_q = 0;
+    power_i = 0;
+    power_q = 0;
+    cross = 0;
+
+    for (i = 0; i < TEST_IQCORR_ITERATIONS; i++) {
+        for (j = 0; j < TEST_IQCORR_INPUT_SIZE; j++) {
+            phase = 2 * M_PI * TEST_IQCORR_TONE * (double) n / TEST_IQCORR_SAMPLE_RATE;
+            samples[j].i = (int16_t) lround((0.5 * cos(phase) + TEST_IQCORR_DC_I) * FIXED_Q15_ONE);
+            samples[j].q = (int16_t) lround(
+                    (0.5 * TEST_IQCORR_GAIN * sin(phase + TEST_IQCORR_SKEW) + TEST_IQCORR_DC_Q) * FIXED_Q15_ONE);
+            n++;
+        }
+
+        iqcorr_do_fixed(ctx, samples, TEST_IQCORR_INPUT_SIZE);
+    }
+
+    for (j = 0; j < TEST_IQCORR_INPUT_SIZE; j++) {
+        mean_i += samples[j].i;
+        mean_q += samples[j].q;
+        power_i += (double) samples[j].i * samples[j].i;
+        power_q += (double) samples[j].q * samples[j].q;
+        cross += (double) samples[j].i * samples[j].q;
+    }
+
+    assert_true(fabs(mean_i / TEST_IQCORR_INPUT_SIZE) < 64);
+    assert_true(fabs(mean_q / TEST_IQCORR_INPUT_SIZE) < 64);
+    assert_true(fabs(power_q / power_i - 1) < 1e-2);
+    assert_true(fabs(cross / power_i) < 1e-2);
+
+    iqcorr_free(ctx);
+}
@@ -0,0 +1,42 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef __RTLSDR_RADIO__IQCORR__H__TEST
+#define __RTLSDR_RADIO__IQCORR__H__TEST
+
+#include "../src/iqcorr.h"
+
+#define TEST_IQCORR_SAMPLE_RATE 2048000
+#define TEST_IQCORR_TONE 125000
+#define TEST_IQCORR_INPUT_SIZE 2048
+#define TEST_IQCORR_ITERATIONS 200
+
+#define TEST_IQCORR_DC_I 0.1
+#define TEST_IQCORR_DC_Q -0.05
+#define TEST_IQCORR_GAIN 1.1
+#define TEST_IQCORR_SKEW 0.1
+
+void test_iqcorr_init(void **);
+
+void test_iqcorr_correct(void **);
+
+void test_iqcorr_correct_fixed(void **);
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "iqsink.h"
+#include "../src/utils.h"
+
+static void test_iqsink_tone(FP_FLOAT complex *, size_t *);
+
+static int16_t test_iqsink_load_int16(const uint8_t *);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_iqsink_init),
+        cmocka_unit_test(test_iqsink_int16),
+        cmocka_unit_test(test_iqsink_packets),
+        cmocka_unit_test(test_iqsink_int4),
+        cmocka_unit_test(test_iqsink_fixed),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("iqsink", tests, NULL, NULL);
+}
+
+void test_iqsink_init(void **state) {
+    (void) state;
+
+    iqsink_ctx *ctx;
+
+    assert_null(iqsink_init(TEST_IQSINK_SRC_RATE, 30000, 0, TEST_IQSINK_INPUT_SIZE, IQ_FORMAT_INT16, 0));
+    assert_null(iqsink_init(TEST_IQSINK_SRC_RATE, TEST_IQSINK_DST_RATE, 0, TEST_IQSINK_INPUT_SIZE, 'x', 0));
+
+    assert_int_equal(1, iqsink_get_sample_size(IQ_FORMAT_INT4));
+    assert_int_equal(2, iqsink_get_sample_size(IQ_FORMAT_INT8));
+    assert_int_equal(4, iqsink_get_sample_size(IQ_FORMAT_INT16));
+    assert_int_equal(8, iqsink_get_sample_size(IQ_FORMAT_FLOAT));
+
+    ctx = iqsink_init(TEST_IQSINK_SRC_RATE, TEST_IQSINK_DST_RATE, TEST_IQSINK_OFFSET, TEST_IQSINK_INPUT_SIZE,
+                      IQ_FORMAT_INT16, 0);
+    assert_non_null(ctx);
+    assert_int_equal(TEST_IQSINK_INPUT_SIZE / (TEST_IQSINK_SRC_RATE / TEST_IQSINK_DST_RATE), ctx->output_size);
+    assert_int_equal(1, ctx->packets_size);
+    assert_int_equal(0, ctx->packets_count);
+
+    iqsink_free(ctx);
+}
+
+void test_iqsink_int16(void **state) {
+    (void) state;
+
+    iqsink_ctx *ctx;
+    iqsink_packet *packet;
+    FP_FLOAT complex *input;
+    uint8_t header[IQSINK_HEADER_SIZE];
+    uint8_t expected[8];
+    struct timespec ts;
+    size_t header_size;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = iqsink_init(TEST_IQSINK_SRC_RATE, TEST_IQSINK_DST_RATE, TEST_IQSINK_OFFSET, TEST_IQSINK_INPUT_SIZE,
+                      IQ_FORMAT_INT16, 0);
+    assert_non_null(ctx);
+
+    input = (FP_FLOAT complex *) calloc(TEST_IQSINK_INPUT_SIZE, sizeof(FP_FLOAT complex));
+    assert_non_null(input);
+
+    n = 0;
+
+    for (i = 0; i < TEST_IQSINK_ITERATIONS; i++) {
+        test_iqsink_tone(input, &n);
+        assert_int_equal(EXIT_SUCCESS, iqsink_process(ctx, input));
+    }
+
+    assert_int_equal(1, ctx->packets_count);
+
+    packet = &ctx->packets[0];
+    assert_int_equal((TEST_IQSINK_ITERATIONS - 1) * ctx->output_size, packet->sample);
+    assert_int_equal(ctx->output_size, packet->samples);
+    assert_int_equal(ctx->output_size * 4, packet->data_size);
+
+    // The tone sits at the offset, so it comes out as DC
+    for (j = 0; j < packet->samples; j++) {
+        assert_true(fabs(test_iqsink_load_int16(packet->data + 4 * j) - TEST_IQSINK_AMPLITUDE * INT16_MAX)
+                    < 0.05 * TEST_IQSINK_AMPLITUDE * INT16_MAX);
+        assert_true(abs(test_iqsink_load_int16(packet->data + 4 * j + 2)) < 0.05 * TEST_IQSINK_AMPLITUDE * INT16_MAX);
+    }
+
+    ts.tv_sec = 1600000000;
+    ts.tv_nsec = 250000000;
+
+    assert_int_equal(EXIT_FAILURE, iqsink_serialize_header(ctx, packet, &ts, 145000000, header,
+                                                           IQSINK_HEADER_SIZE - 1, &header_size));
+    assert_int_equal(EXIT_SUCCESS, iqsink_serialize_header(ctx, packet, &ts, 145000000, header,
+                                                           IQSINK_HEADER_SIZE, &header_size));
+    assert_int_equal(IQSINK_HEADER_SIZE, header_size);
+    assert_memory_equal(IQSINK_HEADER, header, 3);
+    assert_int_equal(IQ_FORMAT_INT16, header[IQSINK_OFFSET_FORMAT]);
+
+    utils_uint64_to_be(expected, packet->sample);
+    assert_memory_equal(expected, header + IQSINK_OFFSET_SAMPLE, sizeof(uint64_t));
+    utils_uint64_to_be(expected, 1600000000250ULL);
+    assert_memory_equal(expected, header + IQSINK_OFFSET_TIMESTAMP, sizeof(uint64_t));
+    utils_uint32_to_be(expected, 145000000 + TEST_IQSINK_OFFSET);
+    assert_memory_equal(expected, header + IQSINK_OFFSET_FREQUENCY, sizeof(uint32_t));
+    utils_uint32_to_be(expected, TEST_IQSINK_DST_RATE);
+    assert_memory_equal(expected, header + IQSINK_OFFSET_SAMPLE_RATE, sizeof(uint32_t));
+    utils_uint32_to_be(expected, (uint32_t) ctx->output_size);
+    assert_memory_equal(expected, header + IQSINK_OFFSET_SAMPLES, sizeof(uint32_t));
+
+    free(input);
+    iqsink_free(ctx);
+}
+
+void test_iqsink_packets(void **state) {
+    (void) state;
+
+    iqsink_ctx *ctx;
+    FP_FLOAT complex *input;
+    size_t n;
+
+    ctx = iqsink_init(TEST_IQSINK_SRC_RATE, TEST_IQSINK_DST_RATE, 0, TEST_IQSINK_INPUT_SIZE, IQ_FORMAT_FLOAT, 0);
+    assert_non_null(ctx);
+
+    input = (FP_FLOAT complex *) calloc(TEST_IQSINK_INPUT_SIZE, sizeof(FP_FLOAT complex));
+    assert_non_null(input);
+
+    n = 0;
+    test_iqsink_tone(input, &n);
+    assert_int_equal(EXIT_SUCCESS, iqsink_process(ctx, input));
+
+    assert_int_equal(2, ctx->packets_count);
+    assert_true(ctx->packets[0].data_size + IQSINK_HEADER_SIZE <= IQSINK_PACKET_SIZE_MAX);
+    assert_int_equal(ctx->output_size, ctx->packets[0].samples + ctx->packets[1].samples);
+    assert_int_equal(ctx->packets[0].samples, ctx->packets[1].sample);
+    assert_ptr_equal(ctx->packets[0].data + ctx->packets[0].data_size, ctx->packets[1].data);
+
+    // Skipped blocks leave a gap in the sample index
+    iqsink_skip(ctx, 2);
+    assert_int_equal(0, ctx->packets_count);
+
+    assert_int_equal(EXIT_SUCCESS, iqsink_process(ctx, input));
+    assert_int_equal(3 * ctx->output_size, ctx->packets[0].sample);
+
+    free(input);
+    iqsink_free(ctx);
+}
+
+void test_iqsink_int4(void **state) {
+    (void) state;
+
+    iqsink_ctx *ctx;
+    FP_FLOAT complex *input;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = iqsink_init(TEST_IQSINK_SRC_RATE, TEST_IQSINK_DST_RATE, TEST_IQSINK_OFFSET, TEST_IQSINK_INPUT_SIZE,
+                      IQ_FORMAT_INT4, 20);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->packets_size);
+
+    input = (FP_FLOAT complex *) calloc(TEST_IQSINK_INPUT_SIZE, sizeof(FP_FLOAT complex));
+    assert_non_null(input);
+
+    n = 0;
+
+    for (i = 0; i < TEST_IQSINK_ITERATIONS; i++) {
+        test_iqsink_tone(input, &n);
+        assert_int_equal(EXIT_SUCCESS, iqsink_process(ctx, input));
+    }
+
+    // 20 dB of gain on a half scale tone clip I to +7, Q stays around 0
+    assert_int_equal(ctx->output_size, ctx->packets[0].data_size);
+    for (j = 0; j < ctx->packets[0].samples; j++) {
+        assert_int_equal(0x70, ctx->packets[0].data[j] & 0xF0);
+        assert_true((ctx->packets[0].data[j] & 0x0F) <= 1 || (ctx->packets[0].data[j] & 0x0F) >= 0x0F);
+    }
+
+    free(input);
+    iqsink_free(ctx);
+}
+
+void test_iqsink_fixed(void **state) {
+    (void) state;
+
+    iqsink_ctx *ctx;
+    FP_FLOAT complex *tone;
+    fixed_complex *input;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = iqsink_init(TEST_IQSINK_SRC_RATE, TEST_IQSINK_DST_RATE, TEST_IQSINK_OFFSET, TEST_IQSINK_INPUT_SIZE,
+                      IQ_FORMAT_INT8, 0);
+    assert_non_null(ctx);
+
+    tone = (FP_FLOAT complex *) calloc(TEST_IQSINK_INPUT_SIZE, sizeof(FP_FLOAT complex));
+    input = (fixed_complex *) calloc(TEST_IQSINK_INPUT_SIZE, sizeof(fixed_complex));
+    assert_non_null(tone);
+    assert_non_null(input);
+
+    n = 0;
+
+    for (i = 0; i < TEST_IQSINK_ITERATIONS; i++) {
+        test_iqsink_tone(tone, &n);
+        for (j = 0; j < TEST_IQSINK_INPUT_SIZE; j++) {
+            input[j].i = fixed_from_float(creal(tone[j]));
+            input[j].q = fixed_from_float(cimag(tone[j]));
+        }
+
+        assert_int_equal(EXIT_SUCCESS, iqsink_process_fixed(ctx, input));
+    }
+
+    assert_int_equal(ctx->output_size * 2, ctx->packets[0].data_size);
+    for (j = 0; j < ctx->packets[0].samples; j++) {
+        assert_true(abs((int8_t) ctx->packets[0].data[2 * j] - (int) (TEST_IQSINK_AMPLITUDE * INT8_MAX)) <= 4);
+        assert_true(abs((int8_t) ctx->packets[0].data[2 * j + 1]) <= 4);
+    }
+
+    free(input);
+    free(tone);
+    iqsink_free(ctx);
+}
+
+static void test_iqsink_tone(FP_FLOAT complex *input, size_t *n) {
+    double phase;
+    size_t i;
+
+    for (i = 0; i < TEST_IQSINK_INPUT_SIZE; i++) {
+        phase = 2 * M_PI * TEST_IQSINK_OFFSET * (double) *n / TEST_IQSINK_SRC_RATE;
+        input[i] = (FP_FLOAT) (TEST_IQSINK_AMPLITUDE * cos(phase)) + (FP_FLOAT) (TEST_IQSINK_AMPLITUDE * sin(phase)) * I;
+        (*n)++;
+    }
+}
+
+static int16_t test_iqsink_load_int16(const uint8_t *buffer) {
+    return (int16_t) (buffer[0] | buffer[1] << 8);
+}
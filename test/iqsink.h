@@ -0,0 +1,42 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__IQSINK__H__TEST
+#define __RTLSDR_RADIO__IQSINK__H__TEST
+
+#include "../src/iqsink.h"
+
+#define TEST_IQSINK_SRC_RATE 2048000
+#define TEST_IQSINK_DST_RATE 32000
+#define TEST_IQSINK_OFFSET 125000
+#define TEST_IQSINK_INPUT_SIZE 16384
+#define TEST_IQSINK_AMPLITUDE 0.5
+#define TEST_IQSINK_ITERATIONS 3
+
+void test_iqsink_init(void **);
+
+void test_iqsink_int16(void **);
+
+void test_iqsink_packets(void **);
+
+void test_iqsink_int4(void **);
+
+void test_iqsink_fixed(void **);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "jitter.h"
+
+static jitter_ctx *test_jitter_create();
+
+static void test_jitter_put(jitter_ctx *, uint64_t);
+
+static void test_jitter_get_frame(jitter_ctx *, uint64_t);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_jitter_init),
+        cmocka_unit_test(test_jitter_in_order),
+        cmocka_unit_test(test_jitter_reorder),
+        cmocka_unit_test(test_jitter_lost),
+        cmocka_unit_test(test_jitter_late_duplicated),
+        cmocka_unit_test(test_jitter_adaptive_target),
+        cmocka_unit_test(test_jitter_skip_and_idle),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("jitter", tests, NULL, NULL);
+}
+
+void test_jitter_init(void **state) {
+    (void) state;
+
+    jitter_ctx *ctx;
+    uint8_t data[JITTER_DATA_SIZE_MAX];
+    size_t size;
+
+    ctx = jitter_init(1, 60);
+    assert_null(ctx);
+
+    ctx = jitter_init(TEST_JITTER_SLOTS, 60);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->target);
+
+    jitter_set_frame_ms(ctx, TEST_JITTER_FRAME_MS);
+    assert_int_equal(3, ctx->target);
+
+    assert_int_equal(JITTER_EMPTY, jitter_get(ctx, data, &size));
+
+    assert_int_equal(EXIT_FAILURE, jitter_put(ctx, 0, 0, 0, data, JITTER_DATA_SIZE_MAX + 1));
+
+    jitter_free(ctx);
+}
+
+void test_jitter_in_order(void **state) {
+    (void) state;
+
+    jitter_ctx *ctx;
+    uint8_t data[JITTER_DATA_SIZE_MAX];
+    size_t size;
+
+    ctx = test_jitter_create();
+
+    test_jitter_put(ctx, 100);
+    test_jitter_put(ctx, 101);
+    assert_int_equal(JITTER_EMPTY, jitter_get(ctx, data, &size));
+
+    test_jitter_put(ctx, 102);
+    test_jitter_get_frame(ctx, 100);
+    test_jitter_get_frame(ctx, 101);
+    test_jitter_get_frame(ctx, 102);
+
+    assert_int_equal(3, ctx->received);
+    assert_int_equal(3, ctx->played);
+    assert_int_equal(0, ctx->buffered);
+
+    jitter_free(ctx);
+}
+
+void test_jitter_reorder(void **state) {
+    (void) state;
+
+    jitter_ctx *ctx;
+
+    ctx = test_jitter_create();
+
+    test_jitter_put(ctx, 12);
+    test_jitter_put(ctx, 10);
+    test_jitter_put(ctx, 11);
+
+    test_jitter_get_frame(ctx, 10);
+    test_jitter_get_frame(ctx, 11);
+    test_jitter_get_frame(ctx, 12);
+
+    assert_int_equal(0, ctx->concealed);
+
+    jitter_free(ctx);
+}
+
+void test_jitter_lost(void **state) {
+    (void) state;
+
+    jitter_ctx *ctx;
+    uint8_t data[JITTER_DATA_SIZE_MAX];
+    size_t size;
+
+    ctx = test_jitter_create();
+
+    test_jitter_put(ctx, 0);
+    test_jitter_put(ctx, 1);
+    test_jitter_put(ctx, 2);
+    test_jitter_put(ctx, 4);
+
+    test_jitter_get_frame(ctx, 0);
+    test_jitter_get_frame(ctx, 1);
+    test_jitter_get_frame(ctx, 2);
+    assert_int_equal(JITTER_LOST, jitter_get(ctx, data, &size));
+    test_jitter_get_frame(ctx, 4);
+
+    assert_int_equal(1, ctx->concealed);
+    assert_int_equal(4, ctx->played);
+
+    jitter_free(ctx);
+}
+
+void test_jitter_late_duplicated(void **state) {
+    (void) state;
+
+    jitter_ctx *ctx;
+
+    ctx = test_jitter_create();
+
+    test_jitter_put(ctx, 0);
+    test_jitter_put(ctx, 1);
+    test_jitter_put(ctx, 2);
+
+    test_jitter_get_frame(ctx, 0);
+
+    test_jitter_put(ctx, 0);
+    assert_int_equal(1, ctx->late);
+
+    test_jitter_put(ctx, 1);
+    assert_int_equal(1, ctx->duplicated);
+
+    assert_int_equal(3, ctx->received);
+    assert_int_equal(2, ctx->buffered);
+
+    jitter_free(ctx);
+}
+
+void test_jitter_adaptive_target(void **state) {
+    (void) state;
+
+    jitter_ctx *ctx;
+    uint8_t data[JITTER_DATA_SIZE_MAX];
+    size_t size;
+    uint64_t n;
+    uint64_t timestamp;
+    uint64_t arrival;
+
+    ctx = test_jitter_create();
+
+    for (n = 0; n < 100; n++) {
+        timestamp = 1000 + n * TEST_JITTER_FRAME_MS;
+        arrival = timestamp + (n % 2 == 1 ? 100 : 0);
+        data[0] = (uint8_t) n;
+
+        assert_int_equal(EXIT_SUCCESS, jitter_put(ctx, n, timestamp, arrival, data, 1));
+        jitter_get(ctx, data, &size);
+    }
+
+    assert_true(ctx->jitter_ms > 50);
+    assert_int_equal(TEST_JITTER_SLOTS / 2, ctx->target);
+
+    jitter_free(ctx);
+}
+
+void test_jitter_skip_and_idle(void **state) {
+    (void) state;
+
+    jitter_ctx *ctx;
+    uint8_t data[JITTER_DATA_SIZE_MAX];
+    size_t size;
+    uint64_t n;
+
+    ctx = test_jitter_create();
+
+    for (n = 0; n < 8; n++)
+        test_jitter_put(ctx, n);
+
+    test_jitter_get_frame(ctx, 1);
+    test_jitter_get_frame(ctx, 3);
+    assert_int_equal(2, ctx->skipped);
+
+    for (n = 4; n < 8; n++)
+        test_jitter_get_frame(ctx, n);
+
+    assert_int_equal(JITTER_LOST, jitter_get(ctx, data, &size));
+    assert_int_equal(JITTER_LOST, jitter_get(ctx, data, &size));
+    assert_int_equal(JITTER_LOST, jitter_get(ctx, data, &size));
+    assert_int_equal(JITTER_EMPTY, jitter_get(ctx, data, &size));
+    assert_int_equal(0, ctx->playing);
+
+    test_jitter_put(ctx, 20);
+    test_jitter_put(ctx, 21);
+    test_jitter_put(ctx, 22);
+    test_jitter_get_frame(ctx, 20);
+
+    jitter_free(ctx);
+}
+
+static jitter_ctx *test_jitter_create() {
+    jitter_ctx *ctx;
+
+    ctx = jitter_init(TEST_JITTER_SLOTS, 60);
+    assert_non_null(ctx);
+
+    jitter_set_frame_ms(ctx, TEST_JITTER_FRAME_MS);
+
+    return ctx;
+}
+
+static void test_jitter_put(jitter_ctx *ctx, uint64_t number) {
+    uint8_t data[2];
+
+    data[0] = (uint8_t) number;
+    data[1] = (uint8_t) (number >> 8);
+
+    assert_int_equal(EXIT_SUCCESS, jitter_put(ctx, number, 0, 0, data, sizeof(data)));
+}
+
+static void test_jitter_get_frame(jitter_ctx *ctx, uint64_t number) {
+    uint8_t data[JITTER_DATA_SIZE_MAX];
+    size_t size;
+
+    assert_int_equal(JITTER_FRAME, jitter_get(ctx, data, &size));
+    assert_int_equal(2, size);
+    assert_int_equal((uint8_t) number, data[0]);
+    assert_int_equal((uint8_t) (number >> 8), data[1]);
+}
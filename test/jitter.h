@@ -0,0 +1,42 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__JITTER__H__TEST
+#define __RTLSDR_RADIO__JITTER__H__TEST
+
+#include "../src/jitter.h"
+
+#define TEST_JITTER_SLOTS 16
+#define TEST_JITTER_FRAME_MS 20
+
+void test_jitter_init(void **);
+
+void test_jitter_in_order(void **);
+
+void test_jitter_reorder(void **);
+
+void test_jitter_lost(void **);
+
+void test_jitter_late_duplicated(void **);
+
+void test_jitter_adaptive_target(void **);
+
+void test_jitter_skip_and_idle(void **);
+
+#endif
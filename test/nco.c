@@ -0,0 +1,127 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "nco.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_nco_init),
+        cmocka_unit_test(test_nco_shift),
+        cmocka_unit_test(test_nco_shift_fixed),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("nco", tests, NULL, NULL);
+}
+
+void test_nco_init(void **state) {
+    (void) state;
+
+    nco_ctx *ctx;
+
+    assert_null(nco_init(0, TEST_NCO_OFFSET));
+
+    ctx = nco_init(TEST_NCO_SAMPLE_RATE, 0);
+    assert_non_null(ctx);
+    assert_int_equal(0, ctx->increment);
+
+    nco_set_offset(ctx, TEST_NCO_SAMPLE_RATE / 4);
+    assert_int_equal(0xC0000000, ctx->increment);
+
+    nco_set_offset(ctx, -TEST_NCO_SAMPLE_RATE / 4);
+    assert_int_equal(0x40000000, ctx->increment);
+
+    nco_free(ctx);
+}
+
+void test_nco_shift(void **state) {
+    (void) state;
+
+    nco_ctx *ctx;
+    FP_FLOAT complex input[TEST_NCO_INPUT_SIZE];
+    FP_FLOAT complex output[TEST_NCO_INPUT_SIZE];
+    double phase;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = nco_init(TEST_NCO_SAMPLE_RATE, TEST_NCO_OFFSET);
+    assert_non_null(ctx);
+
+    n = 0;
+
+    for (i = 0; i < TEST_NCO_ITERATIONS; i++) {
+        for (j = 0; j < TEST_NCO_INPUT_SIZE; j++) {
+            phase = 2 * M_PI * TEST_NCO_OFFSET * (double) n / TEST_NCO_SAMPLE_RATE;
+            input[j] = (FP_FLOAT) cos(phase) + (FP_FLOAT) sin(phase) * I;
+            n++;
+        }
+
+        nco_mix(ctx, input, TEST_NCO_INPUT_SIZE, output);
+
+        for (j = 0; j < TEST_NCO_INPUT_SIZE; j++) {
+            assert_true(fabs((double) creal(output[j]) - 1) < 1e-3);
+            assert_true(fabs((double) cimag(output[j])) < 1e-3);
+        }
+    }
+
+    nco_free(ctx);
+}
+
+void test_nco_shift_fixed(void **state) {
+    (void) state;
+
+    nco_ctx *ctx;
+    fixed_complex input[TEST_NCO_INPUT_SIZE];
+    fixed_complex output[TEST_NCO_INPUT_SIZE];
+    double phase;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    ctx = nco_init(TEST_NCO_SAMPLE_RATE, TEST_NCO_OFFSET);
+    assert_non_null(ctx);
+
+    n = 0;
+
+    for (i = 0; i < TEST_NCO_ITERATIONS; i++) {
+        for (j = 0; j < TEST_NCO_INPUT_SIZE; j++) {
+            phase = 2 * M_PI * TEST_NCO_OFFSET * (double) n / TEST_NCO_SAMPLE_RATE;
+            input[j].i = (int16_t) lround(cos(phase) * FIXED_Q15_HALF);
+            input[j].q = (int16_t) lround(sin(phase) * FIXED_Q15_HALF);
+            n++;
+        }
+
+        nco_mix_fixed(ctx, input, TEST_NCO_INPUT_SIZE, output);
+
+        for (j = 0; j < TEST_NCO_INPUT_SIZE; j++) {
+            assert_true(abs(output[j].i - FIXED_Q15_HALF) < 8);
+            assert_true(abs(output[j].q) < 8);
+        }
+    }
+
+    nco_free(ctx);
+}
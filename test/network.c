@@ -0,0 +1,357 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define _GNU_SOURCE
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <cmocka.h>
+
+#include "network.h"
+
+static network_ctx *test_network_receiver(uint16_t *);
+
+static void test_network_fill(network_batch *, uint8_t *, size_t, size_t);
+
+static void test_network_check(const uint8_t *, size_t, size_t, size_t);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_network_batch_layout),
+        cmocka_unit_test(test_network_batch_send),
+        cmocka_unit_test(test_network_batch_partial),
+        cmocka_unit_test(test_network_fanout),
+        cmocka_unit_test(test_network_fanout_errors),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("network", tests, NULL, NULL);
+}
+
+void test_network_batch_layout(void **state) {
+    (void) state;
+
+    network_batch *batch;
+    uint8_t data[TEST_NETWORK_DATA];
+    uint8_t *header;
+    size_t i;
+
+    batch = network_batch_init(TEST_NETWORK_BATCH, TEST_NETWORK_HEADER);
+    assert_non_null(batch);
+    assert_int_equal(0, batch->count);
+
+    assert_int_equal(EXIT_FAILURE, network_batch_add(batch, TEST_NETWORK_HEADER + 1, data, sizeof(data)));
+    assert_int_equal(0, batch->count);
+
+    for (i = 0; i < TEST_NETWORK_BATCH; i++) {
+        header = network_batch_header(batch);
+        assert_ptr_equal(batch->headers + i * TEST_NETWORK_HEADER, header);
+        assert_int_equal(EXIT_SUCCESS, network_batch_add(batch, i + 1, i % 2 == 0 ? data : NULL,
+                                                         i % 2 == 0 ? sizeof(data) : 0));
+
+        // Each message points to its own header and data pair
+        assert_ptr_equal(batch->iovecs + i * NETWORK_BATCH_IOVECS, batch->messages[i].msg_hdr.msg_iov);
+        assert_int_equal(NETWORK_BATCH_IOVECS, batch->messages[i].msg_hdr.msg_iovlen);
+        assert_ptr_equal(header, batch->iovecs[i * NETWORK_BATCH_IOVECS].iov_base);
+        assert_int_equal(i + 1, batch->iovecs[i * NETWORK_BATCH_IOVECS].iov_len);
+        assert_ptr_equal(i % 2 == 0 ? data : NULL, batch->iovecs[i * NETWORK_BATCH_IOVECS + 1].iov_base);
+        assert_int_equal(i % 2 == 0 ? sizeof(data) : 0, batch->iovecs[i * NETWORK_BATCH_IOVECS + 1].iov_len);
+    }
+
+    assert_int_equal(TEST_NETWORK_BATCH, batch->count);
+    assert_null(network_batch_header(batch));
+    assert_int_equal(EXIT_FAILURE, network_batch_add(batch, 1, data, sizeof(data)));
+
+    network_batch_free(batch);
+}
+
+void test_network_batch_send(void **state) {
+    (void) state;
+
+    network_ctx *rx;
+    network_ctx *tx;
+    network_batch *batch;
+    uint8_t data[TEST_NETWORK_BATCH * TEST_NETWORK_DATA];
+    uint8_t buffer[TEST_NETWORK_BUFFER];
+    uint16_t port;
+    ssize_t received;
+    size_t i;
+
+    rx = test_network_receiver(&port);
+
+    tx = network_init(TEST_NETWORK_ADDRESS, port);
+    assert_non_null(tx);
+    assert_int_equal(EXIT_SUCCESS, network_socket_open(tx));
+
+    batch = network_batch_init(TEST_NETWORK_BATCH, TEST_NETWORK_HEADER);
+    assert_non_null(batch);
+
+    test_network_fill(batch, data, TEST_NETWORK_BATCH, TEST_NETWORK_DATA);
+
+    assert_int_equal(EXIT_SUCCESS, network_socket_send_batch(tx, batch));
+    assert_int_equal(0, batch->count);
+    assert_int_equal(TEST_NETWORK_BATCH, tx->destinations[0].sent);
+    assert_int_equal(0, tx->destinations[0].dropped);
+    assert_int_equal(0, tx->destinations[0].errors);
+
+    for (i = 0; i < TEST_NETWORK_BATCH; i++) {
+        received = network_socket_receive(rx, buffer, sizeof(buffer));
+        assert_int_equal(TEST_NETWORK_HEADER + TEST_NETWORK_DATA, received);
+        test_network_check(buffer, (size_t) received, i, TEST_NETWORK_DATA);
+    }
+
+    network_batch_free(batch);
+
+    network_socket_close(tx);
+    network_free(tx);
+
+    network_socket_close(rx);
+    network_free(rx);
+}
+
+void test_network_batch_partial(void **state) {
+    (void) state;
+
+    network_ctx *tx;
+    network_batch *batch;
+    struct sockaddr_un sockaddr;
+    uint8_t *data;
+    uint8_t buffer[TEST_NETWORK_BUFFER];
+    char path[sizeof(sockaddr.sun_path)];
+    int sndbuf;
+    int sck;
+    ssize_t received;
+    size_t count;
+
+    snprintf(path, sizeof(path), "/tmp/rtlsdr-radio-test-network-%d", getpid());
+    unlink(path);
+
+    sck = socket(AF_UNIX, SOCK_DGRAM, 0);
+    assert_int_not_equal(-1, sck);
+
+    memset(&sockaddr, 0, sizeof(sockaddr));
+    sockaddr.sun_family = AF_UNIX;
+    strcpy(sockaddr.sun_path, path);
+    assert_int_equal(0, bind(sck, (struct sockaddr *) &sockaddr, sizeof(sockaddr)));
+
+    tx = network_init(path, 0);
+    assert_non_null(tx);
+    assert_int_equal(EXIT_SUCCESS, network_socket_open(tx));
+
+    // A tiny send buffer makes sendmmsg stop part way through the batch
+    sndbuf = TEST_NETWORK_PARTIAL_SNDBUF;
+    assert_int_equal(0, setsockopt(tx->sck, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)));
+
+    data = (uint8_t *) malloc(TEST_NETWORK_PARTIAL_BATCH * TEST_NETWORK_PARTIAL_DATA);
+    assert_non_null(data);
+
+    batch = network_batch_init(TEST_NETWORK_PARTIAL_BATCH, TEST_NETWORK_HEADER);
+    assert_non_null(batch);
+
+    test_network_fill(batch, data, TEST_NETWORK_PARTIAL_BATCH, TEST_NETWORK_PARTIAL_DATA);
+
+    assert_int_equal(EXIT_SUCCESS, network_socket_send_batch(tx, batch));
+    assert_int_equal(0, batch->count);
+    assert_true(tx->destinations[0].sent > 0);
+    assert_true(tx->destinations[0].dropped > 0);
+    assert_int_equal(TEST_NETWORK_PARTIAL_BATCH, tx->destinations[0].sent + tx->destinations[0].dropped);
+    assert_int_equal(0, tx->destinations[0].errors);
+
+    // What went out arrives whole and in order
+    count = 0;
+    while ((received = recv(sck, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+        assert_int_equal(TEST_NETWORK_HEADER + TEST_NETWORK_PARTIAL_DATA, received);
+        test_network_check(buffer, (size_t) received, count, TEST_NETWORK_PARTIAL_DATA);
+        count++;
+    }
+
+    assert_int_equal(tx->destinations[0].sent, count);
+
+    network_batch_free(batch);
+    free(data);
+
+    network_socket_close(tx);
+    network_free(tx);
+
+    close(sck);
+    unlink(path);
+}
+
+void test_network_fanout(void **state) {
+    (void) state;
+
+    network_ctx *rx[2];
+    network_ctx *tx;
+    network_batch *batch;
+    uint8_t data[TEST_NETWORK_BATCH * TEST_NETWORK_DATA];
+    uint8_t buffer[TEST_NETWORK_BUFFER];
+    uint16_t ports[2];
+    size_t d;
+    size_t i;
+
+    network_free(NULL);
+
+    rx[0] = test_network_receiver(&ports[0]);
+    rx[1] = test_network_receiver(&ports[1]);
+
+    tx = network_init(TEST_NETWORK_ADDRESS, ports[0]);
+    assert_non_null(tx);
+    assert_int_equal(EXIT_SUCCESS, network_socket_open(tx));
+    assert_int_equal(EXIT_SUCCESS, network_destination_add(tx, TEST_NETWORK_ADDRESS, ports[1]));
+    assert_int_equal(2, tx->destinations_count);
+
+    memset(buffer, 0x5A, TEST_NETWORK_DATA);
+    assert_int_equal(EXIT_SUCCESS, network_socket_send(tx, buffer, TEST_NETWORK_DATA));
+
+    batch = network_batch_init(TEST_NETWORK_BATCH, TEST_NETWORK_HEADER);
+    assert_non_null(batch);
+
+    test_network_fill(batch, data, TEST_NETWORK_BATCH, TEST_NETWORK_DATA);
+    assert_int_equal(EXIT_SUCCESS, network_socket_send_batch(tx, batch));
+
+    // Every destination gets the single packet and the whole batch
+    for (d = 0; d < 2; d++) {
+        assert_int_equal(1 + TEST_NETWORK_BATCH, tx->destinations[d].sent);
+        assert_int_equal(0, tx->destinations[d].dropped);
+        assert_int_equal(0, tx->destinations[d].errors);
+
+        memset(buffer, 0, sizeof(buffer));
+        assert_int_equal(TEST_NETWORK_DATA, network_socket_receive(rx[d], buffer, sizeof(buffer)));
+        for (i = 0; i < TEST_NETWORK_DATA; i++)
+            assert_int_equal(0x5A, buffer[i]);
+
+        for (i = 0; i < TEST_NETWORK_BATCH; i++)
+            test_network_check(buffer, (size_t) network_socket_receive(rx[d], buffer, sizeof(buffer)), i,
+                               TEST_NETWORK_DATA);
+    }
+
+    network_batch_free(batch);
+
+    network_socket_close(tx);
+    network_free(tx);
+
+    for (d = 0; d < 2; d++) {
+        network_socket_close(rx[d]);
+        network_free(rx[d]);
+    }
+}
+
+void test_network_fanout_errors(void **state) {
+    (void) state;
+
+    network_ctx *rx;
+    network_ctx *tx;
+    network_batch *batch;
+    uint8_t data[TEST_NETWORK_BATCH * TEST_NETWORK_DATA];
+    uint8_t buffer[TEST_NETWORK_BUFFER];
+    uint16_t port;
+    size_t i;
+
+    rx = test_network_receiver(&port);
+
+    tx = network_init(TEST_NETWORK_ADDRESS, port);
+    assert_non_null(tx);
+    assert_int_equal(EXIT_SUCCESS, network_socket_open(tx));
+    assert_int_equal(EXIT_SUCCESS, network_destination_add(tx, TEST_NETWORK_MISSING_PATH, 0));
+
+    batch = network_batch_init(TEST_NETWORK_BATCH, TEST_NETWORK_HEADER);
+    assert_non_null(batch);
+
+    // A dead destination is counted and does not stop the others
+    test_network_fill(batch, data, TEST_NETWORK_BATCH, TEST_NETWORK_DATA);
+    assert_int_equal(EXIT_SUCCESS, network_socket_send_batch(tx, batch));
+    assert_int_equal(EXIT_SUCCESS, network_socket_send(tx, data, TEST_NETWORK_DATA));
+
+    assert_int_equal(TEST_NETWORK_BATCH + 1, tx->destinations[0].sent);
+    assert_int_equal(0, tx->destinations[0].errors);
+    assert_int_equal(0, tx->destinations[1].sent);
+    assert_int_equal(2, tx->destinations[1].errors);
+
+    for (i = 0; i < TEST_NETWORK_BATCH; i++)
+        test_network_check(buffer, (size_t) network_socket_receive(rx, buffer, sizeof(buffer)), i,
+                           TEST_NETWORK_DATA);
+
+    network_batch_free(batch);
+
+    network_socket_close(tx);
+    network_free(tx);
+
+    // It fails only when every destination failed
+    tx = network_init(TEST_NETWORK_MISSING_PATH, 0);
+    assert_non_null(tx);
+    assert_int_equal(EXIT_SUCCESS, network_socket_open(tx));
+    assert_int_equal(EXIT_FAILURE, network_socket_send(tx, data, TEST_NETWORK_DATA));
+    assert_int_equal(1, tx->destinations[0].errors);
+
+    network_socket_close(tx);
+    network_free(tx);
+
+    network_socket_close(rx);
+    network_free(rx);
+}
+
+static network_ctx *test_network_receiver(uint16_t *port) {
+    network_ctx *ctx;
+    struct sockaddr_in sockaddr;
+    socklen_t sockaddr_len;
+
+    ctx = network_init(TEST_NETWORK_ADDRESS, 0);
+    assert_non_null(ctx);
+    assert_int_equal(EXIT_SUCCESS, network_socket_bind(ctx, TEST_NETWORK_BUFFER * 64));
+
+    sockaddr_len = sizeof(sockaddr);
+    assert_int_equal(0, getsockname(ctx->sck, (struct sockaddr *) &sockaddr, &sockaddr_len));
+    *port = ntohs(sockaddr.sin_port);
+
+    return ctx;
+}
+
+static void test_network_fill(network_batch *batch, uint8_t *data, size_t count, size_t data_size) {
+    uint8_t *header;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        header = network_batch_header(batch);
+        assert_non_null(header);
+        memset(header, (int) (0x80 + i), TEST_NETWORK_HEADER);
+        memset(data + i * data_size, (int) i, data_size);
+        assert_int_equal(EXIT_SUCCESS, network_batch_add(batch, TEST_NETWORK_HEADER, data + i * data_size,
+                                                         data_size));
+    }
+}
+
+static void test_network_check(const uint8_t *buffer, size_t size, size_t index, size_t data_size) {
+    size_t i;
+
+    assert_int_equal(TEST_NETWORK_HEADER + data_size, size);
+
+    for (i = 0; i < TEST_NETWORK_HEADER; i++)
+        assert_int_equal((uint8_t) (0x80 + index), buffer[i]);
+
+    for (i = 0; i < data_size; i++)
+        assert_int_equal((uint8_t) index, buffer[TEST_NETWORK_HEADER + i]);
+}
@@ -0,0 +1,47 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__NETWORK__H__TEST
+#define __RTLSDR_RADIO__NETWORK__H__TEST
+
+#include "../src/network.h"
+
+#define TEST_NETWORK_ADDRESS "127.0.0.1"
+#define TEST_NETWORK_BATCH 4
+#define TEST_NETWORK_HEADER 16
+#define TEST_NETWORK_DATA 64
+#define TEST_NETWORK_BUFFER 2048
+
+#define TEST_NETWORK_PARTIAL_BATCH 64
+#define TEST_NETWORK_PARTIAL_DATA 1024
+#define TEST_NETWORK_PARTIAL_SNDBUF 4096
+
+#define TEST_NETWORK_MISSING_PATH "/nonexistent/rtlsdr-radio-test-network"
+
+void test_network_batch_layout(void **);
+
+void test_network_batch_send(void **);
+
+void test_network_batch_partial(void **);
+
+void test_network_fanout(void **);
+
+void test_network_fanout_errors(void **);
+
+#endif
@@ -0,0 +1,545 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "payload.h"
+#include "../src/utils.h"
+
+static void test_payload_fill(payload *, uint8_t *);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_payload_serialize_header),
+        cmocka_unit_test(test_payload_serialize),
+        cmocka_unit_test(test_payload_parse),
+        cmocka_unit_test(test_payload_parse_wrong),
+        cmocka_unit_test(test_payload_aggregate),
+        cmocka_unit_test(test_payload_aggregate_blocks),
+        cmocka_unit_test(test_payload_repair),
+        cmocka_unit_test(test_payload_v2_parse),
+        cmocka_unit_test(test_payload_v2_loss),
+        cmocka_unit_test(test_payload_v2_aggregate),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("payload", tests, NULL, NULL);
+}
+
+void test_payload_serialize_header(void **state) {
+    (void) state;
+
+    payload *p;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    uint8_t expected[8];
+    uint8_t legacy[40];
+    size_t written;
+    float rms;
+
+    p = payload_init();
+    assert_non_null(p);
+    test_payload_fill(p, data);
+
+    assert_int_equal(EXIT_FAILURE, payload_serialize_header(p, buffer, PAYLOAD_HEADER_SIZE - 1, &written));
+    assert_int_equal(EXIT_SUCCESS, payload_serialize_header(p, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written));
+    assert_int_equal(PAYLOAD_HEADER_SIZE, written);
+
+    assert_memory_equal(PAYLOAD_HEADER, buffer, 3);
+
+    utils_uint32_to_be(expected, 7);
+    assert_memory_equal(expected, buffer + PAYLOAD_OFFSET_RECEIVER, sizeof(uint32_t));
+
+    utils_uint64_to_be(expected, 0x0102030405060708);
+    assert_memory_equal(expected, buffer + PAYLOAD_OFFSET_NUMBER, sizeof(uint64_t));
+
+    utils_uint64_to_be(expected, 1600000000123);
+    assert_memory_equal(expected, buffer + PAYLOAD_OFFSET_TIMESTAMP, sizeof(uint64_t));
+
+    utils_uint32_to_be(expected, 2);
+    assert_memory_equal(expected, buffer + PAYLOAD_OFFSET_CHANNEL, sizeof(uint32_t));
+
+    utils_uint32_to_be(expected, 145500000);
+    assert_memory_equal(expected, buffer + PAYLOAD_OFFSET_FREQUENCY, sizeof(uint32_t));
+
+    utils_uint32_to_be(expected, TEST_PAYLOAD_DATA_SIZE);
+    assert_memory_equal(expected, buffer + PAYLOAD_OFFSET_DATA_SIZE, sizeof(uint32_t));
+
+    // Same bytes as the original serializer: rms written whole, then
+    // overwritten by the data size one byte after it
+    assert_int_equal(36, PAYLOAD_HEADER_SIZE);
+    memset(legacy, 0, sizeof(legacy));
+    memcpy(legacy, PAYLOAD_HEADER, 3);
+    utils_uint32_to_be(legacy + 3, 7);
+    utils_uint64_to_be(legacy + 7, 0x0102030405060708);
+    utils_uint64_to_be(legacy + 15, 1600000000123);
+    utils_uint32_to_be(legacy + 23, 2);
+    utils_uint32_to_be(legacy + 27, 145500000);
+    rms = 0.25f;
+    memcpy(legacy + 31, &rms, sizeof(float));
+    utils_uint32_to_be(legacy + 32, TEST_PAYLOAD_DATA_SIZE);
+    assert_memory_equal(legacy, buffer, PAYLOAD_HEADER_SIZE);
+
+    payload_free(p);
+}
+
+void test_payload_serialize(void **state) {
+    (void) state;
+
+    payload *p;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    size_t written;
+
+    p = payload_init();
+    assert_non_null(p);
+    test_payload_fill(p, data);
+
+    assert_int_equal(PAYLOAD_HEADER_SIZE + TEST_PAYLOAD_DATA_SIZE, payload_get_size(p));
+    assert_int_equal(EXIT_FAILURE, payload_serialize(p, buffer, PAYLOAD_HEADER_SIZE, &written));
+    assert_int_equal(EXIT_SUCCESS, payload_serialize(p, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written));
+    assert_int_equal(PAYLOAD_HEADER_SIZE + TEST_PAYLOAD_DATA_SIZE, written);
+    assert_memory_equal(data, buffer + PAYLOAD_HEADER_SIZE, TEST_PAYLOAD_DATA_SIZE);
+
+    payload_free(p);
+}
+
+void test_payload_parse(void **state) {
+    (void) state;
+
+    payload *p;
+    payload *parsed;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    size_t written;
+
+    p = payload_init();
+    parsed = payload_init();
+    assert_non_null(p);
+    assert_non_null(parsed);
+    test_payload_fill(p, data);
+
+    payload_serialize(p, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+
+    assert_int_equal(EXIT_SUCCESS, payload_parse(parsed, buffer, written));
+    assert_int_equal(p->receiver, parsed->receiver);
+    assert_int_equal(p->number, parsed->number);
+    assert_int_equal(p->timestamp, parsed->timestamp);
+    assert_int_equal(p->channel, parsed->channel);
+    assert_int_equal(p->frequency, parsed->frequency);
+    assert_float_equal(0, parsed->rms, 0);
+    assert_int_equal(p->data_size, parsed->data_size);
+    assert_ptr_equal(buffer + PAYLOAD_HEADER_SIZE, parsed->data);
+
+    payload_free(parsed);
+    payload_free(p);
+}
+
+void test_payload_aggregate_blocks(void **state) {
+    (void) state;
+
+    payload *p;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    size_t frame;
+    size_t written;
+    uint32_t frames;
+    uint32_t flushed;
+    uint32_t pcm;
+    uint64_t number;
+    int contains_data;
+    int block;
+
+    p = payload_init();
+    assert_non_null(p);
+    test_payload_fill(p, data);
+
+    frame = payload_aggregate_get_frame_size(TEST_PAYLOAD_DATA_SIZE);
+
+    written = 0;
+    frames = 0;
+    flushed = 0;
+    pcm = 0;
+    number = 0;
+
+    // A codec frame completes every 2.5 blocks, like the codec thread does
+    for (block = 0; block < 50; block++) {
+        pcm += TEST_PAYLOAD_BLOCK_PCM;
+        contains_data = pcm >= TEST_PAYLOAD_FRAME_PCM;
+        if (contains_data)
+            pcm -= TEST_PAYLOAD_FRAME_PCM;
+
+        if (contains_data) {
+            if (frames == 0)
+                assert_int_equal(EXIT_SUCCESS, payload_aggregate_begin(p, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written));
+
+            assert_int_equal(EXIT_SUCCESS, payload_aggregate_add(buffer, TEST_PAYLOAD_BUFFER_SIZE, &written, number++,
+                                                                 data, TEST_PAYLOAD_DATA_SIZE));
+            frames++;
+        }
+
+        if (!payload_aggregate_is_due(1, frames, TEST_PAYLOAD_AGGREGATE_FRAMES, 0, 0, written, frame,
+                                      TEST_PAYLOAD_BUFFER_SIZE))
+            continue;
+
+        assert_int_equal(TEST_PAYLOAD_AGGREGATE_FRAMES, frames);
+        assert_int_equal(PAYLOAD_AGGREGATE_HEADER_SIZE + TEST_PAYLOAD_AGGREGATE_FRAMES * frame, written);
+
+        frames = 0;
+        flushed++;
+    }
+
+    assert_int_equal(number / TEST_PAYLOAD_AGGREGATE_FRAMES, flushed);
+
+    assert_false(payload_aggregate_is_due(0, 0, TEST_PAYLOAD_AGGREGATE_FRAMES, 0, 0, 0, frame,
+                                          TEST_PAYLOAD_BUFFER_SIZE));
+    assert_true(payload_aggregate_is_due(0, 1, TEST_PAYLOAD_AGGREGATE_FRAMES, 0, 0, written, frame,
+                                         TEST_PAYLOAD_BUFFER_SIZE));
+    assert_false(payload_aggregate_is_due(1, 1, TEST_PAYLOAD_AGGREGATE_FRAMES, 19, 20, written, frame,
+                                          TEST_PAYLOAD_BUFFER_SIZE));
+    assert_true(payload_aggregate_is_due(1, 1, TEST_PAYLOAD_AGGREGATE_FRAMES, 20, 20, written, frame,
+                                         TEST_PAYLOAD_BUFFER_SIZE));
+    assert_true(payload_aggregate_is_due(1, 1, TEST_PAYLOAD_AGGREGATE_FRAMES, 0, 0,
+                                         TEST_PAYLOAD_BUFFER_SIZE - frame + 1, frame, TEST_PAYLOAD_BUFFER_SIZE));
+
+    payload_free(p);
+}
+
+void test_payload_parse_wrong(void **state) {
+    (void) state;
+
+    payload *p;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    size_t written;
+
+    p = payload_init();
+    assert_non_null(p);
+    test_payload_fill(p, data);
+
+    payload_serialize(p, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+
+    assert_int_equal(EXIT_FAILURE, payload_parse(p, buffer, PAYLOAD_HEADER_SIZE - 1));
+    assert_int_equal(EXIT_FAILURE, payload_parse(p, buffer, written - 1));
+
+    buffer[2] = 'X';
+    assert_int_equal(EXIT_FAILURE, payload_parse(p, buffer, written));
+
+    payload_free(p);
+}
+
+void test_payload_aggregate(void **state) {
+    (void) state;
+
+    payload *p;
+    payload *parsed;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    uint8_t expected[8];
+    const uint8_t *cursor;
+    uint32_t frames;
+    size_t written;
+    size_t frame;
+
+    p = payload_init();
+    assert_non_null(p);
+    test_payload_fill(p, data);
+
+    assert_int_equal(EXIT_SUCCESS, payload_aggregate_begin(p, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written));
+    assert_int_equal(PAYLOAD_AGGREGATE_HEADER_SIZE, written);
+    assert_memory_equal(PAYLOAD_AGGREGATE_HEADER, buffer, 3);
+
+    assert_int_equal(EXIT_SUCCESS, payload_aggregate_add(buffer, TEST_PAYLOAD_BUFFER_SIZE, &written, 10,
+                                                         data, TEST_PAYLOAD_DATA_SIZE));
+    assert_int_equal(EXIT_SUCCESS, payload_aggregate_add(buffer, TEST_PAYLOAD_BUFFER_SIZE, &written, 11,
+                                                         data, TEST_PAYLOAD_DATA_SIZE));
+    assert_int_equal(EXIT_FAILURE, payload_aggregate_add(buffer, written + 1, &written, 12,
+                                                         data, TEST_PAYLOAD_DATA_SIZE));
+    assert_int_equal(EXIT_SUCCESS, payload_aggregate_end(buffer, 2));
+
+    frame = payload_aggregate_get_frame_size(TEST_PAYLOAD_DATA_SIZE);
+    assert_int_equal(PAYLOAD_AGGREGATE_HEADER_SIZE + 2 * frame, written);
+
+    utils_uint32_to_be(expected, 2);
+    assert_memory_equal(expected, buffer + PAYLOAD_AGGREGATE_OFFSET_FRAMES, sizeof(uint32_t));
+
+    utils_uint64_to_be(expected, 11);
+    assert_memory_equal(expected, buffer + PAYLOAD_AGGREGATE_HEADER_SIZE + frame, sizeof(uint64_t));
+    assert_memory_equal(data, buffer + PAYLOAD_AGGREGATE_HEADER_SIZE + frame + 12, TEST_PAYLOAD_DATA_SIZE);
+
+    parsed = payload_init();
+    assert_non_null(parsed);
+
+    assert_int_equal(EXIT_SUCCESS, payload_aggregate_parse(parsed, buffer, written, &frames));
+    assert_int_equal(2, frames);
+    assert_int_equal(p->channel, parsed->channel);
+    assert_int_equal(p->timestamp, parsed->timestamp);
+
+    cursor = parsed->data;
+
+    assert_int_equal(EXIT_SUCCESS, payload_aggregate_parse_frame(parsed, &cursor, buffer + written));
+    assert_int_equal(10, parsed->number);
+    assert_int_equal(EXIT_SUCCESS, payload_aggregate_parse_frame(parsed, &cursor, buffer + written));
+    assert_int_equal(11, parsed->number);
+    assert_int_equal(TEST_PAYLOAD_DATA_SIZE, parsed->data_size);
+    assert_memory_equal(data, parsed->data, TEST_PAYLOAD_DATA_SIZE);
+
+    assert_int_equal(EXIT_FAILURE, payload_aggregate_parse_frame(parsed, &cursor, buffer + written));
+    assert_int_equal(EXIT_FAILURE, payload_aggregate_parse(parsed, buffer + 1, written - 1, &frames));
+
+    payload_free(parsed);
+    payload_free(p);
+}
+
+void test_payload_repair(void **state) {
+    (void) state;
+
+    payload *p;
+    payload *parsed;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    uint8_t expected[8];
+    uint32_t mask;
+    uint32_t size;
+    size_t written;
+
+    p = payload_init();
+    assert_non_null(p);
+    test_payload_fill(p, data);
+    payload_set_numbers(p, 1, 40);
+
+    assert_int_equal(EXIT_FAILURE, payload_repair_serialize_header(p, 0x0B, 5, buffer,
+                                                                   PAYLOAD_REPAIR_HEADER_SIZE - 1, &written));
+    assert_int_equal(EXIT_SUCCESS, payload_repair_serialize_header(p, 0x0B, 5, buffer, TEST_PAYLOAD_BUFFER_SIZE,
+                                                                   &written));
+    assert_int_equal(PAYLOAD_REPAIR_HEADER_SIZE, written);
+    assert_memory_equal(PAYLOAD_REPAIR_HEADER, buffer, 3);
+    assert_int_equal(1, payload_get_version(buffer, written));
+
+    utils_uint64_to_be(expected, 40);
+    assert_memory_equal(expected, buffer + PAYLOAD_REPAIR_OFFSET_NUMBER, sizeof(uint64_t));
+    utils_uint32_to_be(expected, 0x0B);
+    assert_memory_equal(expected, buffer + PAYLOAD_REPAIR_OFFSET_MASK, sizeof(uint32_t));
+
+    memcpy(buffer + written, data, TEST_PAYLOAD_DATA_SIZE);
+    written += TEST_PAYLOAD_DATA_SIZE;
+
+    parsed = payload_init();
+    assert_non_null(parsed);
+
+    assert_int_equal(EXIT_SUCCESS, payload_repair_parse(parsed, buffer, written, &mask, &size));
+    assert_int_equal(0x0B, mask);
+    assert_int_equal(5, size);
+    assert_int_equal(40, parsed->number);
+    assert_int_equal(p->channel, parsed->channel);
+    assert_int_equal(p->timestamp, parsed->timestamp);
+    assert_int_equal(TEST_PAYLOAD_DATA_SIZE, parsed->data_size);
+    assert_memory_equal(data, parsed->data, TEST_PAYLOAD_DATA_SIZE);
+
+    assert_int_equal(EXIT_FAILURE, payload_repair_parse(parsed, buffer, written - 1, &mask, &size));
+    assert_int_equal(EXIT_FAILURE, payload_parse(parsed, buffer, written));
+
+    payload_free(parsed);
+    payload_free(p);
+}
+
+void test_payload_v2_parse(void **state) {
+    (void) state;
+
+    payload *p;
+    payload *parsed;
+    payload_v2_state tx;
+    payload_v2_state rx;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    size_t written;
+    size_t i;
+
+    p = payload_init();
+    parsed = payload_init();
+    assert_non_null(p);
+    assert_non_null(parsed);
+    test_payload_fill(p, data);
+    payload_set_codec_flags(p, 3, PAYLOAD_V2_FLAG_SQUELCH);
+
+    memset(&tx, 0, sizeof(payload_v2_state));
+    memset(&rx, 0, sizeof(payload_v2_state));
+
+    for (i = 0; i < 3; i++) {
+        assert_int_equal(EXIT_SUCCESS, payload_v2_serialize_header(p, &tx, buffer, TEST_PAYLOAD_BUFFER_SIZE,
+                                                                   &written));
+        memcpy(buffer + written, data, TEST_PAYLOAD_DATA_SIZE);
+        written += TEST_PAYLOAD_DATA_SIZE;
+
+        if (i == 0) {
+            assert_true(p->flags & PAYLOAD_V2_FLAG_KEY);
+        } else {
+            assert_false(p->flags & PAYLOAD_V2_FLAG_KEY);
+            assert_true(written * 2 < PAYLOAD_HEADER_SIZE + TEST_PAYLOAD_DATA_SIZE);
+        }
+
+        assert_int_equal(2, payload_get_version(buffer, written));
+        assert_int_equal(EXIT_SUCCESS, payload_v2_parse(parsed, &rx, buffer, written));
+        assert_int_equal(p->receiver, parsed->receiver);
+        assert_int_equal(p->number, parsed->number);
+        assert_int_equal(p->timestamp, parsed->timestamp);
+        assert_int_equal(p->channel, parsed->channel);
+        assert_int_equal(p->frequency, parsed->frequency);
+        assert_float_equal(p->rms, parsed->rms, 0.001);
+        assert_int_equal(3, parsed->codec_mode);
+        assert_true(parsed->flags & PAYLOAD_V2_FLAG_SQUELCH);
+        assert_int_equal(TEST_PAYLOAD_DATA_SIZE, parsed->data_size);
+        assert_memory_equal(data, parsed->data, TEST_PAYLOAD_DATA_SIZE);
+
+        p->number += 1 + i;
+        p->timestamp += 20;
+    }
+
+    payload_serialize(p, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+    assert_int_equal(1, payload_get_version(buffer, written));
+
+    payload_free(parsed);
+    payload_free(p);
+}
+
+void test_payload_v2_loss(void **state) {
+    (void) state;
+
+    payload *p;
+    payload *parsed;
+    payload_v2_state tx;
+    payload_v2_state rx;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    size_t written;
+    size_t i;
+
+    p = payload_init();
+    parsed = payload_init();
+    assert_non_null(p);
+    assert_non_null(parsed);
+    test_payload_fill(p, data);
+    payload_set_data_size(p, 0);
+
+    memset(&tx, 0, sizeof(payload_v2_state));
+    memset(&rx, 0, sizeof(payload_v2_state));
+
+    payload_v2_serialize_header(p, &tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+    assert_int_equal(EXIT_SUCCESS, payload_v2_parse(parsed, &rx, buffer, written));
+
+    p->number++;
+    payload_v2_serialize_header(p, &tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+
+    p->number++;
+    payload_v2_serialize_header(p, &tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+    assert_int_equal(EXIT_FAILURE, payload_v2_parse(parsed, &rx, buffer, written));
+    assert_int_equal(0, rx.valid);
+
+    for (i = 3; i < PAYLOAD_V2_KEY_INTERVAL; i++) {
+        p->number++;
+        payload_v2_serialize_header(p, &tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+        assert_int_equal(EXIT_FAILURE, payload_v2_parse(parsed, &rx, buffer, written));
+    }
+
+    p->number++;
+    payload_v2_serialize_header(p, &tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written);
+    assert_true(p->flags & PAYLOAD_V2_FLAG_KEY);
+    assert_int_equal(EXIT_SUCCESS, payload_v2_parse(parsed, &rx, buffer, written));
+    assert_int_equal(p->number, parsed->number);
+
+    payload_free(parsed);
+    payload_free(p);
+}
+
+void test_payload_v2_aggregate(void **state) {
+    (void) state;
+
+    payload *p;
+    payload *parsed;
+    payload_v2_state tx;
+    payload_v2_state rx;
+    uint8_t data[TEST_PAYLOAD_DATA_SIZE];
+    uint8_t buffer[TEST_PAYLOAD_BUFFER_SIZE];
+    const uint8_t *cursor;
+    uint32_t channel;
+    size_t written;
+
+    p = payload_init();
+    parsed = payload_init();
+    assert_non_null(p);
+    assert_non_null(parsed);
+    test_payload_fill(p, data);
+
+    memset(&tx, 0, sizeof(payload_v2_state));
+    memset(&rx, 0, sizeof(payload_v2_state));
+
+    assert_int_equal(EXIT_SUCCESS, payload_v2_aggregate_begin(p, &tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written));
+    assert_int_equal(EXIT_SUCCESS, payload_v2_aggregate_add(&tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written,
+                                                            p->number, data, TEST_PAYLOAD_DATA_SIZE));
+    assert_int_equal(EXIT_SUCCESS, payload_v2_aggregate_add(&tx, buffer, TEST_PAYLOAD_BUFFER_SIZE, &written,
+                                                            p->number + 2, data + 1, TEST_PAYLOAD_DATA_SIZE - 1));
+    assert_int_equal(EXIT_SUCCESS, payload_v2_aggregate_end(&tx, buffer));
+
+    assert_int_equal(EXIT_SUCCESS, payload_v2_get_channel(buffer, written, &channel));
+    assert_int_equal(p->channel, channel);
+
+    assert_int_equal(EXIT_SUCCESS, payload_v2_parse(parsed, &rx, buffer, written));
+    assert_true(parsed->flags & PAYLOAD_V2_FLAG_AGGREGATE);
+    assert_int_equal(2, rx.frames);
+
+    cursor = parsed->data;
+
+    assert_int_equal(EXIT_SUCCESS, payload_v2_parse_frame(parsed, &rx, &cursor, buffer + written));
+    assert_int_equal(p->number, parsed->number);
+    assert_int_equal(TEST_PAYLOAD_DATA_SIZE, parsed->data_size);
+    assert_memory_equal(data, parsed->data, TEST_PAYLOAD_DATA_SIZE);
+
+    assert_int_equal(EXIT_SUCCESS, payload_v2_parse_frame(parsed, &rx, &cursor, buffer + written));
+    assert_int_equal(p->number + 2, parsed->number);
+    assert_int_equal(TEST_PAYLOAD_DATA_SIZE - 1, parsed->data_size);
+    assert_memory_equal(data + 1, parsed->data, TEST_PAYLOAD_DATA_SIZE - 1);
+
+    assert_int_equal(EXIT_FAILURE, payload_v2_parse_frame(parsed, &rx, &cursor, buffer + written));
+    assert_ptr_equal(buffer + written, cursor);
+
+    payload_free(parsed);
+    payload_free(p);
+}
+
+static void test_payload_fill(payload *p, uint8_t *data) {
+    struct timespec ts;
+    size_t i;
+
+    for (i = 0; i < TEST_PAYLOAD_DATA_SIZE; i++)
+        data[i] = (uint8_t) (i * 3 + 1);
+
+    ts.tv_sec = 1600000000;
+    ts.tv_nsec = 123000000;
+
+    payload_set_numbers(p, 7, 0x0102030405060708);
+    payload_set_timestamp(p, &ts);
+    payload_set_rms(p, 0.25);
+    payload_set_channel_frequency(p, 2, 145500000);
+    payload_set_data(p, data, TEST_PAYLOAD_DATA_SIZE);
+}
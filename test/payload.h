@@ -0,0 +1,52 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__PAYLOAD__H__TEST
+#define __RTLSDR_RADIO__PAYLOAD__H__TEST
+
+#include "../src/payload.h"
+
+#define TEST_PAYLOAD_DATA_SIZE 8
+#define TEST_PAYLOAD_BUFFER_SIZE 256
+
+#define TEST_PAYLOAD_BLOCK_PCM 64
+#define TEST_PAYLOAD_FRAME_PCM 160
+#define TEST_PAYLOAD_AGGREGATE_FRAMES 4
+
+void test_payload_serialize_header(void **);
+
+void test_payload_serialize(void **);
+
+void test_payload_parse(void **);
+
+void test_payload_parse_wrong(void **);
+
+void test_payload_aggregate(void **);
+
+void test_payload_aggregate_blocks(void **);
+
+void test_payload_repair(void **);
+
+void test_payload_v2_parse(void **);
+
+void test_payload_v2_loss(void **);
+
+void test_payload_v2_aggregate(void **);
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "scan.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_scan_init),
+        cmocka_unit_test(test_scan_hop),
+        cmocka_unit_test(test_scan_dwell),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("scan", tests, NULL, NULL);
+}
+
+void test_scan_init(void **state) {
+    (void) state;
+
+    scan_ctx *ctx;
+    uint32_t freqs[] = {145500000, 145525000};
+
+    ctx = scan_init(freqs, 0, TEST_SCAN_DWELL_BLOCKS, TEST_SCAN_RESUME_BLOCKS);
+    assert_null(ctx);
+
+    ctx = scan_init(freqs, 2, 0, 0);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->dwell_blocks);
+    assert_int_equal(1, ctx->resume_blocks);
+    assert_int_equal(145500000, scan_frequency(ctx));
+
+    scan_free(ctx);
+}
+
+void test_scan_hop(void **state) {
+    (void) state;
+
+    scan_ctx *ctx;
+    uint32_t freqs[] = {145500000, 145525000, 145550000};
+    size_t i;
+    size_t j;
+
+    ctx = scan_init(freqs, 3, TEST_SCAN_DWELL_BLOCKS, TEST_SCAN_RESUME_BLOCKS);
+    assert_non_null(ctx);
+
+    for (i = 0; i < 6; i++) {
+        assert_int_equal(freqs[i % 3], scan_frequency(ctx));
+
+        for (j = 1; j < TEST_SCAN_DWELL_BLOCKS; j++)
+            assert_int_equal(0, scan_update(ctx, 0));
+
+        assert_int_equal(1, scan_update(ctx, 0));
+    }
+
+    assert_int_equal(6, ctx->hops);
+    assert_int_equal(freqs[0], scan_frequency(ctx));
+
+    scan_free(ctx);
+}
+
+void test_scan_dwell(void **state) {
+    (void) state;
+
+    scan_ctx *ctx;
+    uint32_t freqs[] = {145500000, 145525000};
+    size_t j;
+
+    ctx = scan_init(freqs, 2, TEST_SCAN_DWELL_BLOCKS, TEST_SCAN_RESUME_BLOCKS);
+    assert_non_null(ctx);
+
+    assert_int_equal(0, scan_update(ctx, 0));
+    assert_int_equal(0, scan_update(ctx, 1));
+    assert_int_equal(SCAN_STATE_DWELL, ctx->state);
+
+    for (j = 0; j < TEST_SCAN_DWELL_BLOCKS * 4; j++)
+        assert_int_equal(0, scan_update(ctx, 1));
+
+    for (j = 1; j < TEST_SCAN_RESUME_BLOCKS; j++)
+        assert_int_equal(0, scan_update(ctx, 0));
+
+    assert_int_equal(0, scan_update(ctx, 1));
+
+    for (j = 1; j < TEST_SCAN_RESUME_BLOCKS; j++)
+        assert_int_equal(0, scan_update(ctx, 0));
+
+    assert_int_equal(1, scan_update(ctx, 0));
+    assert_int_equal(SCAN_STATE_LISTEN, ctx->state);
+    assert_int_equal(freqs[1], scan_frequency(ctx));
+    assert_int_equal(1, ctx->hops);
+
+    scan_free(ctx);
+}
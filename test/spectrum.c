@@ -0,0 +1,191 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "spectrum.h"
+#include "../src/utils.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_spectrum_init),
+        cmocka_unit_test(test_spectrum_tone),
+        cmocka_unit_test(test_spectrum_tone_fixed),
+        cmocka_unit_test(test_spectrum_levels),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("spectrum", tests, NULL, NULL);
+}
+
+static void test_spectrum_check(spectrum_ctx *ctx) {
+    uint8_t buffer[64 + TEST_SPECTRUM_SIZE];
+    uint8_t expected[8];
+    struct timespec ts;
+    size_t written;
+    uint8_t *bins;
+    size_t peak;
+    size_t i;
+
+    ts.tv_sec = 1;
+    ts.tv_nsec = 500000000;
+
+    assert_int_equal(EXIT_SUCCESS, spectrum_serialize(ctx, &ts, TEST_SPECTRUM_FREQUENCY, TEST_SPECTRUM_SAMPLE_RATE,
+                                                      buffer, sizeof(buffer), &written));
+    assert_int_equal(spectrum_get_size(ctx), written);
+    assert_int_equal(0, ctx->count);
+
+    assert_memory_equal(SPECTRUM_HEADER, buffer, 3);
+
+    utils_uint64_to_be(expected, 1500);
+    assert_memory_equal(expected, buffer + 3 + 8, 8);
+
+    utils_uint32_to_be(expected, TEST_SPECTRUM_FREQUENCY);
+    assert_memory_equal(expected, buffer + 3 + 8 + 8, 4);
+
+    utils_uint16_to_be(expected, TEST_SPECTRUM_SIZE);
+    assert_memory_equal(expected, buffer + 3 + 8 + 8 + 4 + 4, 2);
+
+    bins = buffer + written - TEST_SPECTRUM_SIZE;
+    peak = TEST_SPECTRUM_SIZE / 2 + TEST_SPECTRUM_BIN;
+
+    assert_true(bins[peak] >= UINT8_MAX - 2);
+
+    for (i = 0; i < TEST_SPECTRUM_SIZE; i++)
+        if (i + 4 < peak || i > peak + 4)
+            assert_true(bins[i] < UINT8_MAX - 80 * SPECTRUM_DB_STEPS);
+}
+
+void test_spectrum_init(void **state) {
+    (void) state;
+
+    spectrum_ctx *ctx;
+    uint8_t buffer[1];
+    struct timespec ts;
+    size_t written;
+
+    assert_null(spectrum_init(1, TEST_SPECTRUM_AVERAGES, FFT_RIGOR_ESTIMATE));
+    assert_null(spectrum_init(TEST_SPECTRUM_SIZE, 0, FFT_RIGOR_ESTIMATE));
+
+    ctx = spectrum_init(TEST_SPECTRUM_SIZE, TEST_SPECTRUM_AVERAGES, FFT_RIGOR_ESTIMATE);
+    assert_non_null(ctx);
+    assert_false(spectrum_ready(ctx));
+
+    ts.tv_sec = 0;
+    ts.tv_nsec = 0;
+    assert_int_equal(EXIT_FAILURE, spectrum_serialize(ctx, &ts, 0, 0, buffer, sizeof(buffer), &written));
+
+    spectrum_free(ctx);
+}
+
+void test_spectrum_tone(void **state) {
+    (void) state;
+
+    spectrum_ctx *ctx;
+    FP_FLOAT complex samples[TEST_SPECTRUM_SIZE];
+    double phase;
+    size_t i;
+    size_t j;
+
+    ctx = spectrum_init(TEST_SPECTRUM_SIZE, TEST_SPECTRUM_AVERAGES, FFT_RIGOR_ESTIMATE);
+    assert_non_null(ctx);
+
+    for (i = 0; i < TEST_SPECTRUM_AVERAGES; i++) {
+        for (j = 0; j < TEST_SPECTRUM_SIZE; j++) {
+            phase = 2 * M_PI * TEST_SPECTRUM_BIN * (double) j / TEST_SPECTRUM_SIZE;
+            samples[j] = (FP_FLOAT) cos(phase) + (FP_FLOAT) sin(phase) * I;
+        }
+
+        assert_false(spectrum_ready(ctx));
+        assert_int_equal(EXIT_SUCCESS, spectrum_add(ctx, samples));
+    }
+
+    assert_true(spectrum_ready(ctx));
+
+    test_spectrum_check(ctx);
+
+    spectrum_free(ctx);
+}
+
+void test_spectrum_tone_fixed(void **state) {
+    (void) state;
+
+    spectrum_ctx *ctx;
+    fixed_complex samples[TEST_SPECTRUM_SIZE];
+    double phase;
+    size_t i;
+    size_t j;
+
+    ctx = spectrum_init(TEST_SPECTRUM_SIZE, TEST_SPECTRUM_AVERAGES, FFT_RIGOR_ESTIMATE);
+    assert_non_null(ctx);
+
+    for (i = 0; i < TEST_SPECTRUM_AVERAGES; i++) {
+        for (j = 0; j < TEST_SPECTRUM_SIZE; j++) {
+            phase = 2 * M_PI * TEST_SPECTRUM_BIN * (double) j / TEST_SPECTRUM_SIZE;
+            samples[j].i = (int16_t) lround(cos(phase) * FIXED_Q15_ONE);
+            samples[j].q = (int16_t) lround(sin(phase) * FIXED_Q15_ONE);
+        }
+
+        assert_int_equal(EXIT_SUCCESS, spectrum_add_fixed(ctx, samples));
+    }
+
+    test_spectrum_check(ctx);
+
+    spectrum_free(ctx);
+}
+
+void test_spectrum_levels(void **state) {
+    (void) state;
+
+    spectrum_ctx *ctx;
+    FP_FLOAT complex samples[TEST_SPECTRUM_SIZE];
+    FP_FLOAT levels[TEST_SPECTRUM_SIZE];
+    double phase;
+    size_t peak;
+    size_t i;
+
+    ctx = spectrum_init(TEST_SPECTRUM_SIZE, TEST_SPECTRUM_AVERAGES, FFT_RIGOR_ESTIMATE);
+    assert_non_null(ctx);
+
+    assert_int_equal(EXIT_FAILURE, spectrum_levels(ctx, levels));
+
+    for (i = 0; i < TEST_SPECTRUM_SIZE; i++) {
+        phase = -2 * M_PI * TEST_SPECTRUM_BIN * (double) i / TEST_SPECTRUM_SIZE;
+        samples[i] = (FP_FLOAT) (0.1 * cos(phase)) + (FP_FLOAT) (0.1 * sin(phase)) * I;
+    }
+
+    assert_int_equal(EXIT_SUCCESS, spectrum_add(ctx, samples));
+    assert_int_equal(EXIT_SUCCESS, spectrum_levels(ctx, levels));
+    assert_int_equal(0, ctx->count);
+
+    peak = TEST_SPECTRUM_SIZE / 2 - TEST_SPECTRUM_BIN;
+    assert_true(fabs((double) levels[peak] + 20) < 0.5);
+
+    for (i = 0; i < TEST_SPECTRUM_SIZE; i++)
+        if (i + 4 < peak || i > peak + 4)
+            assert_true(levels[i] < -100);
+
+    spectrum_free(ctx);
+}
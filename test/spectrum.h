@@ -0,0 +1,40 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef __RTLSDR_RADIO__SPECTRUM__H__TEST
+#define __RTLSDR_RADIO__SPECTRUM__H__TEST
+
+#include "../src/spectrum.h"
+
+#define TEST_SPECTRUM_SAMPLE_RATE 1024000
+#define TEST_SPECTRUM_FREQUENCY 145500000
+#define TEST_SPECTRUM_SIZE 256
+#define TEST_SPECTRUM_AVERAGES 4
+#define TEST_SPECTRUM_BIN 32
+
+void test_spectrum_init(void **);
+
+void test_spectrum_tone(void **);
+
+void test_spectrum_tone_fixed(void **);
+
+void test_spectrum_levels(void **);
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <math.h>
+
+#include "squelch.h"
+
+static FP_FLOAT test_squelch_level(double);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_squelch_none),
+        cmocka_unit_test(test_squelch_rms),
+        cmocka_unit_test(test_squelch_hang),
+        cmocka_unit_test(test_squelch_hysteresis),
+        cmocka_unit_test(test_squelch_snr),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("squelch", tests, NULL, NULL);
+}
+
+void test_squelch_none(void **state) {
+    (void) state;
+
+    squelch_ctx *ctx;
+
+    ctx = squelch_init(SQUELCH_MODE_NONE, TEST_SQUELCH_LEVEL, TEST_SQUELCH_HYSTERESIS, TEST_SQUELCH_HANG_BLOCKS);
+    assert_non_null(ctx);
+    assert_int_equal(1, ctx->open);
+
+    assert_int_equal(1, squelch_update(ctx, 0));
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-100)));
+
+    squelch_reset(ctx);
+    assert_int_equal(1, ctx->open);
+
+    squelch_free(ctx);
+}
+
+void test_squelch_rms(void **state) {
+    (void) state;
+
+    squelch_ctx *ctx;
+
+    ctx = squelch_init(SQUELCH_MODE_RMS, TEST_SQUELCH_LEVEL, TEST_SQUELCH_HYSTERESIS, 0);
+    assert_non_null(ctx);
+    assert_int_equal(0, ctx->open);
+
+    assert_int_equal(0, squelch_update(ctx, 0));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-40)));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-31)));
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-29.5)));
+
+    // Between the close and the open thresholds it keeps its state
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-35)));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-36.5)));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-35)));
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-10)));
+
+    squelch_reset(ctx);
+    assert_int_equal(0, ctx->open);
+
+    squelch_free(ctx);
+}
+
+void test_squelch_hang(void **state) {
+    (void) state;
+
+    squelch_ctx *ctx;
+    size_t i;
+
+    ctx = squelch_init(SQUELCH_MODE_RMS, TEST_SQUELCH_LEVEL, TEST_SQUELCH_HYSTERESIS, TEST_SQUELCH_HANG_BLOCKS);
+    assert_non_null(ctx);
+
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-20)));
+    assert_int_equal(TEST_SQUELCH_HANG_BLOCKS, ctx->hang);
+
+    for (i = 0; i < TEST_SQUELCH_HANG_BLOCKS; i++) {
+        assert_int_equal(1, squelch_update(ctx, test_squelch_level(-60)));
+        assert_int_equal(TEST_SQUELCH_HANG_BLOCKS - i - 1, ctx->hang);
+    }
+
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-60)));
+
+    // A block above the close threshold restarts the countdown
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-20)));
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-60)));
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-33)));
+    assert_int_equal(TEST_SQUELCH_HANG_BLOCKS, ctx->hang);
+
+    for (i = 0; i < TEST_SQUELCH_HANG_BLOCKS; i++)
+        assert_int_equal(1, squelch_update(ctx, test_squelch_level(-60)));
+
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-60)));
+
+    squelch_free(ctx);
+}
+
+void test_squelch_hysteresis(void **state) {
+    (void) state;
+
+    squelch_ctx *ctx;
+
+    ctx = squelch_init(SQUELCH_MODE_RMS, TEST_SQUELCH_LEVEL, 0, 0);
+    assert_non_null(ctx);
+    assert_true(ctx->open_level == ctx->close_level);
+
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-29.5)));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-30.5)));
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-29.5)));
+
+    squelch_free(ctx);
+
+    ctx = squelch_init(SQUELCH_MODE_RMS, TEST_SQUELCH_LEVEL, 20, 0);
+    assert_non_null(ctx);
+    assert_true(fabs((double) ctx->close_level - (TEST_SQUELCH_LEVEL - 20)) < 1e-6);
+
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-29.5)));
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-49.5)));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-50.5)));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-31)));
+
+    squelch_free(ctx);
+}
+
+void test_squelch_snr(void **state) {
+    (void) state;
+
+    squelch_ctx *ctx;
+    FP_FLOAT noise;
+    size_t i;
+
+    ctx = squelch_init(SQUELCH_MODE_SNR, 10, 3, 0);
+    assert_non_null(ctx);
+
+    for (i = 0; i < 10; i++)
+        assert_int_equal(0, squelch_update(ctx, test_squelch_level(-60)));
+
+    // The floor rises slowly while closed
+    assert_true(ctx->noise > test_squelch_level(-60) * test_squelch_level(-60));
+
+    // and follows any drop at once
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-70)));
+    assert_true(fabs(10 * log10((double) ctx->noise) + 70) < 1e-3);
+
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-55)));
+    noise = ctx->noise;
+
+    // It does not rise while open, so a long signal keeps the squelch open
+    for (i = 0; i < 1000; i++)
+        assert_int_equal(1, squelch_update(ctx, test_squelch_level(-55)));
+    assert_true(noise == ctx->noise);
+
+    assert_int_equal(1, squelch_update(ctx, test_squelch_level(-62.5)));
+    assert_int_equal(0, squelch_update(ctx, test_squelch_level(-63.5)));
+
+    squelch_reset(ctx);
+    assert_int_equal(0, ctx->open);
+    assert_true(ctx->noise == 0);
+
+    squelch_free(ctx);
+}
+
+static FP_FLOAT test_squelch_level(double level) {
+    return (FP_FLOAT) pow(10, level / 20);
+}
@@ -0,0 +1,39 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__SQUELCH__H__TEST
+#define __RTLSDR_RADIO__SQUELCH__H__TEST
+
+#include "../src/squelch.h"
+
+#define TEST_SQUELCH_LEVEL (-30)
+#define TEST_SQUELCH_HYSTERESIS 6
+#define TEST_SQUELCH_HANG_BLOCKS 3
+
+void test_squelch_none(void **);
+
+void test_squelch_rms(void **);
+
+void test_squelch_hang(void **);
+
+void test_squelch_hysteresis(void **);
+
+void test_squelch_snr(void **);
+
+#endif
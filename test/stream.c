@@ -0,0 +1,256 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <endian.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <cmocka.h>
+
+#include "stream.h"
+
+static int test_stream_listen(uint16_t *);
+
+static uint16_t test_stream_closed_port();
+
+static void test_stream_read(int, uint8_t *, size_t);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_stream_init),
+        cmocka_unit_test(test_stream_drop_oldest),
+        cmocka_unit_test(test_stream_oversize),
+        cmocka_unit_test(test_stream_deliver),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("stream", tests, NULL, NULL);
+}
+
+void test_stream_init(void **state) {
+    (void) state;
+
+    stream_ctx *ctx;
+
+    assert_null(stream_init("127.0.0.1", test_stream_closed_port(), 1, TEST_STREAM_FRAME));
+
+    ctx = stream_init("127.0.0.1", test_stream_closed_port(), TEST_STREAM_QUEUE, TEST_STREAM_FRAME);
+    assert_non_null(ctx);
+    assert_int_equal(0, ctx->count);
+    assert_int_equal(STREAM_LENGTH_SIZE + TEST_STREAM_FRAME, ctx->frame_size);
+
+    stream_free(ctx);
+}
+
+void test_stream_drop_oldest(void **state) {
+    (void) state;
+
+    stream_ctx *ctx;
+    uint8_t header[2];
+    uint8_t data[4];
+    uint8_t *frame;
+    uint32_t length;
+    size_t i;
+
+    ctx = stream_init("127.0.0.1", test_stream_closed_port(), TEST_STREAM_QUEUE, TEST_STREAM_FRAME);
+    assert_non_null(ctx);
+
+    for (i = 0; i < TEST_STREAM_QUEUE + 2; i++) {
+        header[0] = 0xAA;
+        header[1] = (uint8_t) i;
+        memset(data, (int) i, sizeof(data));
+        assert_int_equal(EXIT_SUCCESS, stream_push(ctx, header, sizeof(header), data, sizeof(data)));
+    }
+
+    pthread_mutex_lock(&ctx->mutex);
+
+    assert_int_equal(TEST_STREAM_QUEUE, ctx->count);
+    assert_int_equal(TEST_STREAM_QUEUE + 2, ctx->queued);
+    assert_int_equal(2, ctx->dropped);
+    assert_int_equal(0, ctx->sent);
+
+    for (i = 0; i < TEST_STREAM_QUEUE; i++) {
+        frame = ctx->frames + ((ctx->head + i) % ctx->queue_size) * ctx->frame_size;
+        memcpy(&length, frame, sizeof(length));
+        assert_int_equal(sizeof(header) + sizeof(data), le32toh(length));
+        assert_int_equal(STREAM_LENGTH_SIZE + sizeof(header) + sizeof(data), ctx->sizes[(ctx->head + i) % ctx->queue_size]);
+        assert_int_equal(0xAA, frame[STREAM_LENGTH_SIZE]);
+        assert_int_equal(i + 2, frame[STREAM_LENGTH_SIZE + 1]);
+        assert_int_equal(i + 2, frame[STREAM_LENGTH_SIZE + 2]);
+    }
+
+    // A partially written frame must survive the drop
+    ctx->offset = 1;
+
+    pthread_mutex_unlock(&ctx->mutex);
+
+    header[1] = 0x10;
+    assert_int_equal(EXIT_SUCCESS, stream_push(ctx, header, sizeof(header), data, sizeof(data)));
+
+    pthread_mutex_lock(&ctx->mutex);
+
+    assert_int_equal(TEST_STREAM_QUEUE, ctx->count);
+    assert_int_equal(3, ctx->dropped);
+    assert_int_equal(2, ctx->frames[ctx->head * ctx->frame_size + STREAM_LENGTH_SIZE + 1]);
+    assert_int_equal(4, ctx->frames[((ctx->head + 1) % ctx->queue_size) * ctx->frame_size + STREAM_LENGTH_SIZE + 1]);
+    assert_int_equal(0x10, ctx->frames[((ctx->head + 3) % ctx->queue_size) * ctx->frame_size + STREAM_LENGTH_SIZE + 1]);
+
+    ctx->offset = 0;
+
+    pthread_mutex_unlock(&ctx->mutex);
+
+    stream_free(ctx);
+}
+
+void test_stream_oversize(void **state) {
+    (void) state;
+
+    stream_ctx *ctx;
+    uint8_t header[4];
+    uint8_t data[TEST_STREAM_FRAME];
+
+    ctx = stream_init("127.0.0.1", test_stream_closed_port(), TEST_STREAM_QUEUE, TEST_STREAM_FRAME);
+    assert_non_null(ctx);
+
+    memset(header, 0, sizeof(header));
+    memset(data, 0, sizeof(data));
+
+    assert_int_equal(EXIT_FAILURE, stream_push(ctx, header, sizeof(header), data, sizeof(data)));
+    assert_int_equal(EXIT_SUCCESS, stream_push(ctx, header, 0, data, sizeof(data)));
+
+    pthread_mutex_lock(&ctx->mutex);
+    assert_int_equal(1, ctx->count);
+    assert_int_equal(1, ctx->dropped);
+    pthread_mutex_unlock(&ctx->mutex);
+
+    stream_free(ctx);
+}
+
+void test_stream_deliver(void **state) {
+    (void) state;
+
+    stream_ctx *ctx;
+    struct pollfd fd;
+    uint16_t port;
+    int server;
+    int client;
+    uint8_t header[3];
+    uint8_t data[5];
+    uint8_t buffer[STREAM_LENGTH_SIZE + sizeof(header) + sizeof(data)];
+    uint32_t length;
+    size_t i;
+
+    server = test_stream_listen(&port);
+    assert_int_not_equal(-1, server);
+
+    ctx = stream_init("127.0.0.1", port, TEST_STREAM_QUEUE, TEST_STREAM_FRAME);
+    assert_non_null(ctx);
+
+    for (i = 0; i < 2; i++) {
+        memset(header, (int) (0x10 + i), sizeof(header));
+        memset(data, (int) (0x20 + i), sizeof(data));
+        assert_int_equal(EXIT_SUCCESS, stream_push(ctx, header, sizeof(header), data, sizeof(data)));
+    }
+
+    fd.fd = server;
+    fd.events = POLLIN;
+    fd.revents = 0;
+    assert_int_equal(1, poll(&fd, 1, TEST_STREAM_TIMEOUT_MS));
+
+    client = accept(server, NULL, NULL);
+    assert_int_not_equal(-1, client);
+
+    for (i = 0; i < 2; i++) {
+        test_stream_read(client, buffer, sizeof(buffer));
+
+        memcpy(&length, buffer, sizeof(length));
+        assert_int_equal(sizeof(header) + sizeof(data), le32toh(length));
+        assert_int_equal(0x10 + i, buffer[STREAM_LENGTH_SIZE]);
+        assert_int_equal(0x10 + i, buffer[STREAM_LENGTH_SIZE + sizeof(header) - 1]);
+        assert_int_equal(0x20 + i, buffer[STREAM_LENGTH_SIZE + sizeof(header)]);
+        assert_int_equal(0x20 + i, buffer[sizeof(buffer) - 1]);
+    }
+
+    stream_free(ctx);
+
+    close(client);
+    close(server);
+}
+
+static int test_stream_listen(uint16_t *port) {
+    struct sockaddr_in address;
+    socklen_t address_len;
+    int sck;
+
+    sck = socket(AF_INET, SOCK_STREAM, 0);
+    if (sck == -1)
+        return -1;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    address_len = sizeof(address);
+    if (bind(sck, (struct sockaddr *) &address, sizeof(address)) == -1
+        || listen(sck, 1) == -1
+        || getsockname(sck, (struct sockaddr *) &address, &address_len) == -1) {
+        close(sck);
+        return -1;
+    }
+
+    *port = ntohs(address.sin_port);
+
+    return sck;
+}
+
+static uint16_t test_stream_closed_port() {
+    uint16_t port;
+    int sck;
+
+    sck = test_stream_listen(&port);
+    assert_int_not_equal(-1, sck);
+    close(sck);
+
+    return port;
+}
+
+static void test_stream_read(int sck, uint8_t *buffer, size_t size) {
+    struct pollfd fd;
+    ssize_t ln;
+    size_t pos;
+
+    fd.fd = sck;
+    fd.events = POLLIN;
+
+    for (pos = 0; pos < size; pos += (size_t) ln) {
+        fd.revents = 0;
+        assert_int_equal(1, poll(&fd, 1, TEST_STREAM_TIMEOUT_MS));
+
+        ln = recv(sck, buffer + pos, size - pos, 0);
+        assert_true(ln > 0);
+    }
+}
@@ -0,0 +1,37 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__STREAM__H__TEST
+#define __RTLSDR_RADIO__STREAM__H__TEST
+
+#include "../src/stream.h"
+
+#define TEST_STREAM_QUEUE 4
+#define TEST_STREAM_FRAME 16
+#define TEST_STREAM_TIMEOUT_MS 2000
+
+void test_stream_init(void **);
+
+void test_stream_drop_oldest(void **);
+
+void test_stream_oversize(void **);
+
+void test_stream_deliver(void **);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "survey.h"
+#include "../src/spectrum.h"
+#include "../src/utils.h"
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_survey_init),
+        cmocka_unit_test(test_survey_hops),
+        cmocka_unit_test(test_survey_write_csv),
+        cmocka_unit_test(test_survey_write_binary),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("survey", tests, NULL, NULL);
+}
+
+void test_survey_init(void **state) {
+    (void) state;
+
+    survey_ctx *ctx;
+
+    assert_null(survey_init(TEST_SURVEY_STOP, TEST_SURVEY_START, TEST_SURVEY_SAMPLE_RATE, TEST_SURVEY_SIZE,
+                            TEST_SURVEY_CROP));
+    assert_null(survey_init(TEST_SURVEY_START, TEST_SURVEY_STOP, TEST_SURVEY_SAMPLE_RATE, TEST_SURVEY_SIZE, 50));
+
+    ctx = survey_init(TEST_SURVEY_START, TEST_SURVEY_STOP, TEST_SURVEY_SAMPLE_RATE, TEST_SURVEY_SIZE,
+                      TEST_SURVEY_CROP);
+    assert_non_null(ctx);
+
+    assert_int_equal(TEST_SURVEY_SIZE * TEST_SURVEY_CROP / 100, ctx->crop);
+    assert_int_equal(TEST_SURVEY_SIZE - 2 * ctx->crop, ctx->bins);
+    assert_int_equal(1637, ctx->hops);
+
+    survey_free(ctx);
+}
+
+void test_survey_hops(void **state) {
+    (void) state;
+
+    survey_ctx *ctx;
+    double low;
+    double previous;
+    size_t hop;
+
+    ctx = survey_init(TEST_SURVEY_START, TEST_SURVEY_STOP, TEST_SURVEY_SAMPLE_RATE, TEST_SURVEY_SIZE,
+                      TEST_SURVEY_CROP);
+    assert_non_null(ctx);
+
+    previous = 0;
+
+    for (hop = 0; hop < ctx->hops; hop++) {
+        low = survey_hop_low(ctx, survey_hop_frequency(ctx, hop));
+
+        if (hop == 0)
+            assert_true(fabs(low - TEST_SURVEY_START) <= 1);
+        else
+            assert_true(fabs(low - previous - ctx->hop_width) <= 1);
+
+        previous = low;
+    }
+
+    assert_true(previous + ctx->hop_width >= TEST_SURVEY_STOP);
+    assert_true(previous < TEST_SURVEY_STOP);
+
+    survey_free(ctx);
+}
+
+void test_survey_write_csv(void **state) {
+    (void) state;
+
+    survey_ctx *ctx;
+    FP_FLOAT levels[8];
+    struct timespec ts;
+    char line[256];
+    FILE *fd;
+    size_t i;
+
+    ctx = survey_init(100000000, 101000000, 8000, 8, TEST_SURVEY_CROP);
+    assert_non_null(ctx);
+    assert_int_equal(4, ctx->bins);
+
+    for (i = 0; i < 8; i++)
+        levels[i] = (FP_FLOAT) -10 * (FP_FLOAT) i;
+
+    ts.tv_sec = 86400;
+    ts.tv_nsec = 0;
+
+    fd = tmpfile();
+    assert_non_null(fd);
+
+    assert_int_equal(EXIT_SUCCESS, survey_write(ctx, SURVEY_FORMAT_CSV, fd, &ts, survey_hop_frequency(ctx, 0), 64,
+                                                levels));
+
+    rewind(fd);
+    assert_non_null(fgets(line, sizeof(line), fd));
+    assert_string_equal("1970-01-02, 00:00:00, 100000000, 100004000, 1000.00, 64, -20.00, -30.00, -40.00, -50.00\n",
+                        line);
+
+    fclose(fd);
+    survey_free(ctx);
+}
+
+void test_survey_write_binary(void **state) {
+    (void) state;
+
+    survey_ctx *ctx;
+    FP_FLOAT levels[8];
+    struct timespec ts;
+    uint8_t record[64];
+    uint8_t expected[8];
+    FILE *fd;
+    size_t i;
+
+    ctx = survey_init(100000000, 101000000, 8000, 8, TEST_SURVEY_CROP);
+    assert_non_null(ctx);
+
+    for (i = 0; i < 8; i++)
+        levels[i] = (FP_FLOAT) -10 * (FP_FLOAT) i;
+
+    ts.tv_sec = 2;
+    ts.tv_nsec = 250000000;
+
+    fd = tmpfile();
+    assert_non_null(fd);
+
+    assert_int_equal(EXIT_SUCCESS, survey_write(ctx, SURVEY_FORMAT_BINARY, fd, &ts, survey_hop_frequency(ctx, 0), 64,
+                                                levels));
+
+    rewind(fd);
+    assert_int_equal(3 + 8 + 4 + 4 + 2 + 4, fread(record, sizeof(uint8_t), sizeof(record), fd));
+
+    assert_memory_equal(SURVEY_HEADER, record, 3);
+
+    utils_uint64_to_be(expected, 2250);
+    assert_memory_equal(expected, record + 3, 8);
+
+    utils_uint32_to_be(expected, 100000000);
+    assert_memory_equal(expected, record + 3 + 8, 4);
+
+    utils_uint32_to_be(expected, 1000000);
+    assert_memory_equal(expected, record + 3 + 8 + 4, 4);
+
+    utils_uint16_to_be(expected, 4);
+    assert_memory_equal(expected, record + 3 + 8 + 4 + 4, 2);
+
+    for (i = 0; i < 4; i++)
+        assert_int_equal((uint8_t) lround((-10.0 * (double) (i + 2) - SPECTRUM_DB_MIN) * SPECTRUM_DB_STEPS),
+                         record[3 + 8 + 4 + 4 + 2 + i]);
+
+    fclose(fd);
+    survey_free(ctx);
+}
@@ -0,0 +1,39 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__SURVEY__H__TEST
+#define __RTLSDR_RADIO__SURVEY__H__TEST
+
+#include "../src/survey.h"
+
+#define TEST_SURVEY_START 24000000
+#define TEST_SURVEY_STOP 1700000000
+#define TEST_SURVEY_SAMPLE_RATE 2048000
+#define TEST_SURVEY_SIZE 1024
+#define TEST_SURVEY_CROP 25
+
+void test_survey_init(void **);
+
+void test_survey_hops(void **);
+
+void test_survey_write_csv(void **);
+
+void test_survey_write_binary(void **);
+
+#endif
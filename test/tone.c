@@ -0,0 +1,171 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include "tone.h"
+
+static int test_tone_run(tone_ctx *, double, double, double);
+
+static int test_tone_run_fixed(tone_ctx *, double, double, double);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_tone_init),
+        cmocka_unit_test(test_tone_detect),
+        cmocka_unit_test(test_tone_wrong_tone),
+        cmocka_unit_test(test_tone_voice_only),
+        cmocka_unit_test(test_tone_detect_fixed),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("tone", tests, NULL, NULL);
+}
+
+void test_tone_init(void **state) {
+    (void) state;
+
+    tone_ctx *ctx;
+
+    assert_int_equal(0, tone_index(670));
+    assert_int_equal(8, tone_index(885));
+    assert_int_equal(TONE_COUNT - 1, tone_index(2541));
+    assert_int_equal(-1, tone_index(880));
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 880);
+    assert_null(ctx);
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 885);
+    assert_non_null(ctx);
+    assert_int_equal(TEST_TONE_SAMPLE_RATE / TONE_RATE, ctx->decimation);
+    assert_int_equal(TONE_RATE * TONE_WINDOW_MS / 1000, ctx->window);
+    assert_int_equal(8, ctx->target);
+    assert_int_equal(0, ctx->open);
+
+    tone_free(ctx);
+}
+
+void test_tone_detect(void **state) {
+    (void) state;
+
+    tone_ctx *ctx;
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 885);
+    assert_non_null(ctx);
+
+    assert_int_equal(1, test_tone_run(ctx, 88.5, 0.1, 0.5));
+
+    tone_reset(ctx);
+    assert_int_equal(0, ctx->open);
+
+    tone_free(ctx);
+}
+
+void test_tone_wrong_tone(void **state) {
+    (void) state;
+
+    tone_ctx *ctx;
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 1000);
+    assert_non_null(ctx);
+    assert_int_equal(0, test_tone_run(ctx, 88.5, 0.1, 0.5));
+    tone_free(ctx);
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 1148);
+    assert_non_null(ctx);
+    assert_int_equal(0, test_tone_run(ctx, 110.9, 0.1, 0.5));
+    tone_free(ctx);
+}
+
+void test_tone_voice_only(void **state) {
+    (void) state;
+
+    tone_ctx *ctx;
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 885);
+    assert_non_null(ctx);
+
+    assert_int_equal(0, test_tone_run(ctx, 88.5, 0, 0.5));
+
+    tone_free(ctx);
+}
+
+void test_tone_detect_fixed(void **state) {
+    (void) state;
+
+    tone_ctx *ctx;
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 1318);
+    assert_non_null(ctx);
+    assert_int_equal(1, test_tone_run_fixed(ctx, 131.8, 0.1, 0.5));
+    tone_free(ctx);
+
+    ctx = tone_init(TEST_TONE_SAMPLE_RATE, 1365);
+    assert_non_null(ctx);
+    assert_int_equal(0, test_tone_run_fixed(ctx, 131.8, 0.1, 0.5));
+    tone_free(ctx);
+}
+
+static int test_tone_run(tone_ctx *ctx, double freq, double tone_level, double voice_level) {
+    FP_FLOAT audio[TEST_TONE_BLOCK_SIZE];
+    double t;
+    size_t b;
+    size_t i;
+    int open;
+
+    open = 0;
+
+    for (b = 0; b < TEST_TONE_BLOCKS; b++) {
+        for (i = 0; i < TEST_TONE_BLOCK_SIZE; i++) {
+            t = (double) (b * TEST_TONE_BLOCK_SIZE + i) / TEST_TONE_SAMPLE_RATE;
+            audio[i] = (FP_FLOAT) (tone_level * sin(2 * M_PI * freq * t)
+                                   + voice_level * sin(2 * M_PI * 1000 * t) * sin(2 * M_PI * 3 * t));
+        }
+
+        open = tone_update(ctx, audio, TEST_TONE_BLOCK_SIZE);
+    }
+
+    return open;
+}
+
+static int test_tone_run_fixed(tone_ctx *ctx, double freq, double tone_level, double voice_level) {
+    int16_t audio[TEST_TONE_BLOCK_SIZE];
+    double t;
+    size_t b;
+    size_t i;
+    int open;
+
+    open = 0;
+
+    for (b = 0; b < TEST_TONE_BLOCKS; b++) {
+        for (i = 0; i < TEST_TONE_BLOCK_SIZE; i++) {
+            t = (double) (b * TEST_TONE_BLOCK_SIZE + i) / TEST_TONE_SAMPLE_RATE;
+            audio[i] = (int16_t) (32767 * (tone_level * sin(2 * M_PI * freq * t)
+                                           + voice_level * sin(2 * M_PI * 1000 * t) * sin(2 * M_PI * 3 * t)));
+        }
+
+        open = tone_update_fixed(ctx, audio, TEST_TONE_BLOCK_SIZE);
+    }
+
+    return open;
+}
@@ -0,0 +1,39 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__TONE__H__TEST
+#define __RTLSDR_RADIO__TONE__H__TEST
+
+#include "../src/tone.h"
+
+#define TEST_TONE_SAMPLE_RATE 32000
+#define TEST_TONE_BLOCK_SIZE 1024
+#define TEST_TONE_BLOCKS 64
+
+void test_tone_init(void **);
+
+void test_tone_detect(void **);
+
+void test_tone_wrong_tone(void **);
+
+void test_tone_voice_only(void **);
+
+void test_tone_detect_fixed(void **);
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "vote.h"
+
+static vote_ctx *test_vote_create();
+
+static void test_vote_put(vote_ctx *, size_t, uint64_t, uint64_t, float);
+
+const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_vote_init),
+        cmocka_unit_test(test_vote_best),
+        cmocka_unit_test(test_vote_window),
+        cmocka_unit_test(test_vote_lost_late),
+        cmocka_unit_test(test_vote_alignment),
+        cmocka_unit_test(test_vote_resync),
+        cmocka_unit_test(test_vote_gap),
+};
+
+int main() {
+    return cmocka_run_group_tests_name("vote", tests, NULL, NULL);
+}
+
+void test_vote_init(void **state) {
+    (void) state;
+
+    vote_ctx *ctx;
+    vote_result result;
+    uint8_t data[1];
+
+    assert_null(vote_init(0, TEST_VOTE_SLOTS, TEST_VOTE_WINDOW_MS));
+    assert_null(vote_init(TEST_VOTE_RECEIVERS, 1, TEST_VOTE_WINDOW_MS));
+
+    ctx = vote_init(TEST_VOTE_RECEIVERS, TEST_VOTE_SLOTS, TEST_VOTE_WINDOW_MS);
+    assert_non_null(ctx);
+
+    assert_int_equal(VOTE_EMPTY, vote_select(ctx, TEST_VOTE_EPOCH, &result));
+
+    data[0] = 0;
+    assert_int_equal(EXIT_FAILURE, vote_put(ctx, 0, 1, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0, data, 1));
+
+    vote_set_frame_ms(ctx, TEST_VOTE_FRAME_MS);
+    assert_int_equal(EXIT_FAILURE, vote_put(ctx, TEST_VOTE_RECEIVERS, 1, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0,
+                                            data, 1));
+    assert_int_equal(EXIT_SUCCESS, vote_put(ctx, 0, 1, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0, data, 1));
+
+    vote_free(ctx);
+}
+
+void test_vote_best(void **state) {
+    (void) state;
+
+    vote_ctx *ctx;
+    vote_result result;
+
+    ctx = test_vote_create();
+
+    test_vote_put(ctx, 0, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0.2f);
+    test_vote_put(ctx, 1, TEST_VOTE_EPOCH + 3, TEST_VOTE_EPOCH + 5, 0.5f);
+    test_vote_put(ctx, 2, TEST_VOTE_EPOCH + 1, TEST_VOTE_EPOCH + 7, 0.3f);
+
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, TEST_VOTE_EPOCH + 7, &result));
+    assert_int_equal(1, result.receiver);
+    assert_int_equal(TEST_VOTE_EPOCH + 3, result.timestamp);
+    assert_int_equal(1, result.size);
+    assert_int_equal(1, result.data[0]);
+    assert_int_equal(7, result.latency);
+
+    assert_int_equal(VOTE_EMPTY, vote_select(ctx, TEST_VOTE_EPOCH + 7, &result));
+
+    assert_int_equal(1, ctx->selected);
+    assert_int_equal(1, ctx->receivers[1].selected);
+    assert_int_equal(7, ctx->latency_max);
+
+    vote_free(ctx);
+}
+
+void test_vote_window(void **state) {
+    (void) state;
+
+    vote_ctx *ctx;
+    vote_result result;
+    uint64_t ts;
+
+    ctx = test_vote_create();
+
+    test_vote_put(ctx, 0, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0.2f);
+    test_vote_put(ctx, 1, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0.1f);
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, TEST_VOTE_EPOCH, &result));
+    assert_int_equal(0, result.receiver);
+
+    ts = TEST_VOTE_EPOCH + TEST_VOTE_FRAME_MS;
+    test_vote_put(ctx, 1, ts, ts, 0.1f);
+
+    assert_int_equal(VOTE_EMPTY, vote_select(ctx, ts + TEST_VOTE_WINDOW_MS - 1, &result));
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, ts + TEST_VOTE_WINDOW_MS, &result));
+    assert_int_equal(1, result.receiver);
+    assert_int_equal(TEST_VOTE_WINDOW_MS, result.latency);
+
+    vote_free(ctx);
+}
+
+void test_vote_lost_late(void **state) {
+    (void) state;
+
+    vote_ctx *ctx;
+    vote_result result;
+
+    ctx = test_vote_create();
+
+    test_vote_put(ctx, 0, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0.2f);
+    test_vote_put(ctx, 0, TEST_VOTE_EPOCH + 2 * TEST_VOTE_FRAME_MS, TEST_VOTE_EPOCH + 1, 0.2f);
+
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, TEST_VOTE_EPOCH + 1, &result));
+    assert_int_equal(VOTE_LOST, vote_select(ctx, TEST_VOTE_EPOCH + 1, &result));
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, TEST_VOTE_EPOCH + 1, &result));
+    assert_int_equal(TEST_VOTE_EPOCH + 2 * TEST_VOTE_FRAME_MS, result.timestamp);
+    assert_int_equal(VOTE_EMPTY, vote_select(ctx, TEST_VOTE_EPOCH + 1, &result));
+
+    test_vote_put(ctx, 1, TEST_VOTE_EPOCH + TEST_VOTE_FRAME_MS, TEST_VOTE_EPOCH + 2, 0.9f);
+    assert_int_equal(1, ctx->late);
+    assert_int_equal(1, ctx->receivers[1].late);
+    assert_int_equal(1, ctx->lost);
+
+    vote_free(ctx);
+}
+
+void test_vote_alignment(void **state) {
+    (void) state;
+
+    vote_ctx *ctx;
+    vote_result result;
+
+    ctx = test_vote_create();
+
+    test_vote_put(ctx, 0, TEST_VOTE_EPOCH + 7, TEST_VOTE_EPOCH, 0.2f);
+    test_vote_put(ctx, 1, TEST_VOTE_EPOCH + 7 + TEST_VOTE_FRAME_MS / 2 - 1, TEST_VOTE_EPOCH, 0.5f);
+    test_vote_put(ctx, 2, TEST_VOTE_EPOCH + 7 + TEST_VOTE_FRAME_MS / 2 + 1, TEST_VOTE_EPOCH, 0.9f);
+
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, TEST_VOTE_EPOCH + TEST_VOTE_WINDOW_MS, &result));
+    assert_int_equal(1, result.receiver);
+
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, TEST_VOTE_EPOCH + TEST_VOTE_WINDOW_MS, &result));
+    assert_int_equal(2, result.receiver);
+
+    vote_free(ctx);
+}
+
+void test_vote_resync(void **state) {
+    (void) state;
+
+    vote_ctx *ctx;
+    vote_result result;
+    uint64_t ts;
+
+    ctx = test_vote_create();
+
+    test_vote_put(ctx, 0, TEST_VOTE_EPOCH, TEST_VOTE_EPOCH, 0.2f);
+    assert_int_equal(VOTE_FRAME, vote_select(ctx, TEST_VOTE_EPOCH, &result));
+
+    ts = TEST_VOTE_EPOCH + 1000 * TEST_VOTE_FRAME_MS;
+    test_vote_put(ctx, 0, ts, ts, 0.2f);
+
+    while (vote_select(ctx, ts, &result) == VOTE_LOST);
+
+    assert_int_equal(ts, result.timestamp);
+    assert_true(ctx->lost < TEST_VOTE_SLOTS);
+
+    vote_free(ctx);
+}
+
+void test_vote_gap(void **state) {
+    (void) state;
+
+    vote_ctx *ctx;
+    vote_result result;
+    uint64_t ts;
+    size_t i;
+
+    ctx = test_vote_create();
+
+    for (i = 0; i < 3; i++) {
+        ts = TEST_VOTE_EPOCH + i * TEST_VOTE_FRAME_MS;
+        test_vote_put(ctx, 0, ts, ts, 0.2f);
+        assert_int_equal(VOTE_FRAME, vote_select(ctx, ts, &result));
+    }
+    assert_int_equal(VOTE_EMPTY, vote_select(ctx, ts, &result));
+
+    // A second transmission starts 5 frames after the first one ended, within the slots
+    for (i = 8; i < 10; i++) {
+        ts = TEST_VOTE_EPOCH + i * TEST_VOTE_FRAME_MS;
+        test_vote_put(ctx, 0, ts, ts, 0.2f);
+        assert_int_equal(VOTE_FRAME, vote_select(ctx, ts, &result));
+        assert_int_equal(ts, result.timestamp);
+    }
+
+    assert_int_equal(5, ctx->selected);
+    assert_int_equal(0, ctx->lost);
+    assert_int_equal(0, ctx->late);
+
+    vote_free(ctx);
+}
+
+static vote_ctx *test_vote_create() {
+    vote_ctx *ctx;
+
+    ctx = vote_init(TEST_VOTE_RECEIVERS, TEST_VOTE_SLOTS, TEST_VOTE_WINDOW_MS);
+    assert_non_null(ctx);
+
+    vote_set_frame_ms(ctx, TEST_VOTE_FRAME_MS);
+
+    return ctx;
+}
+
+static void test_vote_put(vote_ctx *ctx, size_t receiver, uint64_t timestamp, uint64_t arrival, float rms) {
+    uint8_t data[1];
+
+    data[0] = (uint8_t) receiver;
+
+    assert_int_equal(EXIT_SUCCESS, vote_put(ctx, receiver, (uint32_t) receiver + 100, timestamp, arrival, rms,
+                                            data, sizeof(data)));
+}
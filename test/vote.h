@@ -0,0 +1,45 @@
+/*
+ * rtlsdr-radio
+ * Copyright (C) 2020 - 2021  Luca Cireddu (sardylan@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RTLSDR_RADIO__VOTE__H__TEST
+#define __RTLSDR_RADIO__VOTE__H__TEST
+
+#include "../src/vote.h"
+
+#define TEST_VOTE_RECEIVERS 4
+#define TEST_VOTE_SLOTS 16
+#define TEST_VOTE_WINDOW_MS 60
+#define TEST_VOTE_FRAME_MS 40
+#define TEST_VOTE_EPOCH 1600000000000ULL
+
+void test_vote_init(void **);
+
+void test_vote_best(void **);
+
+void test_vote_window(void **);
+
+void test_vote_lost_late(void **);
+
+void test_vote_alignment(void **);
+
+void test_vote_resync(void **);
+
+void test_vote_gap(void **);
+
+#endif